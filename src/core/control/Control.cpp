@@ -17,6 +17,7 @@
 #include "control/NavigationHistory.h"                           // for Navi...
 #include "control/RecentManager.h"                               // for Rece...
 #include "control/ScrollHandler.h"                               // for Scro...
+#include "control/SearchIndex.h"                                 // for Sear...
 #include "control/SetsquareController.h"                         // for Sets...
 #include "control/Tool.h"                                        // for Tool
 #include "control/ToolHandler.h"                                 // for Tool...
@@ -37,6 +38,7 @@
 #include "control/settings/SettingsEnums.h"                      // for Button
 #include "control/settings/ViewModes.h"                          // for ViewM..
 #include "control/tools/TextEditor.h"                            // for Text...
+#include "control/xojfile/AutosaveJournal.h"                     // for Auto...
 #include "control/xojfile/LoadHandler.h"                         // for Load...
 #include "control/zoom/ZoomControl.h"                            // for Zoom...
 #include "gui/FloatingToolbox.h"                                 // for Floa...
@@ -68,6 +70,7 @@
 #include "gui/toolbarMenubar/model/ToolbarModel.h"               // for Tool...
 #include "model/BackgroundImage.h"                               // for Back...
 #include "model/Compass.h"                                       // for Comp...
+#include "model/DecodedImageCache.h"                             // for Deco...
 #include "model/Document.h"                                      // for Docu...
 #include "model/DocumentChangeType.h"                            // for DOCU...
 #include "model/DocumentListener.h"                              // for Docu...
@@ -135,6 +138,10 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
     this->settings = new Settings(std::move(name));
     this->settings->load();
     this->loadPaletteFromSettings();
+    this->undoRedo->setMemoryBudget(size_t{this->settings->getUndoMemoryBudget()} * 1024 * 1024,
+                                    this->settings->isUndoSpillToDisk());
+    DecodedImageCache::getInstance().setMemoryBudget(size_t{this->settings->getImageCacheMemoryBudget()} * 1024 *
+                                                     1024);
 
     this->pageTypes = new PageTypeHandler(gladeSearchPath);
 
@@ -147,9 +154,16 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
     this->scrollHandler = new ScrollHandler(this);
 
     this->scheduler = new XournalScheduler();
+    this->scheduler->setRenderWorkerCount(this->settings->getRenderThreadCount());
 
     this->doc = new Document(this);
 
+    this->autosaveJournal = std::make_unique<AutosaveJournal>(this->doc);
+    this->autosaveJournal->registerListener(this);
+    this->undoRedo->addUndoRedoListener(this->autosaveJournal.get());
+
+    this->searchIndex = std::make_unique<SearchIndex>(this);
+
     // for crashhandling
     setEmergencyDocument(this->doc);
 
@@ -190,6 +204,8 @@ Control::~Control() {
     this->clipboardHandler = nullptr;
     delete this->undoRedo;
     this->undoRedo = nullptr;
+    this->autosaveJournal.reset();
+    this->searchIndex.reset();
     delete this->settings;
     this->settings = nullptr;
     delete this->toolHandler;
@@ -243,6 +259,9 @@ void Control::deleteLastAutosaveFile() {
         if (fs::exists(this->lastAutosaveFilename)) {
             fs::remove(this->lastAutosaveFilename);
         }
+        if (!this->lastAutosaveFilename.empty()) {
+            AutosaveJournal::remove(this->lastAutosaveFilename);
+        }
     } catch (const fs::filesystem_error& e) {
         auto fmtstr = FS(_F("Could not remove old autosave file \"{1}\": {2}") % this->lastAutosaveFilename.u8string() %
                          e.what());
@@ -1621,6 +1640,12 @@ void Control::openXoppFile(fs::path filepath, int scrollToPage, std::function<vo
 
     try {
         LoadHandler loadHandler(&errorMessages);
+        // The pages are parsed when they are first needed, e.g. by a render job: show their errors from the UI thread
+        loadHandler.setLazyLoading(this->settings->isLazyPageLoading(), [ctrl = this](const std::string& error) {
+            auto msg = FS(_F("Error while loading a page of the document:\n{1}") % error);
+            Util::execInUiThread([msg, win = ctrl->getGtkWindow()]() { XojMsgBox::showErrorToUser(win, msg); });
+        });
+        loadHandler.setParsingThreads(this->settings->getLoadParsingThreads());
         doc = loadHandler.loadDocument(filepath);
 
         if (!loadHandler.getMissingPdfFilename().empty() || loadHandler.isAttachedPdfMissing()) {
@@ -2627,6 +2652,8 @@ void Control::fontChanged(const XojFont& font) {
 
 auto Control::getUndoRedoHandler() const -> UndoRedoHandler* { return this->undoRedo; }
 
+auto Control::getAutosaveJournal() const -> AutosaveJournal* { return this->autosaveJournal.get(); }
+
 auto Control::getZoomControl() const -> ZoomControl* { return this->zoom; }
 
 auto Control::getCursor() const -> XournalppCursor* { return this->cursor; }
@@ -2670,6 +2697,8 @@ auto Control::getSidebar() const -> Sidebar* { return this->sidebar; }
 
 auto Control::getSearchBar() const -> SearchBar* { return this->searchBar; }
 
+auto Control::getSearchIndex() const -> SearchIndex* { return this->searchIndex.get(); }
+
 auto Control::getAudioController() const -> AudioController* { return this->audioController.get(); }
 
 auto Control::getPageTypes() const -> PageTypeHandler* { return this->pageTypes; }
@@ -62,6 +62,7 @@ class MainWindow;
 class ObjectInputStream;
 class ScrollHandler;
 class SearchBar;
+class SearchIndex;
 class Settings;
 class TextEditor;
 class XournalScheduler;
@@ -71,6 +72,7 @@ class XojFont;
 class XojPdfRectangle;
 class Callback;
 class ActionDatabase;
+class AutosaveJournal;
 class NavigationHistory;
 
 class Control:
@@ -309,6 +311,7 @@ public:
     ZoomControl* getZoomControl() const;
     Document* getDocument() const;
     UndoRedoHandler* getUndoRedoHandler() const;
+    AutosaveJournal* getAutosaveJournal() const;
     MainWindow* getWindow() const;
     GtkWindow* getGtkWindow() const;
     ScrollHandler* getScrollHandler() const;
@@ -317,6 +320,7 @@ public:
     XournalppCursor* getCursor() const;
     Sidebar* getSidebar() const;
     SearchBar* getSearchBar() const;
+    SearchIndex* getSearchIndex() const;
     AudioController* getAudioController() const;
     PageTypeHandler* getPageTypes() const;
     PageBackgroundChangeController* getPageBackgroundChangeController() const;
@@ -533,6 +537,12 @@ private:
      */
     guint autosaveTimeout = 0;
     fs::path lastAutosaveFilename;
+    /**
+     * The pages changed since the last autosave
+     */
+    std::unique_ptr<AutosaveJournal> autosaveJournal;
+
+    std::unique_ptr<SearchIndex> searchIndex;
 
     XournalScheduler* scheduler;
 
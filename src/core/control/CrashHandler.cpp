@@ -33,8 +33,7 @@ void emergencySave() {
     auto const& filepath = Util::getConfigFile("emergencysave.xopp");
 
     SaveHandler handler;
-    handler.prepareSave(document, filepath);
-    handler.saveTo(filepath);
+    handler.saveDocumentTo(document, filepath, filepath);
 
     if (!handler.getErrorMessage().empty()) {
         std::cerr << "Error: " << handler.getErrorMessage() << std::endl;
@@ -1,43 +1,47 @@
 #include "PdfCache.h"
 
-#include <algorithm>  // for max
+#include <algorithm>  // for max, find_if, remove_if
 #include <cmath>      // for ceil, abs
 #include <cstdio>     // for size_t
-#include <memory>     // for shared_ptr, __shared_ptr_access
+#include <memory>     // for shared_ptr, make_shared, unique_ptr
 #include <string>     // for string
 #include <utility>    // for move
 
-#include <glib.h>  // for g_warning
+#include <glib.h>  // for g_warning, g_debug
 
 #include "control/settings/Settings.h"  // for Settings
 #include "pdf/base/XojPdfDocument.h"    // for XojPdfDocument
 #include "util/Assert.h"                // for xoj_assert
 #include "util/Range.h"                 // for Range
 #include "util/i18n.h"                  // for _
-#include "util/safe_casts.h"            // for as_unsigned
 #include "view/Mask.h"                  // for Mask
 
 class PdfCacheEntry {
 public:
     /**
-     *   Cache [img], the result of rendering [popplerPage] with
-     * the given [zoom].
+     *   Cache [buffer], the result of rendering the page [pdfPageNo]
      *  A change in the document's zoom causes a change in the
      * quality of the PDF backgrounds (zoomed in => need a higher
      * quality rendering).
      *
-     * @param popplerPage
-     * @param buffer is the result of rendering popplerPage
+     * @param pdfPageNo
+     * @param buffer is the result of rendering the page
      */
-    PdfCacheEntry(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer):
-            popplerPage(std::move(popplerPage)), buffer(std::forward<xoj::view::Mask>(buffer)) {}
+    PdfCacheEntry(size_t pdfPageNo, xoj::view::Mask&& buffer):
+            pdfPageNo(pdfPageNo),
+            buffer(std::forward<xoj::view::Mask>(buffer)),
+            memoryUsage(this->buffer.getMemoryUsage()) {}
 
     ~PdfCacheEntry() = default;
 
-    XojPdfPageSPtr popplerPage;
+    size_t pdfPageNo;
     xoj::view::Mask buffer;
+    /// Size of the buffer, in bytes
+    size_t memoryUsage;
 };
 
+constexpr size_t BYTES_PER_MB = 1024 * 1024;
+
 static double getPercentZoomChange(double oldZoom, double newZoom) {
     double averagedZoom = (oldZoom + newZoom) / 2.0;
     return std::abs(oldZoom - newZoom) * 100.0 / averagedZoom;
@@ -47,108 +51,215 @@ PdfCache::PdfCache(const XojPdfDocument& doc, Settings* settings): pdfDocument(d
 
 PdfCache::~PdfCache() = default;
 
-void PdfCache::setRefreshThreshold(double threshold) { this->zoomRefreshThreshold = threshold; }
+void PdfCache::setRefreshThreshold(double threshold) {
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    this->zoomRefreshThreshold = threshold;
+}
 
-void PdfCache::setMaxSize(size_t newSize) {
-    this->maxSize = newSize;
-    if (this->data.size() > this->maxSize) {
-        this->data.resize(this->maxSize);
-    }
+void PdfCache::setMaxMemory(size_t bytes) {
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    this->maxMemory = bytes;
+    shrinkToBudgetUnlocked(0);
+}
+
+auto PdfCache::getMemoryUsage() const -> size_t {
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    return this->memoryUsage;
+}
+
+auto PdfCache::getMaxMemory() const -> size_t {
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    return this->maxMemory;
 }
 
 void PdfCache::updateSettings(Settings* settings) {
     if (settings) {
-        setMaxSize(as_unsigned(settings->getPdfPageCacheSize()));
+        setMaxMemory(static_cast<size_t>(settings->getPdfPageCacheMemory()) * BYTES_PER_MB);
         setRefreshThreshold(settings->getPDFPageRerenderThreshold());
     }
 }
 
 void PdfCache::evictAllExcept(const std::unordered_set<size_t>& retainedPdfPages) {
-    std::lock_guard<std::mutex> lock(this->renderMutex);
-
-    for (auto& entry: this->data) {
-        xoj_assert(entry);
-        xoj_assert(entry->popplerPage);
-
-        const size_t pdfPageNo = static_cast<size_t>(entry->popplerPage->getPageId());
-        if (retainedPdfPages.find(pdfPageNo) == retainedPdfPages.end()) {
-            entry.reset();
-        }
-    }
-
-    this->data.erase(std::remove(this->data.begin(), this->data.end(), nullptr), this->data.end());
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+
+    this->data.erase(std::remove_if(this->data.begin(), this->data.end(),
+                                    [this, &retainedPdfPages](const auto& entry) {
+                                        xoj_assert(entry);
+                                        if (retainedPdfPages.find(entry->pdfPageNo) != retainedPdfPages.end()) {
+                                            return false;
+                                        }
+                                        this->memoryUsage -= entry->memoryUsage;
+                                        return true;
+                                    }),
+                     this->data.end());
 }
 
-auto PdfCache::lookup(size_t pdfPageNo) const -> const PdfCacheEntry* {
-    for (auto& e: this->data) {
-        if (static_cast<size_t>(e->popplerPage->getPageId()) == pdfPageNo) {
-            return e.get();
-        }
+auto PdfCache::lookupUnlocked(size_t pdfPageNo) -> std::shared_ptr<const PdfCacheEntry> {
+    auto it = std::find_if(this->data.begin(), this->data.end(),
+                           [pdfPageNo](const auto& entry) { return entry->pdfPageNo == pdfPageNo; });
+    if (it == this->data.end()) {
+        return nullptr;
     }
 
-    return nullptr;
+    auto entry = *it;
+    if (it != this->data.begin()) {
+        // Most recently used first
+        this->data.erase(it);
+        this->data.push_front(entry);
+    }
+    return entry;
 }
 
-auto PdfCache::cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer) -> const PdfCacheEntry* {
-    xoj_assert(this->maxSize > 0);
-    xoj_assert(popplerPage);
-    const auto pageId = popplerPage->getPageId();
+auto PdfCache::cacheUnlocked(size_t pdfPageNo, xoj::view::Mask&& buffer) -> std::shared_ptr<const PdfCacheEntry> {
+    xoj_assert(this->maxMemory > 0);
 
     auto existingIt = std::find_if(this->data.begin(), this->data.end(),
-                                   [pageId](const auto& entry) { return entry->popplerPage->getPageId() == pageId; });
+                                   [pdfPageNo](const auto& entry) { return entry->pdfPageNo == pdfPageNo; });
     if (existingIt != this->data.end()) {
+        this->memoryUsage -= (*existingIt)->memoryUsage;
         this->data.erase(existingIt);
     }
 
-    if (this->data.size() >= this->maxSize) {
-        this->data.resize(this->maxSize - 1);
-    }
+    this->data.emplace_front(std::make_shared<PdfCacheEntry>(pdfPageNo, std::forward<xoj::view::Mask>(buffer)));
+    this->memoryUsage += this->data.front()->memoryUsage;
 
-    this->data.emplace_front(
-            std::make_unique<PdfCacheEntry>(std::move(popplerPage), std::forward<xoj::view::Mask>(buffer)));
+    // Keep the new entry, even if it does not fit alone: it is about to be painted anyway
+    shrinkToBudgetUnlocked(1);
 
-    return this->data.front().get();
+    return this->data.front();
 }
 
-void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight) {
-    std::lock_guard<std::mutex> lock(this->renderMutex);
+void PdfCache::shrinkToBudgetUnlocked(size_t kept) {
+    size_t evicted = 0;
+    while (this->memoryUsage > this->maxMemory && this->data.size() > kept) {
+        this->memoryUsage -= this->data.back()->memoryUsage;
+        this->data.pop_back();
+        evicted++;
+    }
+    if (evicted > 0) {
+        g_debug("PdfCache: evicted %zu page(s), %zu page(s) using %.1f MB of %.1f MB left", evicted, this->data.size(),
+                static_cast<double>(this->memoryUsage) / BYTES_PER_MB,
+                static_cast<double>(this->maxMemory) / BYTES_PER_MB);
+    }
+}
 
-    const PdfCacheEntry* cacheResult = lookup(pdfPageNo);
+auto PdfCache::needsRefresh(const PdfCacheEntry* entry, double zoom) const -> bool {
+    if (entry == nullptr) {
+        return true;
+    }
+    // If we do have a cached result, is its rendering quality acceptable for our current zoom?
+    return zoom > 1.0 && getPercentZoomChange(entry->buffer.getZoom(), zoom) > this->zoomRefreshThreshold;
+}
 
-    bool needsRefresh = cacheResult == nullptr;
+auto PdfCache::acquireDocument() -> std::unique_ptr<XojPdfDocument> {
+    {
+        std::lock_guard<std::mutex> lock(this->cacheMutex);
+        if (!this->idleDocuments.empty()) {
+            auto doc = std::move(this->idleDocuments.back());
+            this->idleDocuments.pop_back();
+            return doc;
+        }
+        if (this->documentInstances >= MAX_DOCUMENT_INSTANCES) {
+            return nullptr;
+        }
+        this->documentInstances++;
+    }
 
-    if (!needsRefresh) {
-        // If we do have a cached result, is its rendering quality
-        // acceptable for our current zoom?
-        needsRefresh =
-                (zoom > 1.0 && getPercentZoomChange(cacheResult->buffer.getZoom(), zoom) > this->zoomRefreshThreshold);
+    // Parsing the document again takes some time: do not hold the lock meanwhile
+    auto doc = std::make_unique<XojPdfDocument>();
+    if (!doc->loadCopyOf(this->pdfDocument, nullptr)) {
+        g_warning("PdfCache: could not load another instance of the pdf document. The pages will not be rendered in "
+                  "parallel.");
+        std::lock_guard<std::mutex> lock(this->cacheMutex);
+        // Do not try again
+        this->documentInstances = MAX_DOCUMENT_INSTANCES;
+        return nullptr;
     }
+    return doc;
+}
 
-    if (needsRefresh) {
-        double renderZoom = std::max(zoom, 1.0);
+void PdfCache::releaseDocument(std::unique_ptr<XojPdfDocument> doc) {
+    if (doc) {
+        std::lock_guard<std::mutex> lock(this->cacheMutex);
+        this->idleDocuments.push_back(std::move(doc));
+    }
+}
 
-        auto popplerPage = cacheResult ? cacheResult->popplerPage : pdfDocument.getPage(pdfPageNo);
+auto PdfCache::getRendering(size_t pdfPageNo, double zoom, cairo_surface_t* target, bool draft)
+        -> std::shared_ptr<const PdfCacheEntry> {
+    {
+        std::unique_lock<std::mutex> lock(this->cacheMutex);
+        if (draft) {
+            // Even a low resolution rendering does for a draft. Do not wait for a refresh in progress either.
+            if (auto cacheResult = lookupUnlocked(pdfPageNo)) {
+                return cacheResult;
+            }
+        }
+        // If another thread is rasterizing this very page, wait for its result instead of doing it twice
+        this->renderDoneCond.wait(lock, [&]() { return this->pagesInProgress.count(pdfPageNo) == 0; });
 
-        if (!popplerPage) {
-            g_warning("PdfCache::render Could not get the pdf page %zu from the document", pdfPageNo);
-            renderMissingPdfPage(cr, pageWidth, pageHeight);
-            return;
+        auto cacheResult = lookupUnlocked(pdfPageNo);
+        if ((draft && cacheResult) || !needsRefresh(cacheResult.get(), zoom)) {
+            return cacheResult;
         }
+        this->pagesInProgress.insert(pdfPageNo);
+    }
 
-        xoj::view::Mask buffer(cairo_get_target(cr), Range(0, 0, popplerPage->getWidth(), popplerPage->getHeight()),
-                               renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
+    // Rasterize without locking the cache, so that other pages can be rendered in parallel
+    auto doc = acquireDocument();
+    std::unique_lock<std::mutex> sharedDocumentLock(this->sharedDocumentMutex, std::defer_lock);
+    if (!doc) {
+        sharedDocumentLock.lock();
+    }
+    auto popplerPage = (doc ? *doc : this->pdfDocument).getPage(pdfPageNo);
+
+    std::shared_ptr<const PdfCacheEntry> result;
+    if (popplerPage) {
+        const double renderZoom = std::max(zoom, 1.0);
+        const Range extent(0, 0, popplerPage->getWidth(), popplerPage->getHeight());
+        auto buffer = target ? xoj::view::Mask(target, extent, renderZoom, CAIRO_CONTENT_COLOR_ALPHA) :
+                               xoj::view::Mask(1, extent, renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
         popplerPage->render(buffer.get());
-        if (this->maxSize == 0) {
-            buffer.paintTo(cr);
-            return;
+        popplerPage.reset();  // The page holds a reference to the document
+        if (sharedDocumentLock.owns_lock()) {
+            sharedDocumentLock.unlock();
+        }
+
+        std::lock_guard<std::mutex> lock(this->cacheMutex);
+        if (this->maxMemory == 0) {
+            result = std::make_shared<PdfCacheEntry>(pdfPageNo, std::move(buffer));
+        } else {
+            result = cacheUnlocked(pdfPageNo, std::move(buffer));
         }
+    } else {
+        g_warning("PdfCache::render Could not get the pdf page %zu from the document", pdfPageNo);
+    }
+    if (sharedDocumentLock.owns_lock()) {
+        sharedDocumentLock.unlock();
+    }
+    releaseDocument(std::move(doc));
 
-        cacheResult = cache(popplerPage, std::move(buffer));
+    {
+        std::lock_guard<std::mutex> lock(this->cacheMutex);
+        this->pagesInProgress.erase(pdfPageNo);
     }
+    this->renderDoneCond.notify_all();
 
+    return result;
+}
+
+void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight, bool draft) {
+    auto cacheResult = getRendering(pdfPageNo, zoom, cairo_get_target(cr), draft);
+    if (!cacheResult) {
+        renderMissingPdfPage(cr, pageWidth, pageHeight);
+        return;
+    }
+    // The entry is shared: it can be painted even if another thread evicts it meanwhile
     cacheResult->buffer.paintTo(cr);
 }
 
+void PdfCache::prefetch(size_t pdfPageNo, double zoom) { getRendering(pdfPageNo, zoom, nullptr); }
+
 void PdfCache::renderMissingPdfPage(cairo_t* cr, double pageWidth, double pageHeight) {
     cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
     cairo_set_font_size(cr, 26);
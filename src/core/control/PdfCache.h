@@ -11,10 +11,13 @@
 
 #pragma once
 
-#include <cstddef>  // for size_t
-#include <deque>    // for deque
-#include <mutex>    // for mutex
-#include <unordered_set>
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <memory>              // for shared_ptr, unique_ptr
+#include <mutex>               // for mutex
+#include <unordered_set>       // for unordered_set
+#include <vector>              // for vector
 
 #include <cairo.h>  // for cairo_t, cairo_surface_t
 
@@ -40,12 +43,21 @@ private:
 public:
     /**
      * @brief Render the page with number pdfPageNo of the pdf document to the cairo context
+     * Distinct pages can be rendered in parallel from different threads.
      * @param cr the cairo context
      * @param pdfPageNo The page number (in the pdf document)
      * @param zoom The current zoom level
      * @param pageWidth/pageHeight Xournal++ page dimensions
+     * @param draft If true, any cached rendering of the page is used, whatever its resolution. The page is only
+     * rasterized if it is not cached at all.
      */
-    void render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight);
+    void render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight, bool draft = false);
+
+    /**
+     * @brief Rasterize the page with number pdfPageNo into the cache (if it is not there already), without painting it
+     * @param zoom The zoom level the page will be rendered at (including the DPI scaling)
+     */
+    void prefetch(size_t pdfPageNo, double zoom);
 
 public:
     /**
@@ -57,7 +69,17 @@ public:
      */
     void setRefreshThreshold(double percentDifference);
 
-    void setMaxSize(size_t newSize);
+    /**
+     * @brief Set the memory budget of the cache. The least recently used renderings are evicted until the cache fits.
+     * @param bytes The budget in bytes. If 0, nothing is cached.
+     */
+    void setMaxMemory(size_t bytes);
+
+    /**
+     * @return The memory used by the cached renderings, in bytes
+     */
+    size_t getMemoryUsage() const;
+    size_t getMaxMemory() const;
 
     void updateSettings(Settings* settings);
 
@@ -73,21 +95,64 @@ public:
 
 private:
     /**
-     * @brief Look up for a cache entry for the page with number pdfPgeNo in the PDF.
+     * @brief Look up for a cache entry for the page with number pdfPgeNo in the PDF, and mark it as recently used.
+     * The cache's mutex must be locked.
+     */
+    std::shared_ptr<const PdfCacheEntry> lookupUnlocked(size_t pdfPageNo);
+    /**
+     * @brief Push a cache entry. The cache's mutex must be locked.
      */
-    const PdfCacheEntry* lookup(size_t pdfPageNo) const;
+    std::shared_ptr<const PdfCacheEntry> cacheUnlocked(size_t pdfPageNo, xoj::view::Mask&& buffer);
     /**
-     * @brief Push a cache entry
+     * @brief Evict the least recently used entries until the cache fits in its budget, keeping at least the `kept`
+     * most recently used ones. The cache's mutex must be locked.
      */
-    const PdfCacheEntry* cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer);
+    void shrinkToBudgetUnlocked(size_t kept);
 
-private:
-    XojPdfDocument pdfDocument;
+    bool needsRefresh(const PdfCacheEntry* entry, double zoom) const;
+
+    /**
+     * @brief Get the cached rendering of the page, rasterizing it if need be.
+     * @param target A surface similar to the one the rendering will be painted on. If nullptr, an image surface is used
+     * @param draft If true, accept any cached rendering, and never refresh or replace it
+     * @return nullptr if the page could not be rendered
+     */
+    std::shared_ptr<const PdfCacheEntry> getRendering(size_t pdfPageNo, double zoom, cairo_surface_t* target,
+                                                      bool draft = false);
 
-    std::mutex renderMutex;
+    /**
+     * @brief Get a document instance that no other thread is using, to render pages in parallel.
+     * @return nullptr if none is available: use pdfDocument (whose renderings are serialized) instead.
+     */
+    std::unique_ptr<XojPdfDocument> acquireDocument();
+    void releaseDocument(std::unique_ptr<XojPdfDocument> doc);
+
+    /// Maximal number of document instances used for parallel renderings
+    static constexpr size_t MAX_DOCUMENT_INSTANCES = 4;
 
-    std::deque<std::unique_ptr<PdfCacheEntry>> data;
-    decltype(data)::size_type maxSize = 0;
+private:
+    XojPdfDocument pdfDocument;
+    /// Serializes the use of pdfDocument, when no independent instance is available
+    std::mutex sharedDocumentMutex;
+
+    /// Protects everything below
+    mutable std::mutex cacheMutex;
+    /// Notified whenever a page rendering is done
+    std::condition_variable renderDoneCond;
+
+    /// Pages being rasterized at the moment: other threads wait for the result instead of rasterizing them again
+    std::unordered_set<size_t> pagesInProgress;
+
+    /// Independent instances of pdfDocument, not in use at the moment
+    std::vector<std::unique_ptr<XojPdfDocument>> idleDocuments;
+    /// Number of independent instances created so far
+    size_t documentInstances = 0;
+
+    /// Most recently used entries first. The entries are shared so that they can be painted without locking the cache
+    std::deque<std::shared_ptr<const PdfCacheEntry>> data;
+    /// Sum of the memory used by the entries in data, in bytes
+    size_t memoryUsage = 0;
+    size_t maxMemory = 0;
 
     double zoomRefreshThreshold;
 };
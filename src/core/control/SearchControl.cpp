@@ -3,15 +3,17 @@
 #include <memory>   // for __shared_ptr_access
 #include <utility>  // for move
 
+#include "control/SearchIndex.h"             // for SearchIndex
 #include "model/Element.h"                   // for Element, ELEMENT_TEXT
 #include "model/Layer.h"                     // for Layer
 #include "model/Text.h"                      // for Text
 #include "model/XojPage.h"                   // for XojPage
 #include "view/overlays/SearchResultView.h"  // for SEARCH_CHANGED_NOTIFICATION
 
-SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf):
+SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf, SearchIndex* index):
         page(page),
         pdf(std::move(pdf)),
+        index(index),
         viewPool(std::make_shared<xoj::util::DispatchPool<xoj::view::SearchResultView>>()) {}
 
 SearchControl::~SearchControl() = default;
@@ -32,12 +34,19 @@ auto SearchControl::search(const std::string& text, size_t index, size_t* occurr
         this->results.clear();
         this->currentText = text;
 
+        bool complete = true;
         if (this->pdf) {
-            this->results = this->pdf->findText(text);
+            auto pdfResults = this->index->findPdfText(*this->pdf, text);
+            complete = pdfResults.has_value();
+            if (complete) {
+                this->results = std::move(*pdfResults);
+            }
         }
 
+        // Only lay out the Text elements of the pages where the index found the text
+        const bool hasTextElements = this->index->mayContainText(this->page, text);
         for (Layer* l: this->page->getLayers()) {
-            if (!l->isVisible()) {
+            if (!l->isVisible() || !hasTextElements) {
                 continue;
             }
 
@@ -50,6 +59,11 @@ auto SearchControl::search(const std::string& text, size_t index, size_t* occurr
                 }
             }
         }
+
+        if (!complete) {
+            // The pdf page is not indexed yet (see SearchIndex::awaitPdfPage()): search it again next time
+            this->currentText.clear();
+        }
     }
 
     this->viewPool->dispatch(xoj::view::SearchResultView::SEARCH_CHANGED_NOTIFICATION);
@@ -20,6 +20,8 @@
 #include "pdf/base/XojPdfPage.h"  // for XojPdfPageSPtr, XojPdfRectangle
 #include "util/DispatchPool.h"
 
+class SearchIndex;
+
 namespace xoj::view {
 class OverlayView;
 class Repaintable;
@@ -28,7 +30,7 @@ class SearchResultView;
 
 class SearchControl: public OverlayBase {
 public:
-    SearchControl(const PageRef& page, XojPdfPageSPtr pdf);
+    SearchControl(const PageRef& page, XojPdfPageSPtr pdf, SearchIndex* index);
     virtual ~SearchControl();
 
     bool search(const std::string& text, size_t index, size_t* occurrences, XojPdfRectangle* UpperMostMatch);
@@ -44,6 +46,7 @@ public:
 private:
     PageRef page;
     XojPdfPageSPtr pdf;
+    SearchIndex* index;
     std::string currentText;
     XojPdfRectangle* highlightRect = nullptr;
 
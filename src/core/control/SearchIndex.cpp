@@ -0,0 +1,240 @@
+#include "SearchIndex.h"
+
+#include <algorithm>  // for any_of, min, max
+#include <iterator>   // for next
+#include <limits>     // for numeric_limits
+#include <utility>    // for move
+
+#include <glib.h>  // for g_utf8_get_char_validated, g_unichar_tolower
+
+#include "control/Control.h"                // for Control
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "model/Document.h"                 // for Document
+#include "model/Element.h"                  // for Element, ELEMENT_TEXT
+#include "model/Layer.h"                    // for Layer
+#include "model/Text.h"                     // for Text
+#include "model/XojPage.h"                  // for XojPage
+#include "util/StringUtils.h"               // for StringUtils
+#include "util/Util.h"                      // for execInUiThread
+
+SearchIndex::SearchIndex(Control* control): control(control) {
+    registerListener(control);
+    control->getUndoRedoHandler()->addUndoRedoListener(this);
+}
+
+SearchIndex::~SearchIndex() = default;
+
+auto SearchIndex::toLowerCase(std::string_view text, std::vector<uint32_t>* charIndices) -> std::string {
+    std::string lower;
+    lower.reserve(text.size());
+    const char* p = text.data();
+    const char* end = text.data() + text.size();
+    for (uint32_t index = 0; p < end; index++) {
+        const gunichar c = g_utf8_get_char_validated(p, end - p);
+        size_t inputLength = 1;
+        if (c == static_cast<gunichar>(-1) || c == static_cast<gunichar>(-2)) {
+            // Invalid UTF-8: keep the byte
+            lower.push_back(*p);
+        } else {
+            char buffer[6];
+            lower.append(buffer, static_cast<size_t>(g_unichar_to_utf8(g_unichar_tolower(c), buffer)));
+            inputLength = static_cast<size_t>(g_utf8_next_char(p) - p);
+        }
+        if (charIndices) {
+            charIndices->resize(lower.size(), index);
+        }
+        p += inputLength;
+    }
+    return lower;
+}
+
+SearchIndex::PdfText::PdfText(const XojPdfPage::TextLayout& layout): glyphs(layout.glyphs) {
+    this->text = toLowerCase(layout.text, &this->charIndices);
+}
+
+auto SearchIndex::PdfText::find(std::string_view pattern) const -> std::vector<XojPdfRectangle> {
+    std::vector<XojPdfRectangle> results;
+    if (pattern.empty() || glyphs.empty()) {
+        return results;
+    }
+
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        const size_t first = charIndices[pos];
+        const size_t last = std::min<size_t>(charIndices[pos + pattern.size() - 1], glyphs.size() - 1);
+        XojPdfRectangle box(INF, INF, -INF, -INF);
+        for (size_t i = first; i <= last; i++) {
+            box.x1 = std::min(box.x1, glyphs[i].x1);
+            box.y1 = std::min(box.y1, glyphs[i].y1);
+            box.x2 = std::max(box.x2, glyphs[i].x2);
+            box.y2 = std::max(box.y2, glyphs[i].y2);
+        }
+        if (box.x1 <= box.x2) {
+            results.push_back(box);
+        }
+    }
+    return results;
+}
+
+void SearchIndex::build() {
+    Document* doc = control->getDocument();
+    doc->lock_shared();
+    const size_t pageCount = doc->getPdfPageCount();
+    doc->unlock_shared();
+
+    std::lock_guard lock(mutex);
+    if (this->building) {
+        return;
+    }
+    this->building = true;
+    this->pdfPages.resize(pageCount);
+    for (size_t i = 0; i < pageCount; i++) {
+        if (!this->pdfPages[i]) {
+            control->getScheduler()->addSearchIndex(this, i, this->generation);
+        }
+    }
+}
+
+void SearchIndex::indexPdfPage(size_t pdfPageNo, uint64_t generation) {
+    {
+        std::lock_guard lock(mutex);
+        if (generation != this->generation || pdfPageNo >= this->pdfPages.size() || this->pdfPages[pdfPageNo]) {
+            return;
+        }
+    }
+
+    Document* doc = control->getDocument();
+    doc->lock_shared();
+    XojPdfPageSPtr pdf = doc->getPdfPage(pdfPageNo);
+    doc->unlock_shared();
+
+    // Slow: not under the lock. A page which cannot be read has no text: it is not waited for forever.
+    auto text = std::make_shared<const PdfText>(pdf ? pdf->getTextLayout() : XojPdfPage::TextLayout{});
+
+    std::lock_guard lock(mutex);
+    if (generation == this->generation && pdfPageNo < this->pdfPages.size()) {
+        this->pdfPages[pdfPageNo] = std::move(text);
+        if (this->awaitedPage == pdfPageNo) {
+            Util::execInUiThread([this]() { notifyAwaited(); });
+        }
+    }
+}
+
+auto SearchIndex::findPdfText(const XojPdfPage& pdf, const std::string& text)
+        -> std::optional<std::vector<XojPdfRectangle>> {
+    const auto pdfPageNo = static_cast<size_t>(pdf.getPageId());
+    std::shared_ptr<const PdfText> indexed;
+    {
+        std::lock_guard lock(mutex);
+        if (pdfPageNo >= this->pdfPages.size()) {
+            return std::nullopt;
+        }
+        indexed = this->pdfPages[pdfPageNo];
+    }
+
+    if (!indexed) {
+        return std::nullopt;
+    }
+    return indexed->find(toLowerCase(text));
+}
+
+auto SearchIndex::awaitPdfPage(size_t pdfPageNo, std::function<void()> callback) -> bool {
+    build();
+
+    std::lock_guard lock(mutex);
+    if (pdfPageNo >= this->pdfPages.size() || this->pdfPages[pdfPageNo]) {
+        return false;
+    }
+    this->awaitedPage = pdfPageNo;
+    this->awaitedCallback = std::move(callback);
+    // Before the pages indexed by build(). An outdated job is dropped by indexPdfPage().
+    control->getScheduler()->addSearchIndex(this, pdfPageNo, this->generation, JOB_PRIORITY_HIGH);
+    return true;
+}
+
+void SearchIndex::stopAwaiting() {
+    std::lock_guard lock(mutex);
+    this->awaitedPage.reset();
+    this->awaitedCallback = nullptr;
+}
+
+void SearchIndex::notifyAwaited() {
+    std::function<void()> callback;
+    {
+        std::lock_guard lock(mutex);
+        // Another page may be awaited since then
+        if (!this->awaitedPage || *this->awaitedPage >= this->pdfPages.size() || !this->pdfPages[*this->awaitedPage]) {
+            return;
+        }
+        this->awaitedPage.reset();
+        callback = std::move(this->awaitedCallback);
+        this->awaitedCallback = nullptr;
+    }
+    if (callback) {
+        callback();
+    }
+}
+
+auto SearchIndex::mayContainText(const PageRef& page, const std::string& text) -> bool {
+    const auto& layers = page->getLayersView();
+    auto it = this->pageTexts.find(page);
+    if (it == this->pageTexts.end() || it->second.size() != layers.size()) {
+        std::vector<std::vector<std::string>> texts;
+        texts.reserve(layers.size());
+        for (const Layer* l: layers) {
+            auto& layerTexts = texts.emplace_back();
+            for (const Element* e: l->getElementsView()) {
+                if (e->getType() == ELEMENT_TEXT) {
+                    // Same case conversion as Text::findText()
+                    layerTexts.emplace_back(StringUtils::toLowerCase(static_cast<const Text*>(e)->getText()));
+                }
+            }
+        }
+        it = this->pageTexts.insert_or_assign(page, std::move(texts)).first;
+    }
+
+    const std::string pattern = StringUtils::toLowerCase(text);
+    size_t i = 0;
+    for (const Layer* l: layers) {
+        const auto& layerTexts = it->second[i++];
+        if (l->isVisible() && std::any_of(layerTexts.begin(), layerTexts.end(), [&](const std::string& t) {
+                return t.find(pattern) != std::string::npos;
+            })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SearchIndex::documentChanged(DocumentChangeType type) {
+    if (type == DOCUMENT_CHANGE_PDF_BOOKMARKS) {
+        return;
+    }
+
+    this->pageTexts.clear();
+    stopAwaiting();
+
+    // The outdated jobs which are already running are dropped by indexPdfPage()
+    control->getScheduler()->removeSearchIndex(this, false);
+    bool wasBuilding = false;
+    {
+        std::lock_guard lock(mutex);
+        this->generation++;
+        this->pdfPages.clear();
+        wasBuilding = this->building;
+        this->building = false;
+    }
+    if (wasBuilding) {
+        build();
+    }
+}
+
+void SearchIndex::pageDeleted(size_t) {
+    for (auto it = this->pageTexts.begin(); it != this->pageTexts.end();) {
+        it = it->first.expired() ? this->pageTexts.erase(it) : std::next(it);
+    }
+}
+
+void SearchIndex::undoRedoChanged() {}
+
+void SearchIndex::undoRedoPageChanged(PageRef page) { this->pageTexts.erase(page); }
@@ -0,0 +1,141 @@
+/*
+ * Xournal++
+ *
+ * Index of the searchable text of the document
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t, uint64_t
+#include <functional>   // for function
+#include <map>          // for map
+#include <memory>       // for shared_ptr, weak_ptr, owner_less
+#include <mutex>        // for mutex
+#include <optional>     // for optional
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+#include "model/DocumentListener.h"  // for DocumentListener
+#include "model/PageRef.h"           // for PageRef
+#include "pdf/base/XojPdfPage.h"     // for XojPdfPage, XojPdfRectangle
+#include "undo/UndoRedoHandler.h"    // for UndoRedoListener
+
+class Control;
+class XojPage;
+
+/**
+ * @brief Document-wide index of the searchable text: the text of the pdf pages, with the box of each character, and
+ * the contents of the Text elements of each page.
+ *
+ * Extracting the text of a pdf page is slow: once build() was called, SearchIndexJob%s extract all of them in the
+ * background. It never happens on the main thread: a search on a page which is not indexed yet waits for it with
+ * awaitPdfPage(). The pdf text never changes, until another pdf is loaded (see DocumentListener::documentChanged()).
+ *
+ * The contents of the Text elements of all the layers are indexed on the main thread when a page is searched, and
+ * dropped when the page changes: all the changes of the elements go through the UndoRedoHandler. The visibility of the
+ * layers does not, so it is only checked when searching.
+ */
+class SearchIndex: public DocumentListener, public UndoRedoListener {
+public:
+    explicit SearchIndex(Control* control);
+    ~SearchIndex() override;
+
+    /**
+     * The text of a pdf page, in lower case
+     */
+    class PdfText {
+    public:
+        explicit PdfText(const XojPdfPage::TextLayout& layout);
+
+        /**
+         * @param pattern The searched text, in lower case (see toLowerCase())
+         * @return The bounding boxes of the occurrences of the pattern
+         */
+        std::vector<XojPdfRectangle> find(std::string_view pattern) const;
+
+    private:
+        std::string text;
+        /// For each byte of the text, the index of the character of the pdf it comes from
+        std::vector<uint32_t> charIndices;
+        std::vector<XojPdfRectangle> glyphs;
+    };
+
+    /**
+     * Lower case version of the text, one character at a time
+     * @param charIndices If not null, gets the index of the character of the text each output byte comes from
+     */
+    static std::string toLowerCase(std::string_view text, std::vector<uint32_t>* charIndices = nullptr);
+
+public:
+    /**
+     * Starts indexing the text of the pdf in the background, if it is not already done
+     */
+    void build();
+
+    /**
+     * @return The occurrences of the text (case insensitive) on the pdf page, or nullopt if the page is not indexed yet
+     */
+    std::optional<std::vector<XojPdfRectangle>> findPdfText(const XojPdfPage& pdf, const std::string& text);
+
+    /**
+     * Indexes the pdf page before the other ones, and then calls the callback on the main thread. Only the last
+     * awaited page gets its callback called.
+     * @return false if there is nothing to wait for: the page is already indexed, and the callback is not called
+     */
+    bool awaitPdfPage(size_t pdfPageNo, std::function<void()> callback);
+
+    /**
+     * Drops the callback of awaitPdfPage()
+     */
+    void stopAwaiting();
+
+    /**
+     * @return Whether a Text element of the layers of the page which are visible now may contain the text (case
+     * insensitive)
+     */
+    bool mayContainText(const PageRef& page, const std::string& text);
+
+    /**
+     * Extracts the text of the pdf page, unless it is already indexed. Called by the SearchIndexJob%s.
+     * @param generation The generation of the index when the job was started: the job is outdated if another pdf was
+     * loaded since then
+     */
+    void indexPdfPage(size_t pdfPageNo, uint64_t generation);
+
+public:
+    // DocumentListener and UndoRedoListener interface, called on the main thread
+    void documentChanged(DocumentChangeType type) override;
+    void pageDeleted(size_t page) override;
+    void undoRedoChanged() override;
+    void undoRedoPageChanged(PageRef page) override;
+
+private:
+    /// Calls the callback of awaitPdfPage(), if its page was indexed
+    void notifyAwaited();
+
+private:
+    Control* control;
+
+    /// Protects the pdf index, filled by the SearchIndexJob%s
+    std::mutex mutex;
+    /// Incremented when another pdf is loaded
+    uint64_t generation = 0;
+    bool building = false;
+    /// The text of the pages of the pdf, null until they are indexed
+    std::vector<std::shared_ptr<const PdfText>> pdfPages;
+    /// The page given to awaitPdfPage()
+    std::optional<size_t> awaitedPage;
+    /// Only used on the main thread
+    std::function<void()> awaitedCallback;
+
+    /// The lower case contents of the Text elements of each layer of the pages, until they change. Only used on the
+    /// main thread.
+    std::map<std::weak_ptr<XojPage>, std::vector<std::vector<std::string>>, std::owner_less<>> pageTexts;
+};
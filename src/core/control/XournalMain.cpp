@@ -228,8 +228,35 @@ auto saveDoc(fs::path infile, fs::path outfile) -> int {
         std::exit(-2);
     }
     const fs::path out = fs::absolute(outfile);
-    saver.prepareSave(newDoc.get(), out);
-    saver.saveTo(out);
+    saver.saveDocumentTo(newDoc.get(), out, out);
+
+    if (!saver.getErrorMessage().empty()) {
+        std::cerr << FS(_F("Error saving document: {1}") % saver.getErrorMessage()) << std::endl;
+        std::exit(-3);
+    }
+    return 0;
+}
+
+/**
+ * @brief Convert a xopp-file between the classic (gzip) and the chunked (zip) formats
+ *
+ * @param infile Path to the input .xopp file, in either format
+ * @param outfile Path to the output .xopp file
+ * @param chunked Whether the output is a chunked zip archive
+ * @return int 0 on success
+ *
+ * Calls std::exit(-2) on failure reading the input file and std::exit(-3) on save failure
+ */
+auto convertDoc(fs::path infile, fs::path outfile, bool chunked) -> int {
+    auto doc = loadDocumentOrExit(infile, EXPORT_BACKGROUND_NONE);
+
+    SaveHandler saver;
+    const fs::path out = fs::absolute(outfile);
+    if (chunked) {
+        saver.saveChunkedTo(doc.get(), out, out);
+    } else {
+        saver.saveDocumentTo(doc.get(), out, out);
+    }
 
     if (!saver.getErrorMessage().empty()) {
         std::cerr << FS(_F("Error saving document: {1}") % saver.getErrorMessage()) << std::endl;
@@ -280,12 +307,15 @@ struct XournalMainPrivate {
         g_free(pdfFilename);
         g_free(imgFilename);
         g_free(docFilename);
+        g_free(convertFilename);
     }
 
-    gchar** optFilename{};  ///< Array of paths, in GFilename encoding
-    gchar* pdfFilename{};   ///< Single path, in GFilename encoding
-    gchar* imgFilename{};   ///< Single path, in GFilename encoding
-    gchar* docFilename{};   ///< Single path, in GFilename encoding
+    gchar** optFilename{};     ///< Array of paths, in GFilename encoding
+    gchar* pdfFilename{};      ///< Single path, in GFilename encoding
+    gchar* imgFilename{};      ///< Single path, in GFilename encoding
+    gchar* docFilename{};      ///< Single path, in GFilename encoding
+    gchar* convertFilename{};  ///< Single path, in GFilename encoding
+    gboolean convertChunked = false;
     gboolean showVersion = false;
     int openAtPageNumber = 0;  // when no --page is used, the document opens at the page specified in the metadata file
     gchar* exportRange{};
@@ -559,6 +589,14 @@ auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gi
                 },
                 "saveDocument");
     }
+    if (app_data->convertFilename && app_data->optFilename && *app_data->optFilename) {
+        return exec_guarded(
+                [&] {
+                    return convertDoc(Util::fromGFilename(*app_data->optFilename),
+                                      Util::fromGFilename(app_data->convertFilename), app_data->convertChunked);
+                },
+                "convertDocument");
+    }
     return -1;
 }
 
@@ -626,6 +664,14 @@ auto XournalMain::run(int argc, char** argv) -> int {
                                        nullptr},
                           GOptionEntry{"save", 's', 0, G_OPTION_ARG_FILENAME, &app_data.docFilename,
                                        _("Save xopp-file with the background PDF specified as FILE"), "XOPPFILE"},
+                          GOptionEntry{"convert", 0, 0, G_OPTION_ARG_FILENAME, &app_data.convertFilename,
+                                       _("Save the xopp-file specified as FILE to XOPPFILE\n"
+                                         "                                       (chunked format with --chunked)"),
+                                       "XOPPFILE"},
+                          GOptionEntry{"chunked", 0, 0, G_OPTION_ARG_NONE, &app_data.convertChunked,
+                                       _("Convert to the chunked format (one zip entry per page)\n"
+                                         "                                       Older versions cannot open it."),
+                                       nullptr},
                           GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     g_application_add_main_option_entries(G_APPLICATION(app), options.data());
 
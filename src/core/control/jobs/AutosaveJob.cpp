@@ -1,15 +1,19 @@
 #include "AutosaveJob.h"
 
+#include <utility>  // for move
+
 #include <glib.h>  // for g_message, g_warning
 
-#include "control/Control.h"              // for Control
-#include "control/jobs/Job.h"             // for JOB_TYPE_AUTOSAVE, JobType
-#include "control/xojfile/SaveHandler.h"  // for SaveHandler
-#include "model/Document.h"               // for Document
-#include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
-#include "util/PathUtil.h"                // for clearExtensions, getAutosav...
-#include "util/XojMsgBox.h"               // for XojMsgBox
-#include "util/i18n.h"                    // for FS, _F
+#include "control/Control.h"                  // for Control
+#include "control/jobs/Job.h"                 // for JOB_TYPE_AUTOSAVE, JobType
+#include "control/settings/Settings.h"        // for Settings
+#include "control/xojfile/AutosaveJournal.h"  // for AutosaveJournal
+#include "control/xojfile/SaveHandler.h"      // for SaveHandler
+#include "model/Document.h"                   // for Document
+#include "undo/UndoRedoHandler.h"             // for UndoRedoHandler
+#include "util/PathUtil.h"                    // for clearExtensions, getAutosav...
+#include "util/XojMsgBox.h"                   // for XojMsgBox
+#include "util/i18n.h"                        // for FS, _F
 
 #include "filesystem.h"  // for path
 
@@ -24,6 +28,8 @@ void AutosaveJob::afterRun() {
 
 void AutosaveJob::run() {
     SaveHandler handler;
+    Settings* settings = control->getSettings();
+    handler.setCompression({settings->getSaveCompressionLevel(), settings->getAutosaveCompressionThreads()});
 
     control->getUndoRedoHandler()->documentAutosaved();
 
@@ -40,14 +46,43 @@ void AutosaveJob::run() {
     Util::clearExtensions(filepath);
     filepath += ".autosave.xopp";
 
-    handler.prepareSave(doc, filepath);
-    doc->unlock_shared();
+    AutosaveJournal* journal = control->getAutosaveJournal();
+    if (journal->canAppend(filepath)) {
+        // Only the changed pages are written
+        if (journal->hasChanges()) {
+            g_message("%s", FS(_F("Autosaving the changed pages to {1}") %
+                               AutosaveJournal::getJournalPath(filepath).string())
+                                    .c_str());
+            auto record = journal->prepareRecord(filepath);
+            doc->unlock_shared();
+            this->error = journal->append(std::move(record), filepath);
+        } else {
+            doc->unlock_shared();
+        }
+
+        if (!this->error.empty()) {
+            callAfterRun();
+        } else {
+            control->setLastAutosaveFile(filepath);
+        }
+        return;
+    }
 
     g_message("%s", FS(_F("Autosaving to {1}") % filepath.string()).c_str());
 
     fs::path tempfile = filepath;
     tempfile += u8"~";
-    handler.saveTo(tempfile);
+    auto base = journal->prepareBase();
+    // Only the serialization needs the document: the writing of the compressed file does not block the edits
+    if (!handler.serializeDocument(doc, filepath, false)) {
+        doc->unlock_shared();
+        this->error = handler.getErrorMessage();
+        callAfterRun();
+        return;
+    }
+    doc->unlock_shared();
+
+    handler.writeSerializedTo(tempfile);
 
     doc->lock();
     handler.updateDocumentInfo(doc);
@@ -68,6 +103,7 @@ void AutosaveJob::run() {
             } else {
                 Util::safeRenameFile(tempfile, filepath);
             }
+            journal->setBase(std::move(base), filepath);
             control->setLastAutosaveFile(filepath);
         } catch (const fs::filesystem_error& e) {
             auto fmtstr = _F("Could not rename autosave file from \"{1}\" to \"{2}\": {3}");
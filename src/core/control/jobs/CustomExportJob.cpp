@@ -7,6 +7,7 @@
 
 #include "control/Control.h"                   // for Control
 #include "control/jobs/BaseExportJob.h"        // for BaseExportJob::ExportType
+#include "control/settings/Settings.h"         // for Settings
 #include "control/xojfile/XojExportHandler.h"  // for XojExportHandler
 #include "gui/MainWindow.h"                    // for MainWindow
 #include "gui/dialog/ExportDialog.h"           // for ExportDialog
@@ -123,9 +124,10 @@ void CustomExportJob::run() {
         Document* doc = this->control->getDocument();
 
         XojExportHandler h;
+        Settings* settings = control->getSettings();
+        h.setCompression({settings->getSaveCompressionLevel(), settings->getSaveCompressionThreads()});
         doc->lock_shared();
-        h.prepareSave(doc, filepath);
-        h.saveTo(filepath, this->control);
+        h.saveDocumentTo(doc, filepath, filepath, this->control);
         doc->unlock_shared();
 
         if (!h.getErrorMessage().empty()) {
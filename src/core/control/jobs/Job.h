@@ -13,7 +13,15 @@
 
 #include <atomic>
 
-enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE };
+enum JobType {
+    JOB_TYPE_BLOCKING,
+    JOB_TYPE_PREVIEW,
+    JOB_TYPE_RENDER,
+    /// Quick, low quality rendering. Unlike JOB_TYPE_RENDER, not held back by Scheduler::blockRerenderZoom()
+    JOB_TYPE_RENDER_DRAFT,
+    JOB_TYPE_AUTOSAVE,
+    JOB_TYPE_SEARCH_INDEX
+};
 
 /**
  * A manually ref-counted class representing an asynchronous job to be used with
@@ -0,0 +1,12 @@
+#include "PdfPrefetchJob.h"
+
+#include "control/PdfCache.h"  // for PdfCache
+
+PdfPrefetchJob::PdfPrefetchJob(PdfCache* cache, size_t pdfPageNo, double zoom):
+        cache(cache), pdfPageNo(pdfPageNo), zoom(zoom) {}
+
+auto PdfPrefetchJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+
+auto PdfPrefetchJob::getSource() -> void* { return this->cache; }
+
+void PdfPrefetchJob::run() { this->cache->prefetch(this->pdfPageNo, this->zoom); }
@@ -0,0 +1,41 @@
+/*
+ * Xournal++
+ *
+ * A job which rasterizes a pdf page ahead of time
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+
+#include "Job.h"  // for Job, JobType
+
+class PdfCache;
+
+/**
+ * @brief A Job which puts the rendering of a pdf page in a PdfCache, so that it is ready when the page is shown
+ */
+class PdfPrefetchJob: public Job {
+public:
+    PdfPrefetchJob(PdfCache* cache, size_t pdfPageNo, double zoom);
+
+protected:
+    ~PdfPrefetchJob() override = default;
+
+public:
+    JobType getType() override;
+
+    void* getSource() override;
+
+    void run() override;
+
+private:
+    PdfCache* cache;
+    size_t pdfPageNo;
+    double zoom;
+};
@@ -1,27 +1,29 @@
 #include "RenderJob.h"
 
-#include <mutex>    // for mutex
-#include <utility>  // for move
+#include <mutex>    // for mutex, lock_guard
+#include <utility>  // for move, pair
 #include <vector>   // for vector
 
 #include <cairo.h>  // for cairo_create, cairo_destroy, cairo_...
 
-#include "control/Control.h"            // for Control
-#include "control/ToolEnums.h"          // for TOOL_PLAY_OBJECT
-#include "control/ToolHandler.h"        // for ToolHandler
-#include "control/jobs/Job.h"           // for JOB_TYPE_RENDER, JobType
-#include "gui/PageView.h"               // for XojPageView
-#include "gui/XournalView.h"            // for XournalView
-#include "gui/widgets/XournalWidget.h"  // for gtk_xournal_repaint_area
-#include "model/Document.h"             // for Document
-#include "model/XojPage.h"              // for Page
-#include "util/Assert.h"                // for xoj_assert
-#include "util/Rectangle.h"             // for Rectangle
-#include "util/Util.h"                  // for execInUiThread
-#include "util/raii/CairoWrappers.h"    // for CairoSurfaceSPtr, CairoSPtr
-#include "util/safe_casts.h"            // for strict_cast, as_signed, as_si...
-#include "view/DocumentView.h"          // for DocumentView
-#include "view/Mask.h"                  // for Mask
+#include "control/Control.h"                // for Control
+#include "control/ToolEnums.h"              // for TOOL_PLAY_OBJECT
+#include "control/ToolHandler.h"            // for ToolHandler
+#include "control/jobs/Job.h"               // for JOB_TYPE_RENDER, JobType
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "gui/PageView.h"                   // for XojPageView
+#include "gui/XournalView.h"                // for XournalView
+#include "gui/widgets/XournalWidget.h"      // for gtk_xournal_repaint_area
+#include "model/Document.h"                 // for Document
+#include "model/XojPage.h"                  // for Page
+#include "util/Assert.h"                    // for xoj_assert
+#include "util/Rectangle.h"                 // for Rectangle
+#include "util/Util.h"                      // for execInUiThread
+#include "util/raii/CairoWrappers.h"        // for CairoSurfaceSPtr, CairoSPtr
+#include "util/safe_casts.h"                // for strict_cast, as_signed, as_si...
+#include "view/DocumentView.h"              // for DocumentView
+#include "view/Mask.h"                      // for Mask
+#include "view/TileCache.h"                 // for TileCache
 
 #if defined(__has_cpp_attribute) && __has_cpp_attribute(likely)
 #define XOJ_CPP20_UNLIKELY [[unlikely]]
@@ -30,8 +32,9 @@
 #endif
 
 using xoj::util::Rectangle;
+using xoj::view::TileCache;
 
-RenderJob::RenderJob(XojPageView* view): view(view) {}
+RenderJob::RenderJob(XojPageView* view, bool draft): view(view), draft(draft) {}
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
@@ -51,33 +54,117 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
 
     renderToBuffer(newMask.get());
 
+    // Tiles that do not exist yet will be rendered from scratch when needed
     std::lock_guard lock(this->view->drawingMutex);
-    if (!view->buffer.isInitialized()) {
-        // Todo: the buffer must not be uninitializable here, either by moving it into the job or by locking it at job
-        // creation a shared prt may also be suffice.
-        XOJ_CPP20_UNLIKELY return;
+    this->view->tiles.forEachTileIntersecting(maskRange, [&newMask](cairo_t* cr) { newMask.paintTo(cr); });
+}
+
+auto RenderJob::renderTiles(const std::vector<TileCache::TileCoord>& coords, double zoom) const
+        -> std::vector<std::pair<TileCache::TileCoord, xoj::view::Mask>> {
+    const Range pageRange(0, 0, view->page->getWidth(), view->page->getHeight());
+    const int dpiScaling = view->xournal->getDpiScaleFactor();
+    const double renderZoom = this->draft ? zoom * DRAFT_SCALE : zoom;
+    XournalScheduler* scheduler = view->xournal->getControl()->getScheduler();
+
+    std::vector<std::pair<TileCache::TileCoord, xoj::view::Mask>> res;
+    res.reserve(coords.size());
+    for (TileCache::TileCoord c: coords) {
+        if (view->xournal->getZoom() != zoom || (!this->draft && scheduler->isRerenderZoomBlocked())) {
+            // The zoom is changing: the remaining tiles are outdated already. The next repaint will ask for new ones.
+            break;
+        }
+        // Tiles on the border of the page are cropped
+        Range extent = TileCache::getTileExtent(c, zoom).intersect(pageRange);
+        if (extent.getWidth() <= 0 || extent.getHeight() <= 0) {
+            continue;
+        }
+        xoj::view::Mask tile(dpiScaling, extent, renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
+        if (this->draft) {
+            cairo_set_antialias(tile.get(), CAIRO_ANTIALIAS_NONE);
+        }
+        renderToBuffer(tile.get());
+        res.emplace_back(c, std::move(tile));
+    }
+    return res;
+}
+
+void RenderJob::storeTiles(std::vector<std::pair<TileCache::TileCoord, xoj::view::Mask>> newTiles, double zoom) {
+    Range repaintRange;
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        for (auto& [c, tile]: newTiles) {
+            repaintRange = repaintRange.unite(TileCache::getTileExtent(c, zoom));
+            this->view->tiles.setTile(c, zoom, std::move(tile), this->draft);
+        }
+    }
+    if (!repaintRange.empty()) {
+        repaintRange = repaintRange.intersect(Range(0, 0, view->page->getWidth(), view->page->getHeight()));
+        repaintPageArea(repaintRange.minX, repaintRange.minY, repaintRange.maxX, repaintRange.maxY);
     }
-    newMask.paintTo(view->buffer.get());
+}
+
+void RenderJob::renderDrafts() {
+    Range area;
+    {
+        std::lock_guard lock(this->view->repaintRectMutex);
+        area = this->view->visibleArea;
+    }
+    if (area.empty()) {
+        return;
+    }
+    area = area.intersect(Range(0, 0, view->page->getWidth(), view->page->getHeight()));
+
+    const double zoom = view->xournal->getZoom();
+    std::vector<TileCache::TileCoord> missing;
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        this->view->tiles.setZoom(zoom);
+        // Outdated tiles and drafts are better than a new draft
+        missing = this->view->tiles.getMissingTiles(area, false);
+    }
+    storeTiles(renderTiles(missing, zoom), zoom);
 }
 
 void RenderJob::run() {
+    if (this->draft) {
+        // Leave the pending rerendering requests to the final RenderJob
+        renderDrafts();
+        return;
+    }
+
     this->view->repaintRectMutex.lock();
 
     bool rerenderComplete = std::exchange(this->view->rerenderComplete, false);
     bool sizeChanged = std::exchange(this->view->sizeChanged, false);
     auto rerenderRects = std::move(this->view->rerenderRects);
+    Range area = this->view->visibleArea;
 
     this->view->repaintRectMutex.unlock();
 
-    if (rerenderComplete) {
-        xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(),
-                                Range(0, 0, view->page->getWidth(), view->page->getHeight()), view->xournal->getZoom(),
-                                CAIRO_CONTENT_COLOR_ALPHA);
+    const double zoom = view->xournal->getZoom();
+    const Range pageRange(0, 0, view->page->getWidth(), view->page->getHeight());
+    const bool preload = area.empty();
+    area = preload ? pageRange : area.intersect(pageRange);
 
-        renderToBuffer(newMask.get());
+    if (rerenderComplete) {
+        auto coords = TileCache::getTilesCovering(area, zoom);
+        if (preload && coords.size() > MAX_PRELOADED_TILES) {
+            // The page is not shown yet: only prepare its top part
+            coords.resize(MAX_PRELOADED_TILES);
+        }
+        auto newTiles = renderTiles(coords, zoom);
         {
             std::lock_guard lock(this->view->drawingMutex);
-            std::swap(this->view->buffer, newMask);
+            if (sizeChanged) {
+                this->view->tiles.clear();
+            } else {
+                // The tiles that were not rendered again are still painted until they are needed
+                this->view->tiles.invalidateAll();
+            }
+            this->view->tiles.setZoom(zoom);
+            for (auto& [c, tile]: newTiles) {
+                this->view->tiles.setTile(c, zoom, std::move(tile));
+            }
         }
         if (sizeChanged) {
             // We do not have any control on what portion of the widget needs to be redrawn. Redraw it all.
@@ -90,6 +177,16 @@ void RenderJob::run() {
             rerenderRectangle(rect);
             repaintPageArea(rect.x, rect.y, rect.x + rect.width, rect.y + rect.height);
         }
+
+        std::vector<TileCache::TileCoord> missing;
+        {
+            std::lock_guard lock(this->view->drawingMutex);
+            this->view->tiles.setZoom(zoom);
+            missing = this->view->tiles.getMissingTiles(area);
+        }
+        if (!missing.empty()) {
+            storeTiles(renderTiles(missing, zoom), zoom);
+        }
     }
 }
 
@@ -112,8 +209,14 @@ void RenderJob::renderToBuffer(cairo_t* cr) const {
                                  TOOL_PLAY_OBJECT);
     localView.setPdfCache(this->view->xournal->getCache());
 
+    xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL;
+    if (this->draft) {
+        // A draft must not replace a finer pdf rendering by a low resolution one
+        flags.pdfRendering = xoj::view::ACCEPT_ANY_PDF_RENDERING;
+    }
+
     std::shared_lock<Document> lock(*this->view->xournal->getDocument());
-    localView.drawPage(this->view->page, cr, false);
+    localView.drawPage(this->view->page, cr, false, flags);
 }
 
-auto RenderJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+auto RenderJob::getType() -> JobType { return this->draft ? JOB_TYPE_RENDER_DRAFT : JOB_TYPE_RENDER; }
@@ -11,9 +11,16 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
+#include <utility>  // for pair
+#include <vector>   // for vector
+
 #include <cairo.h>    // for cairo_surface_t
 #include <gtk/gtk.h>  // for GtkWidget
 
+#include "view/Mask.h"       // for Mask
+#include "view/TileCache.h"  // for TileCache
+
 #include "Job.h"  // for Job, JobType
 
 class XojPageView;
@@ -24,7 +31,11 @@ class Rectangle;
 
 class RenderJob: public Job {
 public:
-    RenderJob(XojPageView* view);
+    /**
+     * @param draft If true, the job only renders the missing tiles of the visible area, in low quality, so that
+     * something sensible is shown while zooming. The regular RenderJob then replaces those drafts.
+     */
+    RenderJob(XojPageView* view, bool draft = false);
 
 protected:
     ~RenderJob() override = default;
@@ -45,6 +56,27 @@ private:
 
     void renderToBuffer(cairo_t* cr) const;
 
+    /**
+     * Renders the given tiles of the page. The tiles are not stored in the page's cache.
+     * Stops early if the zoom changes in the meantime.
+     */
+    std::vector<std::pair<xoj::view::TileCache::TileCoord, xoj::view::Mask>> renderTiles(
+            const std::vector<xoj::view::TileCache::TileCoord>& coords, double zoom) const;
+
+    /**
+     * Puts the tiles in the page's cache and repaints the corresponding area
+     */
+    void storeTiles(std::vector<std::pair<xoj::view::TileCache::TileCoord, xoj::view::Mask>> newTiles, double zoom);
+
+    void renderDrafts();
+
+    /// Number of tiles rendered ahead of time for a page which has not been shown yet
+    static constexpr size_t MAX_PRELOADED_TILES = 64;
+
+    /// Resolution of the drafts, relative to the final rendering
+    static constexpr double DRAFT_SCALE = 0.5;
+
 private:
     XojPageView* view;
+    bool draft;
 };
@@ -7,6 +7,7 @@
 
 #include "control/Control.h"              // for Control
 #include "control/jobs/BlockingJob.h"     // for BlockingJob
+#include "control/settings/Settings.h"    // for Settings
 #include "control/xojfile/SaveHandler.h"  // for SaveHandler
 #include "model/Document.h"               // for Document
 #include "model/PageRef.h"                // for PageRef
@@ -103,16 +104,27 @@ auto SaveJob::save() -> bool {
     updatePreview(control);
     Document* doc = this->control->getDocument();
     SaveHandler h;
+    Settings* settings = this->control->getSettings();
+    h.setCompression({settings->getSaveCompressionLevel(), settings->getSaveCompressionThreads()});
 
     doc->lock_shared();
     fs::path target = doc->getFilepath();
     Util::safeReplaceExtension(target, "xopp");
 
-    h.prepareSave(doc, target);
-    doc->unlock_shared();
-
     auto const createBackup = doc->shouldCreateBackupOnSave();
 
+    // Only the serialization needs the document: the writing of the compressed file does not block the edits
+    if (!h.serializeDocument(doc, target, settings->isSaveChunked(), this->control)) {
+        // The file is left untouched
+        doc->unlock_shared();
+        this->lastError = FS(_F("Save file error: {1}") % h.getErrorMessage());
+        if (!control->getWindow()) {
+            g_error("%s", this->lastError.c_str());
+        }
+        return false;
+    }
+    doc->unlock_shared();
+
     if (createBackup) {
         try {
             // Note: The backup must be created for the target as this is the filepath
@@ -128,7 +140,7 @@ auto SaveJob::save() -> bool {
         }
     }
 
-    h.saveTo(target, this->control);
+    h.writeSerializedTo(target);
 
     doc->lock();
     h.updateDocumentInfo(doc);
@@ -1,7 +1,9 @@
 #include "Scheduler.h"
 
+#include <algorithm>  // for any_of, clamp
 #include <cinttypes>  // for PRId64
 #include <cstdint>    // for uint64_t
+#include <thread>     // for thread
 
 #include "control/jobs/Job.h"  // for Job, JOB_TYPE_RENDER
 #include "util/Assert.h"       // for xoj_assert
@@ -40,24 +42,47 @@ Scheduler::~Scheduler() {
     }
 }
 
+void Scheduler::setRenderWorkerCount(unsigned int n) {
+    g_return_if_fail(this->workers.empty());
+    this->renderWorkerCount = n;
+}
+
 void Scheduler::start() {
     SDEBUG("Starting scheduler");
-    g_return_if_fail(this->thread == nullptr);
+    g_return_if_fail(this->workers.empty());
+
+    unsigned int n = this->renderWorkerCount;
+    if (n == 0) {
+        // Leave some cores to the UI thread: each render worker also needs a full page buffer
+        n = std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U);
+    }
+    SDEBUG("Starting %u render workers", n);
 
-    this->thread = g_thread_new(name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this);
+    for (unsigned int i = 0; i <= n; i++) {
+        const bool renderWorker = i < n;
+        auto& w = this->workers.emplace_back(std::make_unique<Worker>(Worker{this, renderWorker}));
+        std::string threadName = name + (renderWorker ? " render " + std::to_string(i) : std::string(" background"));
+        w->thread = g_thread_new(threadName.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), w.get());
+    }
 }
 
 void Scheduler::stop() {
     SDEBUG("Stopping scheduler");
 
-    if (!this->threadRunning) {
-        return;
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        if (!this->threadRunning) {
+            return;
+        }
+        this->threadRunning = false;
     }
-    this->threadRunning = false;
     this->jobQueueCond.notify_all();
 
-    if (this->thread) {
-        g_thread_join(this->thread);
+    for (auto& w: this->workers) {
+        if (w->thread) {
+            g_thread_join(w->thread);
+            w->thread = nullptr;
+        }
     }
 }
 
@@ -75,30 +100,41 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
     this->jobQueueCond.notify_all();
 }
 
-auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> Job* {
-    Job* job = nullptr;
+auto Scheduler::isRunningUnlocked(void* source, JobType type) const -> bool {
+    return std::any_of(this->workers.begin(), this->workers.end(), [&](const auto& w) {
+        return w->busy && (source == nullptr || (w->runningSource == source && w->runningType == type));
+    });
+}
 
-    for (size_t i = JOB_PRIORITY_URGENT; i < JOB_N_PRIORITIES; i++) {
-        std::deque<Job*>& queue = *this->jobQueue[i];
+auto Scheduler::isSourceBusyUnlocked(Job* job) const -> bool {
+    void* source = job->getSource();
+    // Whatever the type of the running job: e.g. a RenderJob and a draft RenderJob of a page write to the same view
+    return source != nullptr && std::any_of(this->workers.begin(), this->workers.end(), [&](const auto& w) {
+               return w->busy && w->runningSource == source;
+           });
+}
 
-        if (onlyNotRender) {
-            for (auto it = queue.begin(); it != queue.end(); ++it) {
-                job = *it;
+auto Scheduler::getNextJobUnlocked(JobPriority first, JobPriority last, bool onlyNotRender, bool* hasRenderJobs)
+        -> Job* {
+    for (size_t i = first; i <= static_cast<size_t>(last); i++) {
+        std::deque<Job*>& queue = *this->jobQueue[i];
 
-                if (job->getType() != JOB_TYPE_RENDER) {
-                    queue.erase(it);
-                    return job;
-                }
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            Job* job = *it;
+            xoj_assert(job != nullptr);
 
+            if (onlyNotRender && job->getType() == JOB_TYPE_RENDER) {
                 if (hasRenderJobs != nullptr) {
                     *hasRenderJobs = true;
                 }
+                continue;
+            }
+            if (isSourceBusyUnlocked(job)) {
+                // Will be picked up once the running job on the same source is done
+                continue;
             }
-        } else if (!queue.empty()) {
-            job = queue.front();
-            queue.pop_front();
-            xoj_assert(job != nullptr);
 
+            queue.erase(it);
             return job;
         }
     }
@@ -106,15 +142,33 @@ auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> J
     return nullptr;
 }
 
+void Scheduler::awaitRunningJobs(void* source, JobType type) {
+    std::unique_lock lock{this->jobQueueMutex};
+    this->jobFinishedCond.wait(lock, [&]() { return !isRunningUnlocked(source, type); });
+}
+
 /**
  * Locks the complete scheduler
  */
-void Scheduler::lock() { this->schedulerMutex.lock(); }
+void Scheduler::lock() {
+    std::unique_lock lock{this->jobQueueMutex};
+    // Another thread may hold the scheduler
+    this->jobFinishedCond.wait(lock, [this]() { return !this->paused; });
+    this->paused = true;
+    this->jobFinishedCond.wait(lock, [this]() { return !isRunningUnlocked(nullptr, JOB_TYPE_BLOCKING); });
+}
 
 /**
  * Unlocks the complete scheduler
  */
-void Scheduler::unlock() { this->schedulerMutex.unlock(); }
+void Scheduler::unlock() {
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->paused = false;
+    }
+    this->jobFinishedCond.notify_all();
+    this->jobQueueCond.notify_all();
+}
 
 #define ZOOM_WAIT_US_TIMEOUT 300000  // 0.3s
 
@@ -130,6 +184,11 @@ void Scheduler::unblockRerenderZoom() {
     this->jobQueueCond.notify_all();
 }
 
+auto Scheduler::isRerenderZoomBlocked() const -> bool {
+    const gint64 blockTime = this->blockRenderZoomTime;
+    return blockTime != 0 && g_get_monotonic_time() < blockTime;
+}
+
 /**
  * If the Scheduler is blocking because we are zooming and there are only render jobs
  * we need to wakeup it later
@@ -143,11 +202,20 @@ auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
     return false;
 }
 
-auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
+auto Scheduler::jobThreadCallback(Worker* worker) -> gpointer {
+    Scheduler* scheduler = worker->scheduler;
+    const JobPriority first = worker->renderWorker ? JOB_PRIORITY_URGENT : JOB_PRIORITY_NONE;
+    const JobPriority last = worker->renderWorker ? JOB_PRIORITY_LOW : JOB_PRIORITY_NONE;
+
+    std::unique_lock jobLock{scheduler->jobQueueMutex};
+    SDEBUG("Job Thread: Locked job queue.");
+
     while (scheduler->threadRunning) {
-        // lock the whole scheduler
-        std::unique_lock schedulerLock{scheduler->schedulerMutex};
-        SDEBUG("Job Thread: Blocked scheduler.");
+        if (scheduler->paused) {
+            SDEBUG("Job Thread: Scheduler locked.");
+            scheduler->jobQueueCond.wait(jobLock);
+            continue;
+        }
 
         bool onlyNonRenderJobs = false;
         gint64 diff = 1000;
@@ -164,44 +232,41 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
             }
         }
 
-        Job* job;
+        bool hasOnlyRenderJobs = false;
+        Job* job = scheduler->getNextJobUnlocked(first, last, onlyNonRenderJobs, &hasOnlyRenderJobs);
 
-        {
-            std::unique_lock jobLock{scheduler->jobQueueMutex};
-            SDEBUG("Job Thread: Locked job queue.");
+        SDEBUG("get job: %" PRId64, (uint64_t)job);
 
-            bool hasOnlyRenderJobs = false;
-            job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
-            if (job != nullptr) {
-                hasOnlyRenderJobs = false;
+        if (job == nullptr) {
+            if (hasOnlyRenderJobs) {
+                if (auto id = scheduler->jobRenderThreadTimerId.exchange(g_timeout_add(
+                            static_cast<guint>(diff), xoj::util::wrap_for_once_v<jobRenderThreadTimer>, scheduler));
+                    id != 0) {
+                    g_source_remove(id);
+                }
             }
 
-            SDEBUG("get job: %" PRId64, (uint64_t)job);
+            scheduler->jobQueueCond.wait(jobLock);
+            continue;
+        }
 
-            if (job == nullptr) {
-                // unlock the whole scheduler
-                schedulerLock.unlock();
+        worker->busy = true;
+        worker->runningType = job->getType();
+        worker->runningSource = job->getSource();
+        jobLock.unlock();
 
-                if (hasOnlyRenderJobs) {
-                    if (auto id = scheduler->jobRenderThreadTimerId.exchange(g_timeout_add(
-                                static_cast<guint>(diff), xoj::util::wrap_for_once_v<jobRenderThreadTimer>, scheduler));
-                        id != 0) {
-                        g_source_remove(id);
-                    }
-                }
+        // Run the job.
+        SDEBUG("do job: %" PRId64, (uint64_t)job);
+        job->execute();
+        job->unref();
 
-                scheduler->jobQueueCond.wait(jobLock);
-                continue;
-            }
-        }
+        jobLock.lock();
+        worker->busy = false;
+        worker->runningSource = nullptr;
 
-        // Run the job.
-        {
-            std::lock_guard lock{scheduler->jobRunningMutex};
-            SDEBUG("do job: %" PRId64, (uint64_t)job);
-            job->execute();
-            job->unref();
-        }
+        // Wake up the threads waiting for this job, and the workers which skipped jobs on the same source
+        scheduler->jobFinishedCond.notify_all();
+        scheduler->jobQueueCond.notify_all();
 
         SDEBUG("next");
     }
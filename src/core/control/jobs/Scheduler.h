@@ -17,11 +17,15 @@
 #include <atomic>              // for atomic
 #include <condition_variable>  // for condition_variable
 #include <deque>               // for deque
+#include <memory>              // for unique_ptr
 #include <mutex>               // for mutex
 #include <string>              // for string
+#include <vector>              // for vector
 
 #include <glib.h>  // for GThread, GTimeVal, gpointer
 
+#include "control/jobs/Job.h"  // for JobType
+
 class Job;
 
 /**
@@ -80,11 +84,22 @@ public:
      */
     void addJob(Job* job, JobPriority priority);
 
+    /**
+     * Sets the number of worker threads processing the jobs of priority JOB_PRIORITY_URGENT to JOB_PRIORITY_LOW.
+     * Jobs of priority JOB_PRIORITY_NONE are always processed by one additional, dedicated thread, so that e.g. saving
+     * does not delay the rendering (and conversely).
+     *
+     * @param n The number of render workers. 0 means it is chosen depending on the number of CPU cores.
+     * Must be called before start().
+     */
+    void setRenderWorkerCount(unsigned int n);
+
     void start();
     void stop();
 
     /**
-     * Locks the complete scheduler
+     * Locks the complete scheduler: waits for all the running jobs to finish and does not start any new job until
+     * unlock() is called
      */
     void lock();
 
@@ -94,7 +109,8 @@ public:
     void unlock();
 
     /**
-     * Don't render the next X ms so the scrolling performance is better
+     * Don't render the next X ms so the scrolling performance is better.
+     * Only the jobs of type JOB_TYPE_RENDER_DRAFT are still run in the meantime.
      */
     void blockRerenderZoom();
 
@@ -103,26 +119,68 @@ public:
      */
     void unblockRerenderZoom();
 
+    /**
+     * @return true if the rendering is currently blocked by blockRerenderZoom()
+     */
+    bool isRerenderZoomBlocked() const;
+
+protected:
+    /**
+     * Blocks until no worker is running a job of the given type for the given source.
+     * If source is nullptr, blocks until no job is running at all.
+     */
+    void awaitRunningJobs(void* source = nullptr, JobType type = JOB_TYPE_RENDER);
+
 private:
-    static auto jobThreadCallback(Scheduler* scheduler) -> gpointer;
-    auto getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr) -> Job*;
+    struct Worker {
+        Scheduler* scheduler;
+        /// Render workers process the jobs of priority URGENT to LOW. The other one processes the jobs of priority NONE
+        bool renderWorker;
+        GThread* thread = nullptr;
+
+        /// Description of the job being run, if any. Protected by jobQueueMutex
+        bool busy = false;
+        JobType runningType = JOB_TYPE_BLOCKING;
+        void* runningSource = nullptr;
+    };
+
+    static auto jobThreadCallback(Worker* worker) -> gpointer;
+
+    /**
+     * Pops the next Job to run among the queues of priority first to last.
+     * Jobs whose source is currently processed by another worker are skipped, so that the jobs on one given source
+     * (e.g. the RenderJob%s of a page, of any JobType) never run concurrently.
+     */
+    auto getNextJobUnlocked(JobPriority first = JOB_PRIORITY_URGENT, JobPriority last = JOB_PRIORITY_NONE,
+                            bool onlyNotRender = false, bool* hasRenderJobs = nullptr) -> Job*;
+
+    bool isSourceBusyUnlocked(Job* job) const;
+    bool isRunningUnlocked(void* source, JobType type) const;
 
     static auto jobRenderThreadTimer(Scheduler* scheduler) -> bool;
 
 protected:
+    /// Protected by jobQueueMutex
     bool threadRunning = true;
 
-    GThread* thread = nullptr;
+    /// The worker threads. The last one processes the jobs of priority JOB_PRIORITY_NONE
+    std::vector<std::unique_ptr<Worker>> workers;
+    unsigned int renderWorkerCount = 0;
 
     std::condition_variable jobQueueCond{};
     std::mutex jobQueueMutex{};
-    std::mutex schedulerMutex{};
 
     /**
+     * Notified whenever a job finishes or the scheduler is unlocked.
      * This is need to be sure there is no job running if we delete a page.
      * If a job is, we may access deleted memory.
      */
-    std::mutex jobRunningMutex{};
+    std::condition_variable jobFinishedCond{};
+
+    /**
+     * Set by lock(): no job is started while it is set. Protected by jobQueueMutex
+     */
+    bool paused = false;
 
     /**
      * Jobs of each priority. New jobs
@@ -0,0 +1,12 @@
+#include "SearchIndexJob.h"
+
+#include "control/SearchIndex.h"  // for SearchIndex
+
+SearchIndexJob::SearchIndexJob(SearchIndex* index, size_t pdfPageNo, uint64_t generation):
+        index(index), pdfPageNo(pdfPageNo), generation(generation) {}
+
+auto SearchIndexJob::getType() -> JobType { return JOB_TYPE_SEARCH_INDEX; }
+
+auto SearchIndexJob::getSource() -> void* { return this->index; }
+
+void SearchIndexJob::run() { this->index->indexPdfPage(this->pdfPageNo, this->generation); }
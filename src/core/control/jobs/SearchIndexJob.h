@@ -0,0 +1,42 @@
+/*
+ * Xournal++
+ *
+ * A job which extracts the text of a pdf page for the search
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+
+#include "Job.h"  // for Job, JobType
+
+class SearchIndex;
+
+/**
+ * @brief A Job which puts the text of a pdf page in the SearchIndex, so that searching does not wait for it
+ */
+class SearchIndexJob: public Job {
+public:
+    SearchIndexJob(SearchIndex* index, size_t pdfPageNo, uint64_t generation);
+
+protected:
+    ~SearchIndexJob() override = default;
+
+public:
+    JobType getType() override;
+
+    void* getSource() override;
+
+    void run() override;
+
+private:
+    SearchIndex* index;
+    size_t pdfPageNo;
+    uint64_t generation;
+};
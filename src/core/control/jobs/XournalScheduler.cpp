@@ -7,9 +7,12 @@
 
 #include "control/jobs/Scheduler.h"  // for JOB_PRIORITY_URGENT, JOB_PRIORIT...
 
-#include "PreviewJob.h"  // for PreviewJob
-#include "RenderJob.h"   // for RenderJob
+#include "PdfPrefetchJob.h"  // for PdfPrefetchJob
+#include "PreviewJob.h"      // for PreviewJob
+#include "RenderJob.h"       // for RenderJob
+#include "SearchIndexJob.h"  // for SearchIndexJob
 
+class PdfCache;
 class SidebarPreviewBaseEntry;
 class XojPageView;
 
@@ -24,7 +27,18 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
     removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH, waitForTaskCompletion);
 }
 
-void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
+void XournalScheduler::removePage(XojPageView* view) {
+    removeSource(view, JOB_TYPE_RENDER_DRAFT, JOB_PRIORITY_URGENT);
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT);
+}
+
+void XournalScheduler::removePdfCache(PdfCache* cache, bool awaitFinishTask) {
+    removeSource(cache, JOB_TYPE_RENDER, JOB_PRIORITY_LOW, awaitFinishTask);
+}
+
+void XournalScheduler::removeSearchIndex(SearchIndex* index, bool awaitFinishTask) {
+    removeSource(index, JOB_TYPE_SEARCH_INDEX, JOB_PRIORITY_NONE, awaitFinishTask);
+}
 
 void XournalScheduler::removeAllJobs() {
     std::lock_guard lock{this->jobQueueMutex};
@@ -39,7 +53,7 @@ void XournalScheduler::removeAllJobs() {
             // Only remove PREVIEW and RENDER jobs; we aren't
             // responsible for other types of jobs.
             JobType type = job->getType();
-            if (type == JOB_TYPE_PREVIEW || type == JOB_TYPE_RENDER) {
+            if (type == JOB_TYPE_PREVIEW || type == JOB_TYPE_RENDER || type == JOB_TYPE_RENDER_DRAFT) {
                 job->deleteJob();
 
                 it = queue.erase(it);
@@ -53,7 +67,7 @@ void XournalScheduler::removeAllJobs() {
     }
 }
 
-void XournalScheduler::finishTask() { std::lock_guard lock{this->jobRunningMutex}; }
+void XournalScheduler::finishTask() { awaitRunningJobs(); }
 
 void XournalScheduler::removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask) {
     {
@@ -77,10 +91,10 @@ void XournalScheduler::removeSource(void* source, JobType type, JobPriority prio
         }
     }
 
-    // wait until the last job is done
+    // wait until the running job on this source (if any) is done
     // we can be sure we don't access "source"
     if (awaitFinishTask) {
-        finishTask();
+        awaitRunningJobs(source, type);
     }
 }
 
@@ -117,3 +131,26 @@ void XournalScheduler::addRerenderPage(XojPageView* view) {
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
 }
+
+void XournalScheduler::addDraftRenderPage(XojPageView* view) {
+    if (existsSource(view, JOB_TYPE_RENDER_DRAFT, JOB_PRIORITY_URGENT)) {
+        return;
+    }
+
+    auto* job = new RenderJob(view, /* draft */ true);
+    addJob(job, JOB_PRIORITY_URGENT);
+    job->unref();
+}
+
+void XournalScheduler::addPdfPrefetch(PdfCache* cache, size_t pdfPageNo, double zoom) {
+    auto* job = new PdfPrefetchJob(cache, pdfPageNo, zoom);
+    addJob(job, JOB_PRIORITY_LOW);
+    job->unref();
+}
+
+void XournalScheduler::addSearchIndex(SearchIndex* index, size_t pdfPageNo, uint64_t generation,
+                                      JobPriority priority) {
+    auto* job = new SearchIndexJob(index, pdfPageNo, generation);
+    addJob(job, priority);
+    job->unref();
+}
@@ -13,10 +13,15 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+
 #include "control/jobs/Job.h"  // for JobType
 
 #include "Scheduler.h"  // for JobPriority, Scheduler
 
+class PdfCache;
+class SearchIndex;
 class SidebarPreviewBaseEntry;
 class XojPageView;
 
@@ -32,6 +37,8 @@ public:
      */
     void removeSidebar(SidebarPreviewBaseEntry* preview);
     void removePage(XojPageView* view);
+    void removePdfCache(PdfCache* cache, bool awaitFinishTask = true);
+    void removeSearchIndex(SearchIndex* index, bool awaitFinishTask = true);
 
     /**
      * Removes all PreviewJob%s / RenderJob%s scheduled to be run
@@ -41,6 +48,25 @@ public:
     void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
     void addRerenderPage(XojPageView* view);
 
+    /**
+     * Quickly renders the missing parts of the page in low quality, even while the rendering is blocked by
+     * blockRerenderZoom(). Use addRerenderPage() to get the final rendering.
+     */
+    void addDraftRenderPage(XojPageView* view);
+
+    /**
+     * Rasterizes a pdf page into the cache in the background, so that it is ready when the page is shown
+     * @param zoom The zoom level (including the DPI scaling) the page will be shown at
+     */
+    void addPdfPrefetch(PdfCache* cache, size_t pdfPageNo, double zoom);
+
+    /**
+     * Extracts the text of a pdf page into the search index in the background
+     * @param generation See SearchIndex::indexPdfPage()
+     */
+    void addSearchIndex(SearchIndex* index, size_t pdfPageNo, uint64_t generation,
+                        JobPriority priority = JOB_PRIORITY_NONE);
+
     /**
      * Blocks until all currently running Job%s have been executed
      */
@@ -1,11 +1,12 @@
 #include "Settings.h"
 
-#include <algorithm>    // for max
+#include <algorithm>    // for max, min, clamp
 #include <cstdint>      // for uint32_t, int32_t
 #include <cstdio>       // for sscanf, size_t
 #include <cstdlib>      // for atoi
 #include <cstring>      // for strcmp
 #include <exception>    // for exception
+#include <thread>       // for thread
 #include <type_traits>  // for add_const<>::type
 #include <utility>      // for pair, move, make_...
 
@@ -21,16 +22,16 @@
 #include "gui/toolbarMenubar/model/ColorPalette.h"  // for Palette
 #include "model/FormatDefinitions.h"                // for FormatUnits, XOJ_...
 #include "util/Color.h"
-#include "util/PathUtil.h"  // for getConfigFile
-#include "util/Util.h"      // for PRECISION_FORMAT_...
-#include "util/i18n.h"      // for _
-#include "util/safe_casts.h"  // for as_unsigned
-#include "util/utf8_view.h"   // for utf8_view
+#include "util/PathUtil.h"                          // for getConfigFile
+#include "util/Util.h"                              // for PRECISION_FORMAT_...
+#include "util/i18n.h"                              // for _
+#include "util/safe_casts.h"                        // for as_unsigned
+#include "util/utf8_view.h"                         // for utf8_view
 
 #include "ButtonConfig.h"  // for ButtonConfig
 #include "config-dev.h"    // for PALETTE_FILE
 #include "config-dev.h"
-#include "filesystem.h"  // for path, exists
+#include "filesystem.h"    // for path, exists
 
 
 using std::string;
@@ -127,6 +128,19 @@ void Settings::loadDefault() {
     this->autosaveTimeout = 3;
     this->autosaveEnabled = true;
 
+    // As many threads as cores, with the default zlib compression level
+    this->saveCompressionThreads = 0U;
+    this->saveCompressionLevel = -1;
+
+    this->lazyPageLoading = true;
+    this->loadParsingThreads = 0U;
+    this->saveChunked = false;
+
+    this->undoMemoryBudget = 1024U;
+    this->undoSpillToDisk = true;
+    this->eraserSweep = true;
+    this->imageCacheMemoryBudget = 256U;
+
     this->addHorizontalSpace = false;
     this->addHorizontalSpaceAmountRight = 150;
     this->addHorizontalSpaceAmountLeft = 150;
@@ -194,10 +208,11 @@ void Settings::loadDefault() {
     this->touchZoomStartThreshold = 0.0;
 
     this->pageRerenderThreshold = 5.0;
-    this->pdfPageCacheSize = 10;
+    this->pdfPageCacheMemory = 256U;
     this->preloadPagesBefore = 3U;
     this->preloadPagesAfter = 5U;
     this->eagerPageCleanup = true;
+    this->renderThreadCount = 0U;
 
     this->selectionBorderColor = Colors::red;
     this->selectionMarkerColor = Colors::xopp_cornflowerblue;
@@ -526,6 +541,25 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->autosaveEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autosaveTimeout")) == 0) {
         this->autosaveTimeout = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveCompressionThreads")) == 0) {
+        this->saveCompressionThreads = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveCompressionLevel")) == 0) {
+        this->saveCompressionLevel = std::clamp(
+                static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10)), -1, 9);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("lazyPageLoading")) == 0) {
+        this->lazyPageLoading = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("loadParsingThreads")) == 0) {
+        this->loadParsingThreads = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveChunked")) == 0) {
+        this->saveChunked = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("undoMemoryBudget")) == 0) {
+        this->undoMemoryBudget = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("undoSpillToDisk")) == 0) {
+        this->undoSpillToDisk = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eraserSweep")) == 0) {
+        this->eraserSweep = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("imageCacheMemoryBudget")) == 0) {
+        this->imageCacheMemoryBudget = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("defaultViewModeAttributes")) == 0) {
         this->viewModes.at(PresetViewModeIds::VIEW_MODE_DEFAULT) =
                 settingsStringToViewMode(reinterpret_cast<const char*>(value));
@@ -539,14 +573,16 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->touchZoomStartThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pageRerenderThreshold")) == 0) {
         this->pageRerenderThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheSize")) == 0) {
-        this->pdfPageCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheMemory")) == 0) {
+        this->pdfPageCacheMemory = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesBefore")) == 0) {
         this->preloadPagesBefore = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesAfter")) == 0) {
         this->preloadPagesAfter = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eagerPageCleanup")) == 0) {
         this->eagerPageCleanup = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("renderThreadCount")) == 0) {
+        this->renderThreadCount = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionBorderColor")) == 0) {
         this->selectionBorderColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionMarkerColor")) == 0) {
@@ -1112,6 +1148,25 @@ void Settings::save() {
     SAVE_BOOL_PROP(autosaveEnabled);
     SAVE_INT_PROP(autosaveTimeout);
 
+    SAVE_UINT_PROP(saveCompressionThreads);
+    ATTACH_COMMENT("The number of threads compressing saved files, 0 to use as many as the CPU cores.");
+    SAVE_INT_PROP(saveCompressionLevel);
+    ATTACH_COMMENT("The gzip compression level of saved files, from 0 (none) to 9 (best), -1 for the default.");
+    SAVE_BOOL_PROP(lazyPageLoading);
+    ATTACH_COMMENT("Only parse the contents of the pages of opened files when they are needed.");
+    SAVE_UINT_PROP(loadParsingThreads);
+    ATTACH_COMMENT("The number of threads parsing the pages of opened files, 0 to use as many as the CPU cores.");
+    SAVE_BOOL_PROP(saveChunked);
+    ATTACH_COMMENT("Save documents as zip archives with one entry per page. Older versions cannot open them.");
+    SAVE_UINT_PROP(undoMemoryBudget);
+    ATTACH_COMMENT("The memory used by the undo history, in MiB, 0 for no limit.");
+    SAVE_BOOL_PROP(undoSpillToDisk);
+    ATTACH_COMMENT("Move the oldest undo steps to a temporary file when the budget is exceeded, instead of dropping.");
+    SAVE_UINT_PROP(imageCacheMemoryBudget);
+    ATTACH_COMMENT("The memory used by the decoded images, in MiB. The least recently drawn ones are decoded again.");
+    SAVE_BOOL_PROP(eraserSweep);
+    ATTACH_COMMENT("Erase along the path of the eraser between the motion events, processed once per frame.");
+
     SAVE_BOOL_PROP(addHorizontalSpace);
     SAVE_INT_PROP(addHorizontalSpaceAmountRight);
     SAVE_INT_PROP(addHorizontalSpaceAmountLeft);
@@ -1150,11 +1205,13 @@ void Settings::save() {
     SAVE_DOUBLE_PROP(touchZoomStartThreshold);
     SAVE_DOUBLE_PROP(pageRerenderThreshold);
 
-    SAVE_INT_PROP(pdfPageCacheSize);
-    ATTACH_COMMENT("The count of rendered PDF pages which will be cached.");
+    SAVE_UINT_PROP(pdfPageCacheMemory);
+    ATTACH_COMMENT("The memory (in MB) the cached renderings of PDF pages may use.");
     SAVE_UINT_PROP(preloadPagesBefore);
     SAVE_UINT_PROP(preloadPagesAfter);
     SAVE_BOOL_PROP(eagerPageCleanup);
+    SAVE_UINT_PROP(renderThreadCount);
+    ATTACH_COMMENT("The number of threads rendering pages and previews. 0 means automatic.");
 
     const auto pageTemplate = pageTemplateSettings.toString();
     SAVE_STRING_PROP(pageTemplate);
@@ -1402,6 +1459,110 @@ void Settings::setAutosaveTimeout(int autosave) {
     save();
 }
 
+auto Settings::getSaveCompressionThreads() const -> unsigned int {
+    if (this->saveCompressionThreads == 0) {
+        return std::max(1U, std::thread::hardware_concurrency());
+    }
+    return this->saveCompressionThreads;
+}
+
+auto Settings::getAutosaveCompressionThreads() const -> unsigned int {
+    return std::min(getSaveCompressionThreads(), MAX_AUTOSAVE_COMPRESSION_THREADS);
+}
+
+void Settings::setSaveCompressionThreads(unsigned int threads) {
+    if (this->saveCompressionThreads == threads) {
+        return;
+    }
+    this->saveCompressionThreads = threads;
+    save();
+}
+
+auto Settings::getSaveCompressionLevel() const -> int { return this->saveCompressionLevel; }
+
+void Settings::setSaveCompressionLevel(int level) {
+    if (this->saveCompressionLevel == level) {
+        return;
+    }
+    this->saveCompressionLevel = level;
+    save();
+}
+
+auto Settings::isLazyPageLoading() const -> bool { return this->lazyPageLoading; }
+
+void Settings::setLazyPageLoading(bool lazy) {
+    if (this->lazyPageLoading == lazy) {
+        return;
+    }
+    this->lazyPageLoading = lazy;
+    save();
+}
+
+auto Settings::getLoadParsingThreads() const -> unsigned int {
+    if (this->loadParsingThreads == 0) {
+        return std::max(1U, std::thread::hardware_concurrency());
+    }
+    return this->loadParsingThreads;
+}
+
+void Settings::setLoadParsingThreads(unsigned int threads) {
+    if (this->loadParsingThreads == threads) {
+        return;
+    }
+    this->loadParsingThreads = threads;
+    save();
+}
+
+auto Settings::isSaveChunked() const -> bool { return this->saveChunked; }
+
+void Settings::setSaveChunked(bool chunked) {
+    if (this->saveChunked == chunked) {
+        return;
+    }
+    this->saveChunked = chunked;
+    save();
+}
+
+auto Settings::getUndoMemoryBudget() const -> unsigned int { return this->undoMemoryBudget; }
+
+void Settings::setUndoMemoryBudget(unsigned int budget) {
+    if (this->undoMemoryBudget == budget) {
+        return;
+    }
+    this->undoMemoryBudget = budget;
+    save();
+}
+
+auto Settings::isUndoSpillToDisk() const -> bool { return this->undoSpillToDisk; }
+
+void Settings::setUndoSpillToDisk(bool spill) {
+    if (this->undoSpillToDisk == spill) {
+        return;
+    }
+    this->undoSpillToDisk = spill;
+    save();
+}
+
+auto Settings::isEraserSweep() const -> bool { return this->eraserSweep; }
+
+void Settings::setEraserSweep(bool sweep) {
+    if (this->eraserSweep == sweep) {
+        return;
+    }
+    this->eraserSweep = sweep;
+    save();
+}
+
+auto Settings::getImageCacheMemoryBudget() const -> unsigned int { return this->imageCacheMemoryBudget; }
+
+void Settings::setImageCacheMemoryBudget(unsigned int budget) {
+    if (this->imageCacheMemoryBudget == budget) {
+        return;
+    }
+    this->imageCacheMemoryBudget = budget;
+    save();
+}
+
 auto Settings::isAutosaveEnabled() const -> bool { return this->autosaveEnabled; }
 
 void Settings::setAutosaveEnabled(bool autosave) {
@@ -2142,13 +2303,13 @@ void Settings::setPDFPageRerenderThreshold(double threshold) {
     save();
 }
 
-auto Settings::getPdfPageCacheSize() const -> int { return this->pdfPageCacheSize; }
+auto Settings::getPdfPageCacheMemory() const -> unsigned int { return this->pdfPageCacheMemory; }
 
-void Settings::setPdfPageCacheSize(int size) {
-    if (this->pdfPageCacheSize == size) {
+void Settings::setPdfPageCacheMemory(unsigned int megabytes) {
+    if (this->pdfPageCacheMemory == megabytes) {
         return;
     }
-    this->pdfPageCacheSize = size;
+    this->pdfPageCacheMemory = megabytes;
     save();
 }
 
@@ -2182,6 +2343,16 @@ void Settings::setEagerPageCleanup(bool b) {
     save();
 }
 
+auto Settings::getRenderThreadCount() const -> unsigned int { return this->renderThreadCount; }
+
+void Settings::setRenderThreadCount(unsigned int n) {
+    if (this->renderThreadCount == n) {
+        return;
+    }
+    this->renderThreadCount = n;
+    save();
+}
+
 auto Settings::getBorderColor() const -> Color { return this->selectionBorderColor; }
 
 void Settings::setBorderColor(Color color) {
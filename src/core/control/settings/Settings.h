@@ -291,6 +291,70 @@ public:
     bool isAutosaveEnabled() const;
     void setAutosaveEnabled(bool autosave);
 
+    /**
+     * @return The number of threads compressing saved files: the setting, or the number of CPU cores if it is 0
+     */
+    unsigned int getSaveCompressionThreads() const;
+    /**
+     * @return The number of threads compressing autosaved files: at most MAX_AUTOSAVE_COMPRESSION_THREADS, so that
+     * the autosaves, which the user did not ask for, do not take over all the CPU cores
+     */
+    unsigned int getAutosaveCompressionThreads() const;
+    static constexpr unsigned int MAX_AUTOSAVE_COMPRESSION_THREADS = 2;
+    /// @param threads The number of threads compressing saved files, 0 for as many as the CPU cores
+    void setSaveCompressionThreads(unsigned int threads);
+    /**
+     * @return The gzip compression level of saved files, from 0 to 9, or -1 for the default level
+     */
+    int getSaveCompressionLevel() const;
+    void setSaveCompressionLevel(int level);
+
+    /**
+     * @return Whether the layers of the pages of opened files are only parsed when they are needed
+     */
+    bool isLazyPageLoading() const;
+    void setLazyPageLoading(bool lazy);
+
+    /**
+     * @return The number of threads parsing the pages of opened files (if they are not loaded lazily): the setting, or
+     * the number of CPU cores if it is 0
+     */
+    unsigned int getLoadParsingThreads() const;
+    /// @param threads The number of threads parsing the pages of opened files, 0 for as many as the CPU cores
+    void setLoadParsingThreads(unsigned int threads);
+
+    /**
+     * @return Whether documents are saved as chunked zip archives, with each page in its own entry
+     */
+    bool isSaveChunked() const;
+    void setSaveChunked(bool chunked);
+
+    /**
+     * @return The memory the undo history may use, in MiB, 0 for no limit
+     */
+    unsigned int getUndoMemoryBudget() const;
+    void setUndoMemoryBudget(unsigned int budget);
+
+    /**
+     * @return Whether the oldest undo steps are moved to a temporary file when the budget is exceeded (instead of
+     * being dropped)
+     */
+    bool isUndoSpillToDisk() const;
+    void setUndoSpillToDisk(bool spill);
+
+    /**
+     * @return The memory the decoded images may use, in MiB
+     */
+    unsigned int getImageCacheMemoryBudget() const;
+    void setImageCacheMemoryBudget(unsigned int budget);
+
+    /**
+     * @return Whether the eraser erases along its path between the motion events, which are then processed once per
+     * frame
+     */
+    bool isEraserSweep() const;
+    void setEraserSweep(bool sweep);
+
     bool getAddVerticalSpace() const;
     void setAddVerticalSpace(bool space);
     int getAddVerticalSpaceAmountAbove() const;
@@ -408,8 +472,11 @@ public:
     double getTouchZoomStartThreshold() const;
     void setTouchZoomStartThreshold(double threshold);
 
-    int getPdfPageCacheSize() const;
-    [[maybe_unused]] void setPdfPageCacheSize(int size);
+    /**
+     * @return The memory budget of the cache of rendered PDF pages, in MB
+     */
+    unsigned int getPdfPageCacheMemory() const;
+    void setPdfPageCacheMemory(unsigned int megabytes);
 
     unsigned int getPreloadPagesBefore() const;
     void setPreloadPagesBefore(unsigned int n);
@@ -420,6 +487,13 @@ public:
     bool isEagerPageCleanup() const;
     void setEagerPageCleanup(bool b);
 
+    /**
+     * The number of threads rendering pages and previews. 0 means automatic (depending on the number of CPU cores).
+     * Only applied on startup.
+     */
+    unsigned int getRenderThreadCount() const;
+    void setRenderThreadCount(unsigned int n);
+
     PageTemplateSettings const& getPageTemplateSettings() const;
     void setPageTemplateSettings(const PageTemplateSettings& pageTemplateSettings);
 
@@ -911,6 +985,52 @@ private:
      */
     int autosaveTimeout{};
 
+    /**
+     * The number of threads compressing saved files, 0 for as many as the CPU cores
+     */
+    unsigned int saveCompressionThreads{};
+
+    /**
+     * The gzip compression level of saved files, from 0 to 9, or -1 for the default level
+     */
+    int saveCompressionLevel{};
+
+    /**
+     * Only parse the layers of the pages of opened files when they are needed. Until then, the text of their layers is
+     * kept compressed in memory.
+     */
+    bool lazyPageLoading{};
+
+    /**
+     * The number of threads parsing the pages of opened files, 0 for as many as the CPU cores
+     */
+    unsigned int loadParsingThreads{};
+
+    /**
+     * Save documents as chunked zip archives, with each page in its own entry
+     */
+    bool saveChunked{};
+
+    /**
+     * The memory the undo history may use, in MiB, 0 for no limit
+     */
+    unsigned int undoMemoryBudget{};
+
+    /**
+     * Move the oldest undo steps to a temporary file when the budget is exceeded
+     */
+    bool undoSpillToDisk{};
+
+    /**
+     * The memory the decoded images may use, in MiB
+     */
+    unsigned int imageCacheMemoryBudget{};
+
+    /**
+     * Erase along the path of the eraser between the motion events
+     */
+    bool eraserSweep{};
+
     /**
      *  Enable automatic save
      */
@@ -990,9 +1110,9 @@ private:
     std::vector<ViewMode> viewModes;
 
     /**
-     *  The count of pages which will be cached
+     *  The memory (in MB) the cached renderings of PDF pages may use
      */
-    int pdfPageCacheSize{};
+    unsigned int pdfPageCacheMemory{};
 
     /**
      *  Percentage by which the page's zoom must change
@@ -1180,6 +1300,11 @@ private:
      */
     bool eagerPageCleanup{};
 
+    /**
+     * The number of threads rendering pages and previews (0 = automatic)
+     */
+    unsigned int renderThreadCount{};
+
     /**
      * Stabilizer related settings
      */
@@ -344,11 +344,13 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke, double strokeMinSize) ->
     Inertia ss[4];
     int brk[5] = {0};
 
+    // The recognizer works on an array of points
+    const std::vector<Point> points = stroke->getPointVector().toVector();
+
     // first see if it's a polygon
-    int n = findPolygonal(stroke->getPoints(), 0, static_cast<int>(stroke->getPointCount()) - 1, MAX_POLYGON_SIDES, brk,
-                          ss);
+    int n = findPolygonal(points.data(), 0, static_cast<int>(points.size()) - 1, MAX_POLYGON_SIDES, brk, ss);
     if (n > 0) {
-        optimizePolygonal(stroke->getPoints(), n, brk, ss);
+        optimizePolygonal(points.data(), n, brk, ss);
 #ifdef DEBUG_RECOGNIZER
         g_message("--");
         g_message("ShapeReco:: Polygon, %d edges:", n);
@@ -376,7 +378,7 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke, double strokeMinSize) ->
         for (int i = 0; i < n; i++) {
             rs[i].startpt = brk[i];
             rs[i].endpt = brk[i + 1];
-            rs[i].calcSegmentGeometry(stroke->getPoints(), brk[i], brk[i + 1], ss + i);
+            rs[i].calcSegmentGeometry(points.data(), brk[i], brk[i + 1], ss + i);
         }
 
         if (auto result = tryTriangle(); result != nullptr) {
@@ -414,7 +416,6 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke, double strokeMinSize) ->
                 const Point P(rs->x1, rs->y1);
                 const Point Q(rs->x2, rs->y2);
 
-                const auto& points = stroke->getPointVector();
                 const Point& last = points.back();
 
                 const double dx = Q.x - P.x;
@@ -1,8 +1,10 @@
 #include "EraseHandler.h"
 
-#include <memory>   // for make_unique, unique_ptr
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>  // for max
+#include <cmath>      // for hypot
+#include <memory>     // for make_unique, unique_ptr
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include <gdk/gdk.h>  // for GdkRectangle
 #include <glib.h>     // for gint
@@ -22,6 +24,8 @@
 #include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
 #include "util/Range.h"                   // for Range
 #include "util/SmallVector.h"             // for SmallVector
+#include "util/glib_casts.h"              // for wrap_for_once_v
+#include "util/safe_casts.h"              // for ceil_cast
 
 EraseHandler::EraseHandler(UndoRedoHandler* undo, Document* doc, const PageRef& page, ToolHandler* handler,
                            LegacyRedrawable* view):
@@ -35,6 +39,10 @@ EraseHandler::EraseHandler(UndoRedoHandler* undo, Document* doc, const PageRef&
         halfEraserSize(0) {}
 
 EraseHandler::~EraseHandler() {
+    if (this->flushSourceId) {
+        g_source_remove(this->flushSourceId);
+        this->pendingPositions.clear();
+    }
     if (this->eraseDeleteUndoAction) {
         this->finalize();
     }
@@ -45,16 +53,116 @@ EraseHandler::~EraseHandler() {
  */
 void EraseHandler::erase(double x, double y) {
     this->halfEraserSize = this->handler->getThickness();
-    xoj::util::Rectangle<double> eraserRect(x - halfEraserSize, y - halfEraserSize, 2 * halfEraserSize,
-                                            2 * halfEraserSize);
+    eraseAt({{x, y}}, {{x, y}});
+    this->lastPosition = xoj::util::Point<double>(x, y);
+}
 
-    Range rerenderRange;
+void EraseHandler::sweepTo(double x, double y) {
+    this->pendingPositions.emplace_back(x, y);
+    if (!this->flushSourceId) {
+        // Runs after the pending input events, but before the redraw
+        this->flushSourceId =
+                g_idle_add_full(G_PRIORITY_HIGH_IDLE, xoj::util::wrap_for_once_v<flushCallback>, this, nullptr);
+    }
+}
+
+void EraseHandler::flushCallback(EraseHandler* self) {
+    self->flushSourceId = 0;
+    self->flush();
+}
+
+void EraseHandler::flush() {
+    if (this->flushSourceId) {
+        g_source_remove(this->flushSourceId);
+        this->flushSourceId = 0;
+    }
+    if (this->pendingPositions.empty()) {
+        return;
+    }
+
+    this->halfEraserSize = this->handler->getThickness();
+    auto from = this->lastPosition.value_or(this->pendingPositions.front());
+    auto positions = getSweptPositions(from, this->pendingPositions, this->halfEraserSize);
+    if (!this->lastPosition) {
+        positions.insert(positions.begin(), from);
+    }
+    std::vector<xoj::util::Point<double>> path;
+    path.reserve(this->pendingPositions.size() + 1);
+    path.push_back(from);
+    path.insert(path.end(), this->pendingPositions.begin(), this->pendingPositions.end());
+    this->lastPosition = this->pendingPositions.back();
+    this->pendingPositions.clear();
+
+    eraseAt(path, positions);
+}
+
+auto EraseHandler::getSweptPositions(xoj::util::Point<double> from, const std::vector<xoj::util::Point<double>>& path,
+                                     double step) -> std::vector<xoj::util::Point<double>> {
+    // Squares of half size `step` whose centers are at most `step` apart overlap: they cover the swept area, up to
+    // small notches on its border
+    constexpr double MIN_STEP = 0.1;
+    step = std::max(step, MIN_STEP);
+
+    std::vector<xoj::util::Point<double>> positions;
+    for (const auto& to: path) {
+        const double length = std::hypot(to.x - from.x, to.y - from.y);
+        if (length == 0) {
+            continue;
+        }
+        const auto n = ceil_cast<size_t>(length / step);
+        for (size_t k = 1; k <= n; k++) {
+            const double t = static_cast<double>(k) / static_cast<double>(n);
+            positions.emplace_back(from.x + t * (to.x - from.x), from.y + t * (to.y - from.y));
+        }
+        from = to;
+    }
+    return positions;
+}
+
+void EraseHandler::eraseAt(const std::vector<xoj::util::Point<double>>& path,
+                           const std::vector<xoj::util::Point<double>>& positions) {
+    const double h = this->halfEraserSize;
+    Range sweptRange;
+    for (const auto& p: positions) {
+        sweptRange.addPoint(p.x - h, p.y - h);
+        sweptRange.addPoint(p.x + h, p.y + h);
+    }
+    if (sweptRange.empty()) {
+        return;
+    }
 
     Layer* l = page->getSelectedLayer();
 
-    for (Element* e: xoj::refElementContainer(l->getElements())) {
-        if (e->getType() == ELEMENT_STROKE && e->getBoundingBox().intersects(eraserRect)) {
-            eraseStroke(l, dynamic_cast<Stroke*>(e), x, y, rerenderRange);
+    // Look the strokes up once for all the positions. They are erased afterwards, as erasing modifies the layer.
+    std::vector<Stroke*> strokes;
+    l->forEachElementIntersecting(sweptRange, [&](Element* e, Element::Index) {
+        if (e->getType() == ELEMENT_STROKE) {
+            strokes.push_back(dynamic_cast<Stroke*>(e));
+        }
+    });
+
+    const bool deleteStrokes = this->handler->getEraserType() == ERASER_TYPE_DELETE_STROKE;
+    Range rerenderRange;
+    for (Stroke* s: strokes) {
+        const bool erasing = s->getErasable() != nullptr;
+        // Each stroke is tested once against the whole path
+        const double padding =
+                deleteStrokes && !erasing ? 0 : PADDING_COEFFICIENT_CAP[s->getStrokeCapStyle()] * s->getWidth();
+        if (!s->intersectsSweptPath(path, h + padding)) {
+            continue;
+        }
+        if (deleteStrokes && !erasing) {
+            deleteStroke(l, s, rerenderRange);
+            continue;
+        }
+        // The default eraser cuts the stroke with the squares which touch it
+        const auto& box = s->getBoundingBox();
+        for (const auto& p: positions) {
+            xoj::util::Rectangle<double> eraserRect(p.x - h - padding, p.y - h - padding, 2 * (h + padding),
+                                                    2 * (h + padding));
+            if (box.intersects(eraserRect) && eraseStroke(l, s, p.x, p.y, rerenderRange)) {
+                break;
+            }
         }
     }
 
@@ -63,64 +171,58 @@ void EraseHandler::erase(double x, double y) {
     }
 }
 
-void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& range) {
-    ErasableStroke* erasable = s->getErasable();
-    if (!erasable) {
-        if (this->handler->getEraserType() == ERASER_TYPE_DELETE_STROKE) {
-            if (!s->intersects(x, y, halfEraserSize)) {
-                // The stroke does not intersect the eraser square
-                return;
-            }
-
-            // delete the entire stroke
-            this->doc->lock();
-            auto [stroke, pos] = l->removeElement(s);
-            this->doc->unlock();
+void EraseHandler::deleteStroke(Layer* l, Stroke* s, Range& range) {
+    this->doc->lock();
+    auto [stroke, pos] = l->removeElement(s);
+    this->doc->unlock();
 
-            if (pos == -1) {
-                return;
-            }
-            range = range.unite(Range(s->getBoundingBox()));
-
-            // removed the if statement - this prevents us from putting multiple elements into a
-            // stroke erase operation, but it also prevents the crashing and layer issues!
-            if (!this->eraseDeleteUndoAction) {
-                auto eraseDel = std::make_unique<DeleteUndoAction>(this->page, true);
-                // Todo check dangerous: this->eraseDeleteUndoAction could be a dangling reference
-                this->eraseDeleteUndoAction = eraseDel.get();
-                this->undo->addUndoAction(std::move(eraseDel));
-            }
+    if (pos == -1) {
+        return;
+    }
+    range = range.unite(Range(s->getBoundingBox()));
+
+    // removed the if statement - this prevents us from putting multiple elements into a
+    // stroke erase operation, but it also prevents the crashing and layer issues!
+    if (!this->eraseDeleteUndoAction) {
+        auto eraseDel = std::make_unique<DeleteUndoAction>(this->page, true);
+        // Todo check dangerous: this->eraseDeleteUndoAction could be a dangling reference
+        this->eraseDeleteUndoAction = eraseDel.get();
+        this->undo->addUndoAction(std::move(eraseDel));
+    }
 
-            this->eraseDeleteUndoAction->addElement(l, std::move(stroke), pos);
-        } else {  // Default eraser
-            auto pos = l->indexOf(s);
-            if (pos == -1) {
-                return;
-            }
+    this->eraseDeleteUndoAction->addElement(l, std::move(stroke), pos);
+}
 
-            const double paddingCoeff = PADDING_COEFFICIENT_CAP[s->getStrokeCapStyle()];
-            const PaddedBox paddedEraserBox{{x, y}, halfEraserSize, halfEraserSize + paddingCoeff * s->getWidth()};
-            auto intersectionParameters = s->intersectWithPaddedBox(paddedEraserBox);
+auto EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& range) -> bool {
+    ErasableStroke* erasable = s->getErasable();
+    if (!erasable) {
+        auto pos = l->indexOf(s);
+        if (pos == -1) {
+            return true;
+        }
 
-            if (intersectionParameters.empty()) {
-                // The stroke does not intersect the eraser square
-                return;
-            }
+        const double paddingCoeff = PADDING_COEFFICIENT_CAP[s->getStrokeCapStyle()];
+        const PaddedBox paddedEraserBox{{x, y}, halfEraserSize, halfEraserSize + paddingCoeff * s->getWidth()};
+        auto intersectionParameters = s->intersectWithPaddedBox(paddedEraserBox);
 
-            if (this->eraseUndoAction == nullptr) {
-                auto eraseUndo = std::make_unique<EraseUndoAction>(this->page);
-                // Todo check dangerous: this->eraseDeleteUndoAction could be a dangling reference
-                this->eraseUndoAction = eraseUndo.get();
-                this->undo->addUndoAction(std::move(eraseUndo));
-            }
+        if (intersectionParameters.empty()) {
+            // The stroke does not intersect the eraser square
+            return false;
+        }
 
-            doc->lock();
-            erasable = new ErasableStroke(*s);
-            s->setErasable(erasable);
-            doc->unlock();
-            this->eraseUndoAction->addOriginal(l, s, pos);
-            erasable->beginErasure(intersectionParameters, range);
+        if (this->eraseUndoAction == nullptr) {
+            auto eraseUndo = std::make_unique<EraseUndoAction>(this->page);
+            // Todo check dangerous: this->eraseDeleteUndoAction could be a dangling reference
+            this->eraseUndoAction = eraseUndo.get();
+            this->undo->addUndoAction(std::move(eraseUndo));
         }
+
+        doc->lock();
+        erasable = new ErasableStroke(*s);
+        s->setErasable(erasable);
+        doc->unlock();
+        this->eraseUndoAction->addOriginal(l, s, pos);
+        erasable->beginErasure(intersectionParameters, range);
     } else {
         /**
          * This stroke has already been touched by the eraser
@@ -128,15 +230,18 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& r
          */
         auto pos = l->indexOf(s);
         if (pos == -1) {
-            return;
+            return true;
         }
         const double paddingCoeff = PADDING_COEFFICIENT_CAP[s->getStrokeCapStyle()];
         const PaddedBox paddedEraserBox{{x, y}, halfEraserSize, halfEraserSize + paddingCoeff * s->getWidth()};
         erasable->erase(paddedEraserBox, range);
     }
+    return false;
 }
 
 void EraseHandler::finalize() {
+    this->lastPosition.reset();
+
     if (this->eraseUndoAction) {
         this->eraseUndoAction->finalize();
         this->eraseUndoAction = nullptr;
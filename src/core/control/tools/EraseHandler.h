@@ -11,7 +11,13 @@
 
 #pragma once
 
+#include <optional>  // for optional
+#include <vector>    // for vector
+
+#include <glib.h>  // for guint
+
 #include "model/PageRef.h"  // for PageRef
+#include "util/Point.h"     // for Point
 
 class DeleteUndoAction;
 class Document;
@@ -30,11 +36,55 @@ public:
     virtual ~EraseHandler();
 
 public:
+    /**
+     * Erase at the given position, right away
+     */
     void erase(double x, double y);
+
+    /**
+     * Erase along the path from the previous position to (x, y). The positions are queued and processed together
+     * before the next frame is drawn: the strokes crossed between two sparse events are erased too, and the strokes
+     * near dense events are only looked up once.
+     */
+    void sweepTo(double x, double y);
+
+    /**
+     * Erase along the positions queued by sweepTo() right away. Must not be called with the document locked.
+     */
+    void flush();
+
+    /**
+     * Complete the undo actions and end the path of the eraser. The queued positions must have been flushed.
+     */
     void finalize();
 
+    /**
+     * @return The positions of the eraser square along the path from `from` through `path`, spaced by at most `step`
+     * so that the squares cover the swept area (`from` itself is not included)
+     */
+    static std::vector<xoj::util::Point<double>> getSweptPositions(xoj::util::Point<double> from,
+                                                                   const std::vector<xoj::util::Point<double>>& path,
+                                                                   double step);
+
 private:
-    void eraseStroke(Layer* l, Stroke* s, double x, double y, Range& range);
+    /**
+     * Erase along the path of the eraser. Each stroke is tested once against the whole path: the strokes it crosses
+     * are deleted, or cut by the eraser square at each of the positions (in order) with the default eraser.
+     * @param positions The positions of the eraser square covering the path
+     */
+    void eraseAt(const std::vector<xoj::util::Point<double>>& path,
+                 const std::vector<xoj::util::Point<double>>& positions);
+
+    /// Delete the whole stroke, with the "Delete Stroke" eraser
+    void deleteStroke(Layer* l, Stroke* s, Range& range);
+
+    /**
+     * Cut the stroke with the eraser square at (x, y), with the default eraser
+     * @return true if the stroke was removed from the layer meanwhile
+     */
+    bool eraseStroke(Layer* l, Stroke* s, double x, double y, Range& range);
+
+    static void flushCallback(EraseHandler* self);
 
 private:
     PageRef page;
@@ -48,6 +98,12 @@ private:
 
     double halfEraserSize;
 
+    /// The last position the eraser was processed at, during a stroke of the eraser
+    std::optional<xoj::util::Point<double>> lastPosition;
+    /// The positions queued by sweepTo()
+    std::vector<xoj::util::Point<double>> pendingPositions;
+    guint flushSourceId = 0;
+
 private:
     /**
      * Coefficient for adding padding to the erased sections of strokes.
@@ -1,9 +1,13 @@
 #include "Selector.h"
 
-#include <algorithm>  // for max, min
-#include <cmath>      // for abs, NAN
+#include <algorithm>  // for max, min, clamp
+#include <atomic>     // for atomic
+#include <cmath>      // for abs, floor, isfinite, NAN
+#include <future>     // for async, future
 #include <limits>     // for numeric_limits
 #include <memory>     // for __shared_ptr_access
+#include <thread>     // for thread
+#include <utility>    // for pair
 
 #include <gdk/gdk.h>  // for GdkRGBA, gdk_cairo_set_source_rgba
 
@@ -30,6 +34,8 @@ auto Selector::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
     // Extend selection geometry (bbox) to infinity where touching page edges
     this->extendAtPageEdges();
 
+    this->prepareContains();
+
     // Find selected elements
     size_t layerId = 0;
     if (multiLayer && !disableMultilayer) {
@@ -40,36 +46,63 @@ auto Selector::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
             if (!l->isVisible()) {
                 continue;
             }
-            bool selectionOnLayer = false;
-            Element::Index pos = 0;
-            for (const auto& e: l->getElementsView()) {
-                if (e->isInSelection(this)) {
-                    this->selectedElements.emplace_back(e, pos);
-                    selectionOnLayer = true;
-                }
-                pos++;
-            }
-            if (selectionOnLayer) {
+            if (selectElements(l)) {
                 layerId = layers.size() - as_unsigned(std::distance(layers.rbegin(), it));
                 break;
             }
         }
     } else {
         std::shared_lock lock(*doc);
-        const Layer* l = page->getSelectedLayer();
-        Element::Index pos = 0;
-        for (const auto& e: l->getElementsView()) {
-            if (e->isInSelection(this)) {
-                this->selectedElements.emplace_back(e, pos);
-                layerId = page->getSelectedLayerId();
-            }
-            pos++;
+        if (selectElements(page->getSelectedLayer())) {
+            layerId = page->getSelectedLayerId();
         }
     }
 
     return layerId;
 }
 
+auto Selector::selectElements(const Layer* l) -> bool {
+    std::vector<std::pair<const Element*, Element::Index>> candidates;
+    l->forEachElementIntersecting(this->bbox, [&](const Element* e, Element::Index pos) {
+        e->getBoundingBox();  // Computed lazily: make sure the worker threads only read it
+        candidates.emplace_back(e, pos);
+    });
+
+    // Not std::vector<bool>, whose elements cannot be written concurrently
+    std::vector<char> selected(candidates.size(), false);
+    std::atomic<size_t> next = 0;
+    auto testCandidates = [&]() {
+        constexpr size_t CHUNK_SIZE = 64;
+        for (size_t first = next.fetch_add(CHUNK_SIZE); first < candidates.size();
+             first = next.fetch_add(CHUNK_SIZE)) {
+            const size_t last = std::min(first + CHUNK_SIZE, candidates.size());
+            for (size_t i = first; i < last; i++) {
+                selected[i] = candidates[i].first->isInSelection(this);
+            }
+        }
+    };
+
+    const size_t nbThreads = std::min<size_t>(std::max(1U, std::thread::hardware_concurrency()),
+                                              candidates.size() / MIN_PARALLEL_ELEMENTS);
+    std::vector<std::future<void>> workers;
+    for (size_t i = 1; i < nbThreads; i++) {
+        workers.emplace_back(std::async(std::launch::async, testCandidates));
+    }
+    testCandidates();
+    for (auto& w: workers) {
+        w.get();
+    }
+
+    bool any = false;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (selected[i]) {
+            this->selectedElements.emplace_back(candidates[i].first, candidates[i].second);
+            any = true;
+        }
+    }
+    return any;
+}
+
 auto Selector::isMultiLayerSelection() -> bool { return this->multiLayer; }
 
 auto Selector::releaseElements() -> InsertionOrderRef { return std::move(this->selectedElements); }
@@ -133,6 +166,9 @@ LassoSelector::LassoSelector(double x, double y, bool multiLayer): Selector(mult
 
 void LassoSelector::currentPos(double x, double y) {
     boundaryPoints.emplace_back(x, y);
+    // The edge buckets, if any, are out of date
+    bandEdges.clear();
+    bandOffsets.clear();
     bbox.addPoint(x, y);
 
     // at least three points needed
@@ -227,68 +263,131 @@ void LassoSelector::extendAtPageEdges() {
     boundaryPoints = std::move(newBoundaryPoints);
 }
 
-auto LassoSelector::contains(double x, double y) const -> bool {
-    if (boundaryPoints.size() <= 2 || !bbox.contains(x, y)) {
-        return false;
+void LassoSelector::prepareContains() {
+    bandEdges.clear();
+    bandOffsets.clear();
+    if (boundaryPoints.size() <= 2) {
+        return;
     }
 
-    int hits = 0;
+    // Horizontal edges never cross the ray of contains(): skip them
+    std::vector<Edge> edges;
+    edges.reserve(boundaryPoints.size());
+    const BoundaryPoint* last = &boundaryPoints.back();
+    for (const BoundaryPoint& cur: boundaryPoints) {
+        if (cur.y != last->y) {
+            edges.push_back({*last, cur});
+        }
+        last = &cur;
+    }
 
-    const BoundaryPoint& last = boundaryPoints.back();
+    // The bands split the finite part of the lasso. The bands at both ends extend to infinity.
+    double minY = std::numeric_limits<double>::infinity();
+    double maxY = -std::numeric_limits<double>::infinity();
+    for (const BoundaryPoint& p: boundaryPoints) {
+        if (std::isfinite(p.y)) {
+            minY = std::min(minY, p.y);
+            maxY = std::max(maxY, p.y);
+        }
+    }
+    const size_t nbBands = std::clamp<size_t>(edges.size() / 4, 1, MAX_BANDS);
+    bandMinY = minY;
+    bandScale = maxY > minY ? static_cast<double>(nbBands) / (maxY - minY) : 0.0;
+
+    // Bucket sort: count the edges of each band, then fill the buckets
+    bandOffsets.assign(nbBands + 1, 0);
+    for (const Edge& e: edges) {
+        const size_t lastBand = bandOf(std::max(e.last.y, e.cur.y));
+        for (size_t b = bandOf(std::min(e.last.y, e.cur.y)); b <= lastBand; b++) {
+            bandOffsets[b + 1]++;
+        }
+    }
+    for (size_t b = 0; b < nbBands; b++) {
+        bandOffsets[b + 1] += bandOffsets[b];
+    }
+    bandEdges.resize(bandOffsets.back());
+    std::vector<size_t> fill(bandOffsets.begin(), bandOffsets.end() - 1);
+    for (const Edge& e: edges) {
+        const size_t lastBand = bandOf(std::max(e.last.y, e.cur.y));
+        for (size_t b = bandOf(std::min(e.last.y, e.cur.y)); b <= lastBand; b++) {
+            bandEdges[fill[b]++] = e;
+        }
+    }
+}
 
-    double lastx = last.x;
-    double lasty = last.y;
-    double curx = NAN, cury = NAN;
+auto LassoSelector::bandOf(double y) const -> size_t {
+    if (bandScale == 0.0) {
+        return 0;
+    }
+    // Computed in double: y may be infinite
+    const double band = std::floor((y - bandMinY) * bandScale);
+    return static_cast<size_t>(std::clamp(band, 0.0, static_cast<double>(bandOffsets.size() - 2)));
+}
 
-    // Walk the edges of the polygon
-    for (auto pointIterator = boundaryPoints.begin(); pointIterator != boundaryPoints.end();
-         lastx = curx, lasty = cury, ++pointIterator) {
-        curx = pointIterator->x;
-        cury = pointIterator->y;
+auto LassoSelector::crossesEdge(double x, double y, const Edge& e) -> bool {
+    const double lastx = e.last.x;
+    const double lasty = e.last.y;
+    const double curx = e.cur.x;
+    const double cury = e.cur.y;
 
-        if (cury == lasty) {
-            continue;
+    int leftx = 0;
+    if (curx < lastx) {
+        if (x >= lastx) {
+            return false;
         }
+        leftx = static_cast<int>(curx);
+    } else {
+        if (x >= curx) {
+            return false;
+        }
+        leftx = static_cast<int>(lastx);
+    }
 
-        int leftx = 0;
-        if (curx < lastx) {
-            if (x >= lastx) {
-                continue;
-            }
-            leftx = static_cast<int>(curx);
-        } else {
-            if (x >= curx) {
-                continue;
-            }
-            leftx = static_cast<int>(lastx);
+    double test1 = NAN, test2 = NAN;
+    if (cury < lasty) {
+        if (y < cury || y >= lasty) {
+            return false;
+        }
+        if (x < leftx) {
+            return true;
+        }
+        test1 = x - curx;
+        test2 = y - cury;
+    } else {
+        if (y < lasty || y >= cury) {
+            return false;
         }
+        if (x < leftx) {
+            return true;
+        }
+        test1 = x - lastx;
+        test2 = y - lasty;
+    }
 
-        double test1 = NAN, test2 = NAN;
-        if (cury < lasty) {
-            if (y < cury || y >= lasty) {
-                continue;
-            }
-            if (x < leftx) {
-                hits++;
-                continue;
-            }
-            test1 = x - curx;
-            test2 = y - cury;
-        } else {
-            if (y < lasty || y >= cury) {
-                continue;
-            }
-            if (x < leftx) {
-                hits++;
-                continue;
-            }
-            test1 = x - lastx;
-            test2 = y - lasty;
+    return test1 < (test2 / (lasty - cury) * (lastx - curx));
+}
+
+auto LassoSelector::contains(double x, double y) const -> bool {
+    if (boundaryPoints.size() <= 2 || !bbox.contains(x, y)) {
+        return false;
+    }
+
+    int hits = 0;
+    if (!bandOffsets.empty()) {
+        const size_t band = bandOf(y);
+        for (size_t i = bandOffsets[band]; i < bandOffsets[band + 1]; i++) {
+            hits += crossesEdge(x, y, bandEdges[i]);
         }
+        return (hits & 1) != 0;
+    }
 
-        if (test1 < (test2 / (lasty - cury) * (lastx - curx))) {
-            hits++;
+    // Walk the edges of the polygon
+    const BoundaryPoint* last = &boundaryPoints.back();
+    for (const BoundaryPoint& cur: boundaryPoints) {
+        if (cur.y != last->y) {
+            hits += crossesEdge(x, y, {*last, cur});
         }
+        last = &cur;
     }
 
     return (hits & 1) != 0;
@@ -11,7 +11,8 @@
 
 #pragma once
 
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
 
 #include "model/Element.h"  // for Element (ptr only), ShapeContainer
 #include "model/ElementInsertionPosition.h"
@@ -23,6 +24,7 @@
 #include "view/overlays/SelectorView.h"
 
 class Document;
+class Layer;
 
 class Selector: public ShapeContainer, public OverlayBase {
 public:
@@ -62,8 +64,24 @@ public:
      * Define a threshold in pt for the vicinity the selection area must be in to trigger extension.
      */
     static constexpr double EDGE_TOUCHING_THRESHOLD = 1.0;  // pt
+
+    /// Selections with at least that many candidate elements are tested on several threads
+    static constexpr size_t MIN_PARALLEL_ELEMENTS = 512;
+
 private:
+    /**
+     * Adds the elements of the layer which are in the selection to selectedElements
+     * @return true if any element was selected
+     */
+    bool selectElements(const Layer* l);
+
 protected:
+    /**
+     * Called by finalize() once the geometry is final, before the element containment checks: a chance to build
+     * acceleration structures for contains(), which may then be called from several threads.
+     */
+    virtual void prepareContains() {}
+
     std::vector<BoundaryPoint> boundaryPoints;
 
     bool multiLayer;
@@ -109,4 +127,34 @@ public:
     const std::vector<BoundaryPoint>& getBoundary() const override;
 
     void extendAtPageEdges() override;
+
+    /// Maximal number of horizontal bands of the edge buckets
+    static constexpr size_t MAX_BANDS = 1024;
+
+protected:
+    /// Buckets the edges of the lasso by horizontal bands
+    void prepareContains() override;
+
+private:
+    struct Edge {
+        BoundaryPoint last;
+        BoundaryPoint cur;
+    };
+
+    /// Whether a horizontal ray from (x, y) to the left crosses the edge, in the sense of the even-odd rule
+    static bool crossesEdge(double x, double y, const Edge& e);
+
+    /// The band of the edge buckets containing the ordinate y
+    size_t bandOf(double y) const;
+
+    /**
+     * The non-horizontal edges of the lasso, bucketed by horizontal bands of equal height: a point only needs to be
+     * tested against the edges of its band. The edges of the band b are bandEdges[bandOffsets[b]..bandOffsets[b + 1]).
+     * Empty until prepareContains() is called.
+     */
+    std::vector<Edge> bandEdges;
+    std::vector<size_t> bandOffsets;
+    double bandMinY = 0;
+    /// Number of bands per unit of height
+    double bandScale = 0;
 };
@@ -1,20 +1,17 @@
 #include "DoubleAttribute.h"
 
-#include <string>  // for allocator, string
-
-#include <glib.h>  // for g_ascii_formatd, G_ASCII_DTOSTR_B...
+#include <cstddef>  // for size_t
 
 #include "control/xml/Attribute.h"  // for XMLAttribute
 #include "util/OutputStream.h"      // for OutputStream
-#include "util/Util.h"              // for PRECISION_FORMAT_STRING
+#include "util/Util.h"              // for formatNumber, NUMBER_STRING_BUF_SIZE
 
 DoubleAttribute::DoubleAttribute(const char8_t* name, double value): XMLAttribute(name) { this->value = value; }
 
 DoubleAttribute::~DoubleAttribute() = default;
 
 void DoubleAttribute::writeOut(OutputStream* out) {
-    char str[G_ASCII_DTOSTR_BUF_SIZE];
-    // g_ascii_ version uses C locale always.
-    g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
-    out->write(str);
+    char str[Util::NUMBER_STRING_BUF_SIZE];
+    char* end = Util::formatNumber(str, value);
+    out->write(str, static_cast<size_t>(end - str));
 }
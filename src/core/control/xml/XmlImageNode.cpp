@@ -1,5 +1,7 @@
 #include "XmlImageNode.h"
 
+#include <utility>  // for move
+
 #include <glib.h>  // for g_base64_encode, g_free, gchar, g_e...
 
 #include "control/xml/XmlNode.h"  // for XmlNode
@@ -25,6 +27,8 @@ void XmlImageNode::setImage(cairo_surface_t* img) {
     this->img = cairo_surface_reference(img);
 }
 
+void XmlImageNode::setPngData(std::shared_ptr<const std::string> png) { this->png = std::move(png); }
+
 auto XmlImageNode::pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length)
         -> cairo_status_t {
     for (unsigned int i = 0; i < length; i++, image->pos++) {
@@ -47,12 +51,18 @@ void XmlImageNode::writeOut(OutputStream* out) {
 
     out->write(">");
 
-    if (this->img == nullptr) {
+    if (this->img == nullptr && this->png == nullptr) {
         g_error("XmlImageNode::writeOut(); this->img == nullptr");
     } else {
         this->out = out;
         this->pos = 0;
-        cairo_surface_write_to_png_stream(this->img, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction), this);
+        if (this->png) {
+            pngWriteFunction(this, reinterpret_cast<const unsigned char*>(this->png->data()),
+                             static_cast<unsigned int>(this->png->size()));
+        } else {
+            cairo_surface_write_to_png_stream(this->img, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction),
+                                              this);
+        }
         gchar* base64_str = g_base64_encode(this->buffer, this->pos);
         out->write(base64_str);
         g_free(base64_str);
@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <memory>  // for shared_ptr
+#include <string>  // for string
+
 #include <cairo.h>  // for cairo_surface_t, cairo_status_t
 
 #include "XmlNode.h"  // for XmlNode
@@ -24,6 +27,8 @@ public:
 
 public:
     void setImage(cairo_surface_t* img);
+    /// Write the given PNG data instead of encoding an image, e.g. when it was already encoded for another node
+    void setPngData(std::shared_ptr<const std::string> png);
 
     static cairo_status_t pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length);
 
@@ -31,6 +36,7 @@ public:
 
 private:
     cairo_surface_t* img;
+    std::shared_ptr<const std::string> png;
 
     OutputStream* out;
     unsigned int pos;
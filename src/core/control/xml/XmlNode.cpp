@@ -55,14 +55,13 @@ void XmlNode::setAttrib(const char8_t* attrib, std::vector<double> values) {
 }
 
 void XmlNode::writeOut(OutputStream* out, ProgressListener* listener) {
-    out->write("<");
-    out->write(tag);
-    writeAttributes(out);
-
     if (children.empty()) {
+        out->write("<");
+        out->write(tag);
+        writeAttributes(out);
         out->write("/>\n");
     } else {
-        out->write(">\n");
+        writeOpeningTag(out);
 
         if (listener) {
             listener->setMaximumState(children.size());
@@ -78,12 +77,29 @@ void XmlNode::writeOut(OutputStream* out, ProgressListener* listener) {
             i++;
         }
 
-        out->write("</");
-        out->write(tag);
-        out->write(">\n");
+        writeClosingTag(out);
     }
 }
 
+void XmlNode::writeOpeningTag(OutputStream* out) {
+    out->write("<");
+    out->write(tag);
+    writeAttributes(out);
+    out->write(">\n");
+}
+
+void XmlNode::writeChildren(OutputStream* out) {
+    for (auto& node: children) {
+        node->writeOut(out);
+    }
+}
+
+void XmlNode::writeClosingTag(OutputStream* out) {
+    out->write("</");
+    out->write(tag);
+    out->write(">\n");
+}
+
 void XmlNode::addChild(XmlNode* node) { children.emplace_back(node); }
 
 void XmlNode::putAttrib(XMLAttribute* a) {
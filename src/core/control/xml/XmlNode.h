@@ -42,6 +42,13 @@ public:
 
     virtual void writeOut(OutputStream* out) { writeOut(out, nullptr); }
 
+    /**
+     * Write the node piece by piece, so that more children can be written in between without being added to the node
+     */
+    void writeOpeningTag(OutputStream* out);
+    void writeChildren(OutputStream* out);
+    void writeClosingTag(OutputStream* out);
+
     void addChild(XmlNode* node);
 
 protected:
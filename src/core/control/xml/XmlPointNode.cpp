@@ -1,7 +1,6 @@
 #include "XmlPointNode.h"
 
-#include <algorithm>  // for max
-#include <utility>    // for move
+#include <utility>  // for move
 
 #include "control/xml/XmlAudioNode.h"  // for XmlAudioNode
 #include "util/OutputStream.h"         // for OutputStream
@@ -10,7 +9,12 @@
 
 XmlPointNode::XmlPointNode(StringUtils::StaticStringView tag): XmlAudioNode(tag) {}
 
-void XmlPointNode::setPoints(std::vector<Point> pts) { this->points = std::move(pts); }
+void XmlPointNode::setPoints(StrokePoints pts) {
+    this->points = std::move(pts);
+    this->pointsRef = nullptr;
+}
+
+void XmlPointNode::setPointsRef(const StrokePoints* pts) { this->pointsRef = pts; }
 
 void XmlPointNode::writeOut(OutputStream* out) {
     /** Write stroke and its attributes */
@@ -20,14 +24,8 @@ void XmlPointNode::writeOut(OutputStream* out) {
 
     out->write(">");
 
-    auto pointIter = points.begin();
-    Util::writeCoordinateString(out, pointIter->x, pointIter->y);
-    ++pointIter;
-    for (; pointIter != points.end(); ++pointIter) {
-        out->write(" ");
-
-        Util::writeCoordinateString(out, pointIter->x, pointIter->y);
-    }
+    const StrokePoints& pts = pointsRef ? *pointsRef : points;
+    Util::writeCoordinateString(out, pts.xData(), pts.yData(), pts.size());
 
     out->write("</");
     out->write(tag);
@@ -11,9 +11,7 @@
 
 #pragma once
 
-#include <vector>  // for vector
-
-#include "model/Point.h"  // for Point
+#include "model/StrokePoints.h"  // for StrokePoints
 
 #include "XmlAudioNode.h"  // for XmlAudioNode
 
@@ -24,9 +22,15 @@ public:
     XmlPointNode(StringUtils::StaticStringView tag);
 
 public:
-    void setPoints(std::vector<Point> points);
+    void setPoints(StrokePoints points);
+    /**
+     * @brief Use the points without copying them. They must outlive the node.
+     */
+    void setPointsRef(const StrokePoints* points);
     void writeOut(OutputStream* out) override;
 
 private:
-    std::vector<Point> points{};
+    StrokePoints points{};
+    /// Points not owned by the node, written instead of `points` if set
+    const StrokePoints* pointsRef = nullptr;
 };
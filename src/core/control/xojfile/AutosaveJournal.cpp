@@ -0,0 +1,397 @@
+#include "AutosaveJournal.h"
+
+#include <algorithm>     // for min
+#include <charconv>      // for from_chars
+#include <optional>      // for optional
+#include <stdexcept>     // for runtime_error
+#include <string_view>   // for string_view
+#include <system_error>  // for errc, error_code
+#include <utility>       // for move
+
+#include <glib.h>  // for g_warning
+#include <zlib.h>  // for gzwrite, gzclose, gzFile
+
+#include "control/xojfile/LoadHandler.h"  // for LoadHandler
+#include "control/xojfile/SaveHandler.h"  // for SaveHandler
+#include "model/Document.h"               // for Document
+#include "model/XojPage.h"                // for XojPage
+#include "util/GzInputStream.h"           // for GzInputStream
+#include "util/GzUtil.h"                  // for GzUtil
+#include "util/OutputStream.h"            // for StringOutputStream
+#include "util/StringInputStream.h"       // for StringInputStream
+#include "util/i18n.h"                    // for FS, _F
+
+namespace {
+constexpr std::string_view JOURNAL_MAGIC = "xournalpp-journal";
+constexpr int JOURNAL_VERSION = 1;
+constexpr std::string_view RECORD_TAG = "record";
+
+auto getRecordPath(const fs::path& journal, size_t record) -> fs::path {
+    return fs::path(journal) += "." + std::to_string(record);
+}
+
+/// Splits the text in space separated tokens, one line at a time
+class Tokenizer {
+public:
+    explicit Tokenizer(std::string_view text): text(text) {}
+
+    auto next() -> std::string_view {
+        const size_t end = std::min(text.find_first_of(" \n", pos), text.size());
+        std::string_view token = text.substr(pos, end - pos);
+        pos = end < text.size() && text[end] == ' ' ? end + 1 : end;
+        return token;
+    }
+
+    template <typename T>
+    auto nextNumber() -> std::optional<T> {
+        const auto token = next();
+        T value{};
+        auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (token.empty() || ec != std::errc{} || ptr != token.data() + token.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    /// Skip the end of the line. @return false if the line has more tokens
+    auto endLine() -> bool {
+        if (pos >= text.size() || text[pos] != '\n') {
+            return false;
+        }
+        pos++;
+        return true;
+    }
+
+    auto atEnd() const -> bool { return pos >= text.size(); }
+
+    /// @return The next len bytes, or std::nullopt if the text is shorter
+    auto take(size_t len) -> std::optional<std::string_view> {
+        if (text.size() - pos < len) {
+            return std::nullopt;
+        }
+        auto data = text.substr(pos, len);
+        pos += len;
+        return data;
+    }
+
+private:
+    std::string_view text;
+    size_t pos = 0;
+};
+
+struct Record {
+    size_t id;
+    std::vector<AutosaveJournal::Location> order;
+    std::string_view xml;
+};
+}  // namespace
+
+AutosaveJournal::AutosaveJournal(const Document* doc): doc(doc) {}
+
+AutosaveJournal::~AutosaveJournal() = default;
+
+void AutosaveJournal::documentChanged(DocumentChangeType type) {
+    if (type != DOCUMENT_CHANGE_PDF_BOOKMARKS) {
+        std::lock_guard lock(mutex);
+        fullSaveRequired = ++changeCount;
+    }
+}
+
+void AutosaveJournal::pageSizeChanged(size_t page) { markChanged(doc->getPage(page)); }
+
+void AutosaveJournal::pageChanged(size_t page) { markChanged(doc->getPage(page)); }
+
+void AutosaveJournal::pageInserted(size_t page) { markChanged(doc->getPage(page)); }
+
+void AutosaveJournal::undoRedoChanged() {}
+
+void AutosaveJournal::undoRedoPageChanged(PageRef page) { markChanged(page); }
+
+void AutosaveJournal::markChanged(const PageRef& page) {
+    if (page) {
+        std::lock_guard lock(mutex);
+        changedPages[page] = ++changeCount;
+    }
+}
+
+auto AutosaveJournal::hasChanges() -> bool {
+    {
+        std::lock_guard lock(mutex);
+        if (!changedPages.empty() || fullSaveRequired != 0) {
+            return true;
+        }
+    }
+    if (doc->getPageCount() != this->order.size()) {
+        return true;
+    }
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef p = doc->getPage(i);
+        auto it = locations.find(p);
+        if (it == locations.end() || it->second.modificationCount != p->getModificationCount() ||
+            it->second.location.record != order[i].record || it->second.location.index != order[i].index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto AutosaveJournal::canAppend(const fs::path& file) -> bool {
+    {
+        std::lock_guard lock(mutex);
+        if (fullSaveRequired != 0) {
+            return false;
+        }
+    }
+    if (file != this->autosaveFile || this->nextRecord > MAX_RECORDS) {
+        return false;
+    }
+
+    // Make sure the autosave file was not replaced in the meantime
+    std::error_code ec;
+    const auto size = fs::file_size(file, ec);
+    const auto time = fs::last_write_time(file, ec);
+    return !ec && size == this->baseSize && time == this->baseTime;
+}
+
+auto AutosaveJournal::prepareRecord(const fs::path& file) -> Record {
+    std::map<std::weak_ptr<XojPage>, uint64_t, std::owner_less<>> changed;
+    Record record{};
+    {
+        std::lock_guard lock(mutex);
+        record.changeCount = changeCount;
+        changed = changedPages;
+    }
+    record.id = this->nextRecord;
+
+    // The pages that were not written yet, and the location of every page
+    std::vector<size_t> pagesToWrite;
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef p = doc->getPage(i);
+        const uint64_t modificationCount = p->getModificationCount();
+        auto it = locations.find(p);
+        Location loc{};
+        if (it == locations.end() || it->second.modificationCount != modificationCount || changed.count(p)) {
+            loc = {record.id, pagesToWrite.size()};
+            pagesToWrite.push_back(i);
+        } else {
+            loc = it->second.location;
+        }
+        record.order.push_back(loc);
+        record.locations[p] = {loc, modificationCount};
+    }
+
+    if (!pagesToWrite.empty()) {
+        SaveHandler handler;
+        StringOutputStream xml;
+        const auto recordPath = getRecordPath(getJournalPath(file), record.id);
+        handler.savePagesTo(doc, pagesToWrite, recordPath, &xml, recordPath);
+        record.xml = xml.takeString();
+        record.error = handler.getErrorMessage();
+    }
+    return record;
+}
+
+auto AutosaveJournal::append(const fs::path& file) -> std::string { return append(prepareRecord(file), file); }
+
+auto AutosaveJournal::append(Record record, const fs::path& file) -> std::string {
+    if (!record.error.empty()) {
+        return record.error;
+    }
+
+    const fs::path journal = getJournalPath(file);
+    const size_t id = record.id;
+
+    std::string header;
+    std::error_code ec;
+    if (!fs::exists(journal, ec)) {
+        header += std::string(JOURNAL_MAGIC) + " " + std::to_string(JOURNAL_VERSION) + " " +
+                  std::to_string(this->baseSize) + " " + std::to_string(this->baseTime.time_since_epoch().count()) +
+                  "\n";
+    }
+    header += std::string(RECORD_TAG) + " " + std::to_string(id) + " " + std::to_string(record.order.size());
+    for (const auto& loc: record.order) {
+        header += " " + std::to_string(loc.record) + ":" + std::to_string(loc.index);
+    }
+    const std::string& data = record.xml;
+    header += " " + std::to_string(data.size()) + "\n";
+
+    // Each append creates a new gzip member, which is read as the continuation of the previous ones
+    gzFile fp = GzUtil::openPath(journal, "ab");
+    if (!fp) {
+        return FS(_F("Error opening file: \"{1}\"") % journal.u8string());
+    }
+    bool ok = gzwrite(fp, header.data(), static_cast<unsigned int>(header.size())) == static_cast<int>(header.size());
+    if (ok && !data.empty()) {
+        ok = gzwrite(fp, data.data(), static_cast<unsigned int>(data.size())) == static_cast<int>(data.size());
+    }
+    ok = gzclose(fp) == Z_OK && ok;
+    if (!ok) {
+        std::lock_guard lock(mutex);
+        // The journal may be corrupted: do not append to it anymore
+        fullSaveRequired = changeCount;
+        return FS(_F("Error writing data to file: \"{1}\"") % journal.u8string());
+    }
+
+    this->locations = std::move(record.locations);
+    this->order = std::move(record.order);
+    this->nextRecord++;
+
+    std::lock_guard lock(mutex);
+    std::erase_if(changedPages, [count = record.changeCount](const auto& entry) { return entry.second <= count; });
+    return {};
+}
+
+auto AutosaveJournal::prepareBase() -> Base {
+    Base base;
+    {
+        std::lock_guard lock(mutex);
+        base.changeCount = changeCount;
+    }
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        base.pages.push_back(doc->getPage(i));
+        base.modificationCounts.push_back(base.pages.back()->getModificationCount());
+    }
+    return base;
+}
+
+void AutosaveJournal::setBase(Base base, const fs::path& file) {
+    remove(file);
+
+    std::error_code ec;
+    this->baseSize = fs::file_size(file, ec);
+    this->baseTime = fs::last_write_time(file, ec);
+    this->autosaveFile = ec ? fs::path{} : file;
+
+    this->locations.clear();
+    this->order.clear();
+    for (size_t i = 0; i < base.pages.size(); i++) {
+        this->locations[base.pages[i]] = {{0, i}, base.modificationCounts[i]};
+        this->order.push_back({0, i});
+    }
+    this->nextRecord = 1;
+
+    std::lock_guard lock(mutex);
+    std::erase_if(changedPages, [&base](const auto& entry) { return entry.second <= base.changeCount; });
+    if (fullSaveRequired <= base.changeCount) {
+        fullSaveRequired = 0;
+    }
+}
+
+auto AutosaveJournal::getJournalPath(const fs::path& autosaveFile) -> fs::path {
+    return fs::path(autosaveFile) += ".journal";
+}
+
+void AutosaveJournal::remove(const fs::path& autosaveFile) {
+    const auto journal = getJournalPath(autosaveFile);
+    // The background images of the records are named "<journal>.<record>.bg_<n>.png"
+    const auto prefix = journal.filename().u8string() + u8".";
+    std::error_code ec;
+    fs::remove(journal, ec);
+    for (const auto& entry: fs::directory_iterator(journal.parent_path(), ec)) {
+        if (entry.path().filename().u8string().starts_with(prefix)) {
+            fs::remove(entry.path(), ec);
+        }
+    }
+}
+
+void AutosaveJournal::replay(Document& doc, const fs::path& autosaveFile) {
+    const auto journal = getJournalPath(autosaveFile);
+    std::error_code ec;
+    if (!fs::exists(journal, ec)) {
+        return;
+    }
+
+    std::string content;
+    {
+        xoj::util::GzInputStream in(journal);
+        char buffer[16 * 1024];
+        int len = 0;
+        // A truncated journal is read up to the error: the last record is then incomplete and ignored
+        while ((len = in.read(buffer, sizeof(buffer))) > 0) {
+            content.append(buffer, static_cast<size_t>(len));
+        }
+    }
+
+    Tokenizer tokens(content);
+    const auto baseSize = fs::file_size(autosaveFile, ec);
+    const auto baseTime = fs::last_write_time(autosaveFile, ec).time_since_epoch().count();
+    if (tokens.next() != JOURNAL_MAGIC || tokens.nextNumber<int>() != JOURNAL_VERSION) {
+        throw std::runtime_error(FS(_F("\"{1}\" is not a valid journal") % journal.u8string()));
+    }
+    if (tokens.nextNumber<std::uintmax_t>() != baseSize ||
+        tokens.nextNumber<fs::file_time_type::rep>() != baseTime || !tokens.endLine()) {
+        g_warning("Ignoring the outdated autosave journal \"%s\"", journal.string().c_str());
+        return;
+    }
+
+    std::map<size_t, std::string_view> records;
+    std::optional<Record> last;
+    while (!tokens.atEnd()) {
+        Record r;
+        auto id = tokens.next() == RECORD_TAG ? tokens.nextNumber<size_t>() : std::nullopt;
+        auto count = tokens.nextNumber<size_t>();
+        if (!id || !count) {
+            break;
+        }
+        r.id = *id;
+        bool valid = true;
+        for (size_t i = 0; i < *count && valid; i++) {
+            auto token = tokens.next();
+            auto sep = token.find(':');
+            Location loc{};
+            valid = sep != std::string_view::npos &&
+                    std::from_chars(token.data(), token.data() + sep, loc.record).ec == std::errc{} &&
+                    std::from_chars(token.data() + sep + 1, token.data() + token.size(), loc.index).ec ==
+                            std::errc{} &&
+                    loc.record <= r.id;
+            r.order.push_back(loc);
+        }
+        auto length = tokens.nextNumber<size_t>();
+        auto xml = valid && length && tokens.endLine() ? tokens.take(*length) : std::nullopt;
+        if (!xml) {
+            break;
+        }
+        r.xml = *xml;
+        records[r.id] = r.xml;
+        last = std::move(r);
+    }
+    if (!last) {
+        return;
+    }
+
+    // Load the pages of the records the final order refers to
+    std::map<size_t, std::vector<PageRef>> recordPages;
+    for (size_t i = 0; i < doc.getPageCount(); i++) {
+        recordPages[0].push_back(doc.getPage(i));
+    }
+    for (const auto& loc: last->order) {
+        if (recordPages.count(loc.record)) {
+            continue;
+        }
+        auto it = records.find(loc.record);
+        if (it == records.end() || it->second.empty()) {
+            throw std::runtime_error(FS(_F("Missing record {1} in \"{2}\"") % loc.record % journal.u8string()));
+        }
+        auto xml = std::make_unique<xoj::util::StringInputStream>(std::string(it->second));
+        auto recordDoc = LoadHandler().loadDocument(std::move(xml), getRecordPath(journal, loc.record));
+        auto& pages = recordPages[loc.record];
+        for (size_t i = 0; i < recordDoc->getPageCount(); i++) {
+            pages.push_back(recordDoc->getPage(i));
+        }
+    }
+
+    std::vector<PageRef> pages;
+    for (const auto& loc: last->order) {
+        const auto& source = recordPages[loc.record];
+        if (loc.index >= source.size()) {
+            throw std::runtime_error(FS(_F("Missing page {1} of record {2} in \"{3}\"") % loc.index % loc.record %
+                                        journal.u8string()));
+        }
+        pages.push_back(source[loc.index]);
+    }
+
+    for (size_t i = doc.getPageCount(); i > 0; i--) {
+        doc.deletePage(i - 1);
+    }
+    doc.addPages(pages.begin(), pages.end());
+}
@@ -0,0 +1,183 @@
+/*
+ * Xournal++
+ *
+ * Journal of the pages changed since the last full autosave
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t, uintmax_t
+#include <map>      // for map
+#include <memory>   // for weak_ptr, owner_less
+#include <mutex>    // for mutex
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "model/DocumentListener.h"  // for DocumentListener
+#include "model/PageRef.h"           // for PageRef
+#include "undo/UndoRedoHandler.h"    // for UndoRedoListener
+
+#include "filesystem.h"  // for path
+
+class Document;
+class XojPage;
+
+/**
+ * @brief Appends the pages changed since the last autosave to a journal next to the autosave file, instead of
+ * rewriting the whole document.
+ *
+ * The journal "<autosave file>.journal" is a gzip file, to which one gzip member is appended per autosave. Each
+ * record holds the changed pages, as a document of their own, and the order of all the pages of the document: each
+ * page is either a page of the autosave file (the base) or a page of a previous record.
+ * When too many records were written, the whole document is autosaved again and the journal is removed (compaction).
+ *
+ * A page is written again when its modification count (see XojPage::getModificationCount()) differs from the one it
+ * had when it was last written, which catches all the changes, even those made after their undo action was recorded.
+ * The notifications of the UndoRedoHandler and of the DocumentHandler, on the main thread, additionally mark pages as
+ * changed and tell when the whole document has to be autosaved again. The journal itself is written by the
+ * AutosaveJob.
+ *
+ * Loading an autosave file replays its journal (see LoadHandler::loadDocument()), which gives the same document as a
+ * full autosave would have.
+ */
+class AutosaveJournal: public DocumentListener, public UndoRedoListener {
+public:
+    explicit AutosaveJournal(const Document* doc);
+    ~AutosaveJournal() override;
+
+    /**
+     * The location of a page in the autosave file (record 0) or in a record of the journal
+     */
+    struct Location {
+        size_t record;
+        size_t index;
+    };
+
+    /**
+     * Where the last written version of a page is, and the modification count of the page when it was written
+     */
+    struct WrittenPage {
+        Location location;
+        uint64_t modificationCount;
+    };
+
+    /**
+     * The state of the document written by a full autosave, to be committed with setBase() once the file is in place
+     */
+    struct Base {
+        std::vector<PageRef> pages;
+        std::vector<uint64_t> modificationCounts;
+        uint64_t changeCount;
+    };
+
+public:
+    // DocumentListener and UndoRedoListener interface, called on the main thread
+    void documentChanged(DocumentChangeType type) override;
+    void pageSizeChanged(size_t page) override;
+    void pageChanged(size_t page) override;
+    void pageInserted(size_t page) override;
+    void undoRedoChanged() override;
+    void undoRedoPageChanged(PageRef page) override;
+
+    /**
+     * @return Whether some pages changed, or were inserted, deleted or moved, since they were last written. Needs read
+     * access to the document.
+     */
+    bool hasChanges();
+
+    /**
+     * @return Whether the changes can be appended to the journal of this autosave file, instead of autosaving the
+     * whole document
+     */
+    bool canAppend(const fs::path& autosaveFile);
+
+    /**
+     * A record of the journal, serialized but not written yet
+     */
+    struct Record {
+        size_t id;
+        /// The value of changeCount when the record was serialized
+        uint64_t changeCount;
+        /// The location of every page of the document
+        std::vector<Location> order;
+        std::map<std::weak_ptr<XojPage>, WrittenPage, std::owner_less<>> locations;
+        /// The pages that changed since they were last written, as a document of their own
+        std::string xml;
+        std::string error;
+    };
+
+    /**
+     * Serialize the pages changed since the last autosave. Needs read access to the document.
+     */
+    Record prepareRecord(const fs::path& autosaveFile);
+
+    /**
+     * Append the record to the journal. Does not access the document.
+     * @return An error message, empty on success
+     */
+    std::string append(Record record, const fs::path& autosaveFile);
+
+    /**
+     * Append the pages changed since the last autosave to the journal. Needs read access to the document.
+     * @return An error message, empty on success
+     */
+    std::string append(const fs::path& autosaveFile);
+
+    /**
+     * Remember the state of the document before it is entirely autosaved. Needs read access to the document.
+     */
+    Base prepareBase();
+
+    /**
+     * The whole document was autosaved to autosaveFile: removes the previous journal.
+     */
+    void setBase(Base base, const fs::path& autosaveFile);
+
+    /// @return The path of the journal of the autosave file
+    static fs::path getJournalPath(const fs::path& autosaveFile);
+
+    /// Remove the journal of the autosave file, and the background images written with it
+    static void remove(const fs::path& autosaveFile);
+
+    /**
+     * Apply the journal of the autosave file, if there is one, to the document loaded from the autosave file.
+     * The last record that was completely written is used.
+     * @exception Throws a `std::runtime_error` if the journal cannot be applied. The document is then unchanged.
+     */
+    static void replay(Document& doc, const fs::path& autosaveFile);
+
+private:
+    void markChanged(const PageRef& page);
+
+private:
+    /// Compact the journal after this many records
+    static constexpr size_t MAX_RECORDS = 20;
+
+    const Document* doc;
+
+    /// Protects the members modified on the main thread
+    std::mutex mutex;
+    /// The pages changed since they were last written, with the value of changeCount when they changed
+    std::map<std::weak_ptr<XojPage>, uint64_t, std::owner_less<>> changedPages;
+    uint64_t changeCount = 0;
+    /// The value of changeCount when a full autosave became necessary, or 0
+    uint64_t fullSaveRequired = 1;
+
+    // Only accessed by the AutosaveJob
+
+    fs::path autosaveFile;
+    /// Identification of the autosave file the journal applies to
+    std::uintmax_t baseSize = 0;
+    fs::file_time_type baseTime;
+    /// Where the last written version of each page is
+    std::map<std::weak_ptr<XojPage>, WrittenPage, std::owner_less<>> locations;
+    /// The location of every page of the document, as last written
+    std::vector<Location> order;
+    size_t nextRecord = 1;
+};
@@ -0,0 +1,53 @@
+/*
+ * Xournal++
+ *
+ * Layout of the chunked .xopp container
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <string>       // for string, to_string
+#include <string_view>  // for string_view
+
+/**
+ * The chunked container is a zip archive holding each page in its own entry, so that pages can be read (and
+ * decompressed) independently from each other:
+ *  - "mimetype": the mimetype, stored uncompressed
+ *  - "META-INF/version": the file version, as for the other zip files
+ *  - "META-INF/pages": the manifest, a "pages <count>" line followed by one "<entry> <size>" line per page, in order
+ *  - "document.xml": the document, whose pages only contain their background
+ *  - "pages/<n>.xml": the layers of the n-th page
+ *  - "images/<n>": the data of the image elements, stored once for all the images with the same data. The image
+ *    elements refer to them with an <attachment path="images/<n>"/> tag.
+ *  - "thumbnails/thumbnail.png": the preview
+ *  - "content.xml": a single page document, which is all that the older versions read. It tells that the file needs a
+ *    newer version, or to be converted to the gzip format with `xournalpp --convert=<file>`.
+ *
+ * The attached PDF and background images are stored next to the file, as for the gzip files.
+ */
+namespace xoj::chunked_format {
+constexpr std::string_view MIMETYPE = "application/xournal++";
+
+constexpr const char* MIMETYPE_ENTRY = "mimetype";
+constexpr const char* VERSION_ENTRY = "META-INF/version";
+constexpr const char* MANIFEST_ENTRY = "META-INF/pages";
+constexpr const char* DOCUMENT_ENTRY = "document.xml";
+constexpr const char* THUMBNAIL_ENTRY = "thumbnails/thumbnail.png";
+constexpr const char* FALLBACK_ENTRY = "content.xml";
+
+constexpr std::string_view MANIFEST_HEADER = "pages";
+
+constexpr std::string_view IMAGES_DIR = "images/";
+
+/// @return The name of the entry holding the layers of the page
+inline auto getPageEntry(size_t page) -> std::string { return "pages/" + std::to_string(page) + ".xml"; }
+
+/// @return The name of the entry holding the data of an image
+inline auto getImageEntry(size_t image) -> std::string { return std::string(IMAGES_DIR) + std::to_string(image); }
+}  // namespace xoj::chunked_format
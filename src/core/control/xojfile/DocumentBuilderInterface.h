@@ -24,8 +24,8 @@
 
 class LineStyle;
 class PageType;
-class Point;
 class StrokeCapStyle;
+class StrokePoints;
 class StrokeTool;
 class TextAlignment;
 
@@ -49,7 +49,7 @@ public:
     virtual void finalizeLayer() = 0;
     virtual void addStroke(StrokeTool tool, Color color, double width, int fill, StrokeCapStyle capStyle,
                            const LineStyle& lineStyle, fs::path filename, size_t timestamp) = 0;
-    virtual void setStrokePoints(std::vector<Point> pointVector, bool hasPressure) = 0;
+    virtual void setStrokePoints(StrokePoints points, bool hasPressure) = 0;
     virtual void finalizeStroke() = 0;
     virtual void addText(std::string font, double size, double x, double y, Color color, std::optional<double> wrap,
                          std::optional<TextAlignment> align, bool justify, fs::path filename, size_t timestamp) = 0;
@@ -1,16 +1,21 @@
 #include "LoadHandler.h"
 
-#include <algorithm>      // for copy
+#include <algorithm>      // for copy, max, min
 #include <array>          // for array
+#include <atomic>         // for atomic
+#include <cctype>         // for isspace
 #include <cmath>          // for isnan
 #include <cstddef>        // for byte
 #include <cstdlib>        // for atoi, size_t
-#include <cstring>        // for strcmp, strlen
+#include <functional>     // for function
+#include <future>         // for async, future
 #include <iterator>       // for back_inserter
 #include <memory>         // for make_unique, make_shared...
+#include <mutex>          // for lock_guard
 #include <optional>       // for optional
-#include <ranges>         // for take
+#include <ranges>         // for find_if
 #include <regex>          // for regex_search, match_results
+#include <sstream>        // for istringstream
 #include <stdexcept>      // for runtime_error
 #include <string>         // for string
 #include <string_view>    // for string_view
@@ -23,31 +28,39 @@
 #include <glibconfig.h>  // for gssize...
 #include <zip.h>         // for zip_file_t, zip_fopen,...
 #include <zipconf.h>     // for zip_int64_t, zip_uint64_t
-
-#include "control/xojfile/XmlParser.h"  // for XmlParser
-#include "model/BackgroundImage.h"      // for BackgroundImage
-#include "model/Document.h"             // for Document
-#include "model/Font.h"                 // for XojFont
-#include "model/Image.h"                // for Image
-#include "model/Layer.h"                // for Layer
-#include "model/Link.h"                 // for Link
-#include "model/PageType.h"             // for PageType, PageTypeFormat
-#include "model/Point.h"                // for Point
-#include "model/Stroke.h"               // for Stroke, StrokeCapStyle
-#include "model/TexImage.h"             // for TexImage
-#include "model/Text.h"                 // for Text
-#include "model/XojPage.h"              // for XojPage
-#include "util/Assert.h"                // for xoj_assert
-#include "util/Color.h"                 // for Color
-#include "util/GzInputStream.h"         // for GzInputStream
-#include "util/LoopUtil.h"              // for for_first_then_each
-#include "util/PathUtil.h"              // for PathStorageMode
-#include "util/StringUtils.h"           // for char_cast
-#include "util/ZipInputStream.h"        // for ZipInputStream
-#include "util/i18n.h"                  // for _F, FS, _
-#include "util/raii/CLibrariesSPtr.h"   // for adopt
-#include "util/raii/GLibGuards.h"       // for GErrorGuard
-#include "util/raii/GObjectSPtr.h"      // for GObjectSPtr
+#include <zlib.h>        // for inflate, z_stream
+
+#include "control/xojfile/AutosaveJournal.h"  // for AutosaveJournal
+#include "control/xojfile/ChunkedFormat.h"    // for MANIFEST_ENTRY, DOCUMENT_ENTRY
+#include "control/xojfile/XmlAttrs.h"         // for FILEVERSION_STR
+#include "control/xojfile/XmlParser.h"        // for XmlParser
+#include "model/BackgroundImage.h"            // for BackgroundImage
+#include "model/Document.h"                   // for Document
+#include "model/Font.h"                       // for XojFont
+#include "model/Image.h"                      // for Image
+#include "model/ImageDataPool.h"              // for ImageDataPool
+#include "model/Layer.h"                      // for Layer
+#include "model/Link.h"                       // for Link
+#include "model/PageContentLoader.h"          // for PageContentLoader
+#include "model/PageType.h"                   // for PageType, PageTypeFormat
+#include "model/Point.h"                      // for Point
+#include "model/Stroke.h"                     // for Stroke, StrokeCapStyle
+#include "model/TexImage.h"                   // for TexImage
+#include "model/Text.h"                       // for Text
+#include "model/XojPage.h"                    // for XojPage
+#include "util/Assert.h"                      // for xoj_assert
+#include "util/Color.h"                       // for Color
+#include "util/GzInputStream.h"               // for GzInputStream
+#include "util/GzUtil.h"                      // for GzUtil
+#include "util/LoopUtil.h"                    // for for_first_then_each
+#include "util/PathUtil.h"                    // for PathStorageMode
+#include "util/StringInputStream.h"           // for StringInputStream
+#include "util/StringUtils.h"                 // for char_cast
+#include "util/ZipInputStream.h"              // for ZipInputStream
+#include "util/i18n.h"                        // for _F, FS, _
+#include "util/raii/CLibrariesSPtr.h"         // for adopt
+#include "util/raii/GLibGuards.h"             // for GErrorGuard
+#include "util/raii/GObjectSPtr.h"            // for GObjectSPtr
 
 #include "filesystem.h"  // for path, is_regular_file
 
@@ -55,10 +68,190 @@
 namespace {
 constexpr size_t MAX_VERSION_LENGTH = 50;
 constexpr size_t MAX_MIMETYPE_LENGTH = 25;
+/// The smaller pages are not worth compressing while they wait to be parsed in lazy mode
+constexpr size_t MIN_DEFLATED_PAGE_SIZE = 1024;
 
 struct zip_file_deleter {
     void operator()(zip_file_t* ptr) noexcept { zip_fclose(ptr); }
 };
+
+/// Inflate raw deflate data (without zlib or gzip header), as stored in zip archives
+auto inflateRaw(const std::string& data, size_t size) -> std::optional<std::string> {
+    std::string result(size, '\0');
+    z_stream stream{};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return std::nullopt;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(result.data());
+    stream.avail_out = static_cast<uInt>(result.size());
+    const int ret = inflate(&stream, Z_FINISH);
+    const bool complete = ret == Z_STREAM_END && stream.total_out == size;
+    inflateEnd(&stream);
+    if (!complete) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+/// Parses the layers of a page from their XML text, the first time they are needed
+class LazyPageContents: public PageContentLoader {
+public:
+    /**
+     * @param inflatedSize If set, layersXml is compressed with deflate and has this size once inflated
+     * @param reportError If not set, the errors are only printed to the console
+     * @param imageAttachments The image attachments of the chunked archive the page comes from
+     */
+    LazyPageContents(std::string layersXml, fs::path filepath, int fileVersion,
+                     std::optional<size_t> inflatedSize = std::nullopt,
+                     LoadHandler::PageErrorReporter reportError = nullptr,
+                     std::shared_ptr<const LoadHandler::ImageAttachments> imageAttachments = nullptr):
+            layersXml(std::move(layersXml)),
+            filepath(std::move(filepath)),
+            fileVersion(fileVersion),
+            inflatedSize(inflatedSize),
+            reportError(std::move(reportError)),
+            imageAttachments(std::move(imageAttachments)) {}
+
+    auto loadLayers() -> std::vector<Layer*> override {
+        if (this->inflatedSize) {
+            auto inflated = inflateRaw(this->layersXml, *this->inflatedSize);
+            if (!inflated) {
+                this->error = _("The contents of the page are corrupted");
+                report(this->error);
+                return {};
+            }
+            this->layersXml = std::move(*inflated);
+        }
+
+        // Parse the layers as the only page of a document
+        std::string xml = std::string("<xournal ") + char_cast(xoj::xml_attrs::FILEVERSION_STR) + "=\"" +
+                          std::to_string(this->fileVersion) + "\"><page width=\"1\" height=\"1\">";
+        xml += std::exchange(this->layersXml, {});
+        xml += "</page></xournal>";
+        std::vector<std::string> errors;
+        std::vector<Layer*> layers;
+        try {
+            LoadHandler handler(&errors);
+            handler.setImageAttachments(this->imageAttachments);
+            auto doc = handler.loadDocument(std::make_unique<xoj::util::StringInputStream>(std::move(xml)),
+                                            this->filepath);
+            layers = std::exchange(doc->getPage(0)->getLayers(), {});
+        } catch (const std::runtime_error& e) {
+            // Nothing could be recovered: the page must not be saved without its layers
+            this->error = e.what();
+            errors.emplace_back(e.what());
+        }
+        if (this->reportError && !errors.empty()) {
+            // All the errors of the page at once: the reporter may show them to the user
+            std::string message = errors.front();
+            for (size_t i = 1; i < errors.size(); i++) {
+                message += "\n" + errors[i];
+            }
+            this->reportError(message);
+        }
+        return layers;
+    }
+
+    auto getError() const -> std::string override { return this->error; }
+
+private:
+    void report(const std::string& error) {
+        if (this->reportError) {
+            this->reportError(error);
+        } else {
+            g_warning("LoadHandler: Could not load the contents of a page: %s", error.c_str());
+        }
+    }
+
+private:
+    std::string layersXml;
+    fs::path filepath;
+    int fileVersion;
+    std::optional<size_t> inflatedSize;
+    LoadHandler::PageErrorReporter reportError;
+    std::shared_ptr<const LoadHandler::ImageAttachments> imageAttachments;
+    std::string error;
+};
+
+/// The contents of a page that are missing from the file: the page must not be saved
+class MissingPageContents: public PageContentLoader {
+public:
+    explicit MissingPageContents(std::string error): error(std::move(error)) {}
+
+    auto loadLayers() -> std::vector<Layer*> override { return {}; }
+    auto getError() const -> std::string override { return this->error; }
+
+private:
+    std::string error;
+};
+
+/// Position of a page whose layers can be parsed later
+struct LazyPageRange {
+    size_t pageBegin;
+    size_t layersBegin;
+    size_t layersEnd;
+};
+
+/**
+ * Find the next page, starting at `from`, whose children are a background and other tags, followed only by layers.
+ * Text nodes and attributes cannot contain '<' unescaped, so the tags can be found without parsing the contents.
+ */
+auto findLazyPage(std::string_view xml, size_t from) -> std::optional<LazyPageRange> {
+    constexpr std::string_view PAGE_TAG = "<page";
+    constexpr std::string_view PAGE_END = "</page>";
+    constexpr std::string_view LAYER_TAG = "<layer";
+    constexpr std::string_view LAYER_END = "</layer>";
+    constexpr auto npos = std::string_view::npos;
+
+    auto isTagAt = [xml](size_t pos, std::string_view tag) {
+        const size_t next = pos + tag.size();
+        return xml.compare(pos, tag.size(), tag) == 0 && next < xml.size() &&
+               (std::isspace(static_cast<unsigned char>(xml[next])) || xml[next] == '>' || xml[next] == '/');
+    };
+
+    for (size_t pageBegin = xml.find(PAGE_TAG, from); pageBegin != npos;
+         pageBegin = xml.find(PAGE_TAG, pageBegin + 1)) {
+        if (!isTagAt(pageBegin, PAGE_TAG)) {
+            continue;
+        }
+        const size_t headEnd = xml.find('>', pageBegin);
+        const size_t pageEnd = xml.find(PAGE_END, pageBegin);
+        if (headEnd == npos || pageEnd == npos) {
+            return std::nullopt;
+        }
+        if (xml[headEnd - 1] == '/') {
+            // Empty page
+            continue;
+        }
+        const size_t layersBegin = xml.find(LAYER_TAG, headEnd);
+        if (layersBegin >= pageEnd) {
+            continue;
+        }
+
+        bool onlyLayers = true;
+        for (size_t pos = layersBegin; onlyLayers;) {
+            pos = xml.find_first_not_of(" \t\r\n", pos);
+            if (pos == pageEnd) {
+                break;
+            }
+            const size_t tagEnd = xml.find('>', pos);
+            onlyLayers = pos != npos && isTagAt(pos, LAYER_TAG) && tagEnd < pageEnd;
+            if (onlyLayers && xml[tagEnd - 1] == '/') {
+                pos = tagEnd + 1;
+            } else if (onlyLayers) {
+                const size_t layerEnd = xml.find(LAYER_END, tagEnd);
+                onlyLayers = layerEnd < pageEnd;
+                pos = layerEnd + LAYER_END.size();
+            }
+        }
+        if (onlyLayers) {
+            return LazyPageRange{pageBegin, layersBegin, pageEnd};
+        }
+    }
+    return std::nullopt;
+}
 }  // namespace
 
 using zip_file_wrapper = std::unique_ptr<zip_file_t, zip_file_deleter>;
@@ -80,6 +273,17 @@ auto LoadHandler::getMissingPdfFilename() const -> const fs::path& { return this
 
 auto LoadHandler::getFileVersion() const -> int { return this->fileVersion; }
 
+void LoadHandler::setLazyLoading(bool lazy, PageErrorReporter reportPageError) {
+    this->lazyLoading = lazy;
+    this->lazyPageErrorReporter = std::move(reportPageError);
+}
+
+void LoadHandler::setParsingThreads(unsigned int threads) { this->parsingThreads = std::max(threads, 1U); }
+
+void LoadHandler::setImageAttachments(std::shared_ptr<const ImageAttachments> attachments) {
+    this->imageAttachments = std::move(attachments);
+}
+
 void LoadHandler::addDocument(std::u8string creator, int fileVersion) {
     this->creator = std::move(creator);
     if (this->isGzFile) {
@@ -94,6 +298,7 @@ void LoadHandler::finalizeDocument() {
 
     this->doc->addPages(this->pages.begin(), this->pages.end());
     this->pages.clear();
+    this->backgroundPixbufs.clear();
     this->parsingComplete = true;
 }
 
@@ -102,13 +307,30 @@ void LoadHandler::addPage(double width, double height) {
 
     this->page = std::make_shared<XojPage>(width, height, /*suppressLayerCreation*/ true);
     this->pages.emplace_back(this->page);
+
+    if (this->isChunkedFile) {
+        this->page->setContentLoader(readChunkedPage(this->pages.size() - 1));
+    } else if (this->lazyPageContents) {
+        std::string layers = std::move(*this->lazyPageContents);
+        this->lazyPageContents.reset();
+        std::optional<size_t> inflatedSize;
+        if (this->lazyLoading && layers.size() >= MIN_DEFLATED_PAGE_SIZE) {
+            // Kept until the page is needed: only keep it compressed, as in the chunked files
+            if (auto deflated = GzUtil::deflateRaw(layers, Z_BEST_SPEED)) {
+                inflatedSize = layers.size();
+                layers = std::move(*deflated);
+            }
+        }
+        this->page->setContentLoader(std::make_unique<LazyPageContents>(
+                std::move(layers), this->xournalFilepath, this->fileVersion, inflatedSize, getPageErrorReporter()));
+    }
 }
 
 void LoadHandler::finalizePage() {
     xoj_assert(this->page);
 
     // Handle unnecessary layer insertion in case of existing layers in file
-    if (this->page->getLayerCount() == 0) {
+    if (this->page->isContentLoaded() && this->page->getLayerCount() == 0) {
         this->page->addLayer(new Layer{});
     }
     // this->pages already holds a reference to the page
@@ -196,32 +418,20 @@ void LoadHandler::setBgPixmap(bool attach, const fs::path& filename) {
         const fs::path fileToLoad = getAbsoluteFilepath(filename, attach);
 
         xoj::util::GErrorGuard error{};
-        img.loadFile(fileToLoad, xoj::util::out_ptr(error));
+        img.loadFile(fileToLoad, xoj::util::out_ptr(error), &this->backgroundPixbufs);
 
         if (error) {
             logError(FS(_F("Could not read image: {1}. Error message: {2}") % fileToLoad.u8string() % error->message));
         }
     } else {
         // The image is stored in an attachment inside the zip archive
-        const auto readResult = readZipAttachment(filename);  // Do not remove the const qualifier - see below
+        auto readResult = readZipAttachment(filename);
         if (!readResult) {
             return;
         }
-        const std::string& imgData = *readResult;  // Do not remove the const qualifier - see below
-
-        /**
-         * To avoid an unnecessary copy, the data is still managed by the std::unique_ptr<std::string> instance. The
-         * input stream assumes the data will not be modified: do not remove the const qualifier on readResult or
-         * imgData
-         */
-        const xoj::util::GObjectSPtr<GInputStream> inputStream{
-                g_memory_input_stream_new_from_data(imgData.data(), static_cast<gssize>(imgData.size()), nullptr),
-                xoj::util::adopt};
 
         xoj::util::GErrorGuard error{};
-        img.loadFile(inputStream.get(), filename, xoj::util::out_ptr(error));
-
-        g_input_stream_close(inputStream.get(), nullptr, nullptr);
+        img.loadData(std::move(*readResult), filename, xoj::util::out_ptr(error), &this->backgroundPixbufs);
 
         if (error) {
             logError(FS(_F("Could not read image: {1}. Error message: {2}") % filename.u8string() % error->message));
@@ -316,7 +526,7 @@ void LoadHandler::addStroke(StrokeTool tool, Color color, double width, int fill
     setAudioAttributes(*this->stroke, std::move(filename), timestamp);
 }
 
-void LoadHandler::setStrokePoints(std::vector<Point> pointVector, bool hasPressure) {
+void LoadHandler::setStrokePoints(StrokePoints points, bool hasPressure) {
     // Check if stroke still exists or has already been assigned points.
     // In corrupt files, this function may be called more than once, and the
     // stroke may have been deleted in a previous call.
@@ -324,14 +534,20 @@ void LoadHandler::setStrokePoints(std::vector<Point> pointVector, bool hasPressu
         return;
     }
 
-    if (hasPressure && !std::ranges::all_of(
-                               pointVector | std::views::take(pointVector.size() - 1),
-                               [](double pressure) { return pressure > 0; }, &Point::z)) {
+    auto hasNonPositivePressure = [&points]() {
+        for (size_t i = 0; i + 1 < points.size(); i++) {
+            if (!(points.pressure(i) > 0)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (hasPressure && hasNonPositivePressure()) {
         // Warning: this may delete this->stroke if no positive pressure values are provided
         // Do not dereference this->stroke after that without checking first
-        fixNullPressureValues(std::move(pointVector));
+        fixNullPressureValues(points.toVector());
     } else {
-        this->stroke->setPointVector(std::move(pointVector));
+        this->stroke->setPointVector(std::move(points));
     }
 }
 
@@ -405,6 +621,16 @@ void LoadHandler::setImageAttachment(const fs::path& filename) {
         g_warning("LoadHandler: Image attachment found, but the image already has data");
     }
 
+    if (this->imageAttachments) {
+        const std::string name = char_cast(filename.u8string().c_str());
+        if (auto it = this->imageAttachments->find(name); it != this->imageAttachments->end()) {
+            this->image->setImage(it->second);
+        } else {
+            logError(FS(_F("Could not open attachment: {1}. Error message: {2}") % name % _("No such file")));
+        }
+        return;
+    }
+
     auto imageData = readZipAttachment(filename);
     if (imageData) {
         this->image->setImage(std::move(*imageData));
@@ -486,6 +712,7 @@ void LoadHandler::finalizeLink() {
 
 void LoadHandler::logError(const std::string& error) {
     g_warning("LoadHandler: %s", error.c_str());
+    std::lock_guard lock(this->errorMutex);
     if (this->errorMessages) {
         this->errorMessages->emplace_back(error);
     }
@@ -515,7 +742,12 @@ auto LoadHandler::openFile(fs::path const& filepath) -> std::unique_ptr<xoj::uti
         std::array<char, MAX_MIMETYPE_LENGTH + 1> mimetype = {};
         // read the mimetype and a few more bytes to make sure we do not only read a subset
         zip_fread(mimetypeFp.get(), mimetype.data(), MAX_MIMETYPE_LENGTH);
-        if (!strcmp(mimetype.data(), "application/xournal++")) {
+        // The mimetype may end with a line break
+        std::string_view mimetypeView = mimetype.data();
+        while (!mimetypeView.empty() && std::isspace(static_cast<unsigned char>(mimetypeView.back()))) {
+            mimetypeView.remove_suffix(1);
+        }
+        if (mimetypeView != "application/xournal++") {
             throw std::runtime_error{FS(_F("The file \"{1}\" is no valid .xopp file (Mimetype wrong): \"{2}\"") %
                                         filepath.u8string() % mimetype.data())};
         }
@@ -541,6 +773,15 @@ auto LoadHandler::openFile(fs::path const& filepath) -> std::unique_ptr<xoj::uti
                        filepath.u8string() % std::string(versionString.begin(), versionString.end()))};
         }
 
+        if (zip_name_locate(this->zipFp.get(), xoj::chunked_format::MANIFEST_ENTRY, 0) >= 0) {
+            readManifest();
+            readImageAttachments();
+            this->isChunkedFile = true;
+            // The attachments of chunked archives are next to the file, as for gzip files
+            this->isGzFile = true;
+            return std::make_unique<xoj::util::ZipInputStream>(this->zipFp.get(), xoj::chunked_format::DOCUMENT_ENTRY);
+        }
+
         // open the main content file
         return std::make_unique<xoj::util::ZipInputStream>(this->zipFp.get(), "content.xml");
     }
@@ -549,6 +790,94 @@ auto LoadHandler::openFile(fs::path const& filepath) -> std::unique_ptr<xoj::uti
     throw std::runtime_error{FS(_F("Could not open file: \"{1}\"") % filepath.u8string())};
 }
 
+void LoadHandler::readManifest() {
+    auto manifest = readZipAttachment(xoj::chunked_format::MANIFEST_ENTRY);
+    std::istringstream in(manifest ? *manifest : std::string());
+    std::string header;
+    size_t count = 0;
+    if (!(in >> header >> count) || header != xoj::chunked_format::MANIFEST_HEADER) {
+        throw std::runtime_error{FS(_F("The file \"{1}\" is not a valid .xopp file (Page manifest corrupted)") %
+                                    this->xournalFilepath.u8string())};
+    }
+    this->chunkedPages.clear();
+    for (size_t i = 0; i < count; i++) {
+        ChunkedPage page;
+        if (!(in >> page.entry >> page.size)) {
+            throw std::runtime_error{FS(_F("The file \"{1}\" is not a valid .xopp file (Page manifest corrupted)") %
+                                        this->xournalFilepath.u8string())};
+        }
+        this->chunkedPages.emplace_back(std::move(page));
+    }
+}
+
+void LoadHandler::readImageAttachments() {
+    auto attachments = std::make_shared<ImageAttachments>();
+    const zip_int64_t count = zip_get_num_entries(this->zipFp.get(), 0);
+    for (zip_int64_t i = 0; i < count; i++) {
+        const char* name = zip_get_name(this->zipFp.get(), static_cast<zip_uint64_t>(i), 0);
+        if (!name || !std::string_view(name).starts_with(xoj::chunked_format::IMAGES_DIR)) {
+            continue;
+        }
+        if (auto data = readZipAttachment(name)) {
+            attachments->emplace(name, ImageDataPool::getInstance().intern(std::move(*data)));
+        }
+    }
+    this->imageAttachments = std::move(attachments);
+}
+
+auto LoadHandler::readChunkedPage(size_t index) -> std::unique_ptr<PageContentLoader> {
+    // The page is still created, but cannot be saved without its contents
+    auto missing = [&](const std::string& error) -> std::unique_ptr<PageContentLoader> {
+        logError(error);
+        return std::make_unique<MissingPageContents>(error);
+    };
+    if (index >= this->chunkedPages.size()) {
+        return missing(FS(_F("The contents of page {1} are missing") % (index + 1)));
+    }
+    const ChunkedPage& entry = this->chunkedPages[index];
+    zip_stat_t stat;
+    if (zip_stat(this->zipFp.get(), entry.entry.c_str(), 0, &stat) != 0 || !(stat.valid & ZIP_STAT_COMP_METHOD) ||
+        !(stat.valid & ZIP_STAT_COMP_SIZE) || !(stat.valid & ZIP_STAT_SIZE) || stat.size != entry.size) {
+        return missing(FS(_F("The contents of page {1} are missing") % (index + 1)));
+    }
+
+    if (stat.comp_method != ZIP_CM_DEFLATE) {
+        // Stored, or compressed with another method: let libzip decompress it now
+        auto data = readZipAttachment(entry.entry);
+        if (!data) {
+            return std::make_unique<MissingPageContents>(FS(_F("The contents of page {1} are missing") % (index + 1)));
+        }
+        return std::make_unique<LazyPageContents>(std::move(*data), this->xournalFilepath, this->fileVersion,
+                                                  std::nullopt, getPageErrorReporter(), this->imageAttachments);
+    }
+
+    // Keep the compressed data, which is only inflated when the page is needed
+    auto file = zip_file_wrapper{zip_fopen_index(this->zipFp.get(), stat.index, ZIP_FL_COMPRESSED)};
+    if (!file) {
+        return missing(FS(_F("Could not open attachment: {1}. Error message: {2}") % entry.entry %
+                          zip_error_strerror(zip_get_error(this->zipFp.get()))));
+    }
+    std::string data(stat.comp_size, '\0');
+    zip_uint64_t readBytes = 0;
+    while (readBytes < stat.comp_size) {
+        const zip_int64_t read = zip_fread(file.get(), data.data() + readBytes, stat.comp_size - readBytes);
+        if (read <= 0) {
+            return missing(FS(_F("Could not open attachment: {1}. Error message: Could not read file") % entry.entry));
+        }
+        readBytes += static_cast<zip_uint64_t>(read);
+    }
+    return std::make_unique<LazyPageContents>(std::move(data), this->xournalFilepath, this->fileVersion, entry.size,
+                                              getPageErrorReporter(), this->imageAttachments);
+}
+
+auto LoadHandler::getPageErrorReporter() -> PageErrorReporter {
+    if (this->lazyLoading) {
+        // The error messages may not be read anymore when the page is loaded
+        return this->lazyPageErrorReporter;
+    }
+    return [this](const std::string& error) { logError(error); };
+}
+
 void LoadHandler::closeFile() noexcept { this->zipFp.reset(); }
 
 XOJ_GIO_GUARD_GENERATOR_TYPE(GMarkupParseContext, g_markup_parse_context_free);
@@ -566,9 +895,20 @@ void LoadHandler::parseXml(std::unique_ptr<xoj::util::InputStream> xmlContentStr
         }
     };
 
+    xoj::util::GErrorGuard error;
+    const auto parse = [&](std::string_view text) -> void {
+        auto valid = g_markup_parse_context_parse(context.get(), text.data(), static_cast<gssize>(text.size()),
+                                                  xoj::util::out_ptr(error));
+        handleGError(std::move(error));
+        if (!valid) {
+            throw std::runtime_error{_("Invalid XML data read")};
+        }
+    };
+
     std::array<char, 1024> buffer{};
     int len{};
-    xoj::util::GErrorGuard error;
+    // In lazy or parallel mode, the whole text is read first to find the layers of the pages
+    std::string xml;
     while (true) {
         len = xmlContentStream->read(buffer.data(), buffer.size());
         if (len < 0) {
@@ -578,13 +918,28 @@ void LoadHandler::parseXml(std::unique_ptr<xoj::util::InputStream> xmlContentStr
             break;
         }
 
-        auto valid = g_markup_parse_context_parse(context.get(), buffer.data(), len, xoj::util::out_ptr(error));
-        handleGError(std::move(error));
-        if (!valid) {
-            throw std::runtime_error{_("Invalid XML data read")};
+        if ((this->lazyLoading || this->parsingThreads > 1) && this->isGzFile) {
+            xml.append(buffer.data(), static_cast<size_t>(len));
+        } else {
+            parse({buffer.data(), static_cast<size_t>(len)});
         }
     }
 
+    size_t parsed = 0;
+    while (auto range = findLazyPage(xml, parsed)) {
+        parse(std::string_view(xml).substr(parsed, range->pageBegin - parsed));
+        // The page is created while its opening tag is parsed, and takes the text of its layers
+        this->lazyPageContents = xml.substr(range->layersBegin, range->layersEnd - range->layersBegin);
+        parse(std::string_view(xml).substr(range->pageBegin, range->layersBegin - range->pageBegin));
+        if (this->lazyPageContents) {
+            // The page tag was not recognized: parse the layers now, to report the same errors as usual
+            parse(*this->lazyPageContents);
+            this->lazyPageContents.reset();
+        }
+        parsed = range->layersEnd;
+    }
+    parse(std::string_view(xml).substr(parsed));
+
     // Sanity checks for document validity
     if (!g_markup_parse_context_end_parse(context.get(), xoj::util::out_ptr(error)) || !this->parsingComplete) {
         handleGError(std::move(error));
@@ -607,6 +962,36 @@ void LoadHandler::parseXml(std::unique_ptr<xoj::util::InputStream> xmlContentStr
     if (this->doc->getPageCount() == 0) {
         throw std::runtime_error{_("Document is corrupted (no pages found in file)")};
     }
+
+    if (!this->lazyLoading) {
+        loadPageContents();
+    }
+}
+
+void LoadHandler::loadPageContents() {
+    std::vector<PageRef> pending;
+    for (size_t i = 0; i < this->doc->getPageCount(); i++) {
+        if (auto p = this->doc->getPage(i); !p->isContentLoaded()) {
+            pending.emplace_back(std::move(p));
+        }
+    }
+
+    // The pages are independent documents: each thread takes the next page until all of them are parsed
+    std::atomic<size_t> next = 0;
+    auto parsePages = [&]() {
+        for (size_t i = next++; i < pending.size(); i = next++) {
+            pending[i]->getLayerCount();
+        }
+    };
+    const size_t threads = std::min<size_t>(this->parsingThreads, pending.size());
+    std::vector<std::future<void>> workers;
+    for (size_t t = 1; t < threads; t++) {
+        workers.emplace_back(std::async(std::launch::async, parsePages));
+    }
+    parsePages();
+    for (auto& worker: workers) {
+        worker.get();
+    }
 }
 
 
@@ -618,6 +1003,13 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> std::unique_ptr<Docu
     xoj_assert(this->doc);
     this->doc->setCreateBackupOnSave(true);
 
+    // Recover the changes written to the journal of an autosave file
+    try {
+        AutosaveJournal::replay(*this->doc, filepath);
+    } catch (const std::runtime_error& e) {
+        logError(FS(_F("Could not recover the changes from the autosave journal: {1}") % e.what()));
+    }
+
     if (this->fileVersion == 1 || (this->errorMessages && !this->errorMessages->empty())) {
         // Either, this file was created by Xournal, not Xournal++, or loading
         // the file failed to some extent (i.e. file is corrupt or uses unknown
@@ -635,6 +1027,16 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> std::unique_ptr<Docu
 }
 
 
+auto LoadHandler::loadDocument(std::unique_ptr<xoj::util::InputStream> xmlContentStream, fs::path const& filepath)
+        -> std::unique_ptr<Document> {
+    this->xournalFilepath = filepath;
+    this->isGzFile = true;
+    parseXml(std::move(xmlContentStream));
+
+    xoj_assert(this->doc);
+    return std::move(this->doc);
+}
+
 void LoadHandler::fixNullPressureValues(std::vector<Point> pts) {
     /*
      * Due to various bugs (see e.g. https://github.com/xournalpp/xournalpp/issues/3643), old files may contain strokes
@@ -12,7 +12,9 @@
 #pragma once
 
 #include <cstddef>        // for size_t
+#include <functional>     // for function
 #include <memory>         // for unique_ptr
+#include <mutex>          // for mutex
 #include <optional>       // for optional
 #include <string>         // for string
 #include <string_view>    // for string_view
@@ -22,6 +24,7 @@
 #include <zip.h>  // for zip_t
 
 #include "control/xojfile/DocumentBuilderInterface.h"  // for DocumentBuilderInterface
+#include "model/BackgroundImage.h"                     // for BackgroundImage
 #include "model/Document.h"                            // for Document
 #include "model/DocumentHandler.h"                     // for DocumentHandler
 #include "model/PageRef.h"                             // for PageRef
@@ -40,6 +43,7 @@ class TexImage;
 class Text;
 class TextAlignment;
 class Link;
+class PageContentLoader;
 
 namespace xoj::util {
 class InputStream;
@@ -67,6 +71,15 @@ public:
      */
     std::unique_ptr<Document> loadDocument(fs::path const& filepath);
 
+    /**
+     * Load a document from an uncompressed XML stream
+     * @param filepath The path of the document, used to find the attached files
+     * @return A valid pointer to a `Document`
+     * @exception Throws a `std::runtime_error` if a fatal error is encountered.
+     */
+    std::unique_ptr<Document> loadDocument(std::unique_ptr<xoj::util::InputStream> xmlContentStream,
+                                           fs::path const& filepath);
+
     /**
      * The attached PDF file was not found.
      * Here "attached" refers to either a file in the zip archive, or a file in
@@ -81,6 +94,35 @@ public:
     /** @return The version of the loaded file */
     int getFileVersion() const;
 
+    /// Receives the errors of the pages parsed after the document was loaded, possibly from another thread
+    using PageErrorReporter = std::function<void(const std::string&)>;
+
+    /**
+     * Only create the pages and their backgrounds when loading a .xopp/.xoj file: the layers of each page are parsed
+     * the first time they are needed (see XojPage::setContentLoader()), and are kept compressed until then. The whole
+     * file is still read while it is loaded. Zip archives are always loaded entirely, except the chunked ones (see
+     * ChunkedFormat.h), whose pages are read from the archive and parsed when they are needed.
+     * @param reportPageError Receives the errors of each page when it is parsed, all at once. If not set, they are
+     * only printed to the console.
+     */
+    void setLazyLoading(bool lazy, PageErrorReporter reportPageError = nullptr);
+
+    /**
+     * Parse the pages of .xopp/.xoj files on several threads: the document and the backgrounds are parsed first, then
+     * the layers of the pages are parsed concurrently. Ignored in lazy mode.
+     * @param threads The number of threads, 1 to parse the file in one go
+     */
+    void setParsingThreads(unsigned int threads);
+
+    /// The data of the images stored in a chunked archive, by entry name (see ChunkedFormat.h)
+    using ImageAttachments = std::unordered_map<std::string, std::shared_ptr<const std::string>>;
+
+    /**
+     * Take the data of the image attachments from `attachments` instead of the zip archive: the layers of the pages of
+     * chunked archives are parsed apart from the archive.
+     */
+    void setImageAttachments(std::shared_ptr<const ImageAttachments> attachments);
+
 private:
     // interface for XmlParser
     void addDocument(std::u8string creator, int fileVersion) override;
@@ -98,7 +140,7 @@ private:
     void finalizeLayer() override;
     void addStroke(StrokeTool tool, Color color, double width, int fill, StrokeCapStyle capStyle,
                    const LineStyle& lineStyle, fs::path filename, size_t timestamp) override;
-    void setStrokePoints(std::vector<Point> pointVector, bool hasPressure) override;
+    void setStrokePoints(StrokePoints points, bool hasPressure) override;
     void finalizeStroke() override;
     void addText(std::string font, double size, double x, double y, Color color, std::optional<double> wrap,
                  std::optional<TextAlignment> align, bool justify, fs::path filename, size_t timestamp) override;
@@ -126,12 +168,28 @@ private:
      * If the file is a zip file, initializes `zipFp` for access to the other
      * files in the archive.
      * @return A pointer to an XML input stream, reading either directly from
-     *          the gzip file, or from "content.xml" in the zip archive
+     *          the gzip file, or from "content.xml" in the zip archive, or
+     *          from "document.xml" in a chunked archive
      * @exception Throws a `std::runtime_error` if the file could not be opened
      *            or required contents could not be found.
      */
     std::unique_ptr<xoj::util::InputStream> openFile(fs::path const& filepath);
 
+    /**
+     * Read the manifest of a chunked archive into `chunkedPages`
+     * @exception Throws a `std::runtime_error` if the manifest is corrupted.
+     */
+    void readManifest();
+
+    /**
+     * Read the (compressed) layers of the page of a chunked archive
+     * @return The loader parsing them, or nullptr if they cannot be read
+     */
+    std::unique_ptr<PageContentLoader> readChunkedPage(size_t index);
+
+    /// Read the image attachments of a chunked archive into `imageAttachments`
+    void readImageAttachments();
+
     /** Reset `zipFp`, closing the zip archive if it is open. */
     void closeFile() noexcept;
 
@@ -145,6 +203,15 @@ private:
      */
     void parseXml(std::unique_ptr<xoj::util::InputStream> xmlContentStream);
 
+    /** Parse the layers of the pages that were not parsed with the document, on `parsingThreads` threads */
+    void loadPageContents();
+
+    /**
+     * @return The function reporting the errors of the pages parsed after the document: in lazy mode, the one given
+     *         to setLazyLoading()
+     */
+    PageErrorReporter getPageErrorReporter();
+
     /**
      * Remove points of the current `stroke` that have an invalid pressure.
      * Splits up the stroke into valid segments and adds them to the layer,
@@ -193,8 +260,27 @@ private:
     zip_wrapper zipFp;
     bool isGzFile;
 
+    /// The pages entries of a chunked archive, with their uncompressed size
+    struct ChunkedPage {
+        std::string entry;
+        size_t size;
+    };
+    std::vector<ChunkedPage> chunkedPages;
+    bool isChunkedFile = false;
+    std::shared_ptr<const ImageAttachments> imageAttachments;
+
     std::vector<PageRef> pages;
     std::unordered_map<fs::path, fs::path> audioFiles;
+    /// The pages of the document whose background images have identical data share the decoded image
+    BackgroundImage::PixbufPool backgroundPixbufs;
+
+    bool lazyLoading = false;
+    PageErrorReporter lazyPageErrorReporter;
+    unsigned int parsingThreads = 1;
+    /// The errors of the pages can be reported by several threads
+    std::mutex errorMutex;
+    /// The text of the layers of the next page, in lazy mode
+    std::optional<std::string> lazyPageContents;
 
     PageRef page;
     std::unique_ptr<Layer> layer;
@@ -1,13 +1,21 @@
 #include "SaveHandler.h"
 
-#include <cinttypes>   // for PRIx32
-#include <cstdint>     // for uint32_t
-#include <cstdio>      // for sprintf, size_t
+#include <algorithm>    // for min, max, copy_n
+#include <cinttypes>    // for PRIx32
+#include <cstdint>      // for uint32_t
+#include <cstdio>       // for sprintf, size_t
+#include <string>       // for string, to_string
+#include <string_view>  // for string_view
+#include <utility>      // for exchange
+#include <vector>       // for vector
 
 #include <cairo.h>                  // for cairo_surface_t
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_save
 #include <glib.h>                   // for g_free, g_strdup_printf
+#include <zip.h>                    // for zip_open, zip_file_add, zip_close
+#include <zlib.h>                   // for crc32
 
+#include "control/jobs/ProgressListener.h"     // for ProgressListener
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
 #include "control/xml/XmlAudioNode.h"          // for XmlAudioNode
 #include "control/xml/XmlImageNode.h"          // for XmlImageNode
@@ -15,6 +23,7 @@
 #include "control/xml/XmlPointNode.h"          // for XmlPointNode
 #include "control/xml/XmlTexNode.h"            // for XmlTexNode
 #include "control/xml/XmlTextNode.h"           // for XmlTextNode
+#include "control/xojfile/ChunkedFormat.h"     // for getPageEntry, getImageEntry, MANIFEST_ENTRY
 #include "control/xojfile/XmlAttrs.h"          // for xml_attrs
 #include "control/xojfile/XmlTags.h"           // for xml_tags
 #include "control/xojfile/XmlValues.h"         // for xml_values
@@ -35,9 +44,11 @@
 #include "model/Text.h"                        // for Text
 #include "model/XojPage.h"                     // for XojPage
 #include "pdf/base/XojPdfDocument.h"           // for XojPdfDocument
-#include "util/OutputStream.h"                 // for GzOutputStream, Output...
+#include "util/GzUtil.h"                       // for GzUtil
+#include "util/OutputStream.h"                 // for GzOutputStream, GzCom...
 #include "util/PathUtil.h"                     // for clearExtensions, normalizeAssetPath
 #include "util/PlaceholderString.h"            // for PlaceholderString
+#include "util/StringUtils.h"                  // for char_cast
 #include "util/i18n.h"                         // for FS, _F
 
 #include "config.h"  // for FILE_FORMAT_VERSION
@@ -47,16 +58,115 @@
 static constexpr auto& TAG_NAMES = xoj::xml_tags::NAMES;
 using TagType = xoj::xml_tags::Type;
 
+namespace {
+auto writePngToString(void* closure, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/// State of a zip source reading a SaveHandler::CompressedEntry
+struct CompressedSource {
+    const std::string& data;
+    size_t size;
+    uint32_t crc;
+    size_t offset = 0;
+    zip_error_t error{};
+};
+
+/// zip_source_callback for the already deflated entries: their stat tells libzip to copy them as they are
+auto readCompressedEntry(void* userdata, void* buffer, zip_uint64_t length, zip_source_cmd_t cmd) -> zip_int64_t {
+    auto* source = static_cast<CompressedSource*>(userdata);
+    switch (cmd) {
+        case ZIP_SOURCE_OPEN:
+            source->offset = 0;
+            return 0;
+        case ZIP_SOURCE_READ: {
+            const size_t n = std::min(static_cast<size_t>(length), source->data.size() - source->offset);
+            std::copy_n(source->data.data() + source->offset, n, static_cast<char*>(buffer));
+            source->offset += n;
+            return static_cast<zip_int64_t>(n);
+        }
+        case ZIP_SOURCE_CLOSE:
+            return 0;
+        case ZIP_SOURCE_STAT: {
+            auto* st = static_cast<zip_stat_t*>(buffer);
+            zip_stat_init(st);
+            st->size = source->size;
+            st->comp_size = source->data.size();
+            st->comp_method = ZIP_CM_DEFLATE;
+            st->crc = source->crc;
+            st->valid |= ZIP_STAT_SIZE | ZIP_STAT_COMP_SIZE | ZIP_STAT_COMP_METHOD | ZIP_STAT_CRC;
+            return sizeof(zip_stat_t);
+        }
+        case ZIP_SOURCE_ERROR:
+            return zip_error_to_data(&source->error, buffer, length);
+        case ZIP_SOURCE_FREE:
+            zip_error_fini(&source->error);
+            delete source;
+            return 0;
+        case ZIP_SOURCE_SUPPORTS:
+            return zip_source_make_command_bitmap(ZIP_SOURCE_OPEN, ZIP_SOURCE_READ, ZIP_SOURCE_CLOSE, ZIP_SOURCE_STAT,
+                                                  ZIP_SOURCE_ERROR, ZIP_SOURCE_FREE, -1);
+        default:
+            zip_error_set(&source->error, ZIP_ER_OPNOTSUPP, 0);
+            return -1;
+    }
+}
+
+/**
+ * @return The "content.xml" of the chunked archives (see ChunkedFormat.h): a single page telling the older versions,
+ * which only read this entry, that the file needs a newer version
+ */
+auto getFallbackDocument() -> std::string {
+    using xoj::xml_attrs::BackgroundType;
+    XmlNode root(TAG_NAMES[TagType::XOURNAL]);
+    root.setAttrib(xoj::xml_attrs::CREATOR_STR, PROJECT_STRING);
+    root.setAttrib(xoj::xml_attrs::FILEVERSION_STR, FILE_FORMAT_VERSION);
+
+    // A4
+    auto* page = new XmlNode(TAG_NAMES[TagType::PAGE]);
+    root.addChild(page);
+    page->setAttrib(xoj::xml_attrs::WIDTH_STR, 595.275591);
+    page->setAttrib(xoj::xml_attrs::HEIGHT_STR, 841.889764);
+
+    auto* background = new XmlNode(TAG_NAMES[TagType::BACKGROUND]);
+    page->addChild(background);
+    background->setAttrib(xoj::xml_attrs::TYPE_STR, BackgroundType::NAMES[BackgroundType::SOLID]);
+    background->setAttrib(xoj::xml_attrs::COLOR_STR, "#ffffffff");
+    background->setAttrib(xoj::xml_attrs::STYLE_STR, "plain");
+
+    auto* layer = new XmlNode(TAG_NAMES[TagType::LAYER]);
+    page->addChild(layer);
+    auto* text = new XmlTextNode(TAG_NAMES[TagType::TEXT],
+                                 FS(_F("This file was written by {1} in a format that this version cannot read.\n"
+                                       "Open it with a newer version, or convert it with\n"
+                                       "xournalpp --convert=<file>\n"
+                                       "Do not save it with this version: its contents would be lost.") %
+                                    PROJECT_STRING));
+    layer->addChild(text);
+    text->setAttrib(xoj::xml_attrs::FONT_STR, "Sans");
+    text->setAttrib(xoj::xml_attrs::SIZE_STR, 12.0);
+    text->setAttrib(xoj::xml_attrs::X_COORD_STR, 40.0);
+    text->setAttrib(xoj::xml_attrs::Y_COORD_STR, 40.0);
+    text->setAttrib(xoj::xml_attrs::COLOR_STR, "#000000ff");
+
+    StringOutputStream out;
+    out.write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
+    root.writeOut(&out);
+    return out.takeString();
+}
+}  // namespace
+
 SaveHandler::SaveHandler() {
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
 }
 
-void SaveHandler::prepareSave(const Document* doc, const fs::path& target) {
-    if (this->root) {
-        // cleanup old data
-        backgroundImages.clear();
-    }
+void SaveHandler::prepareRoot(const Document* doc, bool withPreview) {
+    backgroundImages.clear();
+    attachedImages.clear();
+    attachedImageIndex.clear();
+    encodedImages.clear();
 
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
@@ -66,7 +176,7 @@ void SaveHandler::prepareSave(const Document* doc, const fs::path& target) {
     writeHeader();
 
     auto preview = doc->getPreview();
-    if (preview) {
+    if (withPreview && preview) {
         auto* image = new XmlImageNode(TAG_NAMES[TagType::PREVIEW]);
         image->setImage(preview.get());
         this->root->addChild(image);
@@ -76,6 +186,11 @@ void SaveHandler::prepareSave(const Document* doc, const fs::path& target) {
         PageRef p = doc->getPage(i);
         p->getBackgroundImage().clearSaveState();
     }
+}
+
+void SaveHandler::prepareSave(const Document* doc, const fs::path& target) {
+    this->streaming = false;
+    prepareRoot(doc, true);
 
     for (size_t i = 0; i < doc->getPageCount(); i++) {
         PageRef p = doc->getPage(i);
@@ -128,7 +243,12 @@ void SaveHandler::visitStroke(XmlPointNode* stroke, const Stroke* s) {
 
     const auto& pts = s->getPointVector();
 
-    stroke->setPoints(pts);
+    if (this->streaming) {
+        // The node is written before the stroke can change
+        stroke->setPointsRef(&pts);
+    } else {
+        stroke->setPoints(pts);
+    }
 
     if (s->hasPressure()) {
         std::vector<double> values;
@@ -208,10 +328,11 @@ void SaveHandler::visitLayer(XmlNode* page, const Layer* l) {
             writeTimestamp(text, t);
         } else if (e->getType() == ELEMENT_IMAGE) {
             auto* i = dynamic_cast<const Image*>(e);
-            auto* image = new XmlImageNode(TAG_NAMES[TagType::IMAGE]);
+            XmlNode* image = this->attachImages ? new XmlNode(TAG_NAMES[TagType::IMAGE]) :
+                                                  new XmlImageNode(TAG_NAMES[TagType::IMAGE]);
             layer->addChild(image);
 
-            image->setImage(i->getImage());
+            writeImageData(image, i);
 
             Range r(i->getBoundingBox());
             image->setAttrib(xoj::xml_attrs::LEFT_POS_STR, r.minX);
@@ -305,7 +426,19 @@ void SaveHandler::visitPage(XmlNode* root, ConstPageRef p, const Document* doc,
     } else if (p->getBackgroundType().isImagePage()) {
         background->setAttrib(xoj::xml_attrs::TYPE_STR, BackgroundType::NAMES[BackgroundType::PIXMAP]);
 
-        int cloneId = p->getBackgroundImage().getCloneId();
+        const BackgroundImage& img = p->getBackgroundImage();
+        int cloneId = img.getCloneId();
+        if (cloneId == -1) {
+            // The page may share the image with a previous page: cloned, or attached with the same decoded image (see
+            // BackgroundImage::PixbufPool), which is then only attached once
+            auto it = std::find_if(backgroundImages.begin(), backgroundImages.end(), [&](const ImageInfo& info) {
+                return info.image == img || (info.newPath && img.isAttached() && img.getPixbuf() &&
+                                             info.image.getPixbuf() == img.getPixbuf());
+            });
+            if (it != backgroundImages.end()) {
+                cloneId = it->newId;
+            }
+        }
         if (cloneId != -1) {
             background->setAttrib(xoj::xml_attrs::DOMAIN_STR, Domain::NAMES[Domain::CLONE]);
             char* filename = g_strdup_printf("%i", cloneId);
@@ -365,7 +498,7 @@ void SaveHandler::writeBackgroundName(XmlNode* background, ConstPageRef p) {
 }
 
 void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
-    GzOutputStream out(filepath);
+    GzOutputStream out(filepath, this->compression);
 
     if (!out.getLastError().empty()) {
         this->errorMessage = out.getLastError();
@@ -385,6 +518,343 @@ void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressLi
     out->write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
     root->writeOut(out, listener);
 
+    writeBackgroundImages(filepath);
+}
+
+void SaveHandler::saveDocumentTo(const Document* doc, const fs::path& target, const fs::path& filepath,
+                                 ProgressListener* listener) {
+    // Before the file is truncated
+    if (!checkPageContents(doc, nullptr)) {
+        return;
+    }
+    GzOutputStream out(filepath, this->compression);
+
+    if (!out.getLastError().empty()) {
+        this->errorMessage = out.getLastError();
+        return;
+    }
+
+    saveDocumentTo(doc, target, &out, filepath, listener);
+
+    out.close();
+
+    if (this->errorMessage.empty()) {
+        this->errorMessage = out.getLastError();
+    }
+}
+
+void SaveHandler::saveDocumentTo(const Document* doc, const fs::path& target, OutputStream* out,
+                                 const fs::path& filepath, ProgressListener* listener) {
+    if (streamPages(doc, nullptr, target, out, listener)) {
+        writeBackgroundImages(filepath);
+    }
+}
+
+void SaveHandler::savePagesTo(const Document* doc, const std::vector<size_t>& pages, const fs::path& target,
+                              OutputStream* out, const fs::path& filepath) {
+    if (streamPages(doc, &pages, target, out, nullptr)) {
+        writeBackgroundImages(filepath);
+    }
+}
+
+auto SaveHandler::serializeDocument(const Document* doc, const fs::path& target, bool chunked,
+                                    ProgressListener* listener) -> bool {
+    this->serializedChunked = chunked;
+    if (chunked) {
+        this->isSerialized = serializeChunked(doc, target, listener);
+    } else {
+        // Compressed while it is serialized: only the compressed document is kept in memory
+        this->serialized = std::make_unique<GzStringOutputStream>(this->compression);
+        this->isSerialized = streamPages(doc, nullptr, target, this->serialized.get(), listener);
+        if (!this->isSerialized) {
+            this->serialized.reset();
+        }
+    }
+    return this->isSerialized;
+}
+
+void SaveHandler::writeSerializedTo(const fs::path& filepath) {
+    if (!std::exchange(this->isSerialized, false)) {
+        return;
+    }
+    if (this->serializedChunked) {
+        writeChunkedTo(filepath);
+        this->chunkedEntries = {};
+        return;
+    }
+
+    auto serialized = std::move(this->serialized);
+    if (!serialized->writeTo(filepath)) {
+        this->errorMessage = serialized->getLastError();
+        return;
+    }
+
+    writeBackgroundImages(filepath);
+}
+
+auto SaveHandler::checkPageContents(const Document* doc, const std::vector<size_t>* pages) -> bool {
+    bool complete = true;
+    const size_t pageCount = pages ? pages->size() : doc->getPageCount();
+    for (size_t i = 0; i < pageCount; i++) {
+        const size_t index = pages ? (*pages)[i] : i;
+        const auto error = doc->getPage(index)->getContentError();
+        if (error.empty()) {
+            continue;
+        }
+        if (!this->errorMessage.empty()) {
+            this->errorMessage += "\n";
+        }
+        this->errorMessage += FS(_F("Page {1} could not be loaded entirely: {2}\n"
+                                    "Saving it would lose the rest of its contents. Delete the page to save the "
+                                    "document.") %
+                                 (index + 1) % error);
+        complete = false;
+    }
+    return complete;
+}
+
+auto SaveHandler::streamPages(const Document* doc, const std::vector<size_t>* pages, const fs::path& target,
+                              OutputStream* out, ProgressListener* listener) -> bool {
+    if (!checkPageContents(doc, pages)) {
+        return false;
+    }
+    this->streaming = true;
+    prepareRoot(doc, pages == nullptr);
+
+    out->write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
+    root->writeOpeningTag(out);
+    root->writeChildren(out);
+
+    const size_t pageCount = pages ? pages->size() : doc->getPageCount();
+    if (listener) {
+        listener->setMaximumState(pageCount);
+    }
+    for (size_t i = 0; i < pageCount; i++) {
+        // Only the nodes of the current page are in memory
+        XmlNode parent(TAG_NAMES[TagType::XOURNAL]);
+        visitPage(&parent, doc->getPage(pages ? (*pages)[i] : i), doc, static_cast<int>(i), target);
+        parent.writeChildren(out);
+        if (listener) {
+            listener->setCurrentState(i + 1);
+        }
+    }
+
+    root->writeClosingTag(out);
+    root.reset();
+    this->streaming = false;
+    return true;
+}
+
+void SaveHandler::saveChunkedTo(const Document* doc, const fs::path& target, const fs::path& filepath,
+                                ProgressListener* listener) {
+    if (serializeChunked(doc, target, listener)) {
+        writeChunkedTo(filepath);
+    }
+    this->chunkedEntries = {};
+}
+
+auto SaveHandler::serializeChunked(const Document* doc, const fs::path& target, ProgressListener* listener) -> bool {
+    namespace chunked = xoj::chunked_format;
+    if (!checkPageContents(doc, nullptr)) {
+        return false;
+    }
+    this->streaming = true;
+    this->attachImages = true;
+    prepareRoot(doc, false);
+
+    StringOutputStream skeleton;
+    skeleton.write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
+    root->writeOpeningTag(&skeleton);
+    root->writeChildren(&skeleton);
+
+    const size_t pageCount = doc->getPageCount();
+    if (listener) {
+        listener->setMaximumState(pageCount);
+    }
+    ChunkedEntries& entries = this->chunkedEntries;
+    entries.pages.clear();
+    entries.pages.reserve(pageCount);
+    entries.manifest = std::string(chunked::MANIFEST_HEADER) + " " + std::to_string(pageCount) + "\n";
+    const unsigned int threads = std::max(this->compression.threads, 1U);
+    this->compressionPool = std::make_unique<xoj::util::WorkerPool>(threads);
+    for (size_t i = 0; i < pageCount; i++) {
+        XmlNode parent(TAG_NAMES[TagType::XOURNAL]);
+        visitPage(&parent, doc->getPage(i), doc, static_cast<int>(i), target);
+        StringOutputStream pageOut;
+        parent.writeChildren(&pageOut);
+        const std::string& page = pageOut.getString();
+
+        // The layers go to their own entry, the rest of the page stays in the document
+        const size_t layersBegin = std::min(page.find("<layer"), page.size());
+        const size_t layersEnd = std::max(page.rfind("</page>"), layersBegin);
+        skeleton.write(std::string_view(page).substr(0, layersBegin));
+        skeleton.write(std::string_view(page).substr(layersEnd));
+        std::string layers = page.substr(layersBegin, layersEnd - layersBegin);
+        entries.manifest += chunked::getPageEntry(i) + " " + std::to_string(layers.size()) + "\n";
+        entries.pages.emplace_back(this->compressionPool->submit(
+                [layers = std::move(layers), level = this->compression.level]() mutable {
+                    return compressEntry(std::move(layers), level);
+                }));
+
+        // Only keep a few uncompressed pages in memory
+        if (i >= 2 * threads) {
+            entries.pages[i - 2 * threads].wait();
+        }
+
+        if (listener) {
+            listener->setCurrentState(i + 1);
+        }
+    }
+    root->writeClosingTag(&skeleton);
+    root.reset();
+    this->streaming = false;
+    this->attachImages = false;
+    entries.document = skeleton.takeString();
+
+    entries.thumbnail.clear();
+    if (auto preview = doc->getPreview()) {
+        cairo_surface_write_to_png_stream(preview.get(), writePngToString, &entries.thumbnail);
+    }
+    return true;
+}
+
+auto SaveHandler::compressEntry(std::string data, int level) -> CompressedEntry {
+    CompressedEntry entry;
+    entry.size = data.size();
+    entry.crc = static_cast<uint32_t>(
+            crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())));
+    if (level != 0) {
+        if (auto deflated = GzUtil::deflateRaw(data, level); deflated && deflated->size() < data.size()) {
+            entry.data = std::move(*deflated);
+            entry.deflated = true;
+            return entry;
+        }
+    }
+    entry.data = std::move(data);
+    return entry;
+}
+
+void SaveHandler::writeChunkedTo(const fs::path& filepath) {
+    namespace chunked = xoj::chunked_format;
+    ChunkedEntries& entries = this->chunkedEntries;
+    std::vector<CompressedEntry> pages;
+    pages.reserve(entries.pages.size());
+    for (auto& page: entries.pages) {
+        pages.emplace_back(page.get());
+    }
+    this->compressionPool.reset();
+    const std::string fallback = getFallbackDocument();
+    const std::string version = "current=" + std::to_string(FILE_FORMAT_VERSION) +
+                                "\nmin=" + std::to_string(FILE_FORMAT_VERSION) + "\n";
+    const std::string mimetype = std::string(chunked::MIMETYPE) + "\n";
+
+    int zipError = 0;
+    zip_t* zip = zip_open(char_cast(filepath.u8string().c_str()), ZIP_CREATE | ZIP_TRUNCATE, &zipError);
+    if (!zip) {
+        zip_error_t error;
+        zip_error_init_with_code(&error, zipError);
+        this->errorMessage = FS(_F("Could not create file \"{1}\": {2}") % filepath.u8string() %
+                                zip_error_strerror(&error));
+        zip_error_fini(&error);
+        return;
+    }
+
+    // The entries must stay alive until the archive is closed
+    bool success = true;
+    auto addEntry = [&](const std::string& name, const std::string& data, bool compress) {
+        zip_source_t* source = zip_source_buffer(zip, data.data(), data.size(), 0);
+        const zip_int64_t index = source ? zip_file_add(zip, name.c_str(), source, ZIP_FL_ENC_UTF_8) : -1;
+        if (index < 0) {
+            zip_source_free(source);
+            success = false;
+            return;
+        }
+        if (!compress || this->compression.level == 0) {
+            zip_set_file_compression(zip, static_cast<zip_uint64_t>(index), ZIP_CM_STORE, 0);
+        } else {
+            const auto level = static_cast<zip_uint32_t>(std::max(this->compression.level, 0));
+            zip_set_file_compression(zip, static_cast<zip_uint64_t>(index), ZIP_CM_DEFLATE, level);
+        }
+    };
+    // The pages are already compressed: libzip copies them as they are, since their compression is not set
+    auto addCompressedEntry = [&](const std::string& name, const CompressedEntry& entry) {
+        if (!entry.deflated) {
+            addEntry(name, entry.data, false);
+            return;
+        }
+        auto* state = new CompressedSource{entry.data, entry.size, entry.crc};
+        zip_error_init(&state->error);
+        zip_source_t* source = zip_source_function(zip, readCompressedEntry, state);
+        if (!source) {
+            zip_error_fini(&state->error);
+            delete state;
+            success = false;
+        } else if (zip_file_add(zip, name.c_str(), source, ZIP_FL_ENC_UTF_8) < 0) {
+            zip_source_free(source);  // Frees the state
+            success = false;
+        }
+    };
+    // The mimetype comes first and is not compressed, so that it can be recognized without unpacking
+    addEntry(chunked::MIMETYPE_ENTRY, mimetype, false);
+    addEntry(chunked::VERSION_ENTRY, version, true);
+    addEntry(chunked::MANIFEST_ENTRY, entries.manifest, true);
+    addEntry(chunked::DOCUMENT_ENTRY, entries.document, true);
+    addEntry(chunked::FALLBACK_ENTRY, fallback, true);
+    for (size_t i = 0; i < pages.size(); i++) {
+        addCompressedEntry(chunked::getPageEntry(i), pages[i]);
+    }
+    // The image data is already compressed
+    for (size_t i = 0; i < attachedImages.size(); i++) {
+        addEntry(chunked::getImageEntry(i), *attachedImages[i], false);
+    }
+    if (!entries.thumbnail.empty()) {
+        addEntry(chunked::THUMBNAIL_ENTRY, entries.thumbnail, false);
+    }
+
+    if (!success || zip_close(zip) != 0) {
+        this->errorMessage =
+                FS(_F("Could not write file \"{1}\": {2}") % filepath.u8string() % zip_strerror(zip));
+        zip_discard(zip);
+        return;
+    }
+
+    writeBackgroundImages(filepath);
+}
+
+void SaveHandler::writeImageData(XmlNode* node, const Image* image) {
+    const auto& data = image->getSharedData();
+    if (this->attachImages) {
+        if (!data) {
+            return;
+        }
+        auto [it, inserted] = this->attachedImageIndex.try_emplace(data.get(), this->attachedImages.size());
+        if (inserted) {
+            this->attachedImages.emplace_back(data);
+        }
+        auto* attachment = new XmlNode(TAG_NAMES[TagType::ATTACHMENT]);
+        attachment->setAttrib(xoj::xml_attrs::PATH_STR, xoj::chunked_format::getImageEntry(it->second));
+        node->addChild(attachment);
+        return;
+    }
+
+    auto* imageNode = static_cast<XmlImageNode*>(node);
+    if (data.use_count() <= 1) {
+        imageNode->setImage(image->getImage().get());
+        return;
+    }
+    // The data is shared by several images: encode it only once
+    auto& png = this->encodedImages[data.get()];
+    if (!png) {
+        auto encoded = std::make_shared<std::string>();
+        if (auto surface = image->getImage()) {
+            cairo_surface_write_to_png_stream(surface.get(), writePngToString, encoded.get());
+        }
+        png = std::move(encoded);
+    }
+    imageNode->setPngData(png);
+}
+
+void SaveHandler::writeBackgroundImages(const fs::path& filepath) {
     for (const auto& info: backgroundImages) {
         if (info.newPath) {
             auto tmpfn = (fs::path(filepath) += ".") += info.newPath.value();
@@ -414,3 +884,5 @@ void SaveHandler::updateDocumentInfo(Document* doc) {
 
 
 auto SaveHandler::getErrorMessage() -> const std::string& { return this->errorMessage; }
+
+void SaveHandler::setCompression(GzCompression compression) { this->compression = compression; }
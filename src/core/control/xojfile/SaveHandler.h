@@ -11,15 +11,21 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint32_t
+#include <future>         // for future
+#include <memory>         // for unique_ptr, shared_ptr
 #include <optional>
-#include <string>  // for string
-#include <vector>  // for vector
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
 
 #include "control/xml/XmlNode.h"    // for XmlNode
 #include "model/BackgroundImage.h"  // for BackgroundImage
 #include "model/PageRef.h"          // for PageRef
 #include "util/Color.h"             // for Color
+#include "util/OutputStream.h"      // for GzCompression, GzStringOutputStream
+#include "util/WorkerPool.h"        // for WorkerPool
 
 #include "filesystem.h"  // for path
 
@@ -27,6 +33,7 @@ class XmlPointNode;
 class ProgressListener;
 class AudioElement;
 class Document;
+class Image;
 class Layer;
 class OutputStream;
 class Stroke;
@@ -47,11 +54,61 @@ public:
      * anywhere
      */
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
+
+    /**
+     * Writes the document to the given path page by page, without building the XML tree of the whole document first.
+     * Needs read-only access to the Document until it returns.
+     * @param target The path the document is saved as: the paths of the assets are relative to it
+     * @param filepath The path of the file to write (usually target)
+     */
+    void saveDocumentTo(const Document* doc, const fs::path& target, const fs::path& filepath,
+                        ProgressListener* listener = nullptr);
+    /**
+     * Writes the document to the given stream page by page, without building the XML tree of the whole document first.
+     * Needs read-only access to the Document until it returns.
+     */
+    void saveDocumentTo(const Document* doc, const fs::path& target, OutputStream* out, const fs::path& filepath,
+                        ProgressListener* listener = nullptr);
+    /**
+     * Writes the given pages of the document, in this order, as a document of their own (without preview).
+     * Needs read-only access to the Document until it returns.
+     */
+    void savePagesTo(const Document* doc, const std::vector<size_t>& pages, const fs::path& target, OutputStream* out,
+                     const fs::path& filepath);
+    /**
+     * Writes the document to the given path as a chunked zip archive, with each page in its own entry
+     * (see ChunkedFormat.h). Needs read-only access to the Document until it returns.
+     */
+    void saveChunkedTo(const Document* doc, const fs::path& target, const fs::path& filepath,
+                       ProgressListener* listener = nullptr);
+
+    /**
+     * Serializes the document to memory, page by page, as saveDocumentTo() or saveChunkedTo() would write it. Needs
+     * read-only access to the Document until it returns.
+     * The pages are compressed on the compression threads while they are serialized, and only the compressed data is
+     * kept. It is written by writeSerializedTo(), which does not access the Document: the writing does not block the
+     * changes to the document.
+     * @param target The path the document is saved as: the paths of the assets are relative to it
+     * @param chunked Whether the document is written as a chunked zip archive (see ChunkedFormat.h)
+     * @return false if the document must not be saved, because some of its pages could not be loaded entirely (see
+     * XojPage::getContentError()). getErrorMessage() then tells which ones.
+     */
+    bool serializeDocument(const Document* doc, const fs::path& target, bool chunked,
+                           ProgressListener* listener = nullptr);
+    /**
+     * Writes the document serialized by serializeDocument() to the given path, if it succeeded. Does not access the
+     * Document instance
+     */
+    void writeSerializedTo(const fs::path& filepath);
+
     /// Update document information. Requires write access to the Document.
     void updateDocumentInfo(Document* doc);
 
     const std::string& getErrorMessage();
 
+    /// Set the compression of the files written by saveTo(), saveDocumentTo() and saveChunkedTo()
+    void setCompression(GzCompression compression);
+
 protected:
     static std::string getColorStr(Color c, unsigned char alpha = 0xff);
 
@@ -69,8 +126,51 @@ protected:
     virtual void writeTimestamp(XmlAudioNode* xmlAudioNode, const AudioElement* audioElement);
     virtual void writeBackgroundName(XmlNode* background, ConstPageRef p);
 
+private:
+    /// Reset the state and create the root node, with the header and optionally the preview
+    void prepareRoot(const Document* doc, bool withPreview);
+    /**
+     * Make sure that all the contents of the pages (all of them if pages is nullptr) were loaded: saving a page whose
+     * contents are missing would overwrite them. Sets the error message otherwise.
+     * @return false if some pages cannot be saved
+     */
+    bool checkPageContents(const Document* doc, const std::vector<size_t>* pages);
+    /**
+     * Write the pages (all of them if pages is nullptr) as soon as they are visited
+     * @return false if nothing was written because of checkPageContents()
+     */
+    bool streamPages(const Document* doc, const std::vector<size_t>* pages, const fs::path& target, OutputStream* out,
+                     ProgressListener* listener);
+    /**
+     * Serialize the entries of the chunked zip archive to chunkedEntries
+     * @return false if nothing was serialized because of checkPageContents()
+     */
+    bool serializeChunked(const Document* doc, const fs::path& target, ProgressListener* listener);
+    /// Write chunkedEntries as a zip archive
+    void writeChunkedTo(const fs::path& filepath);
+
+    /// An entry of the chunked zip archive, compressed by a compression thread
+    struct CompressedEntry {
+        std::string data;
+        size_t size = 0;  ///< Uncompressed size
+        uint32_t crc = 0;
+        bool deflated = false;  ///< Otherwise the data is stored as is
+    };
+    static CompressedEntry compressEntry(std::string data, int level);
+    /// Write the attached background images next to filepath
+    void writeBackgroundImages(const fs::path& filepath);
+    /// Write the data of the image, inline or as an attachment
+    void writeImageData(XmlNode* node, const Image* image);
+
 protected:
     std::unique_ptr<XmlNode> root{};
+    /**
+     * Whether the XML is written as soon as a page is visited: the nodes can then refer to the data of the Document
+     * instead of copying it
+     */
+    bool streaming = false;
+
+    GzCompression compression{};
     bool firstPdfPageVisited;
     int attachBgId;
 
@@ -82,4 +182,26 @@ protected:
         int newId;
     };
     std::vector<ImageInfo> backgroundImages{};
+
+    /// Whether the data of the images is written to attachments (see ChunkedFormat.h) instead of inline
+    bool attachImages = false;
+    /// The data written to attachments, once for all the images sharing it
+    std::vector<std::shared_ptr<const std::string>> attachedImages{};
+    /// The index in attachedImages or the encoded PNG, by image data (see ImageDataPool)
+    std::unordered_map<const std::string*, size_t> attachedImageIndex{};
+    std::unordered_map<const std::string*, std::shared_ptr<const std::string>> encodedImages{};
+
+    /// The document serialized by serializeDocument(), if isSerialized
+    bool isSerialized = false;
+    bool serializedChunked = false;
+    std::unique_ptr<GzStringOutputStream> serialized{};
+    struct ChunkedEntries {
+        std::string manifest;
+        std::string document;
+        std::vector<std::future<CompressedEntry>> pages;
+        std::string thumbnail;
+    };
+    ChunkedEntries chunkedEntries{};
+    /// Compresses the pages of chunkedEntries, on GzCompression::threads threads
+    std::unique_ptr<xoj::util::WorkerPool> compressionPool{};
 };
@@ -1,14 +1,12 @@
 #include "control/xojfile/XmlParser.h"
 
-#include <algorithm>    // for all_of
+#include <algorithm>    // for all_of, count
 #include <cctype>       // for isspace
 #include <cstddef>      // for size_t
 #include <ranges>       // for all_of, reverse_view
-#include <stdexcept>    // for domain_error
 #include <string>       // for stod, string
 #include <string_view>  // for string_view
 #include <utility>      // for move
-#include <vector>       // for vector
 
 #include <glib.h>        // for GMarkupParseContext, g_warning...
 #include <glibconfig.h>  // for gsize
@@ -21,6 +19,7 @@
 #include "model/PageType.h"                            // for PageType
 #include "model/Point.h"                               // for Point
 #include "model/Stroke.h"                              // for StrokeTool, StrokeCapStyle
+#include "model/StrokePoints.h"                        // for StrokePoints
 #include "model/TextAlignment.h"                       // for TextAlignment
 #include "util/Assert.h"                               // for xoj_assert
 #include "util/Color.h"                                // for Color
@@ -48,8 +47,8 @@ static auto isAllWhitespace(std::string_view string) -> bool {
  * false. If a parsing error occured, the function prints an error message and
  * returns false.
  *
- * When available, we use std::from_chars, because it is about 10x faster than
- * streams and about 5x faster than g_ascii_strtod.
+ * See XmlParserHelper::scanNumber: the fixed decimal format used by Xournal++
+ * is parsed directly, other formats with std::from_chars when available.
  *
  * @param it    Pointer to the beginning of the string, modified to point to the
  *              first unparsed character
@@ -59,26 +58,18 @@ static auto isAllWhitespace(std::string_view string) -> bool {
  *         an error occured
  */
 static auto parseDouble(const char*& it, const char* end, double& value) -> bool {
-    // Skip any leading whitespace
-    while (it != end && (*it == ' ' || *it == '\n')) {
-        ++it;
-    }
-
-    // Return false if reached end of string
-    if (it == end) {
-        return false;
-    }
-
-    try {
-        value = XmlParserHelper::parseNumeric<double>(it, end);
-        return true;
-    } catch (const std::domain_error& e) {
-        g_warning("XML parser: Error parsing a double:\n"
-                  "\"%s\"\n"
-                  "Remaining string: \"%s\"",
-                  e.what(), StringUtils::ellipsize(std::string_view{it, end}).c_str());
-        return false;
+    switch (XmlParserHelper::scanNumber(it, end, value)) {
+        case XmlParserHelper::ScanResult::OK:
+            return true;
+        case XmlParserHelper::ScanResult::END:
+            return false;
+        case XmlParserHelper::ScanResult::BAD_NUMBER:
+            break;
     }
+    g_warning("XML parser: Error parsing a double:\n"
+              "Remaining string: \"%s\"",
+              StringUtils::ellipsize(std::string_view{it, end}).c_str());
+    return false;
 }
 
 void XmlParser::parserStartElement(GMarkupParseContext* context, const gchar* elementName, const gchar** attributeNames,
@@ -382,8 +373,11 @@ void XmlParser::parseStrokeTag(const XmlParserHelper::AttributeMap& attributeMap
 }
 
 void XmlParser::parseStrokeText(std::string_view text) {
-    std::vector<Point> pointVector;
-    pointVector.reserve(this->pressureBuffer.size() + 1);  // The last point has no pressure value
+    StrokePoints points;
+    // The last point has no pressure value. Without pressure values, count the separators: the coordinates are
+    // written "x1 y1 x2 y2..."
+    points.reserve(this->pressureBuffer.empty() ? (static_cast<size_t>(std::ranges::count(text, ' ')) + 2) / 2 :
+                                                  this->pressureBuffer.size() + 1);
 
     auto it = text.data();
     const auto end = text.data() + text.size();
@@ -396,25 +390,25 @@ void XmlParser::parseStrokeText(std::string_view text) {
             break;
         }
         const auto p = (pit != pressureBuffer.end()) ? *pit++ : Point::NO_PRESSURE;
-        pointVector.emplace_back(x, y, p);
+        points.push_back(Point(x, y, p));
     }
 
     // Check for strokes with the wrong number of coordinates or pressure points
     // An empty pressure buffer is valid: all points have NO_PRESSURE
-    if (this->pressureBuffer.size() + 1 < pointVector.size() && !this->pressureBuffer.empty()) {
+    if (this->pressureBuffer.size() + 1 < points.size() && !this->pressureBuffer.empty()) {
         this->builder.logError(FS(_F("Found stroke with more coordinates than pressure points: {1}, expected {2}. "
                                      "Shrinking stroke to match pressure point count") %
-                                  pointVector.size() % (this->pressureBuffer.size() + 1)));
-        pointVector.resize(this->pressureBuffer.size() + 1);
+                                  points.size() % (this->pressureBuffer.size() + 1)));
+        points.truncate(this->pressureBuffer.size() + 1);
     }
-    if (this->pressureBuffer.size() >= pointVector.size() && !pointVector.empty()) {
+    if (this->pressureBuffer.size() >= points.size() && !points.empty()) {
         this->builder.logError(FS(_F("Found stroke with too many pressure points: {1}, expected {2}. "
                                      "Discarding remaining pressure points") %
-                                  this->pressureBuffer.size() % (pointVector.size() - 1)));
-        pointVector.back().z = Point::NO_PRESSURE;  // The last point should have no pressure
+                                  this->pressureBuffer.size() % (points.size() - 1)));
+        points.setPressure(points.size() - 1, Point::NO_PRESSURE);  // The last point should have no pressure
     }
 
-    this->builder.setStrokePoints(std::move(pointVector), !this->pressureBuffer.empty());
+    this->builder.setStrokePoints(std::move(points), !this->pressureBuffer.empty());
     this->pressureBuffer.clear();
 }
 
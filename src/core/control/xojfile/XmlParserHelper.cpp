@@ -1,9 +1,11 @@
 #include "control/xojfile/XmlParserHelper.h"
 
 #include <array>
+#include <bit>
 #include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <istream>
 #include <iterator>
 #include <optional>
@@ -230,3 +232,117 @@ auto XmlParserHelper::decodeBase64(std::string_view base64data) -> std::string {
     result.shrink_to_fit();
     return result;
 }
+
+
+namespace {
+constexpr auto POWERS_OF_TEN = std::array<double, 16>{1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                      1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+/// Integers with at most that many digits are exactly representable as doubles
+constexpr ptrdiff_t MAX_EXACT_DIGITS = 15;
+
+inline auto isDigit(char c) -> bool { return static_cast<unsigned char>(c - '0') < 10; }
+
+/*
+ * Process 8 characters at once, in a 64 bits register. See e.g. the fast_float library.
+ * The characters are loaded in memory order: only valid on little endian targets.
+ */
+inline auto load8(const char* p) -> uint64_t {
+    uint64_t v{};
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline auto areEightDigits(uint64_t v) -> bool {
+    return ((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+inline auto parseEightDigits(uint64_t v) -> uint64_t {
+    constexpr uint64_t MASK = 0x000000FF000000FF;
+    constexpr uint64_t MUL1 = 0x000F424000000064;  // 100 + (1000000 << 32)
+    constexpr uint64_t MUL2 = 0x0000271000000001;  // 1 + (10000 << 32)
+    v -= 0x3030303030303030;
+    v = (v * 10) + (v >> 8);
+    v = (((v & MASK) * MUL1) + (((v >> 16) & MASK) * MUL2)) >> 32;
+    return static_cast<uint32_t>(v);
+}
+
+/// Accumulate the digits starting at p into mantissa. Returns a pointer to the first non-digit
+inline auto scanDigits(const char* p, const char* end, uint64_t& mantissa) -> const char* {
+    if constexpr (std::endian::native == std::endian::little) {
+        while (end - p >= 8 && areEightDigits(load8(p))) {
+            mantissa = mantissa * 100000000 + parseEightDigits(load8(p));
+            p += 8;
+        }
+    }
+    while (p != end && isDigit(*p)) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * Parses [-]digits[.digits], with at most MAX_EXACT_DIGITS digits and no exponent.
+ * The mantissa and the power of ten are then exact, so that their quotient is correctly rounded: this gives the same
+ * result as std::from_chars.
+ * @return false if the string is not in this format
+ */
+inline auto scanFixedDecimal(const char*& it, const char* end, double& value) -> bool {
+    const char* p = it;
+    const bool negative = *p == '-';
+    if (negative) {
+        ++p;
+    }
+    uint64_t mantissa = 0;
+    const char* intStart = p;
+    p = scanDigits(p, end, mantissa);
+    ptrdiff_t digits = p - intStart;
+    ptrdiff_t fracDigits = 0;
+    if (p != end && *p == '.') {
+        ++p;
+        const char* fracStart = p;
+        p = scanDigits(p, end, mantissa);
+        fracDigits = p - fracStart;
+        digits += fracDigits;
+    }
+    if (digits == 0 || digits > MAX_EXACT_DIGITS || (p != end && (*p == 'e' || *p == 'E'))) {
+        return false;
+    }
+    const double v = static_cast<double>(mantissa) / POWERS_OF_TEN[static_cast<size_t>(fracDigits)];
+    value = negative ? -v : v;
+    it = p;
+    return true;
+}
+}  // namespace
+
+auto XmlParserHelper::scanNumber(const char*& it, const char* end, double& value) -> ScanResult {
+    // Skip any leading whitespace
+    while (it != end && (*it == ' ' || *it == '\n')) {
+        ++it;
+    }
+    if (it == end) {
+        return ScanResult::END;
+    }
+
+    if (scanFixedDecimal(it, end, value)) {
+        return ScanResult::OK;
+    }
+
+    // Any other format
+#if ENABLE_FLOAT_FROM_CHARS
+    auto [ptr, ec] = std::from_chars(it, end, value);
+    if (ec != std::errc{}) {
+        return ScanResult::BAD_NUMBER;
+    }
+    it = ptr;
+#else
+    xoj_assert(*end == '\0');
+    char* ptr = nullptr;
+    value = g_ascii_strtod(it, &ptr);
+    if (ptr == it) {
+        return ScanResult::BAD_NUMBER;
+    }
+    it = ptr;
+#endif
+    return ScanResult::OK;
+}
@@ -142,6 +142,33 @@ T parseNumeric(const char*& it, const char* end) {
     return value;
 }
 
+/**
+ * Result of scanNumber()
+ */
+enum class ScanResult {
+    OK,         ///< A value was parsed
+    END,        ///< Only whitespace was left
+    BAD_NUMBER  ///< The string does not start with a number (after the whitespace)
+};
+
+/**
+ * Skip whitespace and parse the next number of a list, like the coordinates or the pressure values of a stroke.
+ *
+ * The fixed decimal format Xournal++ writes (e.g. "-12.345678") is parsed directly, up to 8 digits at a time. Other
+ * formats (exponents, more than 15 significant digits...) are passed on to std::from_chars (or g_ascii_strtod). The
+ * result is the same in both cases.
+ *
+ * Unlike parseNumeric(), this function does not throw.
+ * @param it    Pointer to the beginning of the string, modified to point to the
+ *              first unparsed character
+ * @param end   Pointer to one character past the end of the string
+ * @param value Output parameter for the parsed value
+ *
+ * @note The fallback implementation requires that the string be null-terminated
+ *       at end.
+ */
+ScanResult scanNumber(const char*& it, const char* end, double& value);
+
 namespace detail {
 
 // SFINAE logic for checking named enums and utf8 views
@@ -126,8 +126,12 @@ void XojPageView::addOverlayView(std::unique_ptr<xoj::view::OverlayView> overlay
 void XojPageView::setIsVisible(bool visible) { this->visible = visible; }
 
 void XojPageView::deleteViewBuffer() {
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        this->visibleArea = Range();
+    }
     std::lock_guard lock(this->drawingMutex);
-    this->buffer.reset();
+    this->tiles.clear();
 }
 
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
@@ -156,7 +160,7 @@ auto XojPageView::searchTextOnPage(const std::string& text, size_t index, size_t
             pdf = doc->getPdfPage(pNr);
             doc->unlock_shared();
         }
-        this->search = std::make_unique<SearchControl>(page, pdf);
+        this->search = std::make_unique<SearchControl>(page, pdf, xournal->getControl()->getSearchIndex());
         this->overlayViews.emplace_back(std::make_unique<xoj::view::SearchResultView>(
                 this->search.get(), this, settings->getSelectionColor(), settings->getActiveSelectionColor()));
     }
@@ -572,7 +576,11 @@ auto XojPageView::onMotionNotifyEvent(const PositionInputData& pos) -> bool {
     } else if (this->laserPointer && this->laserPointer->onMotionNotifyEvent(pos, zoom)) {
         // used this event
     } else if (h->getToolType() == TOOL_ERASER && h->getEraserType() != ERASER_TYPE_WHITEOUT && this->inEraser) {
-        this->eraser->erase(x, y);
+        if (settings->isEraserSweep()) {
+            this->eraser->sweepTo(x, y);
+        } else {
+            this->eraser->erase(x, y);
+        }
     } else if (h->getActiveTool()->getToolType() == TOOL_LINK) {
         startLink();
         this->linkHandler->highlight(this->getPage(), round_cast<int>(x), round_cast<int>(y), this);
@@ -707,6 +715,7 @@ auto XojPageView::onButtonReleaseEvent(const PositionInputData& pos) -> bool {
 
     if (this->inEraser) {
         this->inEraser = false;
+        this->eraser->flush();
         Document* doc = this->xournal->getControl()->getDocument();
         doc->lock();
         this->eraser->finalize();
@@ -869,10 +878,11 @@ void XojPageView::flagDirtyRegion(const Range& rg) const { repaintArea(rg.minX,
 void XojPageView::drawAndDeleteToolView(xoj::view::ToolView* v, const Range& rg) {
     if (v->isViewOf(this->inputHandler.get()) || v->isViewOf(this->verticalSpace.get()) ||
         v->isViewOf(this->textEditor.get())) {
-        // Draw the inputHandler's view onto the page buffer.
+        // Draw the inputHandler's view onto the page tiles.
         std::lock_guard lock(this->drawingMutex);
-        if (auto cr = buffer.get(); cr) {
-            v->drawWithoutDrawingAids(cr);
+        if (!this->tiles.isEmpty()) {
+            Range area = rg.empty() ? Range(0, 0, getWidth(), getHeight()) : rg;
+            this->tiles.forEachTileIntersecting(area, [v](cairo_t* cr) { v->drawWithoutDrawingAids(cr); });
         } else {
             rerenderPage();
         }
@@ -1092,6 +1102,13 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
     xoj::util::CairoSaveGuard saveGuard(cr);
     cairo_scale(cr, zoom, zoom);
 
+    const Range visiblePart = this->getVisiblePart();
+    if (!visiblePart.empty()) {
+        std::lock_guard lock(this->repaintRectMutex);
+        this->visibleArea = visiblePart;
+    }
+
+    auto tilesState = xoj::view::TileCache::State::UP_TO_DATE;
     {
         std::lock_guard lock(this->drawingMutex);  // Lock the mutex first
         xoj::util::CairoSaveGuard saveGuard(cr);   // see comment at the end of the scope
@@ -1100,13 +1117,26 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
             return true;
         }
 
-        if (this->buffer.getZoom() != zoom) {
-            rerenderPage();
-            cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
-        }
-        this->buffer.paintTo(cr);
+        Range clip;
+        cairo_clip_extents(cr, &clip.minX, &clip.minY, &clip.maxX, &clip.maxY);
+        clip = clip.intersect(Range(0, 0, getWidth(), getHeight()));
+
+        // Tiles of another zoom level are painted scaled until the missing tiles are rendered
+        this->tiles.setZoom(zoom);
+        tilesState = this->tiles.paintTo(cr, clip);
+        this->tiles.prune(visiblePart);
     }  // Restore the state of cr and then release the mutex
-       // restoring the state of cr ensures this->buffer.surface is not longer referenced as the source in cr.
+       // restoring the state of cr ensures the tiles' surfaces are no longer referenced as the source in cr.
+
+    if (tilesState != xoj::view::TileCache::State::UP_TO_DATE) {
+        XournalScheduler* scheduler = this->xournal->getControl()->getScheduler();
+        if (tilesState == xoj::view::TileCache::State::INCOMPLETE && scheduler->isRerenderZoomBlocked()) {
+            // We are zooming: show a quick draft until the zoom settles and the final rendering is done
+            scheduler->addDraftRenderPage(this);
+        }
+        // Unlike rerenderPage(), only the missing or outdated tiles of the visible area will be rendered
+        scheduler->addRerenderPage(this);
+    }
 
     /**
      * All the overlay painters below follow the assumption:
@@ -1127,7 +1157,7 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
 
 auto XojPageView::isSelected() const -> bool { return selected; }
 
-auto XojPageView::hasBuffer() const -> bool { return this->buffer.isInitialized(); }
+auto XojPageView::hasBuffer() const -> bool { return !this->tiles.isEmpty(); }
 
 auto XojPageView::getSelectionColor() -> GdkRGBA { return Util::rgb_to_GdkRGBA(settings->getSelectionColor()); }
 
@@ -25,10 +25,11 @@
 #include "gui/inputdevices/InputEvents.h"
 #include "model/PageListener.h"       // for PageListener
 #include "model/PageRef.h"            // for PageRef
+#include "util/Range.h"               // for Range
 #include "util/Rectangle.h"           // for Rectangle
 #include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
-#include "view/Mask.h"                // for Mask
 #include "view/Repaintable.h"         // for Repaintable
+#include "view/TileCache.h"           // for TileCache
 
 #include "Layout.h"            // for Layout
 #include "LegacyRedrawable.h"  // for LegacyRedrawable
@@ -261,7 +262,8 @@ private:
     bool visible = false;
     bool selected = false;
 
-    xoj::view::Mask buffer;
+    /// Rendering of the page. Protected by drawingMutex
+    xoj::view::TileCache tiles;
     std::mutex drawingMutex;
 
     bool inEraser = false;
@@ -283,6 +285,8 @@ private:
     std::vector<xoj::util::Rectangle<double>> rerenderRects;
     bool rerenderComplete = false;
     bool sizeChanged = false;
+    /// Part of the page visible the last time it was painted. Tells the RenderJob which tiles to render
+    Range visibleArea;
 
     xoj::util::Point<int> gridCoordinates;  ///< Coordinates in the layout grid
 
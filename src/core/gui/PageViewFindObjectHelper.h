@@ -16,6 +16,8 @@
 #include <limits>
 #include <optional>
 #include <shared_mutex>
+#include <utility>
+#include <vector>
 
 #include "control/AudioController.h"
 #include "control/Control.h"
@@ -25,6 +27,7 @@
 #include "gui/PageView.h"
 #include "model/Layer.h"
 #include "model/XojPage.h"
+#include "util/Range.h"
 #include "util/safe_casts.h"
 
 #include "XournalView.h"
@@ -112,20 +115,23 @@ public:
 
     bool checkLayer(const Layer* l) override {
         double minDistance = ACTION_RADIUS;
+        // Only consider the elements close to the point
+        std::vector<std::pair<const Element*, Element::Index>> candidates;
+        l->forEachElementIntersecting(Range(x - ACTION_RADIUS, y - ACTION_RADIUS, x + ACTION_RADIUS, y + ACTION_RADIUS),
+                                      [&](const Element* e, Element::Index pos) { candidates.emplace_back(e, pos); });
         // Iterate starting from the front-most element
-        Element::Index pos = as_signed(l->getElementsView().size());
-        for (auto it = l->getElementsView().rbegin(); it < l->getElementsView().rend(); ++it) {
-            pos--;
+        for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+            auto [e, pos] = *it;
             // First perform a rough check to avoid expensive calls to Stroke::distanceTo()
-            if ((*it)->intersectsArea(x - minDistance, y - minDistance, 2. * minDistance, 2. * minDistance)) {
-                double d = (*it)->distanceTo(x, y);
+            if (e->intersectsArea(x - minDistance, y - minDistance, 2. * minDistance, 2. * minDistance)) {
+                double d = e->distanceTo(x, y);
                 if (d == 0.0) {
-                    this->match = *it;
+                    this->match = e;
                     this->matchIndex = pos;
                     return true;
                 }
                 if (d < minDistance) {
-                    this->match = *it;
+                    this->match = e;
                     this->matchIndex = pos;
                     minDistance = d;
                     // Keep going, we may find something closer
@@ -162,18 +168,20 @@ protected:
     /// Plays every element of the layer that are closer than ACTION_RADIUS
     bool checkLayer(const Layer* l) override {
         bool found = false;
-        for (auto&& e: l->getElementsView()) {
-            if (auto* audio = dynamic_cast<const AudioElement*>(e); audio) {
-                // First perform a rough check to avoid expensive calls to Stroke::distanceTo()
-                if (audio->intersectsArea(x - ACTION_RADIUS, y - ACTION_RADIUS, 2. * ACTION_RADIUS,
-                                          2. * ACTION_RADIUS)) {
-                    double d = audio->distanceTo(x, y);
-                    if (d < ACTION_RADIUS) {
-                        found = playElement(audio) || found;
+        l->forEachElementIntersecting(
+                Range(x - ACTION_RADIUS, y - ACTION_RADIUS, x + ACTION_RADIUS, y + ACTION_RADIUS),
+                [&](const Element* e, Element::Index) {
+                    if (auto* audio = dynamic_cast<const AudioElement*>(e); audio) {
+                        // First perform a rough check to avoid expensive calls to Stroke::distanceTo()
+                        if (audio->intersectsArea(x - ACTION_RADIUS, y - ACTION_RADIUS, 2. * ACTION_RADIUS,
+                                                  2. * ACTION_RADIUS)) {
+                            double d = audio->distanceTo(x, y);
+                            if (d < ACTION_RADIUS) {
+                                found = playElement(audio) || found;
+                            }
+                        }
                     }
-                }
-            }
-        }
+                });
         return found;
     }
 
@@ -1,6 +1,7 @@
 #include "SearchBar.h"
 
-#include <string>  // for allocator, string
+#include <functional>  // for function
+#include <string>      // for allocator, string
 
 #include <gdk/gdk.h>         // for GdkEventKey, GDK_SHIFT_MASK
 #include <gdk/gdkkeysyms.h>  // for GDK_KEY_Return
@@ -10,11 +11,14 @@
 #include "control/Control.h"            // for Control
 #include "control/NavigationHistory.h"  // for NavigationHistory
 #include "control/ScrollHandler.h"      // for ScrollHandler
-#include "control/zoom/ZoomControl.h"  // for ZoomControl
-#include "gui/MainWindow.h"            // for MainWindow
-#include "model/Document.h"            // for Document
-#include "util/PlaceholderString.h"    // for PlaceholderString
-#include "util/i18n.h"                 // for _, FC, _F
+#include "control/SearchIndex.h"        // for SearchIndex
+#include "control/zoom/ZoomControl.h"   // for ZoomControl
+#include "gui/MainWindow.h"             // for MainWindow
+#include "model/Document.h"             // for Document
+#include "model/XojPage.h"              // for XojPage
+#include "util/PlaceholderString.h"     // for PlaceholderString
+#include "util/Util.h"                  // for npos
+#include "util/i18n.h"                  // for _, FC, _F
 
 SearchBar::SearchBar(Control* control): control(control) {
     MainWindow* win = control->getWindow();
@@ -76,12 +80,43 @@ auto SearchBar::searchTextOnCurrentPage(const char* text, size_t index, size_t*
     return control->searchTextOnPage(text, p, index, occurrences, matchRect);
 }
 
+auto SearchBar::awaitPage(size_t pageNo, std::function<void()> resume) -> bool {
+    Document* doc = control->getDocument();
+    doc->lock_shared();
+    const size_t pdfPageNo = pageNo < doc->getPageCount() ? doc->getPage(pageNo)->getPdfPageNr() : npos;
+    doc->unlock_shared();
+
+    if (pdfPageNo == npos || !control->getSearchIndex()->awaitPdfPage(pdfPageNo, [this, resume = std::move(resume)]() {
+            this->awaiting = false;
+            resume();
+        })) {
+        return false;
+    }
+
+    this->awaiting = true;
+    gtk_label_set_text(GTK_LABEL(control->getWindow()->get("lbSearchState")), _("Searching..."));
+    return true;
+}
+
+void SearchBar::stopAwaiting() {
+    this->awaiting = false;
+    control->getSearchIndex()->stopAwaiting();
+}
+
 void SearchBar::search(const char* text) {
     MainWindow* win = control->getWindow();
     GtkWidget* lbSearchState = win->get("lbSearchState");
 
     bool found = true;
     this->indexInPage = 0;
+    stopAwaiting();
+
+    // The text of the pdf page is extracted in the background: search once it is done
+    if (*text != 0 && awaitPage(control->getCurrentPageNo(), [this]() {
+            search(gtk_entry_get_text(GTK_ENTRY(control->getWindow()->get("searchTextField"))));
+        })) {
+        return;
+    }
 
     if (*text != 0) {
         found = searchTextOnCurrentPage(text, 1, &this->occurrences, nullptr);
@@ -117,7 +152,7 @@ void SearchBar::searchTextChangedCallback(GtkSearchEntry* entry, SearchBar* sear
 void SearchBar::buttonCloseSearchClicked(GtkButton* button, SearchBar* searchBar) { searchBar->showSearchBar(false); }
 
 template <class Fun>
-void SearchBar::search(Fun next) {
+void SearchBar::search(Fun next, size_t originalPage) {
 
     MainWindow* win = control->getWindow();
     GtkWidget* searchTextField = win->get("searchTextField");
@@ -126,12 +161,20 @@ void SearchBar::search(Fun next) {
     if (*text == 0) {
         return;
     }
-    const size_t originalPage = page;
 
     XojPdfRectangle matchRect = XojPdfRectangle();
     // Search backwards through the pages, wrapping around if needed.
     for (;;) {
         next(text);
+        // The text of the pdf page is extracted in the background: go on once it is done
+        if (awaitPage(page, [this, originalPage]() { resumeSearch(originalPage); })) {
+            return;
+        }
+        if (indexInPage == LAST_IN_PAGE) {
+            control->searchTextOnPage(text, page, 1, &occurrences, nullptr);
+            indexInPage = occurrences;
+        }
+
         const bool found = control->searchTextOnPage(text, page, indexInPage, &occurrences, &matchRect);
 
         if (found) {
@@ -153,7 +196,15 @@ void SearchBar::search(Fun next) {
     }
 }
 
+void SearchBar::resumeSearch(size_t originalPage) {
+    // page and indexInPage were already moved to the awaited page
+    search(+[](const char*) {}, originalPage);
+}
+
 void SearchBar::searchNext() {
+    if (awaiting) {
+        return;
+    }
     size_t pageCount = control->getDocument()->getPageCount();
     search([&](const char* text) {
         indexInPage++;
@@ -165,10 +216,13 @@ void SearchBar::searchNext() {
             }
             indexInPage = 1;
         }
-    });
+    }, page);
 }
 
 void SearchBar::searchPrevious() {
+    if (awaiting) {
+        return;
+    }
     size_t pageCount = control->getDocument()->getPageCount();
     search([&](const char* text) {
         indexInPage--;
@@ -178,10 +232,10 @@ void SearchBar::searchPrevious() {
             if (page > pageCount) {
                 page = pageCount - 1;
             }
-            control->searchTextOnPage(text, page, 1, &occurrences, nullptr);
-            indexInPage = occurrences;
+            // Counted by search(), once the page is indexed
+            indexInPage = LAST_IN_PAGE;
         }
-    });
+    }, page);
 }
 
 void SearchBar::showSearchBar(bool show) {
@@ -193,8 +247,11 @@ void SearchBar::showSearchBar(bool show) {
         gtk_widget_show_all(searchBar);
         gtk_widget_grab_focus(searchTextField);
         this->indexInPage = 0;
+        // Extract the text of the pdf in the background: it is then ready when the search moves to other pages
+        control->getSearchIndex()->build();
     } else {
         searchActive = false;
+        stopAwaiting();
         gtk_widget_hide(searchBar);
         const size_t pageCount = control->getDocument()->getPageCount();
         for (size_t i = pageCount - 1; i < pageCount; i--) {
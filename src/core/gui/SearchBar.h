@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+
 #include <gtk/gtk.h>             // for GtkButton, GtkEntry
 #include <gtk/gtkcssprovider.h>  // for GtkCssProvider
 
@@ -40,9 +43,11 @@ private:
      *              * Iterating from page = next(currentPage) by page = next(page) must reach page == currentPage at
      * some point.
      *              * If page is a valid page number, then so is next(page).
+     * If the text of the pdf page is not extracted yet, the search goes on once it is (see awaitPage()).
+     * @param originalPage The page where the search stops
      */
     template <class Fun>
-    void search(Fun next);
+    void search(Fun next, size_t originalPage);
 
     /**
      * @brief Named specialization of search(), where next(page) = (page + 1) % pageCount
@@ -52,10 +57,22 @@ private:
      * @brief Named specialization of search(), where next(page) = (page + pageCount - 1) % pageCount
      */
     void searchPrevious();
+    /**
+     * @brief Goes on with search() after awaitPage()
+     */
+    void resumeSearch(size_t originalPage);
 
     void search(const char* text);
     bool searchTextOnCurrentPage(const char* text, size_t index, size_t* occurrences, XojPdfRectangle* matchRect);
 
+    /**
+     * Waits until the text of the pdf background of the page is extracted, without blocking
+     * @param resume Called on the main thread once it is extracted, unless stopAwaiting() is called before
+     * @return false if there is nothing to wait for: resume is not called
+     */
+    bool awaitPage(size_t pageNo, std::function<void()> resume);
+    void stopAwaiting();
+
 private:
     Control* control;
     GtkCssProvider* cssTextFild;
@@ -63,4 +80,9 @@ private:
     size_t indexInPage = 0;
     size_t occurrences = 0;
     bool searchActive = false;
+    /// Whether a search waits for awaitPage()
+    bool awaiting = false;
+
+    /// Value of indexInPage for the last occurrence on the page, once they are counted
+    static constexpr size_t LAST_IN_PAGE = static_cast<size_t>(-1);
 };
@@ -56,6 +56,9 @@ constexpr int REGULAR_MOVE_AMOUNT = 3;
 constexpr int SMALL_MOVE_AMOUNT = 1;
 constexpr int LARGE_MOVE_AMOUNT = 10;
 
+/// Number of pages whose pdf background is rasterized ahead of the preloaded pages
+constexpr size_t PDF_PREFETCH_PAGES = 2;
+
 std::pair<size_t, size_t> XournalView::preloadPageBounds(size_t page, size_t maxPage) {
     const size_t preloadBefore = this->control->getSettings()->getPreloadPagesBefore();
     const size_t preloadAfter = this->control->getSettings()->getPreloadPagesAfter();
@@ -64,6 +67,32 @@ std::pair<size_t, size_t> XournalView::preloadPageBounds(size_t page, size_t max
     return {lower, upper};
 }
 
+std::pair<size_t, size_t> XournalView::prefetchPageBounds(size_t page, size_t maxPage) {
+    const auto [lower, upper] = preloadPageBounds(page, maxPage);
+    if (this->scrollingForward) {
+        return {upper, std::min(maxPage, upper + PDF_PREFETCH_PAGES)};
+    }
+    return {lower > PDF_PREFETCH_PAGES ? lower - PDF_PREFETCH_PAGES : 0, lower};
+}
+
+void XournalView::prefetchPdfPages(size_t page) {
+    if (!this->cache) {
+        return;
+    }
+    XournalScheduler* scheduler = this->control->getScheduler();
+    // The former prefetches may be in the wrong direction
+    scheduler->removePdfCache(this->cache.get(), false);
+
+    const double zoom = getZoom() * getDpiScaleFactor();
+    const auto [lower, upper] = prefetchPageBounds(page, this->viewPages.size());
+    for (size_t i = lower; i < upper; i++) {
+        const size_t pdfPageNo = this->viewPages[i]->getPage()->getPdfPageNr();
+        if (pdfPageNo != npos) {
+            scheduler->addPdfPrefetch(this->cache.get(), pdfPageNo, zoom);
+        }
+    }
+}
+
 XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* scrollHandling):
         scrollHandling(scrollHandling), control(control) {
     Document* doc = control->getDocument();
@@ -108,6 +137,10 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
 XournalView::~XournalView() {
     g_source_remove(this->cleanupTimeout);
 
+    if (this->cache) {
+        control->getScheduler()->removePdfCache(this->cache.get());
+    }
+
     gtk_widget_destroy(this->widget);
     this->widget = nullptr;
 }
@@ -122,6 +155,8 @@ auto XournalView::cleanupBufferCache() -> void {
     const auto& [pagesLower, pagesUpper] = this->preloadPageBounds(this->currentPage, this->viewPages.size());
     xoj_assert(pagesLower <= pagesUpper);
 
+    const auto& [prefetchLower, prefetchUpper] = this->prefetchPageBounds(this->currentPage, this->viewPages.size());
+
     std::unordered_set<size_t> retainedPdfPages;
 
     for (size_t i = 0; i < this->viewPages.size(); i++) {
@@ -140,6 +175,13 @@ auto XournalView::cleanupBufferCache() -> void {
         }
     }
 
+    for (size_t i = prefetchLower; i < prefetchUpper; i++) {
+        const size_t pdfPageNo = this->viewPages[i]->getPage()->getPdfPageNr();
+        if (pdfPageNo != npos) {
+            retainedPdfPages.insert(pdfPageNo);
+        }
+    }
+
     if (this->cache) {
         this->cache->evictAllExcept(retainedPdfPages);
     }
@@ -399,6 +441,9 @@ void XournalView::pageSelected(size_t page) {
 
     endTextAllPages();
 
+    if (page != npos && this->currentPage != npos && page != this->currentPage) {
+        this->scrollingForward = page > this->currentPage;
+    }
     this->currentPage = page;
 
     size_t pdfPage = npos;
@@ -427,6 +472,10 @@ void XournalView::pageSelected(size_t page) {
             this->viewPages[i]->rerenderPage();
         }
     }
+
+    if (page != npos) {
+        prefetchPdfPages(page);
+    }
 }
 
 auto XournalView::getControl() const -> Control* { return control; }
@@ -527,6 +576,9 @@ auto XournalView::getVisibleRect(const XojPageView* redrawable) const -> Rectang
 }
 
 void XournalView::recreatePdfCache() {
+    if (this->cache) {
+        control->getScheduler()->removePdfCache(this->cache.get());
+    }
     this->cache.reset();
 
     Document* doc = control->getDocument();
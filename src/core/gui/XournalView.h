@@ -165,6 +165,16 @@ private:
 
     std::pair<size_t, size_t> preloadPageBounds(size_t page, size_t maxPage);
 
+    /**
+     * @return The pages, just beyond the preloaded ones in the scrolling direction, whose pdf background is prefetched
+     */
+    std::pair<size_t, size_t> prefetchPageBounds(size_t page, size_t maxPage);
+
+    /**
+     * Rasterizes the pdf backgrounds of the pages returned by prefetchPageBounds() in the background
+     */
+    void prefetchPdfPages(size_t page);
+
     static auto clearMemoryTimer(XournalView* widget) -> gboolean;
 
     void cleanupBufferCache();
@@ -184,6 +194,11 @@ private:
     size_t currentPage = 0;
     size_t lastSelectedPage = npos;
 
+    /**
+     * Whether the last page change went towards the end of the document
+     */
+    bool scrollingForward = true;
+
     std::unique_ptr<PdfCache> cache;
 
     /**
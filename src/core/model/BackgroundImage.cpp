@@ -1,12 +1,14 @@
 #include "BackgroundImage.h"
 
-#include <string>   // for string
-#include <utility>  // for move
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <utility>      // for move
 
-#include <glib-object.h>  // for g_object_unref
+#include <glib.h>  // for g_compute_checksum_for_data, g_free
 
-#include "util/Stacktrace.h"  // for Stacktrace
+#include "util/Stacktrace.h"        // for Stacktrace
 #include "util/StringUtils.h"
+#include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
 
 /*
  * The contents of a background image
@@ -18,38 +20,65 @@
  */
 
 struct BackgroundImage::Content {
-    Content(fs::path path, GError** error):
-            path(std::move(path)), pixbuf(gdk_pixbuf_new_from_file(char_cast(this->path.u8string().c_str()), error)) {}
-
-    Content(GInputStream* stream, fs::path path, GError** error):
-            path(std::move(path)), pixbuf(gdk_pixbuf_new_from_stream(stream, nullptr, error)) {}
-
-    ~Content() {
-        if (this->pixbuf) {
-            g_object_unref(this->pixbuf);
-            this->pixbuf = nullptr;
-        }
-    };
-
-    Content(const Content&) = delete;
-    Content(Content&&) = default;
-    auto operator=(const Content&) -> Content& = delete;
-    auto operator=(Content&&) -> Content& = default;
+    Content(fs::path path, xoj::util::GObjectSPtr<GdkPixbuf> pixbuf):
+            path(std::move(path)), pixbuf(std::move(pixbuf)) {}
 
     fs::path path;
-    GdkPixbuf* pixbuf = nullptr;
+    /// May be shared with the contents of other images with the same data (see PixbufPool)
+    xoj::util::GObjectSPtr<GdkPixbuf> pixbuf;
     int pageId = -1;
     bool attach = false;
 };
 
+auto BackgroundImage::decode(std::string_view data, GError** error, PixbufPool* pool)
+        -> xoj::util::GObjectSPtr<GdkPixbuf> {
+    std::string checksum;
+    if (pool) {
+        gchar* sum = g_compute_checksum_for_data(G_CHECKSUM_SHA256, reinterpret_cast<const guchar*>(data.data()),
+                                                 data.size());
+        checksum = sum;
+        g_free(sum);
+        if (auto it = pool->find(checksum); it != pool->end()) {
+            return it->second;
+        }
+    }
+
+    /**
+     * The input stream does not copy the data: it is only used while the pixbuf is decoded
+     */
+    const xoj::util::GObjectSPtr<GInputStream> stream{
+            g_memory_input_stream_new_from_data(data.data(), static_cast<gssize>(data.size()), nullptr),
+            xoj::util::adopt};
+    xoj::util::GObjectSPtr<GdkPixbuf> pixbuf(gdk_pixbuf_new_from_stream(stream.get(), nullptr, error),
+                                             xoj::util::adopt);
+    g_input_stream_close(stream.get(), nullptr, nullptr);
+
+    if (pool && pixbuf) {
+        pool->emplace(std::move(checksum), pixbuf);
+    }
+    return pixbuf;
+}
+
 void BackgroundImage::free() { this->img.reset(); }
 
-void BackgroundImage::loadFile(fs::path const& path, GError** error) {
-    this->img = std::make_shared<Content>(path, error);
+void BackgroundImage::loadFile(fs::path const& path, GError** error, PixbufPool* pool) {
+    gchar* contents = nullptr;
+    gsize length = 0;
+    if (pool && g_file_get_contents(char_cast(path.u8string().c_str()), &contents, &length, nullptr)) {
+        std::string data(contents, length);
+        g_free(contents);
+        loadData(std::move(data), path, error, pool);
+        return;
+    }
+
+    // Let GdkPixbuf report the errors
+    xoj::util::GObjectSPtr<GdkPixbuf> pixbuf(gdk_pixbuf_new_from_file(char_cast(path.u8string().c_str()), error),
+                                             xoj::util::adopt);
+    this->img = std::make_shared<Content>(path, std::move(pixbuf));
 }
 
-void BackgroundImage::loadFile(GInputStream* stream, fs::path const& path, GError** error) {
-    this->img = std::make_shared<Content>(stream, path, error);
+void BackgroundImage::loadData(std::string data, fs::path const& path, GError** error, PixbufPool* pool) {
+    this->img = std::make_shared<Content>(path, decode(data, error, pool));
 }
 
 auto BackgroundImage::getCloneId() const -> int { return this->img ? this->img->pageId : -1; }
@@ -81,7 +110,7 @@ void BackgroundImage::setAttach(bool attach) {
     this->img->attach = attach;
 }
 
-auto BackgroundImage::getPixbuf() -> GdkPixbuf* { return this->img ? this->img->pixbuf : nullptr; }
-auto BackgroundImage::getPixbuf() const -> const GdkPixbuf* { return this->img ? this->img->pixbuf : nullptr; }
+auto BackgroundImage::getPixbuf() -> GdkPixbuf* { return this->img ? this->img->pixbuf.get() : nullptr; }
+auto BackgroundImage::getPixbuf() const -> const GdkPixbuf* { return this->img ? this->img->pixbuf.get() : nullptr; }
 
 auto BackgroundImage::isEmpty() const -> bool { return !this->img; }
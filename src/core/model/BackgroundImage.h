@@ -11,12 +11,17 @@
 
 #pragma once
 
-#include <memory>  // for shared_ptr
+#include <memory>         // for shared_ptr
+#include <string>         // for string
+#include <string_view>    // for string_view
+#include <unordered_map>  // for unordered_map
 
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for GdkPixbuf
 #include <gio/gio.h>                // for GInputStream
 #include <glib.h>                   // for GError
 
+#include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
+
 #include "filesystem.h"  // for path
 
 struct BackgroundImage {
@@ -24,8 +29,19 @@ struct BackgroundImage {
 
     void free();
 
-    void loadFile(fs::path const& filepath, GError** error);
-    void loadFile(GInputStream* stream, fs::path const& filepath, GError** error);
+    /**
+     * The decoded images, by checksum of the data they were loaded from. The images loaded with the same pool (e.g.
+     * while a document is loaded) share the decoded image of identical data.
+     */
+    using PixbufPool = std::unordered_map<std::string, xoj::util::GObjectSPtr<GdkPixbuf>>;
+
+    /**
+     * Load the image from a file, or from data read from elsewhere (e.g. a zip archive). Only the decoded image is
+     * kept, not the data. The path, the attachment and the clone id belong to this image and its clones, even if the
+     * decoded image is shared through the pool.
+     */
+    void loadFile(fs::path const& filepath, GError** error, PixbufPool* pool = nullptr);
+    void loadData(std::string data, fs::path const& filepath, GError** error, PixbufPool* pool = nullptr);
 
     int getCloneId() const;
     void setCloneId(int id);
@@ -45,5 +61,8 @@ struct BackgroundImage {
 private:
     struct Content;
 
+    /// @return The decoded image of this data: from the pool, or newly decoded
+    static xoj::util::GObjectSPtr<GdkPixbuf> decode(std::string_view data, GError** error, PixbufPool* pool);
+
     std::shared_ptr<Content> img;
 };
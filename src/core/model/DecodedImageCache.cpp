@@ -0,0 +1,136 @@
+#include "DecodedImageCache.h"
+
+#include <algorithm>  // for max, min
+#include <cmath>      // for log2
+#include <memory>     // for shared_ptr
+
+#include <cairo.h>  // for cairo_image_surface_get_height, cairo_ima...
+#include <glib.h>   // for g_warning
+
+#include "model/Image.h"      // for Image
+#include "util/safe_casts.h"  // for floor_cast
+
+auto DecodedImageCache::getInstance() -> DecodedImageCache& {
+    static DecodedImageCache instance;
+    return instance;
+}
+
+auto DecodedImageCache::getLevel(int fullWidth, int fullHeight, double width, double height) -> unsigned int {
+    if (width <= 0 || height <= 0 || fullWidth <= 0 || fullHeight <= 0) {
+        return 0;
+    }
+    // Compare the sides in order, so that the level does not depend on the orientation of the image
+    const double ratio = std::min(std::max(fullWidth, fullHeight) / std::max(width, height),
+                                  std::min(fullWidth, fullHeight) / std::min(width, height));
+    if (ratio < 2) {
+        return 0;
+    }
+    return std::min(MAX_LEVEL, floor_cast<unsigned int>(std::log2(ratio)));
+}
+
+auto DecodedImageCache::get(const Image& image, double width, double height, std::string* error)
+        -> xoj::util::CairoSurfaceSPtr {
+    // Keeps the data alive while it is decoded without the lock: its address is the key of the entry
+    const std::shared_ptr<const std::string> data = image.getSharedData();
+    if (!data || data->empty()) {
+        if (error) {
+            *error = "image has no data, cannot render it!";
+        }
+        return nullptr;
+    }
+    {
+        std::lock_guard lock(this->mutex);
+        if (auto it = this->entries.find(data.get()); it != this->entries.end()) {
+            auto [fullWidth, fullHeight] = it->second.fullSize;
+            Level& level = it->second.levels[getLevel(fullWidth, fullHeight, width, height)];
+            if (level.surface) {
+                // The image may not have been decoded itself, if its data is shared
+                image.setImageSize(it->second.fullSize);
+                this->lru.splice(this->lru.begin(), this->lru, level.lruPos);
+                return level.surface;
+            }
+        }
+    }
+
+    // Decode without holding the lock, other images can be drawn meanwhile
+    unsigned int levelNr = 0;
+    std::pair<int, int> fullSize = Image::NOSIZE;
+    std::string message;
+    xoj::util::CairoSurfaceSPtr surface = Image::decode(*data, width, height, levelNr, fullSize, message);
+    if (!surface) {
+        if (error) {
+            *error = message;
+        } else {
+            g_warning("%s", message.c_str());
+        }
+        return nullptr;
+    }
+
+    std::lock_guard lock(this->mutex);
+    Entry& entry = this->entries[data.get()];
+    entry.fullSize = fullSize;
+    image.setImageSize(fullSize);
+    Level& level = entry.levels[levelNr];
+    if (level.surface) {
+        // Decoded by another thread meanwhile
+        this->lru.splice(this->lru.begin(), this->lru, level.lruPos);
+        return level.surface;
+    }
+    level.surface = surface;
+    level.memory = static_cast<size_t>(cairo_image_surface_get_stride(surface.get())) *
+                   static_cast<size_t>(cairo_image_surface_get_height(surface.get()));
+    level.lruPos = this->lru.emplace(this->lru.begin(), data.get(), levelNr);
+    this->memoryUsage += level.memory;
+    evict();
+    return surface;
+}
+
+void DecodedImageCache::evict() {
+    // The surface which was just decoded is kept, even if it exceeds the budget on its own
+    while (this->memoryUsage > this->memoryBudget && this->lru.size() > 1) {
+        auto [data, levelNr] = this->lru.back();
+        this->lru.pop_back();
+
+        auto it = this->entries.find(data);
+        Level& level = it->second.levels[levelNr];
+        this->memoryUsage -= level.memory;
+        level = Level{};
+        if (std::none_of(it->second.levels.begin(), it->second.levels.end(),
+                         [](const Level& l) { return l.surface.get() != nullptr; })) {
+            this->entries.erase(it);
+        }
+    }
+}
+
+void DecodedImageCache::remove(const std::string* data) {
+    std::lock_guard lock(this->mutex);
+    auto it = this->entries.find(data);
+    if (it == this->entries.end()) {
+        return;
+    }
+    for (Level& level: it->second.levels) {
+        if (level.surface) {
+            this->memoryUsage -= level.memory;
+            this->lru.erase(level.lruPos);
+        }
+    }
+    this->entries.erase(it);
+}
+
+void DecodedImageCache::clear() {
+    std::lock_guard lock(this->mutex);
+    this->entries.clear();
+    this->lru.clear();
+    this->memoryUsage = 0;
+}
+
+void DecodedImageCache::setMemoryBudget(size_t budget) {
+    std::lock_guard lock(this->mutex);
+    this->memoryBudget = budget;
+    evict();
+}
+
+auto DecodedImageCache::getMemoryUsage() -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->memoryUsage;
+}
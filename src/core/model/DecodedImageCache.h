@@ -0,0 +1,101 @@
+/*
+ * Xournal++
+ *
+ * Cache of the decoded surfaces of the images
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>          // for array
+#include <cstddef>        // for size_t
+#include <list>           // for list
+#include <mutex>          // for mutex
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+class Image;
+
+/**
+ * @brief Decoded surfaces of the Image elements, shared by all the views
+ *
+ * The surfaces are shared by the images with the same data (see ImageDataPool).
+ * An image is decoded at the resolution it is drawn at: the level n of an image is the image divided in size by 2^n
+ * (as in a mipmap). Decoding at a higher level is cheaper, as some loaders (e.g. JPEG) skip the details which are not
+ * needed.
+ * When the surfaces exceed the memory budget, the least recently used ones are evicted. They are decoded again from
+ * the data of the image when they are needed.
+ *
+ * The cache is thread safe: the images are drawn by the main thread and by the render jobs.
+ */
+class DecodedImageCache {
+public:
+    DecodedImageCache() = default;
+    DecodedImageCache(const DecodedImageCache&) = delete;
+    DecodedImageCache& operator=(const DecodedImageCache&) = delete;
+
+    static DecodedImageCache& getInstance();
+
+    /**
+     * @param width, height The size, in pixels, at which the image is drawn, or 0 for the full resolution
+     * @param error Set to the error message if the image cannot be decoded
+     * @return The surface of the highest level which is at least that large, or nullptr if the image cannot be
+     * decoded
+     */
+    xoj::util::CairoSurfaceSPtr get(const Image& image, double width = 0, double height = 0,
+                                    std::string* error = nullptr);
+
+    /// Drop the surfaces of the image data, when it is freed
+    void remove(const std::string* data);
+
+    /// Drop all the surfaces
+    void clear();
+
+    /// @param budget The memory the surfaces may use, in bytes
+    void setMemoryBudget(size_t budget);
+
+    /// @return The memory used by the surfaces, in bytes
+    size_t getMemoryUsage();
+
+    /**
+     * @param fullWidth, fullHeight The size of the image at full resolution
+     * @param width, height The size at which it is drawn, 0 for the full resolution
+     * @return The highest level which is at least that large
+     */
+    static unsigned int getLevel(int fullWidth, int fullHeight, double width, double height);
+
+    static constexpr unsigned int MAX_LEVEL = 8;
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+private:
+    void evict();
+
+    /// The data of the image (see Image::getSharedData()) and the level
+    using Key = std::pair<const std::string*, unsigned int>;
+
+    struct Level {
+        xoj::util::CairoSurfaceSPtr surface;
+        size_t memory = 0;
+        /// Position in the lru list
+        std::list<Key>::iterator lruPos;
+    };
+
+    struct Entry {
+        std::pair<int, int> fullSize;
+        std::array<Level, MAX_LEVEL + 1> levels;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<const std::string*, Entry> entries;
+    /// The decoded levels, the most recently used first
+    std::list<Key> lru;
+    size_t memoryUsage = 0;
+    size_t memoryBudget = DEFAULT_MEMORY_BUDGET;
+};
@@ -4,17 +4,19 @@
 #include <array>      // for array
 #include <cmath>      // for sqrt
 #include <memory>
-#include <utility>  // for move, pair
+#include <utility>    // for move, pair
 
 #include <cairo.h>    // for cairo_surface_destroy
 #include <gdk/gdk.h>  // for gdk_cairo_set_sourc...
 #include <glib.h>     // for guchar
 
-#include "model/Element.h"   // for Element, ELEMENT_IMAGE
-#include "util/Assert.h"     // for xoj_assert
-#include "util/Rectangle.h"  // for Rectangle
+#include "model/DecodedImageCache.h"              // for DecodedImageCache
+#include "model/Element.h"                        // for Element, ELEMENT_IMAGE
+#include "model/ImageDataPool.h"                  // for ImageDataPool
+#include "util/Assert.h"                          // for xoj_assert
+#include "util/Rectangle.h"                       // for Rectangle
 #include "util/i18n.h"
-#include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
+#include "util/raii/GObjectSPtr.h"                // for GObjectSPtr
 #include "util/safe_casts.h"
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
@@ -24,11 +26,6 @@ using xoj::util::Rectangle;
 Image::Image(): Element(ELEMENT_IMAGE) {}
 
 Image::~Image() {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
     if (this->format) {
         gdk_pixbuf_format_free(this->format);
         this->format = nullptr;
@@ -41,8 +38,8 @@ auto Image::clone() const -> ElementPtr {
     img->boundingBox = this->boundingBox;
     img->setColor(this->getColor());
     img->data = this->data;
+    img->imageSize = this->imageSize.load();
 
-    img->image = cairo_surface_reference(this->image);
     img->snappedBounds = this->snappedBounds;
     img->sizeCalculated = this->sizeCalculated;
 
@@ -61,11 +58,10 @@ void Image::setHeight(double height) {
 
 void Image::setImage(std::string_view data) { setImage(std::string(data)); }
 
-void Image::setImage(std::string&& data) {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
+void Image::setImage(std::string&& data) { setImage(ImageDataPool::getInstance().intern(std::move(data))); }
+
+void Image::setImage(std::shared_ptr<const std::string> data) {
+    this->imageSize = packSize(NOSIZE);
     this->data = std::move(data);
 
     if (this->format) {
@@ -76,10 +72,10 @@ void Image::setImage(std::string&& data) {
     // FIXME: awful hack to try to parse the format
     std::array<char*, 4096> buffer{};
     xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
-    size_t remaining = this->data.size();
+    size_t remaining = this->data->size();
     while (remaining > 0) {
         size_t readLen = std::min(remaining, buffer.size());
-        if (!gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(this->data.c_str()), readLen,
+        if (!gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(this->data->c_str()), readLen,
                                      nullptr))
             break;
         remaining -= readLen;
@@ -102,103 +98,140 @@ void Image::setImage(std::string&& data) {
 }
 
 void Image::setImage(GdkPixbuf* img) {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-    this->imageSize = {gdk_pixbuf_get_width(img), gdk_pixbuf_get_height(img)};
+    const int width = gdk_pixbuf_get_width(img);
+    const int height = gdk_pixbuf_get_height(img);
+    setImageSize({width, height});
 
-    this->image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->imageSize.first, this->imageSize.second);
-    xoj_assert(this->image != nullptr);
+    xoj::util::CairoSurfaceSPtr image(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                      xoj::util::adopt);
+    xoj_assert(image);
 
     // Paint the pixbuf on to the surface
-    cairo_t* cr = cairo_create(this->image);
+    cairo_t* cr = cairo_create(image.get());
     gdk_cairo_set_source_pixbuf(cr, img, 0, 0);
     cairo_paint(cr);
     cairo_destroy(cr);
 
     const cairo_write_func_t writeFunc = [](void* bufferPtr, const unsigned char* data,
                                             unsigned int length) -> cairo_status_t {
-        reinterpret_cast<decltype(Image::data)*>(bufferPtr)->append(reinterpret_cast<const char*>(data), length);
+        reinterpret_cast<std::string*>(bufferPtr)->append(reinterpret_cast<const char*>(data), length);
         return CAIRO_STATUS_SUCCESS;
     };
-    cairo_surface_write_to_png_stream(image, writeFunc, &data);
+    std::string png;
+    cairo_surface_write_to_png_stream(image.get(), writeFunc, &png);
+    this->data = ImageDataPool::getInstance().intern(std::move(png));
 }
 
 auto Image::renderBuffer() const -> std::optional<std::string> {
-    xoj_assert_message(data.length() > 0, "image has no data, cannot render it!");
-    if (this->image) {
-        // Already rendered
+    xoj_assert_message(hasData(), "image has no data, cannot render it!");
+    if (getImageSize() != NOSIZE) {
+        // Already rendered once: the data is valid
         return std::nullopt;
     }
+    std::string error;
+    if (!DecodedImageCache::getInstance().get(*this, 0, 0, &error)) {
+        return error;
+    }
+    return std::nullopt;
+}
+
+auto Image::decode(const std::string& data, double width, double height, unsigned int& level,
+                   std::pair<int, int>& fullSize, std::string& error) -> xoj::util::CairoSurfaceSPtr {
+    xoj_assert_message(!data.empty(), "image has no data, cannot render it!");
+
+    struct SizeRequest {
+        double width;
+        double height;
+        unsigned int level = 0;
+        /// The size at full resolution, before the orientation is applied
+        std::pair<int, int> fullSize = NOSIZE;
+    } request{width, height};
+
     xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
     g_signal_connect(loader.get(), "size-prepared",
-                     G_CALLBACK(+[](GdkPixbufLoader* self, gint width, gint height, gpointer) {
+                     G_CALLBACK(+[](GdkPixbufLoader* self, gint width, gint height, gpointer d) {
                          static constexpr uint64_t MAX_SIZE =
                                  1 << 25;  ///< Max number of pixels: 32M = more than enough for A4 in 72pp
                          if (width <= 0 || height <= 0) {
-                             g_warning("Image::renderBuffer(): non-positive width/height");
+                             g_warning("Image::decode(): non-positive width/height");
                              return;
                          }
+                         auto* request = static_cast<SizeRequest*>(d);
+                         gint fullWidth = width;
+                         gint fullHeight = height;
                          if (static_cast<uint64_t>(width) * static_cast<uint64_t>(height) > MAX_SIZE) {
                              double ratio = static_cast<double>(width) / static_cast<double>(height);
-                             gint maxHeight = floor_cast<gint>(std::sqrt(MAX_SIZE / ratio));
-                             gint maxWidth = floor_cast<gint>(maxHeight * ratio);
+                             fullHeight = floor_cast<gint>(std::sqrt(MAX_SIZE / ratio));
+                             fullWidth = floor_cast<gint>(fullHeight * ratio);
                              g_warning("Trying to open an image too big %d x %d. Resizing it to %d x %d", width, height,
-                                       maxWidth, maxHeight);
-                             gdk_pixbuf_loader_set_size(self, maxHeight, maxWidth);
+                                       fullWidth, fullHeight);
+                         }
+                         request->fullSize = std::make_pair(fullWidth, fullHeight);
+                         request->level =
+                                 DecodedImageCache::getLevel(fullWidth, fullHeight, request->width, request->height);
+                         const gint divisor = 1 << request->level;
+                         const gint w = std::max(1, (fullWidth + divisor - 1) / divisor);
+                         const gint h = std::max(1, (fullHeight + divisor - 1) / divisor);
+                         if (w != width || h != height) {
+                             gdk_pixbuf_loader_set_size(self, w, h);
                          }
                      }),
-                     nullptr);
+                     &request);
     GError* err = nullptr;
-    bool success = gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(this->data.c_str()),
-                                           this->data.length(), &err);
+    bool success =
+            gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(data.data()), data.length(), &err);
     if (!success) {
         if (err != nullptr) {
-            std::string msg = std::string(_("Failed to load image")) + "\n" + _("Error: ") + err->message;
-            g_free(err);
-            return msg;
+            error = std::string(_("Failed to load image")) + "\n" + _("Error: ") + err->message;
+            g_error_free(err);
         } else {
-            return std::string(_("Failed to load image")) + "\n" + _("Unrecoverable error");
+            error = std::string(_("Failed to load image")) + "\n" + _("Unrecoverable error");
         }
+        return nullptr;
     }
     success = gdk_pixbuf_loader_close(loader.get(), &err);
     if (!success) {
         if (err != nullptr) {
-            std::string msg = std::string(_("Failed to close image stream")) + "\n" + _("Error: ") + err->message;
-            g_free(err);
-            return msg;
+            error = std::string(_("Failed to close image stream")) + "\n" + _("Error: ") + err->message;
+            g_error_free(err);
         } else {
-            return std::string(_("Failed to close image stream")) + "\n" + _("Unrecoverable error");
+            error = std::string(_("Failed to close image stream")) + "\n" + _("Unrecoverable error");
         }
+        return nullptr;
     }
 
     GdkPixbuf* tmp = gdk_pixbuf_loader_get_pixbuf(loader.get());
     xoj_assert(tmp != nullptr);
     xoj::util::GObjectSPtr<GdkPixbuf> pixbuf(gdk_pixbuf_apply_embedded_orientation(tmp), xoj::util::adopt);
 
-    this->imageSize = {gdk_pixbuf_get_width(pixbuf.get()), gdk_pixbuf_get_height(pixbuf.get())};
+    const int surfaceWidth = gdk_pixbuf_get_width(pixbuf.get());
+    const int surfaceHeight = gdk_pixbuf_get_height(pixbuf.get());
+    if (request.fullSize == NOSIZE) {
+        request.fullSize = {gdk_pixbuf_get_width(tmp), gdk_pixbuf_get_height(tmp)};
+    }
+    const bool rotated = surfaceWidth != gdk_pixbuf_get_width(tmp);
+    fullSize = rotated ? std::make_pair(request.fullSize.second, request.fullSize.first) : request.fullSize;
+    level = request.level;
 
     // TODO: pass in window once this code is refactored into ImageView
-    this->image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->imageSize.first, this->imageSize.second);
-    g_assert(this->image != nullptr);
+    xoj::util::CairoSurfaceSPtr image(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, surfaceWidth, surfaceHeight),
+                                      xoj::util::adopt);
+    g_assert(image);
 
     // Paint the pixbuf on to the surface
     // NOTE: we do this manually instead of using gdk_cairo_surface_create_from_pixbuf
     // since this does not work in CLI mode.
-    cairo_t* cr = cairo_create(this->image);
+    cairo_t* cr = cairo_create(image.get());
     gdk_cairo_set_source_pixbuf(cr, pixbuf.get(), 0, 0);
     cairo_paint(cr);
     cairo_destroy(cr);
-    return std::nullopt;
+    return image;
 }
 
-auto Image::getImage() const -> cairo_surface_t* {
-    if (auto opt = renderBuffer(); opt.has_value()) {
-        // An error occurred
-        g_warning("%s", opt->c_str());
-    }
-    return this->image;
+auto Image::getImage() const -> xoj::util::CairoSurfaceSPtr { return getImage(0, 0); }
+
+auto Image::getImage(double width, double height) const -> xoj::util::CairoSurfaceSPtr {
+    return DecodedImageCache::getInstance().get(*this, width, height);
 }
 
 void Image::scale(double x0, double y0, double fx, double fy, double rotation,
@@ -225,7 +258,7 @@ void Image::serialize(ObjectOutputStream& out) const {
     out.writeDouble(this->boundingBox.width);
     out.writeDouble(this->boundingBox.height);
 
-    out.writeImage(this->data);
+    out.writeImage(this->data ? std::string_view(*this->data) : std::string_view());
 
     out.endObject();
 }
@@ -238,12 +271,8 @@ void Image::readSerialized(ObjectInputStream& in) {
     this->boundingBox.width = in.readDouble();
     this->boundingBox.height = in.readDouble();
 
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
-    this->data = in.readImage();
+    this->imageSize = packSize(NOSIZE);
+    this->data = ImageDataPool::getInstance().intern(in.readImage());
 
     in.endObject();
     this->calcSize();
@@ -254,12 +283,21 @@ void Image::calcSize() const {
     this->sizeCalculated = true;
 }
 
-bool Image::hasData() const { return !this->data.empty(); }
+bool Image::hasData() const { return this->data && !this->data->empty(); }
+
+const unsigned char* Image::getRawData() const {
+    return this->data ? reinterpret_cast<const unsigned char*>(this->data->data()) : nullptr;
+}
 
-const unsigned char* Image::getRawData() const { return reinterpret_cast<const unsigned char*>(this->data.data()); }
+size_t Image::getRawDataLength() const { return this->data ? this->data->size() : 0; }
 
-size_t Image::getRawDataLength() const { return this->data.size(); }
+auto Image::getSharedData() const -> const std::shared_ptr<const std::string>& { return this->data; }
+
+std::pair<int, int> Image::getImageSize() const {
+    const uint64_t size = this->imageSize;
+    return {static_cast<int>(static_cast<uint32_t>(size >> 32U)), static_cast<int>(static_cast<uint32_t>(size))};
+}
 
-std::pair<int, int> Image::getImageSize() const { return this->imageSize; }
+void Image::setImageSize(std::pair<int, int> size) const { this->imageSize = packSize(size); }
 
 GdkPixbufFormat* Image::getImageFormat() const { return this->format; }
@@ -11,7 +11,10 @@
 
 #pragma once
 
+#include <atomic>       // for atomic
 #include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t, uint64_t
+#include <memory>       // for shared_ptr
 #include <optional>     // for optional
 #include <string>       // for string
 #include <string_view>  // for string_view
@@ -20,6 +23,8 @@
 #include <cairo.h>                  // for cairo_surface_t, cairo_status_t
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for GdkPixbufFormat, GdkPixbuf
 
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
 #include "Element.h"  // for Element
 
 class ObjectInputStream;
@@ -42,9 +47,12 @@ public:
     /// Set the image data by copying the data from the provided string_view.
     void setImage(std::string_view data);
 
-    /// Set the image data by moving the data.
+    /// Set the image data by moving the data. Images with the same data share it (see ImageDataPool).
     void setImage(std::string&& data);
 
+    /// Share the image data with other images. The data must come from ImageDataPool::intern().
+    void setImage(std::shared_ptr<const std::string> data);
+
     /// Set the image data by copying the data from the provided pixbuf.
     ///
     /// \deprecated Pass the raw image data instead.
@@ -56,8 +64,12 @@ public:
     /// Returns std::nullopt on success, an error message on failure
     std::optional<std::string> renderBuffer() const;
 
-    /// Returns the internal surface that contains the rendered image data.
-    cairo_surface_t* getImage() const;
+    /// Returns a surface that contains the rendered image data at full resolution.
+    xoj::util::CairoSurfaceSPtr getImage() const;
+
+    /// Returns a surface that contains the rendered image data, at least as large as width x height pixels (but
+    /// possibly smaller than the full resolution). See DecodedImageCache.
+    xoj::util::CairoSurfaceSPtr getImage(double width, double height) const;
 
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
@@ -72,6 +84,9 @@ public:
     /// Return the length of the raw data.
     size_t getRawDataLength() const;
 
+    /// Return the raw data, shared with the other images with the same data.
+    const std::shared_ptr<const std::string>& getSharedData() const;
+
     /// Return the size of the raw image, or (-1, -1) if the image has not been rendered yet.
     std::pair<int, int> getImageSize() const;
 
@@ -87,13 +102,24 @@ public:
 private:
     void calcSize() const override;
 
-private:
-    /// Temporary surface used as a render buffer.
-    mutable cairo_surface_t* image = nullptr;
+    /// Decode the image data at the highest mipmap level which is at least width x height pixels large (0 for the
+    /// full resolution). Sets `level` to this level and `fullSize` to the size of the raw image, or `error` and
+    /// returns nullptr on failure. Runs on any thread.
+    static xoj::util::CairoSurfaceSPtr decode(const std::string& data, double width, double height,
+                                              unsigned int& level, std::pair<int, int>& fullSize, std::string& error);
+    /// Called by the DecodedImageCache, on any thread
+    void setImageSize(std::pair<int, int> size) const;
+    friend class DecodedImageCache;
+
+    static constexpr uint64_t packSize(std::pair<int, int> size) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(size.first)) << 32U | static_cast<uint32_t>(size.second);
+    }
 
+private:
     /// Image format information.
     mutable GdkPixbufFormat* format = nullptr;
-    mutable std::pair<int, int> imageSize = {-1, -1};
+    /// The size of the raw image (see packSize()), set by the threads which decode it
+    mutable std::atomic<uint64_t> imageSize{packSize(NOSIZE)};
 
-    std::string data;
+    std::shared_ptr<const std::string> data;
 };
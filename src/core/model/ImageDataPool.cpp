@@ -0,0 +1,56 @@
+#include "ImageDataPool.h"
+
+#include <functional>   // for hash
+#include <string_view>  // for string_view
+#include <utility>      // for move
+#include <vector>       // for vector
+
+#include "model/DecodedImageCache.h"  // for DecodedImageCache
+
+auto ImageDataPool::getInstance() -> ImageDataPool& {
+    static ImageDataPool instance;
+    return instance;
+}
+
+auto ImageDataPool::intern(std::string data) -> std::shared_ptr<const std::string> {
+    const size_t hash = std::hash<std::string_view>{}(data);
+
+    // The buffers locked while searching are released after the mutex: releasing the last reference locks it
+    std::vector<std::shared_ptr<const std::string>> candidates;
+    std::lock_guard lock(this->mutex);
+    auto [begin, end] = this->buffers.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        // The buffer may be expired, and waiting to be released
+        if (auto buffer = it->second.ref.lock(); buffer && *buffer == data) {
+            return buffer;
+        } else if (buffer) {
+            candidates.emplace_back(std::move(buffer));
+        }
+    }
+
+    auto* raw = new std::string(std::move(data));
+    std::shared_ptr<const std::string> buffer(raw, [this, hash](const std::string* p) {
+        release(p, hash);
+        delete p;
+    });
+    this->buffers.emplace(hash, Buffer{raw, buffer});
+    return buffer;
+}
+
+void ImageDataPool::release(const std::string* data, size_t hash) {
+    DecodedImageCache::getInstance().remove(data);
+
+    std::lock_guard lock(this->mutex);
+    auto [begin, end] = this->buffers.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second.data == data) {
+            this->buffers.erase(it);
+            return;
+        }
+    }
+}
+
+auto ImageDataPool::size() -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->buffers.size();
+}
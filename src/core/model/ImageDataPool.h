@@ -0,0 +1,54 @@
+/*
+ * Xournal++
+ *
+ * Shared storage of the encoded data of the images
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <memory>         // for shared_ptr, weak_ptr
+#include <mutex>          // for mutex
+#include <string>         // for string
+#include <unordered_map>  // for unordered_multimap
+
+/**
+ * @brief Content-addressed storage of the encoded image data
+ *
+ * The images with identical data (e.g. a screenshot pasted on many pages) share one buffer, and thus one decoded
+ * surface in the DecodedImageCache, which is keyed by the buffer. A buffer is freed, and its surfaces are dropped from
+ * the cache, when the last image using it is destroyed.
+ *
+ * The pool is thread safe: the documents are loaded on other threads.
+ */
+class ImageDataPool {
+public:
+    ImageDataPool() = default;
+    ImageDataPool(const ImageDataPool&) = delete;
+    ImageDataPool& operator=(const ImageDataPool&) = delete;
+
+    static ImageDataPool& getInstance();
+
+    /// @return A buffer holding `data`, shared with all the other users of the same data
+    std::shared_ptr<const std::string> intern(std::string data);
+
+    /// @return The number of distinct buffers in use
+    size_t size();
+
+private:
+    void release(const std::string* data, size_t hash);
+
+    struct Buffer {
+        const std::string* data;
+        std::weak_ptr<const std::string> ref;
+    };
+
+    std::mutex mutex;
+    /// The buffers in use, by hash of their contents
+    std::unordered_multimap<size_t, Buffer> buffers;
+};
@@ -1,5 +1,6 @@
 #include "Layer.h"
 
+#include <algorithm>  // for sort, min
 #include <cstddef>
 #include <memory>
 #include <utility>
@@ -9,7 +10,9 @@
 
 #include "model/Element.h"  // for Element, Element::Index, Element::Inval...
 #include "model/ElementInsertionPosition.h"
-#include "util/Assert.h"      // for xoj_assert
+#include "model/LayerSpatialIndex.h"  // for LayerSpatialIndex
+#include "util/Assert.h"              // for xoj_assert
+#include "util/Range.h"               // for Range
 #include "util/Stacktrace.h"  // for Stacktrace
 #include "util/safe_casts.h"
 
@@ -38,7 +41,15 @@ void Layer::addElement(ElementPtr e) {
         return;
     }
 
+    std::lock_guard lock(indexMutex);
+    if (spatialIndex) {
+        spatialIndex->insert(e.get());
+    }
+    if (positionsValid) {
+        positions.emplace(e.get(), static_cast<Element::Index>(this->elements.size()));
+    }
     this->elements.emplace_back(std::move(e));
+    this->modificationCount++;
 }
 
 void Layer::insertElement(ElementPtr e, Element::Index pos) {
@@ -54,12 +65,20 @@ void Layer::insertElement(ElementPtr e, Element::Index pos) {
         pos = 0;
     }
 
+    std::lock_guard lock(indexMutex);
+    if (spatialIndex) {
+        spatialIndex->insert(e.get());
+    }
+
     // If the element should be inserted at the top
     if (pos >= static_cast<int>(this->elements.size())) {
+        pos = static_cast<Element::Index>(this->elements.size());
         this->elements.push_back(std::move(e));
     } else {
         this->elements.insert(this->elements.begin() + pos, std::move(e));
     }
+    updatePositionsFrom(static_cast<size_t>(pos));
+    this->modificationCount++;
 }
 
 auto Layer::indexOf(const Element* e) const -> Element::Index {
@@ -75,8 +94,16 @@ auto Layer::indexOf(const Element* e) const -> Element::Index {
 auto Layer::removeElement(const Element* e) -> InsertionPosition {
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (e == this->elements[i].get()) {
+            std::lock_guard lock(indexMutex);
+            if (spatialIndex) {
+                spatialIndex->remove(e);
+            }
+            positions.erase(e);
+
             auto res = std::move(this->elements[i]);
             this->elements.erase(this->elements.begin() + i);
+            updatePositionsFrom(i);
+            this->modificationCount++;
             return InsertionPosition{std::move(res), i};
         }
     }
@@ -88,9 +115,17 @@ auto Layer::removeElement(const Element* e) -> InsertionPosition {
 
 auto Layer::removeElementAt(const Element* e, Element::Index pos) -> InsertionPosition {
     if (pos >= 0 && as_unsigned(pos) < elements.size() && this->elements[as_unsigned(pos)].get() == e) {
+        std::lock_guard lock(indexMutex);
+        if (spatialIndex) {
+            spatialIndex->remove(e);
+        }
+        positions.erase(e);
+
         auto iter = std::next(this->elements.begin(), pos);
         auto res = std::move(*iter);
         this->elements.erase(iter);
+        updatePositionsFrom(as_unsigned(pos));
+        this->modificationCount++;
         return InsertionPosition{std::move(res), pos};
     }
     return removeElement(e);
@@ -113,11 +148,29 @@ auto Layer::removeElementsAt(InsertionOrderRef const& elts) -> InsertionOrder {
         }
         res.emplace_back(std::move(elements[static_cast<size_t>(pos)]), pos);
     }
+
+    std::lock_guard lock(indexMutex);
+    auto firstRemoved = static_cast<size_t>(endIndex);
+    for (auto&& [e, p]: res) {
+        if (spatialIndex) {
+            spatialIndex->remove(e.get());
+        }
+        positions.erase(e.get());
+        firstRemoved = std::min(firstRemoved, static_cast<size_t>(p));
+    }
     this->elements.erase(std::remove(this->elements.begin(), this->elements.end(), nullptr), this->elements.end());
+    updatePositionsFrom(firstRemoved);
+    this->modificationCount++;
     return res;
 }
 
-auto Layer::clearNoFree() -> std::vector<ElementPtr> { return std::move(this->elements); }
+auto Layer::clearNoFree() -> std::vector<ElementPtr> {
+    std::lock_guard lock(indexMutex);
+    spatialIndex.reset();
+    invalidatePositions();
+    this->modificationCount++;
+    return std::move(this->elements);
+}
 
 auto Layer::isAnnotated() const -> bool { return !this->elements.empty(); }
 
@@ -129,7 +182,10 @@ auto Layer::isVisible() const -> bool { return visible; }
 /**
  * @return true if the layer is visible
  */
-void Layer::setVisible(bool visible) { this->visible = visible; }
+void Layer::setVisible(bool visible) {
+    this->visible = visible;
+    this->modificationCount++;
+}
 
 auto Layer::getElements() -> std::vector<ElementPtr>& { return this->elements; }
 
@@ -137,9 +193,86 @@ auto Layer::getElementsView() const -> xoj::util::PointerContainerView<std::vect
     return this->elements;
 }
 
+void Layer::forEachElementIntersecting(const Range& rg, const std::function<void(Element*, Element::Index)>& f) {
+    for (auto&& [e, pos]: findElementsIntersecting(rg)) {
+        f(e, pos);
+    }
+}
+
+void Layer::forEachElementIntersecting(const Range& rg,
+                                       const std::function<void(const Element*, Element::Index)>& f) const {
+    for (auto&& [e, pos]: findElementsIntersecting(rg)) {
+        f(e, pos);
+    }
+}
+
+auto Layer::findElementsIntersecting(const Range& rg) const -> std::vector<std::pair<Element*, Element::Index>> {
+    std::vector<std::pair<Element*, Element::Index>> result;
+    if (!rg.isValid()) {
+        return result;
+    }
+
+    std::lock_guard lock(indexMutex);
+    if (!spatialIndex) {
+        spatialIndex = std::make_unique<LayerSpatialIndex>();
+        for (auto const& e: this->elements) {
+            spatialIndex->insert(e.get());
+        }
+    }
+    if (!positionsValid) {
+        positions.clear();
+        positions.reserve(this->elements.size());
+        Element::Index pos = 0;
+        for (auto const& e: this->elements) {
+            positions.emplace(e.get(), pos++);
+        }
+        positionsValid = true;
+    }
+
+    std::vector<const Element*> candidates;
+    spatialIndex->query(rg, candidates);
+
+    result.reserve(candidates.size());
+    for (const Element* e: candidates) {
+        // The index may be coarse: check against the actual bounding box
+        Range box(e->getBoundingBox());
+        if (box.minX <= rg.maxX && rg.minX <= box.maxX && box.minY <= rg.maxY && rg.minY <= box.maxY) {
+            Element::Index pos = positions.at(e);
+            result.emplace_back(this->elements[static_cast<size_t>(pos)].get(), pos);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](auto const& a, auto const& b) { return a.second < b.second; });
+    return result;
+}
+
+auto Layer::updateElementBounds(const Element* e) -> bool {
+    this->modificationCount++;
+    std::lock_guard lock(indexMutex);
+    // Without index, there is nothing to update: it will be built from the current bounding boxes
+    return spatialIndex && spatialIndex->update(e);
+}
+
+void Layer::invalidatePositions() {
+    positions.clear();
+    positionsValid = false;
+}
+
+void Layer::updatePositionsFrom(size_t first) {
+    if (!positionsValid) {
+        return;
+    }
+    for (size_t i = first; i < this->elements.size(); i++) {
+        positions.insert_or_assign(this->elements[i].get(), static_cast<Element::Index>(i));
+    }
+}
 
 auto Layer::hasName() const -> bool { return name.has_value(); }
 
 auto Layer::getName() const -> std::string { return name.value_or(""); }
 
-void Layer::setName(const std::string& newName) { this->name = newName; }
+void Layer::setName(const std::string& newName) {
+    this->name = newName;
+    this->modificationCount++;
+}
+
+auto Layer::getModificationCount() const -> uint64_t { return this->modificationCount; }
@@ -11,11 +11,17 @@
 
 #pragma once
 
-#include <cstddef>   // for size_t
-#include <memory>    // for unique_ptr
-#include <optional>  // for optional
-#include <string>    // for string
-#include <vector>    // for vector
+#include <atomic>         // for atomic
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <functional>     // for function
+#include <memory>         // for unique_ptr
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
 
 #include "util/PointerContainerView.h"
 
@@ -25,6 +31,9 @@
 template <class T>
 using optional = std::optional<T>;
 
+class LayerSpatialIndex;
+class Range;
+
 class Layer {
 public:
     Layer();
@@ -77,11 +86,34 @@ public:
 
     /**
      * Returns an iteratable over the Element%s contained in this Layer
+     *
+     * @note Do not add or remove elements through this reference: use addElement() or removeElement() instead, so the
+     * spatial index stays in sync.
      */
     auto getElements() -> std::vector<ElementPtr>&;
 
     auto getElementsView() const -> xoj::util::PointerContainerView<std::vector<ElementPtr>>;
 
+    /**
+     * Calls f on every Element whose bounding box intersects rg, in the order of the Layer%s internal list, together
+     * with its index in this list.
+     * This relies on a spatial index and is much faster than going through all the elements on dense layers.
+     *
+     * @note The matching elements are collected before the first call to f, so f may modify the Layer. The indices
+     * passed to f are those from before any such modification.
+     */
+    void forEachElementIntersecting(const Range& rg, const std::function<void(Element*, Element::Index)>& f);
+    void forEachElementIntersecting(const Range& rg,
+                                    const std::function<void(const Element*, Element::Index)>& f) const;
+
+    /**
+     * Must be called after an Element of this Layer has been modified in place in a way that changes its bounding box
+     * (move, scale, rotation, width or font change...)
+     * @return true if the Element was found in the spatial index. In particular, returns false if the index has not
+     * been built yet (there is then nothing to update).
+     */
+    bool updateElementBounds(const Element* e);
+
     /**
      * Returns whether or not the Layer is empty
      */
@@ -117,9 +149,50 @@ public:
      */
     void setName(const std::string& newName);
 
+    /**
+     * @return A counter incremented by every change of the Layer made through its member functions, including
+     * updateElementBounds(). Used to find out whether the Layer changed since a given point in time.
+     */
+    auto getModificationCount() const -> uint64_t;
+
+private:
+    /**
+     * Returns the elements whose bounding box intersects rg, sorted by their index
+     */
+    auto findElementsIntersecting(const Range& rg) const -> std::vector<std::pair<Element*, Element::Index>>;
+
+    /**
+     * Marks the element positions cache as outdated. Call after any change to the order of the elements.
+     */
+    void invalidatePositions();
+
+    /**
+     * Renumbers the cached positions of the elements from index first on, after an insertion or a removal at first.
+     * The elements before it keep their position, so appending or removing the topmost element costs O(1).
+     * Does nothing if the cache is not built.
+     */
+    void updatePositionsFrom(size_t first);
+
 private:
     std::vector<ElementPtr> elements;
 
+    /**
+     * Spatial index over the elements. It is only built on the first query so that Layer%s that are never queried
+     * (e.g. when exporting from the command line) do not pay for it. Protected by indexMutex.
+     */
+    mutable std::unique_ptr<LayerSpatialIndex> spatialIndex;
+
+    /**
+     * Cache of the positions of the elements in the list, built lazily and then kept up to date by the insertions and
+     * removals. Protected by indexMutex.
+     */
+    mutable std::unordered_map<const Element*, Element::Index> positions;
+    mutable bool positionsValid = false;
+
+    mutable std::mutex indexMutex;
+
+    std::atomic<uint64_t> modificationCount = 0;
+
     bool visible = true;
 
     std::optional<std::string> name;
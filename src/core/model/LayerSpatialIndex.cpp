@@ -0,0 +1,158 @@
+#include "LayerSpatialIndex.h"
+
+#include <algorithm>  // for max, find, min
+#include <cmath>      // for floor, isnan
+#include <limits>     // for numeric_limits
+
+#include "model/Element.h"  // for Element
+#include "util/Range.h"     // for Range
+
+static int32_t toCell(double v, int32_t nanValue) {
+    if (std::isnan(v)) {
+        return nanValue;
+    }
+    const double c = std::floor(v / LayerSpatialIndex::CELL_SIZE);
+    constexpr double lowest = std::numeric_limits<int32_t>::lowest();
+    constexpr double highest = std::numeric_limits<int32_t>::max();
+    return static_cast<int32_t>(std::clamp(c, lowest, highest));
+}
+
+auto LayerSpatialIndex::cellsOf(const Range& rg) -> CellRange {
+    constexpr int32_t lowest = std::numeric_limits<int32_t>::lowest();
+    constexpr int32_t highest = std::numeric_limits<int32_t>::max();
+    return {toCell(rg.minX, lowest), toCell(rg.minY, lowest), toCell(rg.maxX, highest), toCell(rg.maxY, highest)};
+}
+
+auto LayerSpatialIndex::key(int32_t x, int32_t y) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+auto LayerSpatialIndex::CellRange::cellCount() const -> int64_t {
+    if (maxX < minX || maxY < minY) {
+        return 0;
+    }
+    return (static_cast<int64_t>(maxX) - minX + 1) * (static_cast<int64_t>(maxY) - minY + 1);
+}
+
+auto LayerSpatialIndex::CellRange::overlaps(const CellRange& o) const -> bool {
+    return minX <= o.maxX && o.minX <= maxX && minY <= o.maxY && o.minY <= maxY;
+}
+
+auto LayerSpatialIndex::isOversized(const CellRange& cells) -> bool {
+    // A product of two int32 ranges can overflow int64: test each side first
+    auto width = static_cast<int64_t>(cells.maxX) - cells.minX + 1;
+    auto height = static_cast<int64_t>(cells.maxY) - cells.minY + 1;
+    return width > MAX_CELLS_PER_ELEMENT || height > MAX_CELLS_PER_ELEMENT || width * height > MAX_CELLS_PER_ELEMENT;
+}
+
+void LayerSpatialIndex::insert(const Element* e) {
+    auto cellRange = cellsOf(Range(e->getBoundingBox()));
+    if (cellRange.cellCount() == 0) {
+        // Invalid bounding box: we cannot locate the element. Make sure it is always reported.
+        cellRange = {std::numeric_limits<int32_t>::lowest(), std::numeric_limits<int32_t>::lowest(),
+                     std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max()};
+    }
+    auto [it, inserted] = entries.emplace(e, cellRange);
+    if (!inserted) {
+        // Already indexed: refresh instead
+        update(e);
+        return;
+    }
+
+    if (isOversized(cellRange)) {
+        oversized.push_back(e);
+        return;
+    }
+    for (int32_t x = cellRange.minX; x <= cellRange.maxX; x++) {
+        for (int32_t y = cellRange.minY; y <= cellRange.maxY; y++) {
+            cells[key(x, y)].push_back({e, cellRange.minX, cellRange.minY});
+        }
+    }
+}
+
+auto LayerSpatialIndex::remove(const Element* e) -> bool {
+    auto it = entries.find(e);
+    if (it == entries.end()) {
+        return false;
+    }
+    const CellRange cellRange = it->second;
+    entries.erase(it);
+
+    if (isOversized(cellRange)) {
+        oversized.erase(std::find(oversized.begin(), oversized.end(), e));
+        return true;
+    }
+    for (int32_t x = cellRange.minX; x <= cellRange.maxX; x++) {
+        for (int32_t y = cellRange.minY; y <= cellRange.maxY; y++) {
+            auto cellIt = cells.find(key(x, y));
+            if (cellIt == cells.end()) {
+                continue;
+            }
+            auto& cell = cellIt->second;
+            auto entryIt = std::find_if(cell.begin(), cell.end(), [e](const CellEntry& c) { return c.e == e; });
+            if (entryIt != cell.end()) {
+                // The order within a cell is irrelevant
+                *entryIt = cell.back();
+                cell.pop_back();
+            }
+            if (cell.empty()) {
+                cells.erase(cellIt);
+            }
+        }
+    }
+    return true;
+}
+
+auto LayerSpatialIndex::update(const Element* e) -> bool {
+    if (!remove(e)) {
+        return false;
+    }
+    insert(e);
+    return true;
+}
+
+void LayerSpatialIndex::clear() {
+    cells.clear();
+    entries.clear();
+    oversized.clear();
+}
+
+void LayerSpatialIndex::query(const Range& rg, std::vector<const Element*>& result) const {
+    if (!rg.isValid() || entries.empty()) {
+        return;
+    }
+    const CellRange q = cellsOf(rg);
+
+    if (q.cellCount() > static_cast<int64_t>(cells.size())) {
+        // The query covers more cells than there are non-empty ones: a linear scan is cheaper
+        for (auto&& [e, cellRange]: entries) {
+            if (cellRange.overlaps(q)) {
+                result.push_back(e);
+            }
+        }
+        return;
+    }
+
+    for (const Element* e: oversized) {
+        if (entries.at(e).overlaps(q)) {
+            result.push_back(e);
+        }
+    }
+
+    for (int32_t x = q.minX; x <= q.maxX; x++) {
+        for (int32_t y = q.minY; y <= q.maxY; y++) {
+            auto cellIt = cells.find(key(x, y));
+            if (cellIt == cells.end()) {
+                continue;
+            }
+            for (const CellEntry& c: cellIt->second) {
+                // Only report the element in the first cell it shares with the query
+                if (std::max(c.minX, q.minX) == x && std::max(c.minY, q.minY) == y) {
+                    result.push_back(c.e);
+                }
+            }
+        }
+    }
+}
+
+auto LayerSpatialIndex::size() const -> size_t { return entries.size(); }
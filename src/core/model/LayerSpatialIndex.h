@@ -0,0 +1,87 @@
+/*
+ * Xournal++
+ *
+ * Spatial index over the elements of a layer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for int32_t, int64_t, uint64_t
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+class Element;
+class Range;
+
+/**
+ * @brief Uniform grid over the bounding boxes of Element%s
+ *
+ * The plane is divided into square cells of side CELL_SIZE. Every element is registered in all the cells its bounding
+ * box (at the time of insertion/update) touches. Elements spanning too many cells are stored in a separate list and
+ * are reported by every query.
+ *
+ * The index does not own the elements. It is not thread safe: the owner (see Layer) is responsible for the locking.
+ */
+class LayerSpatialIndex {
+public:
+    LayerSpatialIndex() = default;
+
+    void insert(const Element* e);
+
+    /**
+     * @return false if e was not in the index
+     */
+    bool remove(const Element* e);
+
+    /**
+     * Registers e again, after its bounding box has changed.
+     * @return false if e was not in the index (nothing is done in that case)
+     */
+    bool update(const Element* e);
+
+    void clear();
+
+    /**
+     * Appends to result the elements whose bounding box (as it was when the element was indexed) may intersect rg.
+     * Every element is reported at most once, in no particular order.
+     */
+    void query(const Range& rg, std::vector<const Element*>& result) const;
+
+    [[nodiscard]] size_t size() const;
+
+    static constexpr double CELL_SIZE = 32.0;
+    /// Elements whose bounding box spans more cells are not put in the grid
+    static constexpr int64_t MAX_CELLS_PER_ELEMENT = 256;
+
+private:
+    struct CellRange {
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+
+        [[nodiscard]] int64_t cellCount() const;
+        [[nodiscard]] bool overlaps(const CellRange& o) const;
+    };
+
+    struct CellEntry {
+        const Element* e;
+        /// First cell of the element, used to report elements spanning several cells only once
+        int32_t minX;
+        int32_t minY;
+    };
+
+    static CellRange cellsOf(const Range& rg);
+    static uint64_t key(int32_t x, int32_t y);
+    static bool isOversized(const CellRange& cells);
+
+    std::unordered_map<uint64_t, std::vector<CellEntry>> cells;
+    std::unordered_map<const Element*, CellRange> entries;
+    std::vector<const Element*> oversized;
+};
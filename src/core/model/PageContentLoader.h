@@ -0,0 +1,39 @@
+/*
+ * Xournal++
+ *
+ * Loads the contents of a page on demand
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+class Layer;
+
+/**
+ * @brief Source of the layers of a page that was not entirely loaded with its document.
+ * See LoadHandler::setLazyLoading()
+ */
+class PageContentLoader {
+public:
+    virtual ~PageContentLoader() = default;
+
+    /**
+     * Create the layers of the page. Called once, the first time the layers of the page are accessed, possibly from
+     * another thread than the main thread.
+     * @return The layers, at least one. The caller takes ownership.
+     */
+    virtual std::vector<Layer*> loadLayers() = 0;
+
+    /**
+     * @return Why loadLayers() could not create all the contents of the page, or an empty string if it did.
+     * A page with missing contents must not be saved, since that would overwrite them.
+     */
+    virtual std::string getError() const = 0;
+};
@@ -18,23 +18,28 @@ void PageHandler::addListener(PageListener* l) { this->listeners.push_back(l); }
 void PageHandler::removeListener(PageListener* l) { this->listeners.remove(l); }
 
 void PageHandler::fireRectChanged(Rectangle<double>& rect) {
+    this->modificationCount++;
     for (PageListener* pl: this->listeners) { pl->rectChanged(rect); }
 }
 
 void PageHandler::fireRangeChanged(Range& range) {
+    this->modificationCount++;
     for (PageListener* pl: this->listeners) { pl->rangeChanged(range); }
 }
 
 void PageHandler::fireElementChanged(const Element* elem) {
+    this->modificationCount++;
     for (PageListener* pl: this->listeners) { pl->elementChanged(elem); }
 }
 
 void PageHandler::fireElementsChanged(const std::vector<const Element*>& elements, Range range) {
+    this->modificationCount++;
     for (PageListener* pl: this->listeners) {
         pl->elementsChanged(elements, range);
     }
 }
 
 void PageHandler::firePageChanged() {
+    this->modificationCount++;
     for (PageListener* pl: this->listeners) { pl->pageChanged(); }
 }
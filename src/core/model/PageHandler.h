@@ -11,7 +11,9 @@
 
 #pragma once
 
-#include <list>  // for list
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint64_t
+#include <list>     // for list
 #include <vector>
 
 #include "util/Range.h"  // for Range
@@ -41,6 +43,12 @@ public:
     void fireElementsChanged(const std::vector<const Element*>& elements, Range range = Range());
     void firePageChanged();
 
+protected:
+    /**
+     * Counts the changes of the page: incremented by the fire*() functions and by the setters of the page
+     */
+    std::atomic<uint64_t> modificationCount = 0;
+
 private:
     void addListener(PageListener* l);
     void removeListener(PageListener* l);
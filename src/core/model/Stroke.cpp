@@ -1,14 +1,15 @@
 #include "Stroke.h"
 
-#include <algorithm>  // for min, max, copy
+#include <algorithm>  // for min, max, clamp
+#include <array>      // for array
 #include <cmath>      // for abs, hypot, sqrt
 #include <cstdint>    // for uint64_t
-#include <iterator>   // for back_insert_iterator
+#include <iterator>   // for next
 #include <limits>     // for numeric_limits
 #include <memory>
-#include <numeric>    // for accumulate
 #include <optional>   // for optional, nullopt
 #include <string>     // for to_string, operator<<
+#include <utility>    // for move
 
 #include <cairo.h>  // for cairo_matrix_translate
 #include <glib.h>   // for g_free, g_message
@@ -18,12 +19,12 @@
 #include "model/Element.h"                        // for Element, ELEMENT_ST...
 #include "model/LineStyle.h"                      // for LineStyle
 #include "model/Point.h"                          // for Point, Point::NO_PR...
+#include "model/StrokePoints.h"                   // for StrokePoints
+#include "model/StrokeSegmentTree.h"              // for StrokeSegmentTree
 #include "util/Assert.h"                          // for xoj_assert
-#include "util/BasePointerIterator.h"             // for BasePointerIterator
 #include "util/Interval.h"                        // for Interval
-#include "util/PairView.h"                        // for PairView<>::BaseIte...
-#include "util/PairView.h"                        // for PairView
 #include "util/PlaceholderString.h"               // for PlaceholderString
+#include "util/PointArrayKernels.h"               // for minMax, maxValue, findSegmentTouchingBox
 #include "util/Point.h"                           // for xoj::util::Point<>
 #include "util/Rectangle.h"                       // for Rectangle
 #include "util/SmallVector.h"                     // for SmallVector
@@ -49,6 +50,9 @@ using xoj::util::Rectangle;
 #define DEBUG_ERASER(f)
 #endif
 
+/// Tolerance of the eraser test in Stroke::intersects()
+constexpr double INTERSECTION_PADDING = 0.1;
+
 template <typename Float>
 constexpr void updateBoundingBox(Rectangle<Float>& box, Point const& p, double half_width) {
     {
@@ -105,6 +109,7 @@ auto Stroke::cloneStroke() const -> std::unique_ptr<Stroke> {
     s->boundingBox = this->boundingBox;
     s->snappedBounds = this->snappedBounds;
     s->sizeCalculated = this->sizeCalculated;
+    s->segmentTree = this->segmentTree;
     return s;
 }
 
@@ -120,16 +125,12 @@ std::unique_ptr<Stroke> Stroke::cloneSection(const PathParameter& lowerBound, co
 
     s->points.reserve(upperBound.index - lowerBound.index + 2);
 
-    s->points.emplace_back(this->getPoint(lowerBound));
-
-    auto beginIt = std::next(this->points.cbegin(), (std::ptrdiff_t)lowerBound.index + 1);
-    auto endIt = std::next(this->points.cbegin(), (std::ptrdiff_t)upperBound.index + 1);
-    std::copy(beginIt, endIt, std::back_inserter(s->points));
-
-    s->points.emplace_back(this->getPoint(upperBound));
+    s->points.push_back(this->getPoint(lowerBound));
+    s->points.append(this->points, lowerBound.index + 1, upperBound.index + 1);
+    s->points.push_back(this->getPoint(upperBound));
 
     // Remove unused pressure value
-    s->points.back().z = Point::NO_PRESSURE;
+    s->points.setPressure(s->points.size() - 1, Point::NO_PRESSURE);
 
     return s;
 }
@@ -145,20 +146,17 @@ std::unique_ptr<Stroke> Stroke::cloneCircularSectionOfClosedStroke(const PathPar
 
     s->points.reserve(this->points.size() - startParam.index + endParam.index + 1);
 
-    s->points.emplace_back(this->getPoint(startParam));
+    s->points.push_back(this->getPoint(startParam));
 
-    auto startIt = std::next(this->points.cbegin(), (std::ptrdiff_t)startParam.index + 1);
     // Skip the last point: points.back().equalPos(points.front()) == true and we want this point only once
-    xoj_assert(startIt != this->points.cend());
-    std::copy(startIt, std::prev(this->points.cend()), std::back_inserter(s->points));
+    xoj_assert(startParam.index + 1 < this->points.size());
+    s->points.append(this->points, startParam.index + 1, this->points.size() - 1);
+    s->points.append(this->points, 0, endParam.index + 1);
 
-    auto endIt = std::next(this->points.cbegin(), (std::ptrdiff_t)endParam.index + 1);
-    std::copy(this->points.cbegin(), endIt, std::back_inserter(s->points));
-
-    s->points.emplace_back(this->getPoint(endParam));
+    s->points.push_back(this->getPoint(endParam));
 
     // Remove unused pressure value
-    s->points.back().z = Point::NO_PRESSURE;
+    s->points.setPressure(s->points.size() - 1, Point::NO_PRESSURE);
 
     return s;
 }
@@ -176,7 +174,9 @@ void Stroke::serialize(ObjectOutputStream& out) const {
 
     out.writeInt(this->capStyle);
 
-    out.writeData(this->points.data(), this->points.size(), sizeof(Point));
+    // The serialized format stores the points as an array of Point
+    const auto pts = this->points.toVector();
+    out.writeData(pts.data(), pts.size(), sizeof(Point));
 
     this->lineStyle.serialize(out);
 
@@ -196,7 +196,10 @@ void Stroke::readSerialized(ObjectInputStream& in) {
 
     this->capStyle = static_cast<StrokeCapStyle::Value>(in.readInt());
 
-    in.readData(this->points);
+    std::vector<Point> pts;
+    in.readData(pts);
+    this->points = pts;
+    this->segmentTree.reset();
     this->lineStyle.readSerialized(in);
 
     in.endObject();
@@ -223,6 +226,7 @@ void Stroke::setFill(int fill) { this->fill = fill; }
 void Stroke::setWidth(double width) {
     this->width = width;
     this->sizeCalculated = false;
+    this->segmentTree.reset();
 }
 
 auto Stroke::getWidth() const -> double { return this->width; }
@@ -230,11 +234,8 @@ auto Stroke::getWidth() const -> double { return this->width; }
 auto Stroke::rescaleWithMirror() const -> bool { return true; }
 
 auto Stroke::isInSelection(ShapeContainer* container) const -> bool {
-    for (auto&& p: this->points) {
-        double px = p.x;
-        double py = p.y;
-
-        if (!container->contains(px, py)) {
+    for (size_t i = 0; i < this->points.size(); i++) {
+        if (!container->contains(this->points.x(i), this->points.y(i))) {
             return false;
         }
     }
@@ -243,7 +244,8 @@ auto Stroke::isInSelection(ShapeContainer* container) const -> bool {
 }
 
 void Stroke::addPoint(const Point& p) {
-    this->points.emplace_back(p);
+    this->points.push_back(p);
+    this->segmentTree.reset();
     if (!sizeCalculated) {
         return;
     }
@@ -258,11 +260,12 @@ void Stroke::addPoint(const Point& p) {
 
 auto Stroke::getPointCount() const -> size_t { return this->points.size(); }
 
-auto Stroke::getPointVector() const -> std::vector<Point> const& { return points; }
+auto Stroke::getPointVector() const -> StrokePoints const& { return points; }
 
 void Stroke::deletePointsFrom(size_t index) {
-    points.resize(std::min(index, points.size()));
+    points.truncate(index);
     this->sizeCalculated = false;
+    this->segmentTree.reset();
 }
 
 auto Stroke::getPoint(size_t index) const -> Point {
@@ -270,21 +273,20 @@ auto Stroke::getPoint(size_t index) const -> Point {
         g_warning("Stroke::getPoint(%zu) out of bounds!", index);
         return Point(0., 0., Point::NO_PRESSURE);
     }
-    return points.at(index);
+    return points[index];
 }
 
 Point Stroke::getPoint(PathParameter parameter) const {
     xoj_assert(parameter.isValid() && parameter.index < this->points.size() - 1);
 
-    const Point& p = this->points[parameter.index];
+    const Point p = this->points[parameter.index];
     Point res = p.relativeLineTo(this->points[parameter.index + 1], parameter.t);
     res.z = p.z;  // The point's width should be that of the segment's first point
     return res;
 }
 
-auto Stroke::getPoints() const -> const Point* { return this->points.data(); }
-
 void Stroke::setPointVectorInternal(const Range* const snappingBox) {
+    this->segmentTree.reset();
     if (!snappingBox || this->points.empty() || this->points.front().z != Point::NO_PRESSURE) {
         // We cannot deduce the bounding box from the snapping box if the stroke has pressure values
         this->sizeCalculated = false;
@@ -306,12 +308,17 @@ void Stroke::setPointVector(const std::vector<Point>& other, const Range* const
 }
 
 void Stroke::setPointVector(std::vector<Point>&& other, const Range* const snappingBox) {
+    this->points = other;
+    this->setPointVectorInternal(snappingBox);
+}
+
+void Stroke::setPointVector(StrokePoints&& other, const Range* const snappingBox) {
     this->points = std::move(other);
     this->setPointVectorInternal(snappingBox);
 }
 
 
-void Stroke::freeUnusedPointItems() { this->points = {begin(this->points), end(this->points)}; }
+void Stroke::freeUnusedPointItems() { this->points.shrink_to_fit(); }
 
 void Stroke::setToolType(StrokeTool type) { this->toolType = type; }
 
@@ -322,12 +329,14 @@ void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
 void Stroke::move(double dx, double dy) {
-    for (auto&& point: points) {
-        point.x += dx;
-        point.y += dy;
-    }
+    this->points.translate(dx, dy);
     this->boundingBox = this->boundingBox.translated(dx, dy);
     Element::snappedBounds = Element::snappedBounds.translated(dx, dy);
+    this->segmentTree.reset();
+}
+
+static auto toAffineMatrix(const cairo_matrix_t& m) -> xoj::util::simd::AffineMatrix {
+    return {m.xx, m.yx, m.xy, m.yy, m.x0, m.y0};
 }
 
 void Stroke::rotate(double x0, double y0, double th) {
@@ -337,10 +346,9 @@ void Stroke::rotate(double x0, double y0, double th) {
     cairo_matrix_rotate(&rotMatrix, th);
     cairo_matrix_translate(&rotMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
-        cairo_matrix_transform_point(&rotMatrix, &p.x, &p.y);
-    }
+    points.transform(toAffineMatrix(rotMatrix));
     this->sizeCalculated = false;
+    this->segmentTree.reset();
     // Width and Height will likely be changed after this operation
 }
 
@@ -354,29 +362,27 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     cairo_matrix_rotate(&scaleMatrix, -rotation);
     cairo_matrix_translate(&scaleMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
-        cairo_matrix_transform_point(&scaleMatrix, &p.x, &p.y);
-
-        if (p.z != Point::NO_PRESSURE) {
-            p.z *= fz;
-        }
-    }
+    points.transform(toAffineMatrix(scaleMatrix));
+    points.scalePressures(fz);
     this->width *= fz;
 
     this->sizeCalculated = false;
+    this->segmentTree.reset();
 }
 
 auto Stroke::hasPressure() const -> bool {
     if (!this->points.empty()) {
-        return this->points[0].z != Point::NO_PRESSURE;
+        return this->points.pressure(0) != Point::NO_PRESSURE;
     }
     return false;
 }
 
 auto Stroke::getAvgPressure() const -> double {
-    return std::accumulate(begin(this->points), end(this->points), 0.0,
-                           [](double l, Point const& p) { return l + p.z; }) /
-           static_cast<double>(this->points.size());
+    double sum = 0.0;
+    for (size_t i = 0; i < this->points.size(); i++) {
+        sum += this->points.pressure(i);
+    }
+    return sum / static_cast<double>(this->points.size());
 }
 
 void Stroke::updateBoundsLastTwoPressures() {
@@ -387,8 +393,8 @@ void Stroke::updateBoundsLastTwoPressures() {
     auto const pointCount = this->getPointCount();
     xoj_assert(pointCount >= 2);
 
-    Point& p = this->points.back();
-    Point& p2 = this->points[pointCount - 2];
+    const Point p = this->points.back();
+    const Point p2 = this->points[pointCount - 2];
     double pressure = p2.z;
 
     updateSnappedBounds(snappedBounds, p);
@@ -400,25 +406,24 @@ void Stroke::scalePressure(double factor) {
     if (!hasPressure()) {
         return;
     }
-    for (auto&& p: this->points) {
-        p.z *= factor;
-    }
+    this->points.scalePressures(factor);
     this->sizeCalculated = false;
+    this->segmentTree.reset();
 }
 
 void Stroke::setLastPressure(double pressure) {
     if (!this->points.empty()) {
         xoj_assert(pressure != Point::NO_PRESSURE);
-        Point& back = this->points.back();
-        back.z = pressure;
+        this->points.setPressure(this->points.size() - 1, pressure);
+        this->segmentTree.reset();
     }
 }
 
 void Stroke::setSecondToLastPressure(double pressure) {
     auto const pointCount = this->getPointCount();
     if (pointCount >= 2) {
-        Point& p = this->points[pointCount - 2];
-        p.z = pressure;
+        this->points.setPressure(pointCount - 2, pressure);
+        this->segmentTree.reset();
         updateBoundsLastTwoPressures();
     }
 }
@@ -432,28 +437,26 @@ void Stroke::setPressure(const std::vector<double>& pressure) {
 
     auto max_size = std::min(pressure.size(), this->points.size() - 1);
     for (size_t i = 0U; i != max_size; ++i) {
-        this->points[i].z = pressure[i];
+        this->points.setPressure(i, pressure[i]);
     }
+    this->segmentTree.reset();
 }
 
 /**
- * checks if the stroke is intersected by the eraser rectangle
+ * checks if the points first, ..., last and the segments between them are intersected by the eraser rectangle
  */
-auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool {
-    if (this->points.empty()) {
-        return false;
-    }
-
+static auto intersectsPoints(const StrokePoints& points, size_t first, size_t last, double x, double y,
+                             double halfEraserSize) -> bool {
     double x1 = x - halfEraserSize;
     double x2 = x + halfEraserSize;
     double y1 = y - halfEraserSize;
     double y2 = y + halfEraserSize;
 
-    double lastX = points[0].x;
-    double lastY = points[0].y;
-    for (auto&& point: points) {
-        double px = point.x;
-        double py = point.y;
+    double lastX = points.x(first);
+    double lastY = points.y(first);
+    for (size_t i = first; i <= last; i++) {
+        double px = points.x(i);
+        double py = points.y(i);
 
         if (px >= x1 && py >= y1 && px <= x2 && py <= y2) {
             return true;
@@ -481,9 +484,7 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool
 
                 distance -= halfEraserSize * std::sqrt(2);
 
-                constexpr double PADDING = 0.1;
-
-                if (distance <= len / 2 + PADDING) {
+                if (distance <= len / 2 + INTERSECTION_PADDING) {
                     return true;
                 }
             }
@@ -496,19 +497,133 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool
     return false;
 }
 
-double Stroke::distanceTo(double x, double y) const {
-    double distance = std::numeric_limits<double>::max();
-    for (auto&& [p1, p2]: PairView(this->points)) {
+/**
+ * checks if the stroke is intersected by the eraser rectangle
+ */
+auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool {
+    if (this->points.empty()) {
+        return false;
+    }
+
+    if (const auto* tree = getSegmentTree()) {
+        // A segment can only be hit within halfEraserSize of its line, and within halfEraserSize * sqrt(2) + padding
+        // of its ends along the line: these bounds are looser than the test above.
+        const double pad = halfEraserSize * (1 + std::sqrt(2)) + INTERSECTION_PADDING;
+        bool found = false;
+        tree->forEachRangeTouching({x - pad, y - pad, x + pad, y + pad}, 0, tree->getSegmentCount(),
+                                   [&](size_t first, size_t last) {
+                                       found = intersectsPoints(this->points, first, last, x, y, halfEraserSize);
+                                       return found;
+                                   });
+        return found;
+    }
+
+    return intersectsPoints(this->points, 0, this->points.size() - 1, x, y, halfEraserSize);
+}
+
+/**
+ * Whether the segment [p, q] comes within halfSize of the segment [a, b] in the L-infinity norm, i.e. whether it
+ * crosses the area swept by a square of half size halfSize moving from a to b
+ */
+static auto segmentsWithin(xoj::util::Point<double> p, xoj::util::Point<double> q, xoj::util::Point<double> a,
+                           xoj::util::Point<double> b, double halfSize) -> bool {
+    // Separating axis test between the square [-halfSize, halfSize]^2 and the parallelogram [p, q] - [a, b]
+    const std::array<xoj::util::Point<double>, 4> corners = {p - a, q - a, p - b, q - b};
+    const std::array<xoj::util::Point<double>, 4> axes = {
+            {{1, 0}, {0, 1}, {p.y - q.y, q.x - p.x}, {a.y - b.y, b.x - a.x}}};
+    for (const auto& n: axes) {
+        double min = std::numeric_limits<double>::infinity();
+        double max = -min;
+        for (const auto& c: corners) {
+            const double d = c.x * n.x + c.y * n.y;
+            min = std::min(min, d);
+            max = std::max(max, d);
+        }
+        const double extent = halfSize * (std::abs(n.x) + std::abs(n.y));
+        if (min > extent || max < -extent) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto Stroke::intersectsSweptPath(const std::vector<xoj::util::Point<double>>& path, double halfEraserSize) const
+        -> bool {
+    if (this->points.empty() || path.empty()) {
+        return false;
+    }
+    const double h = halfEraserSize + INTERSECTION_PADDING;
+    auto pointAt = [&](size_t i) { return xoj::util::Point<double>(this->points.x(i), this->points.y(i)); };
+    auto testRange = [&](size_t first, size_t last, xoj::util::Point<double> a, xoj::util::Point<double> b) {
+        for (size_t i = first; i < last; i++) {
+            if (segmentsWithin(pointAt(i), pointAt(i + 1), a, b, h)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const auto* tree = getSegmentTree();
+    // The segments of the path, or its only point
+    for (size_t k = path.size() > 1 ? 1 : 0; k < path.size(); k++) {
+        const auto a = path[k == 0 ? 0 : k - 1];
+        const auto b = path[k];
+        if (this->points.size() == 1) {
+            if (segmentsWithin(pointAt(0), pointAt(0), a, b, h)) {
+                return true;
+            }
+            continue;
+        }
+        bool found = false;
+        if (tree) {
+            const xoj::util::simd::Box box{std::min(a.x, b.x) - h, std::min(a.y, b.y) - h, std::max(a.x, b.x) + h,
+                                           std::max(a.y, b.y) + h};
+            tree->forEachRangeTouching(box, 0, tree->getSegmentCount(), [&](size_t first, size_t last) {
+                found = testRange(first, last, a, b);
+                return found;
+            });
+        } else {
+            found = testRange(0, this->points.size() - 1, a, b);
+        }
+        if (found) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Distance between (x,y) and the segments between the points first, ..., last, taking thickness into account, or
+ * distance if it is smaller
+ */
+static auto distanceToPoints(const StrokePoints& points, double width, size_t first, size_t last, double x, double y,
+                             double distance) -> double {
+    for (size_t i = first + 1; i <= last; i++) {
+        const Point p1 = points[i - 1];
+        const Point p2 = points[i];
         xoj::util::Point<double> v(p2.x - p1.x, p2.y - p1.y);
         double ratio = std::clamp(((x - p1.x) * v.x + (y - p1.y) * v.y) / (v.x * v.x + v.y * v.y), 0., 1.);
         /// Projection of (x,y) onto the segment [p1,p2]
         xoj::util::Point<double> projection(p1.x + ratio * v.x, p1.y + ratio * v.y);
-        double width = p1.z == Point::NO_PRESSURE ? this->width : p1.z;
-        distance = std::clamp(std::hypot(x - projection.x, y - projection.y) - .5 * width, 0., distance);
+        double segmentWidth = p1.z == Point::NO_PRESSURE ? width : p1.z;
+        distance = std::clamp(std::hypot(x - projection.x, y - projection.y) - .5 * segmentWidth, 0., distance);
     }
     return distance;
 }
 
+double Stroke::distanceTo(double x, double y) const {
+    double distance = std::numeric_limits<double>::max();
+    if (this->points.size() < 2) {
+        return distance;
+    }
+    if (const auto* tree = getSegmentTree()) {
+        return tree->findMinimum(x, y, distance, [&](size_t first, size_t last, double best) {
+            return distanceToPoints(this->points, this->width, first, last, x, y, best);
+        });
+    }
+    return distanceToPoints(this->points, this->width, 0, this->points.size() - 1, x, y, distance);
+}
+
 /**
  * @brief Get the interval of length parameters where the line (pq) is in the rectangle.
  * @param p First point
@@ -619,10 +734,7 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
 
     size_t index = firstIndex;
 
-    const PairView segments(this->points);
-    auto segmentIt = std::next(segments.begin(), (std::ptrdiff_t)index);
-
-    Flags flags = initializeFlagsFromHalfTangentAtFirstKnot(segmentIt.first(), segmentIt.second());
+    Flags flags = initializeFlagsFromHalfTangentAtFirstKnot(this->points[index], this->points[index + 1]);
 
     DEBUG_ERASER(auto debugstream = serdes_stream<std::stringstream>();
                  debugstream << "Stroke::intersectWithPaddedBox debug:\n"; debugstream << std::boolalpha;
@@ -716,10 +828,28 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
         DEBUG_ERASER(debugstream << "|  |__** result.size() = " << std::setw(3) << result.size() << std::endl;)
     };
 
-    auto endSegmentIt = std::next(segments.begin(), (std::ptrdiff_t)(lastIndex + 1));
-    for (; segmentIt != endSegmentIt; segmentIt++, index++) {
-        processSegment(segmentIt.first(), segmentIt.second(), index);
+    // processSegment() does nothing on a segment not meeting the outer box: skip those in bulk
+    const double* xs = this->points.xData();
+    const double* ys = this->points.yData();
+    constexpr double TOLERANCE = 1e-6;
+    const xoj::util::simd::Box filter = {outerBox.x - TOLERANCE, outerBox.y - TOLERANCE,
+                                         outerBox.x + outerBox.width + TOLERANCE,
+                                         outerBox.y + outerBox.height + TOLERANCE};
+    const size_t endIndex = lastIndex + 1;
+    auto processRange = [&](size_t first, size_t last) {
+        for (size_t i = xoj::util::simd::findSegmentTouchingBox(xs, ys, first, last, filter); i < last;
+             i = xoj::util::simd::findSegmentTouchingBox(xs, ys, i + 1, last, filter)) {
+            processSegment(this->points[i], this->points[i + 1], i);
+        }
+        return false;
+    };
+    if (const auto* tree = getSegmentTree()) {
+        // The ranges come in increasing order, as processSegment() expects
+        tree->forEachRangeTouching(filter, index, endIndex, processRange);
+    } else {
+        processRange(index, endIndex);
     }
+    index = endIndex;
 
     auto isHalfTangentAtLastKnotGoingTowardInnerBox =
             [&innerBox, &outerBox](const Point& lastKnot, const Point& halfTangentControlPoint) -> bool {
@@ -737,13 +867,13 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
     bool inconsistentResults = false;
     if (result.size() % 2) {
         // Not necessarily inconsistent: could be the stroke ends in outerBox
-        --segmentIt;
-        const Point& lastPoint = segmentIt.second();
+        const Point lastPoint = this->points[lastIndex + 1];
 
         DEBUG_ERASER(debugstream << "|  |  Odd number of intersection points" << std::endl;)
 
         if (lastPoint.isInside(outerBox)) {
-            if (flags.wentInsideInner || isHalfTangentAtLastKnotGoingTowardInnerBox(lastPoint, segmentIt.first())) {
+            if (flags.wentInsideInner ||
+                isHalfTangentAtLastKnotGoingTowardInnerBox(lastPoint, this->points[lastIndex])) {
                 result.emplace_back(index - 1, 1.0);
                 DEBUG_ERASER(debugstream << "|  |  ** pushing   (" << std::setw(3) << result.back().index << ","
                                          << std::setw(20) << result.back().t << ")" << std::endl;)
@@ -814,26 +944,20 @@ void Stroke::calcSize() const {
     if (this->points.empty()) {
         Element::boundingBox = Rectangle<double>{};
         Element::snappedBounds = Rectangle<double>{};
+        return;
     }
 
-    double minSnapX = std::numeric_limits<double>::max();
-    double maxSnapX = std::numeric_limits<double>::min();
-    double minSnapY = std::numeric_limits<double>::max();
-    double maxSnapY = std::numeric_limits<double>::min();
-
-    auto halfThick = 0.0;
+    const size_t n = points.size();
+    const auto [minSnapX, maxSnapX] = xoj::util::simd::minMax(points.xData(), n);
+    const auto [minSnapY, maxSnapY] = xoj::util::simd::minMax(points.yData(), n);
 
-    // #pragma omp parralel
-    for (auto&& p: points) {
-        halfThick = std::max(halfThick, p.z);
-        minSnapX = std::min(minSnapX, p.x);
-        minSnapY = std::min(minSnapY, p.y);
-        maxSnapX = std::max(maxSnapX, p.x);
-        maxSnapY = std::max(maxSnapY, p.y);
+    double halfThick = 0.0;
+    if (hasPressure()) {
+        halfThick = std::max(0.0, xoj::util::simd::maxValue(points.pressureData(), n)) / 2.0;
+    } else {
+        halfThick = this->width / 2.0;
     }
 
-    halfThick = points[0].z != Point::NO_PRESSURE ? halfThick / 2.0 : this->width / 2.0;
-
     auto minX = minSnapX - halfThick;
     auto minY = minSnapY - halfThick;
     auto maxX = maxSnapX + halfThick;
@@ -843,6 +967,16 @@ void Stroke::calcSize() const {
     Element::snappedBounds = Rectangle<double>(minSnapX, minSnapY, maxSnapX - minSnapX, maxSnapY - minSnapY);
 }
 
+auto Stroke::getSegmentTree() const -> const StrokeSegmentTree* {
+    if (this->points.size() < StrokeSegmentTree::MIN_POINTS) {
+        return nullptr;
+    }
+    if (!this->segmentTree) {
+        this->segmentTree = std::make_shared<const StrokeSegmentTree>(this->points, this->width);
+    }
+    return this->segmentTree.get();
+}
+
 auto Stroke::getErasable() const -> ErasableStroke* { return this->erasable; }
 
 void Stroke::setErasable(ErasableStroke* erasable) { this->erasable = erasable; }
@@ -13,14 +13,16 @@
 
 #include <array>    // for array
 #include <cstddef>  // for size_t
-#include <memory>   // for unique_ptr
+#include <memory>   // for unique_ptr, shared_ptr
 #include <vector>   // for vector
 
 #include "model/Element.h"
+#include "util/Point.h"  // for Point
 
 #include "AudioElement.h"  // for AudioElement
 #include "LineStyle.h"     // for LineStyle
 #include "Point.h"         // for Point
+#include "StrokePoints.h"  // for StrokePoints
 
 class Element;
 class ObjectInputStream;
@@ -64,6 +66,7 @@ private:
 class ErasableStroke;
 struct PaddedBox;
 struct PathParameter;
+class StrokeSegmentTree;
 template <class T, size_t N>
 class SmallVector;
 
@@ -126,10 +129,9 @@ public:
     void addPoint(const Point& p);
     size_t getPointCount() const;
     void freeUnusedPointItems();
-    std::vector<Point> const& getPointVector() const;
+    StrokePoints const& getPointVector() const;
     Point getPoint(size_t index) const;
     Point getPoint(PathParameter parameter) const;
-    const Point* getPoints() const;
 
     /**
      * @brief Replace the stroke's points by the ones in the provided vector (they will be copied).
@@ -140,6 +142,7 @@ public:
      */
     void setPointVector(const std::vector<Point>& other, const Range* const snappingBox = nullptr);
     void setPointVector(std::vector<Point>&& other, const Range* const snappingBox = nullptr);
+    void setPointVector(StrokePoints&& other, const Range* const snappingBox = nullptr);
 
 private:
     void setPointVectorInternal(const Range* const snappingBox);
@@ -154,6 +157,12 @@ public:
     void setLineStyle(const LineStyle& style);
 
     bool intersects(double x, double y, double halfEraserSize) const;
+
+    /**
+     * @return Whether the stroke crosses the area swept by the eraser square moving along the path (a single point
+     * for an eraser which did not move). Tests the stroke once for the whole path, instead of once per position.
+     */
+    bool intersectsSweptPath(const std::vector<xoj::util::Point<double>>& path, double halfEraserSize) const;
     /**
      * Computes the actual distance between (x,y) and the stroke, taking thickness into account
      * If (x,y) is within the painted area corresponding to the stroke, the return value will be 0.
@@ -214,13 +223,19 @@ public:
 protected:
     void calcSize() const override;
 
+private:
+    /**
+     * @return The hierarchy of the segments, built on first use, or nullptr if the stroke is too short to need one
+     */
+    const StrokeSegmentTree* getSegmentTree() const;
+
 private:
     // The stroke width cannot be inherited from Element
     double width = 0;
     StrokeTool toolType = StrokeTool::PEN;
 
-    // The array with the points
-    std::vector<Point> points{};
+    // The points, with separate arrays of coordinates and pressure values
+    StrokePoints points{};
 
     /**
      * Dashed line
@@ -239,4 +254,10 @@ private:
     int fill = -1;
 
     StrokeCapStyle capStyle = StrokeCapStyle::ROUND;
+
+    /**
+     * Speeds up the intersection and distance queries on long strokes. As the bounding box, it is computed lazily and
+     * dropped whenever the points or the width change.
+     */
+    mutable std::shared_ptr<const StrokeSegmentTree> segmentTree;
 };
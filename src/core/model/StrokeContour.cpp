@@ -5,6 +5,7 @@
 
 #include "model/MathVect.h"
 #include "model/Point.h"
+#include "model/StrokePoints.h"
 #include "util/Assert.h"
 #include "util/safe_casts.h"
 
@@ -41,8 +42,10 @@ struct ReturnOp {
     void operator()(cairo_t* cr) { op(cr, x, y, r, a, b); }
 };
 
-xoj::view::StrokeContour::StrokeContour(const std::vector<Point>& path): path(path) {}
-xoj::view::StrokeContour::~StrokeContour() = default;
+template <class PointContainer>
+xoj::view::StrokeContour<PointContainer>::StrokeContour(const PointContainer& path): path(path) {}
+template <class PointContainer>
+xoj::view::StrokeContour<PointContainer>::~StrokeContour() = default;
 
 static inline void drawCoupling(cairo_t* cr, std::vector<ReturnOp>& ops, const Point& p2, double n1, double n3,
                                 double a1, double a3, double z1) {
@@ -113,7 +116,8 @@ static inline void contourStrokeEnd(cairo_t* cr, const Point& endPoint, const Po
     cairo_arc(cr, endPoint.x, endPoint.y, .5 * (forward ? endPoint.z : adjacentPoint.z), a + M_PI_2, a - M_PI_2);
 }
 
-void xoj::view::StrokeContour::addToCairo(cairo_t* cr) const {
+template <class PointContainer>
+void xoj::view::StrokeContour<PointContainer>::addToCairo(cairo_t* cr) const {
     xoj_assert(path.size() >= 2);
     contourStrokeEnd<true>(cr, path.front(), path[1]);
     // left side of the stroke
@@ -129,7 +133,8 @@ void xoj::view::StrokeContour::addToCairo(cairo_t* cr) const {
     cairo_close_path(cr);
 }
 
-void xoj::view::StrokeContour::drawDebug(cairo_t* cr) const {
+template <class PointContainer>
+void xoj::view::StrokeContour<PointContainer>::drawDebug(cairo_t* cr) const {
     {
         // Draw the points as dashed circles
         cairo_save(cr);
@@ -183,10 +188,12 @@ void xoj::view::StrokeContour::drawDebug(cairo_t* cr) const {
 
 
 // Dashes
-xoj::view::StrokeContourDashes::StrokeContourDashes(const std::vector<Point>& path,
-                                                    const std::vector<double>& dashPattern):
+template <class PointContainer>
+xoj::view::StrokeContourDashes<PointContainer>::StrokeContourDashes(const PointContainer& path,
+                                                                    const std::vector<double>& dashPattern):
         path(path), dashPattern(dashPattern) {}
-xoj::view::StrokeContourDashes::~StrokeContourDashes() = default;
+template <class PointContainer>
+xoj::view::StrokeContourDashes<PointContainer>::~StrokeContourDashes() = default;
 
 static void noop(cairo_t*) {};
 
@@ -220,7 +227,8 @@ static inline void dashSegment(cairo_t* cr, std::vector<ReturnOp>& ops, double&
     }
 }
 
-double xoj::view::StrokeContourDashes::addToCairo(cairo_t* cr, double globalDashOffset) const {
+template <class PointContainer>
+double xoj::view::StrokeContourDashes<PointContainer>::addToCairo(cairo_t* cr, double globalDashOffset) const {
     std::vector<ReturnOp> ops;
     auto dashIt = dashPattern.begin();
     bool on = true;
@@ -298,7 +306,8 @@ static void xtraFun(cairo_t* cr) {
     cairo_stroke(cr);
 }
 
-void xoj::view::StrokeContourDashes::drawDebug(cairo_t* cr) const {
+template <class PointContainer>
+void xoj::view::StrokeContourDashes<PointContainer>::drawDebug(cairo_t* cr) const {
     {
         // Draw the points as dashed circles
         cairo_save(cr);
@@ -352,3 +361,8 @@ void xoj::view::StrokeContourDashes::drawDebug(cairo_t* cr) const {
         xtraFun(cr);
     }
 }
+
+template class xoj::view::StrokeContour<std::vector<Point>>;
+template class xoj::view::StrokeContour<StrokePoints>;
+template class xoj::view::StrokeContourDashes<std::vector<Point>>;
+template class xoj::view::StrokeContourDashes<StrokePoints>;
@@ -16,29 +16,35 @@
 #include <cairo.h>
 
 class Point;
+class StrokePoints;
 
 namespace xoj::view {
+/**
+ * @tparam PointContainer Either std::vector<Point> or StrokePoints
+ */
+template <class PointContainer>
 class StrokeContour final {
 public:
-    explicit StrokeContour(const std::vector<Point>& path);
+    explicit StrokeContour(const PointContainer& path);
     ~StrokeContour();
     void addToCairo(cairo_t* cr) const;
     void drawDebug(cairo_t* cr) const;
 
 private:
-    const std::vector<Point>& path;
+    const PointContainer& path;
 };
 
+template <class PointContainer>
 class StrokeContourDashes final {
 public:
-    StrokeContourDashes(const std::vector<Point>& path, const std::vector<double>& dashPattern);
+    StrokeContourDashes(const PointContainer& path, const std::vector<double>& dashPattern);
     ~StrokeContourDashes();
     /// Returns the new dash offset (= dashoffset + path length)
     double addToCairo(cairo_t* cr, double dashoffset) const;
     void drawDebug(cairo_t* cr) const;
 
 private:
-    const std::vector<Point>& path;
+    const PointContainer& path;
     const std::vector<double>& dashPattern;
 };
 };  // namespace xoj::view
@@ -0,0 +1,132 @@
+#include "StrokePoints.h"
+
+#include <algorithm>  // for any_of, copy
+#include <iterator>   // for next
+
+#include "util/PointArrayKernels.h"  // for translate, transform
+
+StrokePoints::StrokePoints(const std::vector<Point>& points) { *this = points; }
+
+auto StrokePoints::operator=(const std::vector<Point>& points) -> StrokePoints& {
+    clear();
+    reserve(points.size());
+    const bool pressure =
+            std::any_of(points.begin(), points.end(), [](const Point& p) { return p.z != Point::NO_PRESSURE; });
+    for (const Point& p: points) {
+        xs.push_back(p.x);
+        ys.push_back(p.y);
+        if (pressure) {
+            zs.push_back(p.z);
+        }
+    }
+    return *this;
+}
+
+void StrokePoints::push_back(const Point& p) {
+    const bool pressure = hasPressureValues() || p.z != Point::NO_PRESSURE;
+    if (pressure) {
+        ensurePressureArray();
+    }
+    xs.push_back(p.x);
+    ys.push_back(p.y);
+    if (pressure) {
+        zs.push_back(p.z);
+    }
+}
+
+void StrokePoints::set(size_t i, const Point& p) {
+    setPosition(i, p.x, p.y);
+    setPressure(i, p.z);
+}
+
+void StrokePoints::setPosition(size_t i, double x, double y) {
+    xs[i] = x;
+    ys[i] = y;
+}
+
+void StrokePoints::setPressure(size_t i, double pressure) {
+    if (!hasPressureValues()) {
+        if (pressure == Point::NO_PRESSURE) {
+            return;
+        }
+        ensurePressureArray();
+    }
+    zs[i] = pressure;
+}
+
+void StrokePoints::translate(double dx, double dy) {
+    xoj::util::simd::translate(xs.data(), xs.size(), dx);
+    xoj::util::simd::translate(ys.data(), ys.size(), dy);
+}
+
+void StrokePoints::transform(const xoj::util::simd::AffineMatrix& m) {
+    xoj::util::simd::transform(xs.data(), ys.data(), xs.size(), m);
+}
+
+void StrokePoints::scalePressures(double factor) {
+    for (double& z: zs) {
+        if (z != Point::NO_PRESSURE) {
+            z *= factor;
+        }
+    }
+}
+
+void StrokePoints::reserve(size_t n) {
+    xs.reserve(n);
+    ys.reserve(n);
+    if (!zs.empty()) {
+        zs.reserve(n);
+    }
+}
+
+void StrokePoints::truncate(size_t n) {
+    if (n >= size()) {
+        return;
+    }
+    xs.resize(n);
+    ys.resize(n);
+    if (!zs.empty()) {
+        zs.resize(n);
+    }
+}
+
+void StrokePoints::clear() {
+    xs.clear();
+    ys.clear();
+    zs.clear();
+}
+
+void StrokePoints::shrink_to_fit() {
+    xs.shrink_to_fit();
+    ys.shrink_to_fit();
+    zs.shrink_to_fit();
+}
+
+void StrokePoints::append(const StrokePoints& other, size_t first, size_t last) {
+    const auto f = static_cast<std::ptrdiff_t>(first);
+    const auto l = static_cast<std::ptrdiff_t>(last);
+    const bool pressure = hasPressureValues() || other.hasPressureValues();
+    if (pressure) {
+        ensurePressureArray();
+    }
+    xs.insert(xs.end(), std::next(other.xs.begin(), f), std::next(other.xs.begin(), l));
+    ys.insert(ys.end(), std::next(other.ys.begin(), f), std::next(other.ys.begin(), l));
+    if (other.hasPressureValues()) {
+        zs.insert(zs.end(), std::next(other.zs.begin(), f), std::next(other.zs.begin(), l));
+    } else if (pressure) {
+        zs.resize(xs.size(), Point::NO_PRESSURE);
+    }
+}
+
+auto StrokePoints::toVector() const -> std::vector<Point> { return std::vector<Point>(begin(), end()); }
+
+auto StrokePoints::getMemoryUsage() const -> size_t {
+    return (xs.capacity() + ys.capacity() + zs.capacity()) * sizeof(double);
+}
+
+void StrokePoints::ensurePressureArray() {
+    if (zs.size() != xs.size()) {
+        zs.reserve(xs.capacity());
+        zs.resize(xs.size(), Point::NO_PRESSURE);
+    }
+}
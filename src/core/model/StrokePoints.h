@@ -0,0 +1,183 @@
+/*
+ * Xournal++
+ *
+ * Compact storage of the points of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t, ptrdiff_t
+#include <iterator>  // for random_access_iterator_tag
+#include <vector>    // for vector
+
+#include "util/PointArrayKernels.h"  // for AffineMatrix
+
+#include "Point.h"  // for Point
+
+/**
+ * @brief Points of a stroke, stored as separate arrays of coordinates and of pressure values.
+ *
+ * Most strokes (highlighter, no pressure sensitive device...) have no pressure values at all: the pressure array is
+ * only allocated once a point with a pressure value is added. Until then, every point has Point::NO_PRESSURE.
+ *
+ * The points are returned by value. Use the setters to modify them.
+ */
+class StrokePoints {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Point;
+        using difference_type = std::ptrdiff_t;
+        using reference = Point;
+
+        /// Allows it->x on an iterator whose dereferencing returns a temporary
+        struct ArrowProxy {
+            Point p;
+            const Point* operator->() const { return &p; }
+        };
+        using pointer = ArrowProxy;
+
+        const_iterator() = default;
+        const_iterator(const StrokePoints* points, size_t index): points(points), index(index) {}
+
+        reference operator*() const { return (*points)[index]; }
+        pointer operator->() const { return {**this}; }
+        reference operator[](difference_type n) const { return (*points)[index + static_cast<size_t>(n)]; }
+
+        const_iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++index;
+            return tmp;
+        }
+        const_iterator& operator--() {
+            --index;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto tmp = *this;
+            --index;
+            return tmp;
+        }
+        const_iterator& operator+=(difference_type n) {
+            index += static_cast<size_t>(n);
+            return *this;
+        }
+        const_iterator& operator-=(difference_type n) {
+            index -= static_cast<size_t>(n);
+            return *this;
+        }
+        const_iterator operator+(difference_type n) const {
+            return const_iterator(points, index + static_cast<size_t>(n));
+        }
+        const_iterator operator-(difference_type n) const {
+            return const_iterator(points, index - static_cast<size_t>(n));
+        }
+        difference_type operator-(const const_iterator& other) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+        friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+        bool operator<(const const_iterator& other) const { return index < other.index; }
+        bool operator>(const const_iterator& other) const { return other.index < index; }
+        bool operator<=(const const_iterator& other) const { return index <= other.index; }
+        bool operator>=(const const_iterator& other) const { return index >= other.index; }
+
+    private:
+        const StrokePoints* points = nullptr;
+        size_t index = 0;
+    };
+    using iterator = const_iterator;
+    using value_type = Point;
+    using size_type = size_t;
+
+    StrokePoints() = default;
+    StrokePoints(const std::vector<Point>& points);
+
+    StrokePoints& operator=(const std::vector<Point>& points);
+
+    size_t size() const { return xs.size(); }
+    bool empty() const { return xs.empty(); }
+
+    Point operator[](size_t i) const { return Point(xs[i], ys[i], zs.empty() ? Point::NO_PRESSURE : zs[i]); }
+    Point front() const { return (*this)[0]; }
+    Point back() const { return (*this)[size() - 1]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    double x(size_t i) const { return xs[i]; }
+    double y(size_t i) const { return ys[i]; }
+    double pressure(size_t i) const { return zs.empty() ? Point::NO_PRESSURE : zs[i]; }
+
+    /**
+     * @return Whether the pressure array is allocated. If not, no point has a pressure value.
+     */
+    bool hasPressureValues() const { return !zs.empty(); }
+
+    /// The arrays of coordinates
+    const double* xData() const { return xs.data(); }
+    const double* yData() const { return ys.data(); }
+    /// The array of pressure values, or nullptr if there are none
+    const double* pressureData() const { return zs.empty() ? nullptr : zs.data(); }
+
+    void push_back(const Point& p);
+    void set(size_t i, const Point& p);
+    void setPosition(size_t i, double x, double y);
+    void setPressure(size_t i, double pressure);
+
+    /**
+     * @brief Translate all the points
+     */
+    void translate(double dx, double dy);
+
+    /**
+     * @brief Apply an affine transformation to all the points
+     */
+    void transform(const xoj::util::simd::AffineMatrix& m);
+
+    /**
+     * @brief Multiply all the (existing) pressure values
+     */
+    void scalePressures(double factor);
+
+    void reserve(size_t n);
+    /// Only shrinks the storage
+    void truncate(size_t n);
+    void clear();
+    void shrink_to_fit();
+
+    /**
+     * @brief Append the points [first, last) of another storage
+     */
+    void append(const StrokePoints& other, size_t first, size_t last);
+
+    std::vector<Point> toVector() const;
+
+    /**
+     * @return The memory allocated for the points, in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    /// Allocate the pressure array (filled with Point::NO_PRESSURE), if need be
+    void ensurePressureArray();
+
+    std::vector<double> xs;
+    std::vector<double> ys;
+    /// Either empty (no pressure values) or of the same size as xs and ys
+    std::vector<double> zs;
+};
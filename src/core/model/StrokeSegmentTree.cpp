@@ -0,0 +1,48 @@
+#include "StrokeSegmentTree.h"
+
+#include <algorithm>  // for min, max
+
+#include "model/StrokePoints.h"      // for StrokePoints
+#include "util/Assert.h"             // for xoj_assert
+#include "util/PointArrayKernels.h"  // for minMax, maxValue
+
+StrokeSegmentTree::StrokeSegmentTree(const StrokePoints& points, double width) {
+    xoj_assert(points.size() >= 2);
+    const size_t segments = points.size() - 1;
+    this->nodes.reserve(4 * ((segments + LEAF_SIZE - 1) / LEAF_SIZE));
+    build(points, width, 0, segments);
+}
+
+auto StrokeSegmentTree::getSegmentCount() const -> size_t { return this->nodes.front().last; }
+
+auto StrokeSegmentTree::build(const StrokePoints& points, double width, size_t first, size_t last) -> size_t {
+    const size_t index = this->nodes.size();
+    this->nodes.push_back(Node{{}, 0.0, first, last, 0});
+
+    if (last - first <= LEAF_SIZE) {
+        // The segments [first, last) join the points first, ..., last
+        const auto [minX, maxX] = xoj::util::simd::minMax(points.xData() + first, last - first + 1);
+        const auto [minY, maxY] = xoj::util::simd::minMax(points.yData() + first, last - first + 1);
+        double maxWidth = width;
+        if (const double* pressures = points.pressureData()) {
+            // A segment has the width of its first point, or the width of the stroke if it has no pressure value
+            maxWidth = std::max(width, xoj::util::simd::maxValue(pressures + first, last - first));
+        }
+        this->nodes[index].box = {minX, minY, maxX, maxY};
+        this->nodes[index].maxHalfWidth = 0.5 * maxWidth;
+        return index;
+    }
+
+    const size_t middle = first + (last - first) / 2;
+    build(points, width, first, middle);
+    const size_t secondChild = build(points, width, middle, last);
+
+    const Node& a = this->nodes[index + 1];
+    const Node& b = this->nodes[secondChild];
+    Node& n = this->nodes[index];
+    n.box = {std::min(a.box.minX, b.box.minX), std::min(a.box.minY, b.box.minY), std::max(a.box.maxX, b.box.maxX),
+             std::max(a.box.maxY, b.box.maxY)};
+    n.maxHalfWidth = std::max(a.maxHalfWidth, b.maxHalfWidth);
+    n.secondChild = secondChild;
+    return index;
+}
@@ -0,0 +1,147 @@
+/*
+ * Xournal++
+ *
+ * Bounding volume hierarchy over the segments of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <algorithm>  // for max
+#include <array>      // for array
+#include <cmath>      // for hypot
+#include <cstddef>    // for size_t
+#include <vector>     // for vector
+
+#include "util/PointArrayKernels.h"  // for Box
+
+class StrokePoints;
+
+/**
+ * @brief Hierarchy of bounding boxes over the segments [points[i], points[i + 1]] of a stroke
+ *
+ * Each node covers a range of consecutive segments, split in two halves for its children. The points of a stroke are
+ * spatially coherent, so that the boxes of the nodes are tight. The leaves cover at most LEAF_SIZE segments, which
+ * are then scanned linearly by the caller.
+ *
+ * The tree is built from the points of the stroke and does not follow their changes: it must be built again when the
+ * points (or their widths) are modified. See Stroke::getSegmentTree().
+ */
+class StrokeSegmentTree {
+public:
+    /**
+     * @param points The points of the stroke. There must be at least 2 of them.
+     * @param width The width of the stroke, used for the segments without pressure value
+     */
+    StrokeSegmentTree(const StrokePoints& points, double width);
+
+    [[nodiscard]] size_t getSegmentCount() const;
+
+    /**
+     * Calls fn(begin, end) for the ranges [begin, end) of segments, within [first, last), whose bounding boxes may
+     * intersect the box (boundaries included). The ranges are reported in increasing order.
+     * If fn returns true, the search stops.
+     */
+    template <class Fn>
+    void forEachRangeTouching(const xoj::util::simd::Box& box, size_t first, size_t last, Fn fn) const;
+
+    /**
+     * Finds the minimum over all the segments of a non-negative function f, bounded below by
+     *      max(0, distance((x, y), bounding box of the segment) - half width of the segment)
+     * (e.g. the distance to the painted area of the stroke).
+     * Calls best = fn(begin, end, best) for the ranges [begin, end) of segments which may improve the minimum.
+     * @param best The initial minimum
+     */
+    template <class Fn>
+    double findMinimum(double x, double y, double best, Fn fn) const;
+
+    /// Maximal number of segments in a leaf
+    static constexpr size_t LEAF_SIZE = 16;
+    /// Strokes with fewer points are scanned linearly
+    static constexpr size_t MIN_POINTS = 4 * LEAF_SIZE;
+
+private:
+    struct Node {
+        xoj::util::simd::Box box;
+        double maxHalfWidth;
+        /// The segments of the node: [first, last)
+        size_t first;
+        size_t last;
+        /// Index of the second child, the first one being right after the node. 0 for the leaves.
+        size_t secondChild;
+    };
+
+    size_t build(const StrokePoints& points, double width, size_t first, size_t last);
+
+    static bool touches(const xoj::util::simd::Box& a, const xoj::util::simd::Box& b) {
+        return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+    }
+
+    [[nodiscard]] double lowerBound(const Node& n, double x, double y) const {
+        const double dx = std::max({n.box.minX - x, 0.0, x - n.box.maxX});
+        const double dy = std::max({n.box.minY - y, 0.0, y - n.box.maxY});
+        return std::max(std::hypot(dx, dy) - n.maxHalfWidth, 0.0);
+    }
+
+    /// The nodes in depth-first order
+    std::vector<Node> nodes;
+
+    /// Upper bound of the depth of the tree, for the traversal stacks
+    static constexpr size_t MAX_DEPTH = 8 * sizeof(size_t);
+};
+
+template <class Fn>
+void StrokeSegmentTree::forEachRangeTouching(const xoj::util::simd::Box& box, size_t first, size_t last,
+                                             Fn fn) const {
+    std::array<size_t, MAX_DEPTH + 1> stack;  // NOLINT(cppcoreguidelines-pro-type-member-init)
+    size_t size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const size_t index = stack[--size];
+        const Node& n = nodes[index];
+        if (n.last <= first || last <= n.first || !touches(n.box, box)) {
+            continue;
+        }
+        if (n.secondChild == 0) {
+            if (fn(std::max(n.first, first), std::min(n.last, last))) {
+                return;
+            }
+            continue;
+        }
+        // The first child is visited first, so that the ranges are in increasing order
+        stack[size++] = n.secondChild;
+        stack[size++] = index + 1;
+    }
+}
+
+template <class Fn>
+double StrokeSegmentTree::findMinimum(double x, double y, double best, Fn fn) const {
+    std::array<size_t, MAX_DEPTH + 1> stack;  // NOLINT(cppcoreguidelines-pro-type-member-init)
+    size_t size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const Node& n = nodes[stack[--size]];
+        if (lowerBound(n, x, y) >= best) {
+            continue;
+        }
+        if (n.secondChild == 0) {
+            best = fn(n.first, n.last, best);
+            continue;
+        }
+        // Visit the nearest child first: the farthest one is then more likely to be pruned
+        const size_t firstChild = static_cast<size_t>(&n - nodes.data()) + 1;
+        const size_t secondChild = n.secondChild;
+        if (lowerBound(nodes[firstChild], x, y) <= lowerBound(nodes[secondChild], x, y)) {
+            stack[size++] = secondChild;
+            stack[size++] = firstChild;
+        } else {
+            stack[size++] = firstChild;
+            stack[size++] = secondChild;
+        }
+    }
+    return best;
+}
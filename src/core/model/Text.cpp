@@ -1,17 +1,19 @@
 #include "Text.h"
 
+#include <algorithm>  // for find_if
 #include <memory>
-#include <utility>  // for move
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include <glib.h>  // for g_warning
 #include <pango/pangocairo.h>
 
-#include "model/AudioElement.h"   // for AudioElement
-#include "model/Element.h"        // for ELEMENT_TEXT, Eleme...
-#include "model/Font.h"           // for XojFont
-#include "pdf/base/XojPdfPage.h"  // for XojPdfRectangle
-#include "util/Rectangle.h"       // for Rectangle
-#include "util/Stacktrace.h"      // for Stacktrace
+#include "model/AudioElement.h"                   // for AudioElement
+#include "model/Element.h"                        // for ELEMENT_TEXT, Eleme...
+#include "model/Font.h"                           // for XojFont
+#include "pdf/base/XojPdfPage.h"                  // for XojPdfRectangle
+#include "util/Rectangle.h"                       // for Rectangle
+#include "util/Stacktrace.h"                      // for Stacktrace
 #include "util/StringUtils.h"
 #include "util/raii/GObjectSPtr.h"
 #include "util/safe_casts.h"                      // for round_cast
@@ -46,12 +48,16 @@ auto Text::cloneText() const -> std::unique_ptr<Text> {
 
 auto Text::clone() const -> ElementPtr { return cloneText(); }
 
-auto Text::getFont() -> XojFont& { return font; }
+auto Text::getFont() -> XojFont& {
+    invalidateLayout();
+    return font;
+}
 auto Text::getFont() const -> const XojFont& { return font; }
 
 void Text::setFont(const XojFont& font) {
     this->font = font;
     sizeCalculated = false;
+    invalidateLayout();
 }
 
 auto Text::getFontSize() const -> double { return font.getSize(); }
@@ -63,16 +69,29 @@ auto Text::getText() const -> const std::string& { return this->text; }
 void Text::setText(std::string text) {
     this->text = std::move(text);
     sizeCalculated = false;
+    invalidateLayout();
 }
 
 void Text::setWrap(double wrap) {
     this->wrapWidth = wrap;
     sizeCalculated = false;
+    invalidateLayout();
 }
 
 void Text::setAlignment(TextAlignment a) {
     this->align = a;
     sizeCalculated = false;
+    invalidateLayout();
+}
+
+void Text::setJustify(bool j) {
+    this->justify = j;
+    invalidateLayout();
+}
+
+void Text::invalidateLayout() {
+    std::lock_guard lock(layoutMutex);
+    this->layouts.clear();
 }
 
 Text::Boxes Text::computeBoxesForLayout(PangoLayout* layout, xoj::util::Point<double> origin, double wrapWidth) {
@@ -110,9 +129,7 @@ void Text::setOrigin(double x, double y) {
 auto Text::getOrigin() const -> const xoj::util::Point<double>& { return this->snappedBounds.getOrigin(); }
 
 void Text::calcSize() const {
-    auto layout = createPangoLayout();
-    pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
-
+    auto layout = getPangoLayout();
     auto boxes = computeBoxesForLayout(layout.get(), this->getOrigin(), this->wrapWidth);
 
     this->boundingBox = boxes.bounds;
@@ -121,11 +138,57 @@ void Text::calcSize() const {
 
 void Text::setInEditing(bool inEditing) { this->inEditing = inEditing; }
 
-auto Text::createPangoLayout() const -> xoj::util::GObjectSPtr<PangoLayout> {
+static auto createPangoContext() -> xoj::util::GObjectSPtr<PangoContext> {
     xoj::util::GObjectSPtr<PangoContext> c(pango_font_map_create_context(pango_cairo_font_map_get_default()),
                                            xoj::util::adopt);
     pango_context_set_round_glyph_positions(c.get(), false);  // Avoid weird glyph positioning on small fonts
-    xoj::util::GObjectSPtr<PangoLayout> layout(pango_layout_new(c.get()), xoj::util::adopt);
+    return c;
+}
+
+auto Text::getPangoContext(const cairo_font_options_t* options) -> PangoContext* {
+    // The default font map is per thread as well. There are only a few different font options (one per kind of
+    // surface): changing the options of a context instead would invalidate all the layouts made with it.
+    thread_local std::vector<xoj::util::GObjectSPtr<PangoContext>> contexts;
+
+    auto it = std::find_if(contexts.begin(), contexts.end(), [options](const auto& c) {
+        const cairo_font_options_t* o = pango_cairo_context_get_font_options(c.get());
+        return options && o ? cairo_font_options_equal(options, o) : options == o;
+    });
+    if (it != contexts.end()) {
+        return it->get();
+    }
+
+    auto context = createPangoContext();
+    if (options) {
+        pango_cairo_context_set_font_options(context.get(), options);
+    }
+    return contexts.emplace_back(std::move(context)).get();
+}
+
+auto Text::getPangoLayout(const cairo_font_options_t* options) const -> xoj::util::GObjectSPtr<PangoLayout> {
+    // Some threads may end: do not keep their layouts forever
+    constexpr size_t MAX_LAYOUTS = 16;
+
+    PangoContext* context = getPangoContext(options);
+    std::lock_guard lock(layoutMutex);
+    if (this->layouts.size() >= MAX_LAYOUTS && this->layouts.find(context) == this->layouts.end()) {
+        this->layouts.clear();
+    }
+    auto& layout = this->layouts[context];
+    if (!layout) {
+        layout = createPangoLayout(context);
+        pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
+    }
+    return layout;
+}
+
+auto Text::createPangoLayout() const -> xoj::util::GObjectSPtr<PangoLayout> {
+    // A context of its own: the editor may change it
+    return createPangoLayout(createPangoContext().get());
+}
+
+auto Text::createPangoLayout(PangoContext* context) const -> xoj::util::GObjectSPtr<PangoLayout> {
+    xoj::util::GObjectSPtr<PangoLayout> layout(pango_layout_new(context), xoj::util::adopt);
 
     pango_layout_set_width(layout.get(),
                            this->wrapWidth == NO_WRAP ? -1 : round_cast<int>(this->wrapWidth * PANGO_SCALE));
@@ -173,6 +236,7 @@ void Text::scale(double x0, double y0, double fx, double fy, double rotation,
     }
 
     sizeCalculated = false;
+    invalidateLayout();
 }
 
 void Text::rotate(double x0, double y0, double th) {}
@@ -212,6 +276,8 @@ void Text::readSerialized(ObjectInputStream& in) {
     this->justify = in.readInt() != 0;
 
     in.endObject();
+
+    invalidateLayout();
 }
 
 auto Text::findText(const std::string& search) const -> std::vector<XojPdfRectangle> {
@@ -220,9 +286,7 @@ auto Text::findText(const std::string& search) const -> std::vector<XojPdfRectan
         return {};
     }
 
-    auto layout = this->createPangoLayout();
-    pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
-
+    auto layout = this->getPangoLayout();
 
     std::string text = StringUtils::toLowerCase(this->text);
     std::string pattern = StringUtils::toLowerCase(search);
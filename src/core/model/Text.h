@@ -11,9 +11,12 @@
 
 #pragma once
 
+#include <map>     // for map
+#include <mutex>   // for mutex
 #include <string>  // for string
 #include <vector>
 
+#include <cairo.h>  // for cairo_font_options_t
 #include <pango/pango.h>
 
 #include "model/Element.h"
@@ -38,6 +41,7 @@ public:
 
 public:
     void setFont(const XojFont& font);
+    /// The font may be modified through the returned reference: this drops the cached layout
     XojFont& getFont();
     const XojFont& getFont() const;
     double getFontSize() const;       // same result as getFont()->getSize(), but const
@@ -49,9 +53,24 @@ public:
     void setInEditing(bool inEditing);
     bool isInEditing() const;
 
+    /// Creates a new layout, with a Pango context of its own and without the text. For editing: see getPangoLayout()
     xoj::util::GObjectSPtr<PangoLayout> createPangoLayout() const;
     void updatePangoFont(PangoLayout* layout) const;
 
+    /**
+     * The layout of the text, shaped once and cached until the text or its style change.
+     * One layout is cached for each Pango context the text is laid out with (see getPangoContext()): the layout must
+     * not be modified, nor passed to another thread.
+     * @param options The font options of the target surface, or nullptr for the default ones (e.g. for measuring)
+     */
+    xoj::util::GObjectSPtr<PangoLayout> getPangoLayout(const cairo_font_options_t* options = nullptr) const;
+
+    /**
+     * The Pango context of the calling thread for these font options, shared by all the texts (Pango contexts are not
+     * thread safe). Each thread keeps one context per font options, so that they are never modified.
+     */
+    static PangoContext* getPangoContext(const cairo_font_options_t* options = nullptr);
+
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
 
@@ -69,7 +88,7 @@ public:
     void setAlignment(TextAlignment a);
     inline TextAlignment getAlign() const { return align; }
 
-    inline void setJustify(bool j) { this->justify = j; }
+    void setJustify(bool j);
     inline bool getJustify() const { return justify; }
 
     auto cloneText() const -> std::unique_ptr<Text>;
@@ -102,4 +121,11 @@ private:
     bool justify = false;  ///< Stretch whitespaces to make all complete lines have the same width
 
     bool inEditing = false;
+
+    xoj::util::GObjectSPtr<PangoLayout> createPangoLayout(PangoContext* context) const;
+    void invalidateLayout();
+
+    /// Cached by getPangoLayout(), for each context. A layout holds a reference to its context, which stays valid.
+    mutable std::map<PangoContext*, xoj::util::GObjectSPtr<PangoLayout>> layouts;
+    mutable std::mutex layoutMutex;
 };
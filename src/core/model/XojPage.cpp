@@ -2,6 +2,7 @@
 
 #include <algorithm>  // for find, transform
 #include <iterator>   // for back_insert_iterator, back_inserter, begin
+#include <mutex>      // for lock_guard
 #include <utility>    // for move
 
 #include "model/Layer.h"     // for Layer, Layer::Index
@@ -32,6 +33,7 @@ XojPage::XojPage(XojPage const& page):
         bgType(page.bgType),
         pdfBackgroundPage(page.pdfBackgroundPage),
         backgroundColor(page.backgroundColor) {
+    page.loadContents();
     this->layer.reserve(page.layer.size());
     std::transform(begin(page.layer), end(page.layer), std::back_inserter(this->layer),
                    [](auto* layer) { return layer->clone(); });
@@ -39,23 +41,77 @@ XojPage::XojPage(XojPage const& page):
 
 auto XojPage::clone() -> XojPage* { return new XojPage(*this); }
 
+void XojPage::setContentLoader(std::unique_ptr<PageContentLoader> loader) {
+    xoj_assert(this->layer.empty());
+    this->contentLoader = std::move(loader);
+    this->contentPending.store(this->contentLoader != nullptr, std::memory_order_release);
+}
+
+auto XojPage::isContentLoaded() const -> bool { return !this->contentPending.load(std::memory_order_acquire); }
+
+void XojPage::loadContents() const {
+    if (!this->contentPending.load(std::memory_order_acquire)) {
+        return;
+    }
+    // The layers may be needed by several threads at once, e.g. to render the page and to search in it
+    std::lock_guard lock(this->contentLoaderMutex);
+    if (!this->contentPending.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // Loading the contents does not change the observable state of the page
+    auto& layers = const_cast<XojPage*>(this)->layer;
+    layers = this->contentLoader->loadLayers();
+    if (layers.empty()) {
+        layers.push_back(new Layer());
+    }
+    for (const Layer* l: layers) {
+        this->loadedLayersModificationCount += l->getModificationCount();
+    }
+    this->contentError = this->contentLoader->getError();
+    this->contentLoader.reset();
+    this->contentPending.store(false, std::memory_order_release);
+}
+
+auto XojPage::getContentError() const -> std::string {
+    loadContents();
+    return this->contentError;
+}
+
+auto XojPage::getModificationCount() const -> uint64_t {
+    uint64_t count = this->modificationCount;
+    if (!isContentLoaded()) {
+        return count;
+    }
+    for (const Layer* l: this->layer) {
+        count += l->getModificationCount();
+    }
+    return count - this->loadedLayersModificationCount;
+}
+
 void XojPage::addLayer(Layer* layer) {
+    loadContents();
+    this->modificationCount++;
     this->layer.push_back(layer);
     this->currentLayer = npos;
 }
 
 void XojPage::insertLayer(Layer* layer, Layer::Index index) {
+    loadContents();
     if (index >= this->layer.size()) {
         addLayer(layer);
         return;
     }
 
+    this->modificationCount++;
     this->layer.insert(std::next(this->layer.begin(), static_cast<ptrdiff_t>(index)), layer);
     this->currentLayer = index + 1;
 }
 
 void XojPage::removeLayer(Layer* l) {
+    loadContents();
     if (auto it = std::find(layer.begin(), layer.end(), l); it != layer.end()) {
+        // The count of the page must not decrease with the sum of the counts of its layers
+        this->modificationCount += l->getModificationCount() + 1;
         this->layer.erase(it);
     }
     this->currentLayer = npos;
@@ -67,16 +123,26 @@ void XojPage::removeLayer(Layer* l) {
 
 void XojPage::setSelectedLayerId(Layer::Index id) { this->currentLayer = id; }
 
-auto XojPage::getLayers() -> std::vector<Layer*>& { return this->layer; }
+auto XojPage::getLayers() -> std::vector<Layer*>& {
+    loadContents();
+    return this->layer;
+}
 
-auto XojPage::getLayersView() const -> xoj::util::PointerContainerView<std::vector<Layer*>> { return this->layer; }
+auto XojPage::getLayersView() const -> xoj::util::PointerContainerView<std::vector<Layer*>> {
+    loadContents();
+    return this->layer;
+}
 
-auto XojPage::getLayerCount() const -> Layer::Index { return this->layer.size(); }
+auto XojPage::getLayerCount() const -> Layer::Index {
+    loadContents();
+    return this->layer.size();
+}
 
 /**
  * Layer ID 0 = Background, Layer ID 1 = Layer 1
  */
 auto XojPage::getSelectedLayerId() -> Layer::Index {
+    loadContents();
     if (this->currentLayer == npos) {
         this->currentLayer = this->layer.size();
     }
@@ -87,10 +153,12 @@ auto XojPage::getSelectedLayerId() -> Layer::Index {
 void XojPage::setLayerVisible(Layer::Index layerId, bool visible) {
     if (layerId == 0) {
         backgroundVisible = visible;
+        this->modificationCount++;
         return;
     }
 
     layerId--;
+    loadContents();
     if (layerId >= this->layer.size()) {
         return;
     }
@@ -104,6 +172,7 @@ auto XojPage::isLayerVisible(Layer::Index layerId) const -> bool {
     }
 
     layerId--;
+    loadContents();
     if (layerId >= this->layer.size()) {
         return false;
     }
@@ -115,15 +184,20 @@ void XojPage::setBackgroundPdfPageNr(size_t page) {
     this->pdfBackgroundPage = page;
     this->bgType.format = PageTypeFormat::Pdf;
     this->bgType.config = "";
+    this->modificationCount++;
 }
 
-void XojPage::setBackgroundColor(Color color) { this->backgroundColor = color; }
+void XojPage::setBackgroundColor(Color color) {
+    this->backgroundColor = color;
+    this->modificationCount++;
+}
 
 auto XojPage::getBackgroundColor() const -> Color { return this->backgroundColor; }
 
 void XojPage::setSize(double width, double height) {
     this->width = width;
     this->height = height;
+    this->modificationCount++;
 }
 
 auto XojPage::getWidth() const -> double { return this->width; }
@@ -133,6 +207,7 @@ auto XojPage::getHeight() const -> double { return this->height; }
 auto XojPage::getPdfPageNr() const -> size_t { return this->pdfBackgroundPage; }
 
 auto XojPage::isAnnotated() const -> bool {
+    loadContents();
     for (Layer* l: this->layer) {
         if (l->isAnnotated()) {
             return true;
@@ -150,6 +225,7 @@ void XojPage::setBackgroundType(const PageType& bgType) {
     if (!bgType.isImagePage()) {
         this->backgroundImage.free();
     }
+    this->modificationCount++;
 }
 
 auto XojPage::getBackgroundType() const -> PageType { return this->bgType; }
@@ -157,9 +233,13 @@ auto XojPage::getBackgroundType() const -> PageType { return this->bgType; }
 auto XojPage::getBackgroundImage() -> BackgroundImage& { return this->backgroundImage; }
 auto XojPage::getBackgroundImage() const -> const BackgroundImage& { return this->backgroundImage; }
 
-void XojPage::setBackgroundImage(BackgroundImage img) { this->backgroundImage = std::move(img); }
+void XojPage::setBackgroundImage(BackgroundImage img) {
+    this->backgroundImage = std::move(img);
+    this->modificationCount++;
+}
 
 auto XojPage::getSelectedLayer() -> Layer* {
+    loadContents();
     xoj_assert(!layer.empty());
     size_t layer = getSelectedLayerId();
 
@@ -170,8 +250,20 @@ auto XojPage::getSelectedLayer() -> Layer* {
     return this->layer[layer];
 }
 
+void XojPage::updateElementBounds(const Element* e) {
+    loadContents();
+    for (Layer* l: this->layer) {
+        if (l->updateElementBounds(e)) {
+            return;
+        }
+    }
+}
+
 auto XojPage::getBackgroundName() const -> std::string { return backgroundName.value_or(_("Background")); }
 
 auto XojPage::backgroundHasName() const -> bool { return backgroundName.has_value(); }
 
-void XojPage::setBackgroundName(const std::string& newName) { backgroundName = newName; }
+void XojPage::setBackgroundName(const std::string& newName) {
+    backgroundName = newName;
+    this->modificationCount++;
+}
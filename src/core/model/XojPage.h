@@ -11,19 +11,24 @@
 
 #pragma once
 
+#include <atomic>    // for atomic
 #include <cstddef>   // for size_t
+#include <cstdint>   // for uint64_t
+#include <memory>    // for unique_ptr
+#include <mutex>     // for mutex
 #include <optional>  // for optional
 #include <string>    // for string
 #include <vector>    // for vector
 
 #include "util/Color.h"  // for Color
 #include "util/PointerContainerView.h"
-#include "util/Util.h"  // for npos
+#include "util/Util.h"   // for npos
 
-#include "BackgroundImage.h"  // for BackgroundImage
-#include "Layer.h"            // for Layer, Layer::Index
-#include "PageHandler.h"      // for PageHandler
-#include "PageType.h"         // for PageType
+#include "BackgroundImage.h"    // for BackgroundImage
+#include "Layer.h"              // for Layer, Layer::Index
+#include "PageContentLoader.h"  // for PageContentLoader
+#include "PageHandler.h"        // for PageHandler
+#include "PageType.h"           // for PageType
 
 class XojPage: public PageHandler {
 public:
@@ -72,6 +77,12 @@ public:
 
     Layer* getSelectedLayer();
 
+    /**
+     * Updates the spatial index of the Layer containing e.
+     * Call after e has been moved or resized in place, without being removed from its Layer.
+     */
+    void updateElementBounds(const Element* e);
+
     BackgroundImage& getBackgroundImage();
     const BackgroundImage& getBackgroundImage() const;
     void setBackgroundImage(BackgroundImage img);
@@ -85,6 +96,34 @@ public:
      */
     XojPage* clone();
 
+    /**
+     * Let the loader create the layers of the page the first time they are accessed. The page must have no layers.
+     */
+    void setContentLoader(std::unique_ptr<PageContentLoader> loader);
+
+    /**
+     * @return false if the layers of the page are still to be created by its content loader
+     */
+    bool isContentLoaded() const;
+
+    /**
+     * @return Why the content loader could not create all the contents of the page, or an empty string. Loads the
+     * contents. The page cannot be saved if some of its contents are missing (see SaveHandler).
+     */
+    std::string getContentError() const;
+
+    /**
+     * @return A counter which changes with every change of the page or of its layers. Equal values mean that the page
+     * was not modified in between. Does not load the contents of the page.
+     */
+    uint64_t getModificationCount() const;
+
+private:
+    /**
+     * Create the layers with the content loader, if not done yet. Called by all the functions using the layers.
+     */
+    void loadContents() const;
+
 private:
     /**
      * The Background image if any
@@ -102,6 +141,16 @@ private:
      */
     std::vector<Layer*> layer;
 
+    /**
+     * Creates the layers on first access, for pages loaded lazily
+     */
+    mutable std::unique_ptr<PageContentLoader> contentLoader;
+    mutable std::mutex contentLoaderMutex;
+    mutable std::atomic<bool> contentPending = false;
+    mutable std::string contentError;
+    /// The modification counts of the layers created by the content loader, which are not changes of the page
+    mutable uint64_t loadedLayersModificationCount = 0;
+
     /**
      * The current selected layer ID
      */
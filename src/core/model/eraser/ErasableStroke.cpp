@@ -301,7 +301,7 @@ auto ErasableStroke::computeSubSectionBoundingBox(const SubSection& section) con
 
     Range rg = pointRange(this->stroke.getPoint(section.min));
 
-    auto data = this->stroke.getPointVector();
+    const auto& data = this->stroke.getPointVector();
     auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)section.max.index + 1);
     for (auto ptIt = std::next(data.cbegin(), (std::ptrdiff_t)section.min.index + 1); ptIt != endIt; ++ptIt) {
         rg = rg.unite(pointRange(*ptIt));
@@ -82,7 +82,7 @@ auto ErasableStroke::OverlapTree::Populator::getNextFreeSlot() -> std::pair<Node
 }
 
 void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, const Point& firstPoint, size_t min, size_t max,
-                                                          const Point& lastPoint, const std::vector<Point>& pts) {
+                                                          const Point& lastPoint, const StrokePoints& pts) {
     xoj_assert(min <= max && max < pts.size());
     /**
      * Split in two in the middle
@@ -97,7 +97,7 @@ void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, const Poin
 }
 
 void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, const Point& firstPoint, size_t min, size_t max,
-                                                          const std::vector<Point>& pts) {
+                                                          const StrokePoints& pts) {
     xoj_assert(min <= max && max < pts.size());
     if (min == max) {
         // The node corresponds to a single segment
@@ -118,7 +118,7 @@ void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, const Poin
 }
 
 void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, size_t min, size_t max, const Point& lastPoint,
-                                                          const std::vector<Point>& pts) {
+                                                          const StrokePoints& pts) {
     xoj_assert(min <= max && max < pts.size());
     if (min == max) {
         // The node corresponds to a single segment
@@ -139,7 +139,7 @@ void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, size_t min
 }
 
 void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, size_t min, size_t max,
-                                                          const std::vector<Point>& pts) {
+                                                          const StrokePoints& pts) {
     xoj_assert(max > min);
     if (min + 1 == max) {
         // The node corresponds to a single segment
@@ -17,7 +17,8 @@
 
 #include <cairo.h>  // for cairo_t
 
-#include "util/Rectangle.h"  // for Rectangle
+#include "model/StrokePoints.h"  // for StrokePoints
+#include "util/Rectangle.h"      // for Rectangle
 
 #include "ErasableStroke.h"  // for ErasableStroke::SubSection, ErasableStroke
 #include "config-debug.h"    // for DEBUG_ERASABLE_STROKE_BOXES
@@ -140,24 +141,24 @@ private:
          *      firstPoint -- pts[min] -- ... -- pts[max] -- lastPoint
          */
         void populateNode(Node& node, const Point& firstPoint, size_t min, size_t max, const Point& lastPoint,
-                          const std::vector<Point>& pts);
+                          const StrokePoints& pts);
 
         /**
          * @brief Create a subtree corresponding to the subsection:
          *      firstPoint -- pts[min] -- ... -- pts[max]
          */
-        void populateNode(Node& node, const Point& firstPoint, size_t min, size_t max, const std::vector<Point>& pts);
+        void populateNode(Node& node, const Point& firstPoint, size_t min, size_t max, const StrokePoints& pts);
 
         /**
          * @brief Create a subtree corresponding to the subsection:
          *      pts[min] -- ... -- pts[max] -- lastPoint
          */
-        void populateNode(Node& node, size_t min, size_t max, const Point& lastPoint, const std::vector<Point>& pts);
+        void populateNode(Node& node, size_t min, size_t max, const Point& lastPoint, const StrokePoints& pts);
 
         /**
          * @brief Create a subtree corresponding to the subsection:
          *      pts[min] -- ... -- pts[max]
          */
-        void populateNode(Node& node, size_t min, size_t max, const std::vector<Point>& pts);
+        void populateNode(Node& node, size_t min, size_t max, const StrokePoints& pts);
     };
 };
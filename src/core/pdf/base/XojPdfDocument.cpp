@@ -40,6 +40,14 @@ auto XojPdfDocument::load(std::unique_ptr<std::string> data, std::string passwor
     return doc->load(std::move(data), password, error);
 }
 
+auto XojPdfDocument::loadCopyOf(const XojPdfDocumentInterface* doc, GError** error) -> bool {
+    return this->doc->loadCopyOf(doc, error);
+}
+
+auto XojPdfDocument::loadCopyOf(const XojPdfDocument& doc, GError** error) -> bool {
+    return this->doc->loadCopyOf(doc.doc, error);
+}
+
 auto XojPdfDocument::isLoaded() const -> bool { return doc->isLoaded(); }
 
 void XojPdfDocument::reset() { doc->reset(); }
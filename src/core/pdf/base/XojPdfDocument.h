@@ -42,6 +42,8 @@ public:
     bool save(fs::path const& file, GError** error) const override;
     bool load(fs::path const& file, std::string password, GError** error) override;
     bool load(std::unique_ptr<std::string> data, std::string password, GError** error) override;
+    bool loadCopyOf(const XojPdfDocumentInterface* doc, GError** error) override;
+    bool loadCopyOf(const XojPdfDocument& doc, GError** error);
     bool isLoaded() const override;
     void reset() override;
 
@@ -34,6 +34,12 @@ public:
     virtual bool save(fs::path const& file, GError** error) const = 0;
     virtual bool load(fs::path const& file, std::string password, GError** error) = 0;
     virtual bool load(std::unique_ptr<std::string> data, std::string password, GError** error) = 0;
+    /**
+     * Loads the same document as doc, as an independent instance: unlike with assign(), both instances can then be
+     * used in parallel from different threads.
+     * @return false if doc is not loaded, or if the document cannot be loaded again
+     */
+    virtual bool loadCopyOf(const XojPdfDocumentInterface* doc, GError** error) = 0;
     virtual bool isLoaded() const = 0;
     virtual void reset() = 0;
 
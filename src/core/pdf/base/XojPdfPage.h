@@ -61,6 +61,12 @@ public:
         std::unique_ptr<XojPdfAction> action;
     };
 
+    struct TextLayout {
+        std::string text;
+        /// The bounding box of each character (not byte) of the text
+        std::vector<XojPdfRectangle> glyphs;
+    };
+
     virtual double getWidth() const = 0;
     virtual double getHeight() const = 0;
 
@@ -77,6 +83,9 @@ public:
 
     virtual std::vector<XojPdfRectangle> findText(const std::string& text) = 0;
 
+    /// Retrieve the whole text of the page, with the position of each character. Used by the SearchIndex.
+    virtual TextLayout getTextLayout() = 0;
+
     /// Retrieve the text contained in the provided rectangle using the given
     /// selection style.
     /// @param rect start and end points
@@ -2,6 +2,7 @@
 
 #include <memory>    // for make_shared, unique_ptr
 #include <optional>  // for optional
+#include <utility>   // for move
 
 #include <poppler-document.h>  // for poppler_document_get_n_...
 
@@ -17,7 +18,17 @@ using std::string;
 
 PopplerGlibDocument::PopplerGlibDocument(): mutex(std::make_shared<std::mutex>()) {}
 
-PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc): document(doc.document), mutex(doc.mutex) {
+PopplerGlibDocument::Source::Source(std::string uri, GBytes* bytes, std::string password):
+        uri(std::move(uri)), bytes(bytes ? g_bytes_ref(bytes) : nullptr), password(std::move(password)) {}
+
+PopplerGlibDocument::Source::~Source() {
+    if (bytes) {
+        g_bytes_unref(bytes);
+    }
+}
+
+PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc):
+        document(doc.document), mutex(doc.mutex), source(doc.source) {
     if (document) {
         g_object_ref(document);
     }
@@ -42,6 +53,7 @@ void PopplerGlibDocument::assign(XojPdfDocumentInterface* doc) {
     }
 
     mutex = popplerdoc->mutex;
+    source = popplerdoc->source;
 }
 
 auto PopplerGlibDocument::equals(XojPdfDocumentInterface* doc) const -> bool {
@@ -71,6 +83,7 @@ auto PopplerGlibDocument::load(fs::path const& file, string password, GError** e
     }
 
     this->document = poppler_document_new_from_file(uri->c_str(), password.c_str(), error);
+    this->source = this->document ? std::make_shared<const Source>(*uri, nullptr, password) : nullptr;
 
     return this->document != nullptr;
 }
@@ -84,11 +97,35 @@ auto PopplerGlibDocument::load(std::unique_ptr<std::string> data, string passwor
             data->data(), data->size(), [](gpointer d) { delete reinterpret_cast<std::string*>(d); }, data.get());
     data.release();  // the string will be deleted with the bytes object
     this->document = poppler_document_new_from_bytes(bytes, password.c_str(), error);
+    this->source = this->document ? std::make_shared<const Source>(std::string(), bytes, password) : nullptr;
     g_bytes_unref(bytes);  // a reference is now held by the document
 
     return this->document != nullptr;
 }
 
+auto PopplerGlibDocument::loadCopyOf(const XojPdfDocumentInterface* doc, GError** error) -> bool {
+    const auto* popplerdoc = dynamic_cast<const PopplerGlibDocument*>(doc);
+    if (!popplerdoc || !popplerdoc->source) {
+        return false;
+    }
+    const Source& src = *popplerdoc->source;
+
+    if (document) {
+        g_object_unref(document);
+    }
+
+    if (src.bytes) {
+        this->document = poppler_document_new_from_bytes(src.bytes, src.password.c_str(), error);
+    } else {
+        this->document = poppler_document_new_from_file(src.uri.c_str(), src.password.c_str(), error);
+    }
+    // Independent instances can be rendered concurrently
+    this->mutex = std::make_shared<std::mutex>();
+    this->source = this->document ? popplerdoc->source : nullptr;
+
+    return this->document != nullptr;
+}
+
 auto PopplerGlibDocument::isLoaded() const -> bool { return this->document != nullptr; }
 
 void PopplerGlibDocument::reset() {
@@ -96,6 +133,7 @@ void PopplerGlibDocument::reset() {
         g_object_unref(document);
         document = nullptr;
     }
+    source.reset();
 }
 
 auto PopplerGlibDocument::getPage(size_t page) const -> XojPdfPageSPtr {
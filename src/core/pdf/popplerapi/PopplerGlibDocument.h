@@ -40,6 +40,7 @@ public:
     bool save(fs::path const& filepath, GError** error) const override;
     bool load(fs::path const& filepath, std::string password, GError** error) override;
     bool load(std::unique_ptr<std::string> data, std::string password, GError** error) override;
+    bool loadCopyOf(const XojPdfDocumentInterface* doc, GError** error) override;
     bool isLoaded() const override;
     void reset() override;
 
@@ -48,6 +49,19 @@ public:
     XojPdfBookmarkIterator* getContentsIter() const override;
 
 private:
+    /// What the document was loaded from, to be able to load it again (see loadCopyOf())
+    struct Source {
+        Source(std::string uri, GBytes* bytes, std::string password);
+        ~Source();
+        Source(const Source&) = delete;
+        Source& operator=(const Source&) = delete;
+
+        std::string uri;  ///< Empty if the document was loaded from memory
+        GBytes* bytes;    ///< nullptr if the document was loaded from a file
+        std::string password;
+    };
+
     PopplerDocument* document = nullptr;
     std::shared_ptr<std::mutex> mutex;
+    std::shared_ptr<const Source> source;
 };
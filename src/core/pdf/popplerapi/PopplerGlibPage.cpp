@@ -111,6 +111,27 @@ auto PopplerGlibPage::findText(const std::string& text) -> std::vector<XojPdfRec
     return findings;
 }
 
+auto PopplerGlibPage::getTextLayout() -> TextLayout {
+    std::lock_guard guard(*mutex);
+    TextLayout layout;
+
+    char* text = poppler_page_get_text(page);
+    PopplerRectangle* rects = nullptr;
+    guint count = 0;
+    // The rectangles are in the coordinates of the page, unlike the ones of poppler_page_find_text()
+    if (text != nullptr && poppler_page_get_text_layout(page, &rects, &count)) {
+        layout.text = text;
+        layout.glyphs.reserve(count);
+        for (guint i = 0; i < count; i++) {
+            layout.glyphs.emplace_back(rects[i].x1, rects[i].y1, rects[i].x2, rects[i].y2);
+        }
+        g_free(rects);
+    }
+    g_free(text);
+
+    return layout;
+}
+
 auto getPopplerSelectionStyle(XojPdfPageSelectionStyle style) -> PopplerSelectionStyle {
     switch (style) {
         case XojPdfPageSelectionStyle::Word:
@@ -3613,7 +3613,7 @@ static int applib_addImages(lua_State* L) {
         } else {  // data was provided instead
             img = std::make_unique<Image>();
             img->setImage(std::string(data, dataLen));
-            img->getImage();  // render image first to get the proper width and height
+            img->renderBuffer();  // render image first to get the proper width and height
         }
 
         auto [width, height] = img->getImageSize();
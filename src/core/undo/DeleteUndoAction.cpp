@@ -6,11 +6,12 @@
 
 #include "control/Control.h"
 #include "model/Document.h"
-#include "model/Element.h"           // for Element, ELEMENT_IMAGE, ELEMENT_...
-#include "model/Layer.h"             // for Layer
-#include "model/XojPage.h"           // for XojPage
-#include "undo/UndoAction.h"         // for UndoAction
-#include "util/i18n.h"               // for _
+#include "model/Element.h"    // for Element, ELEMENT_IMAGE, ELEMENT_...
+#include "model/Layer.h"      // for Layer
+#include "model/XojPage.h"    // for XojPage
+#include "undo/UndoAction.h"  // for UndoAction
+#include "undo/UndoMemory.h"  // for getMemoryUsage, spillElement
+#include "util/i18n.h"        // for _
 
 
 DeleteUndoAction::DeleteUndoAction(const PageRef& page, bool eraser): UndoAction("DeleteUndoAction"), eraser(eraser) {
@@ -106,3 +107,28 @@ auto DeleteUndoAction::getText() -> std::string {
 
     return text;
 }
+
+auto DeleteUndoAction::getMemoryUsage() const -> size_t {
+    size_t usage = UndoAction::getMemoryUsage();
+    for (const auto& elem: elements) {
+        // The elements are only held by the action while they are deleted
+        usage += sizeof(elem) + (elem.elementOwn ? xoj::undo::getMemoryUsage(*elem.elementOwn) : 0);
+    }
+    return usage;
+}
+
+void DeleteUndoAction::spill(ObjectOutputStream& out) {
+    for (const auto& elem: elements) {
+        if (elem.elementOwn) {
+            xoj::undo::spillElement(*elem.elementOwn, out);
+        }
+    }
+}
+
+void DeleteUndoAction::restore(ObjectInputStream& in) {
+    for (const auto& elem: elements) {
+        if (elem.elementOwn) {
+            xoj::undo::restoreElement(*elem.elementOwn, in);
+        }
+    }
+}
@@ -11,8 +11,9 @@
 
 #pragma once
 
-#include <set>     // for multiset
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <set>      // for multiset
+#include <string>   // for string
 
 #include "model/Element.h"  // for Element, Element::Index
 #include "model/PageRef.h"  // for PageRef
@@ -35,6 +36,10 @@ public:
 
     std::string getText() override;
 
+    size_t getMemoryUsage() const override;
+    void spill(ObjectOutputStream& out) override;
+    void restore(ObjectInputStream& in) override;
+
 private:
     // Todo (performance): replace by flat_multi_set / sorted_vector
     std::multiset<PageLayerPosEntry<Element>> elements{};
@@ -10,6 +10,7 @@
 #include "model/XojPage.h"                // for XojPage
 #include "model/eraser/ErasableStroke.h"  // for ErasableStroke
 #include "undo/UndoAction.h"              // for UndoAction
+#include "undo/UndoMemory.h"              // for getMemoryUsage, spillElement
 #include "util/i18n.h"                    // for _
 
 
@@ -104,3 +105,34 @@ auto EraseUndoAction::redo(Control* control) -> bool {
     this->undone = false;
     return true;
 }
+
+auto EraseUndoAction::getMemoryUsage() const -> size_t {
+    size_t usage = UndoAction::getMemoryUsage();
+    // Either the original strokes or the edited ones are held by the action, the others are in the layers
+    for (const auto* entries: {&original, &edited}) {
+        for (const auto& entry: *entries) {
+            usage += sizeof(entry) + (entry.elementOwn ? xoj::undo::getMemoryUsage(*entry.elementOwn) : 0);
+        }
+    }
+    return usage;
+}
+
+void EraseUndoAction::spill(ObjectOutputStream& out) {
+    for (const auto* entries: {&original, &edited}) {
+        for (const auto& entry: *entries) {
+            if (entry.elementOwn) {
+                xoj::undo::spillElement(*entry.elementOwn, out);
+            }
+        }
+    }
+}
+
+void EraseUndoAction::restore(ObjectInputStream& in) {
+    for (const auto* entries: {&original, &edited}) {
+        for (const auto& entry: *entries) {
+            if (entry.elementOwn) {
+                xoj::undo::restoreElement(*entry.elementOwn, in);
+            }
+        }
+    }
+}
@@ -11,8 +11,9 @@
 
 #pragma once
 
-#include <set>     // for multiset
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <set>      // for multiset
+#include <string>   // for string
 
 #include "model/PageRef.h"  // for PageRef
 #include "model/Stroke.h"   // for Stroke
@@ -39,6 +40,10 @@ public:
 
     std::string getText() override;
 
+    size_t getMemoryUsage() const override;
+    void spill(ObjectOutputStream& out) override;
+    void restore(ObjectInputStream& in) override;
+
 private:
     std::multiset<PageLayerPosEntry<Stroke>> edited{};
     std::multiset<PageLayerPosEntry<Stroke>> original{};
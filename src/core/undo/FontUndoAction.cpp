@@ -53,6 +53,7 @@ auto FontUndoAction::undo(Control* control) -> bool {
     for (FontUndoActionEntry* e: this->data) {
         r = r.unite(Range(e->e->getBoundingBox()));
         e->e->setFont(e->oldFont);
+        this->page->updateElementBounds(e->e);
         r = r.unite(Range(e->e->getBoundingBox()));
     }
 
@@ -76,6 +77,7 @@ auto FontUndoAction::redo(Control* control) -> bool {
     for (FontUndoActionEntry* e: this->data) {
         r = r.unite(Range(e->e->getBoundingBox()));
         e->e->setFont(e->newFont);
+        this->page->updateElementBounds(e->e);
         r = r.unite(Range(e->e->getBoundingBox()));
     }
 
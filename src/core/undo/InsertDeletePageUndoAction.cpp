@@ -5,7 +5,9 @@
 #include "gui/XournalppCursor.h"    // for XournalppCursor
 #include "model/Document.h"         // for Document
 #include "model/PageRef.h"          // for PageRef
+#include "model/XojPage.h"          // for XojPage
 #include "undo/UndoAction.h"        // for UndoAction
+#include "undo/UndoMemory.h"        // for getMemoryUsage, spillPage
 #include "util/Util.h"              // for npos
 #include "util/i18n.h"              // for _
 
@@ -19,6 +21,7 @@ InsertDeletePageUndoAction::InsertDeletePageUndoAction(const PageRef& page, size
 InsertDeletePageUndoAction::~InsertDeletePageUndoAction() { this->page = nullptr; }
 
 auto InsertDeletePageUndoAction::undo(Control* control) -> bool {
+    this->undone = true;
     if (this->inserted) {
         return deletePage(control);
     }
@@ -28,6 +31,7 @@ auto InsertDeletePageUndoAction::undo(Control* control) -> bool {
 }
 
 auto InsertDeletePageUndoAction::redo(Control* control) -> bool {
+    this->undone = false;
     if (this->inserted) {
         return insertPage(control);
     }
@@ -86,3 +90,21 @@ auto InsertDeletePageUndoAction::getText() -> std::string {
 
     return _("Page deleted");
 }
+
+auto InsertDeletePageUndoAction::isPageDeleted() const -> bool { return this->inserted == this->undone; }
+
+auto InsertDeletePageUndoAction::getMemoryUsage() const -> size_t {
+    return UndoAction::getMemoryUsage() + (isPageDeleted() ? xoj::undo::getMemoryUsage(*this->page) : 0);
+}
+
+void InsertDeletePageUndoAction::spill(ObjectOutputStream& out) {
+    if (isPageDeleted()) {
+        xoj::undo::spillPage(*this->page, out);
+    }
+}
+
+void InsertDeletePageUndoAction::restore(ObjectInputStream& in) {
+    if (isPageDeleted()) {
+        xoj::undo::restorePage(*this->page, in);
+    }
+}
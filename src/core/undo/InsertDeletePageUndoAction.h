@@ -11,7 +11,8 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <string>   // for string
 
 #include "model/PageRef.h"  // for PageRef
 
@@ -31,9 +32,15 @@ public:
 
     std::string getText() override;
 
+    size_t getMemoryUsage() const override;
+    void spill(ObjectOutputStream& out) override;
+    void restore(ObjectInputStream& in) override;
+
 private:
     bool insertPage(Control* control);
     bool deletePage(Control* control);
+    /// @return Whether the page is held by the action only, i.e. it is not in the document
+    bool isPageDeleted() const;
 
 private:
     bool inserted;
@@ -31,11 +31,14 @@ MoveUndoAction::MoveUndoAction(Layer* sourceLayer, const PageRef& sourcePage, st
 MoveUndoAction::~MoveUndoAction() = default;
 
 void MoveUndoAction::move() {
+    // this->undone is updated afterwards: if it is set, we are redoing and the elements are in the target layer
+    Layer* layer = this->undone && this->targetLayer ? this->targetLayer : this->sourceLayer;
     if (this->undone) {
         for (Element* e: this->elements) { e->move(dx, dy); }
     } else {
         for (Element* e: this->elements) { e->move(-dx, -dy); }
     }
+    for (Element* e: this->elements) { layer->updateElementBounds(e); }
 }
 
 auto MoveUndoAction::undo(Control* control) -> bool {
@@ -46,6 +46,7 @@ void RotateUndoAction::applyRotation(double rotation, Document* doc) {
     for (Element* e: this->elements) {
         r = r.unite(Range(e->getBoundingBox()));
         e->rotate(this->x0, this->y0, rotation);
+        this->page->updateElementBounds(e);
         r = r.unite(Range(e->getBoundingBox()));
     }
 
@@ -50,6 +50,7 @@ void ScaleUndoAction::applyScale(double fx, double fy, bool restoreLineWidth, Do
     for (Element* e: this->elements) {
         r = r.unite(Range(e->getBoundingBox()));
         e->scale(this->x0, this->y0, fx, fy, this->rotation, restoreLineWidth);
+        this->page->updateElementBounds(e);
         r = r.unite(Range(e->getBoundingBox()));
     }
     doc->unlock();
@@ -79,6 +79,7 @@ auto SizeUndoAction::undo(Control* control) -> bool {
 
         e->s->setWidth(e->originalWidth);
         e->s->setPressure(e->originalPressure);
+        this->page->updateElementBounds(e->s);
 
         range = range.unite(Range(e->s->getBoundingBox()));
     }
@@ -104,6 +105,7 @@ auto SizeUndoAction::redo(Control* control) -> bool {
 
         e->s->setWidth(e->newWidth);
         e->s->setPressure(e->newPressure);
+        this->page->updateElementBounds(e->s);
 
         range = range.unite(Range(e->s->getBoundingBox()));
     }
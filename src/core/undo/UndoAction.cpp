@@ -11,3 +11,9 @@ auto UndoAction::getPages() -> std::vector<PageRef> {
 }
 
 auto UndoAction::getClassName() const -> std::string const& { return this->className; }
+
+auto UndoAction::getMemoryUsage() const -> size_t { return sizeof(*this) + this->className.capacity(); }
+
+void UndoAction::spill(ObjectOutputStream&) {}
+
+void UndoAction::restore(ObjectInputStream&) {}
@@ -11,13 +11,16 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "model/PageRef.h"  // for PageRef
 
 class Control;
+class ObjectInputStream;
+class ObjectOutputStream;
 
 class UndoAction {
 public:
@@ -37,6 +40,20 @@ public:
 
     auto getClassName() const -> std::string const&;
 
+    /**
+     * @return An estimate of the memory held by the action, in bytes (see UndoRedoHandler::setMemoryBudget())
+     */
+    virtual size_t getMemoryUsage() const;
+
+    /**
+     * Write the data held by the action to `out` and free it, to save memory while the action is not undone or redone.
+     * The action is not used until restore() is called.
+     */
+    virtual void spill(ObjectOutputStream& out);
+
+    /// Read back the data written by spill()
+    virtual void restore(ObjectInputStream& in);
+
 protected:
     // This is only for debugging / Testing purpose
     std::string className;
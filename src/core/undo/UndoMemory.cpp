@@ -0,0 +1,95 @@
+#include "UndoMemory.h"
+
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "model/Element.h"                        // for Element, ELEMENT_STROKE
+#include "model/Image.h"                          // for Image
+#include "model/Layer.h"                          // for Layer
+#include "model/Point.h"                          // for Point
+#include "model/Stroke.h"                         // for Stroke
+#include "model/StrokePoints.h"                   // for StrokePoints
+#include "model/TexImage.h"                       // for TexImage
+#include "model/Text.h"                           // for Text
+#include "model/XojPage.h"                        // for XojPage
+#include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
+#include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
+
+namespace xoj::undo {
+
+auto getMemoryUsage(const Element& e) -> size_t {
+    switch (e.getType()) {
+        case ELEMENT_STROKE:
+            return sizeof(Stroke) + static_cast<const Stroke&>(e).getPointVector().getMemoryUsage();
+        case ELEMENT_IMAGE:
+            return sizeof(Image) + static_cast<const Image&>(e).getRawDataLength();
+        case ELEMENT_TEXIMAGE: {
+            const auto& tex = static_cast<const TexImage&>(e);
+            return sizeof(TexImage) + tex.getBinaryData().capacity() + tex.getText().capacity();
+        }
+        case ELEMENT_TEXT:
+            return sizeof(Text) + static_cast<const Text&>(e).getText().capacity();
+        default:
+            return sizeof(Element);
+    }
+}
+
+auto getMemoryUsage(const XojPage& page) -> size_t {
+    if (!page.isContentLoaded()) {
+        return 0;
+    }
+    size_t usage = 0;
+    for (const Layer* l: page.getLayersView()) {
+        for (const Element* e: l->getElementsView()) {
+            usage += getMemoryUsage(*e);
+        }
+    }
+    return usage;
+}
+
+void spillElement(Element& e, ObjectOutputStream& out) {
+    out.writeObject("SpilledElement");
+    if (e.getType() == ELEMENT_STROKE) {
+        auto& stroke = static_cast<Stroke&>(e);
+        out.writeData(stroke.getPointVector().toVector());
+        // The bounds are computed again from the points when they are needed
+        stroke.setPointVector(StrokePoints{});
+    }
+    out.endObject();
+}
+
+void restoreElement(Element& e, ObjectInputStream& in) {
+    in.readObject("SpilledElement");
+    if (e.getType() == ELEMENT_STROKE) {
+        std::vector<Point> points;
+        in.readData(points);
+        static_cast<Stroke&>(e).setPointVector(std::move(points));
+    }
+    in.endObject();
+}
+
+void spillPage(XojPage& page, ObjectOutputStream& out) {
+    out.writeObject("SpilledPage");
+    out.writeInt(page.isContentLoaded() ? 1 : 0);
+    if (page.isContentLoaded()) {
+        for (Layer* l: page.getLayers()) {
+            for (auto& e: l->getElements()) {
+                spillElement(*e, out);
+            }
+        }
+    }
+    out.endObject();
+}
+
+void restorePage(XojPage& page, ObjectInputStream& in) {
+    in.readObject("SpilledPage");
+    if (in.readInt() != 0) {
+        for (Layer* l: page.getLayers()) {
+            for (auto& e: l->getElements()) {
+                restoreElement(*e, in);
+            }
+        }
+    }
+    in.endObject();
+}
+}  // namespace xoj::undo
@@ -0,0 +1,42 @@
+/*
+ * Xournal++
+ *
+ * Memory accounting and spilling of the data held by undo actions
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+
+class Element;
+class ObjectInputStream;
+class ObjectOutputStream;
+class XojPage;
+
+namespace xoj::undo {
+/// @return An estimate of the memory used by the element, in bytes
+size_t getMemoryUsage(const Element& e);
+
+/// @return An estimate of the memory used by the elements of the page, in bytes (0 if they are not loaded yet)
+size_t getMemoryUsage(const XojPage& page);
+
+/**
+ * Write the bulk data of the element (the points of strokes) to `out` and free it. The element keeps its identity,
+ * but must not be used until restoreElement() is called. Images are kept in memory: they cannot be empty.
+ */
+void spillElement(Element& e, ObjectOutputStream& out);
+
+/// Read back the data written by spillElement()
+void restoreElement(Element& e, ObjectInputStream& in);
+
+/// Spill all the elements of the page (if they are loaded), see spillElement()
+void spillPage(XojPage& page, ObjectOutputStream& out);
+
+/// Read back the data written by spillPage()
+void restorePage(XojPage& page, ObjectInputStream& in);
+}  // namespace xoj::undo
@@ -3,18 +3,25 @@
 #include <algorithm>  // for find_if
 #include <cinttypes>  // for PRIu64
 #include <cstdint>    // for uint64_t
-#include <iterator>   // for end, begin
+#include <cstdio>     // for FILE, tmpfile, fseek, fwrite
+#include <iterator>   // for end, begin, next, prev
+#include <map>        // for map
 #include <memory>     // for unique_ptr, allocator_traits<>::value_type
+#include <optional>   // for optional
 #include <utility>    // for move
 
 #include <glib.h>  // for g_message
 
-#include "control/Control.h"  // for Control
-#include "model/Document.h"   // for Document
-#include "undo/UndoAction.h"  // for UndoActionPtr, UndoAction
-#include "util/Assert.h"      // for xoj_assert
-#include "util/XojMsgBox.h"   // for XojMsgBox
-#include "util/i18n.h"        // for _, FS, _F
+#include "control/Control.h"                        // for Control
+#include "model/Document.h"                         // for Document
+#include "undo/UndoAction.h"                        // for UndoActionPtr, UndoAction
+#include "util/Assert.h"                            // for xoj_assert
+#include "util/XojMsgBox.h"                         // for XojMsgBox
+#include "util/i18n.h"                              // for _, FS, _F
+#include "util/serializing/BinObjectEncoding.h"     // for BinObjectEncoding
+#include "util/serializing/InputStreamException.h"  // for InputStreamException
+#include "util/serializing/ObjectInputStream.h"     // for ObjectInputStream
+#include "util/serializing/ObjectOutputStream.h"    // for ObjectOutputStream
 
 using std::string;
 
@@ -67,6 +74,93 @@ void UndoRedoHandler::printContents() {
     }
 }
 
+/// Actions holding less memory are not worth spilling
+constexpr size_t MIN_SPILL_SIZE = 16 * 1024;
+
+/**
+ * Temporary file holding the data of the actions. The space of the data read back is reused by the next writes, and
+ * the end of the file is cut off as soon as it is free. It is removed when it is closed.
+ */
+class UndoRedoHandler::SpillFile {
+public:
+    SpillFile(): fp(std::tmpfile()) {
+        if (!this->fp) {
+            g_warning("Could not create a temporary file for the undo history: it is kept in memory");
+        }
+    }
+    ~SpillFile() {
+        if (this->fp) {
+            std::fclose(this->fp);
+        }
+    }
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    bool isOpen() const { return this->fp != nullptr; }
+
+    /// @return The size of the file, without the free space at its end
+    size_t size() const { return this->end; }
+
+    /// @return The offset of the data in the file, or -1 on error
+    long write(const char* data, size_t length) {
+        // First fit in the free space, or at the end of the file
+        auto it = std::find_if(this->freeSpace.begin(), this->freeSpace.end(),
+                               [&](const auto& space) { return space.second >= length; });
+        const size_t offset = it != this->freeSpace.end() ? it->first : this->end;
+        if (!this->fp || std::fseek(this->fp, static_cast<long>(offset), SEEK_SET) != 0 ||
+            std::fwrite(data, 1, length, this->fp) != length) {
+            return -1;
+        }
+
+        if (it == this->freeSpace.end()) {
+            this->end += length;
+        } else if (const size_t left = it->second - length; left > 0) {
+            this->freeSpace.erase(it);
+            this->freeSpace.emplace(offset + length, left);
+        } else {
+            this->freeSpace.erase(it);
+        }
+        return static_cast<long>(offset);
+    }
+
+    std::optional<std::string> read(long offset, size_t length) {
+        std::string data(length, '\0');
+        if (!this->fp || std::fseek(this->fp, offset, SEEK_SET) != 0 ||
+            std::fread(data.data(), 1, length, this->fp) != length) {
+            return std::nullopt;
+        }
+        return data;
+    }
+
+    /// The data written at offset is not needed anymore: its space is reused
+    void release(long offset, size_t length) {
+        auto it = this->freeSpace.emplace(static_cast<size_t>(offset), length).first;
+        // Merge with the adjacent free space
+        if (auto next = std::next(it); next != this->freeSpace.end() && it->first + it->second == next->first) {
+            it->second += next->second;
+            this->freeSpace.erase(next);
+        }
+        if (it != this->freeSpace.begin()) {
+            if (auto prev = std::prev(it); prev->first + prev->second == it->first) {
+                prev->second += it->second;
+                this->freeSpace.erase(it);
+                it = prev;
+            }
+        }
+        if (it->first + it->second == this->end) {
+            this->end = it->first;
+            this->freeSpace.erase(it);
+        }
+    }
+
+private:
+    std::FILE* fp;
+    /// The size of the file holding data
+    size_t end = 0;
+    /// The free ranges before the end, by offset
+    std::map<size_t, size_t> freeSpace;
+};
+
 UndoRedoHandler::UndoRedoHandler(Control* control): control(control) {}
 
 UndoRedoHandler::~UndoRedoHandler() { clearContents(); }
@@ -83,6 +177,13 @@ void UndoRedoHandler::clearContents() {
 
     this->savedUndo = nullptr;
     this->autosavedUndo = nullptr;
+    this->savedUndoDropped = false;
+    this->autosavedUndoDropped = false;
+
+    this->accountedMemory.clear();
+    this->memoryUsage = 0;
+    this->spilled.clear();
+    this->spillFile.reset();
 
     printContents();
 }
@@ -93,6 +194,9 @@ void UndoRedoHandler::clearRedo() {
         g_message("clearRedo()::Delete UndoAction: %p / %s", undoAction.get(), undoAction->getClassName().c_str());
     }
 #endif
+    for (auto const& undoAction: this->redoList) {
+        unaccount(*undoAction);
+    }
     redoList.clear();
     printContents();
 }
@@ -104,11 +208,16 @@ void UndoRedoHandler::undo() {
 
     xoj_assert(this->undoList.back());
 
+    if (!restore(*this->undoList.back())) {
+        return;
+    }
+
     auto& undoAction = *this->undoList.back();
     this->redoList.emplace_back(std::move(this->undoList.back()));
     this->undoList.pop_back();
 
     bool undoResult = undoAction.undo(this->control);
+    account(undoAction);
 
     if (!undoResult) {
         string msg = FS(_F("Could not undo \"{1}\"\n"
@@ -135,6 +244,7 @@ void UndoRedoHandler::redo() {
     this->redoList.pop_back();
 
     bool redoResult = redoAction.redo(this->control);
+    account(redoAction);
 
     if (!redoResult) {
         string msg = FS(_F("Could not redo \"{1}\"\n"
@@ -160,8 +270,14 @@ void UndoRedoHandler::addUndoAction(UndoActionPtr action) {
         return;
     }
 
+    if (!this->undoList.empty()) {
+        // The previous action may have been completed after it was added (e.g. by the EraseHandler)
+        account(*this->undoList.back());
+    }
     this->undoList.emplace_back(std::move(action));
     clearRedo();
+    account(*this->undoList.back());
+    enforceMemoryBudget();
     fireUpdateUndoRedoButtons(this->undoList.back()->getPages());
 
     printContents();
@@ -206,6 +322,9 @@ void UndoRedoHandler::fireUpdateUndoRedoButtons(const std::vector<PageRef>& page
 void UndoRedoHandler::addUndoRedoListener(UndoRedoListener* listener) { this->listener.emplace_back(listener); }
 
 auto UndoRedoHandler::isChanged() -> bool {
+    if (this->savedUndoDropped) {
+        return true;
+    }
     if (this->undoList.empty()) {
         return this->savedUndo;
     }
@@ -214,6 +333,9 @@ auto UndoRedoHandler::isChanged() -> bool {
 }
 
 auto UndoRedoHandler::isChangedAutosave() -> bool {
+    if (this->autosavedUndoDropped) {
+        return true;
+    }
     if (this->undoList.empty()) {
         return this->autosavedUndo;
     }
@@ -221,9 +343,135 @@ auto UndoRedoHandler::isChangedAutosave() -> bool {
 }
 
 void UndoRedoHandler::documentAutosaved() {
+    this->autosavedUndoDropped = false;
     this->autosavedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
 }
 
 void UndoRedoHandler::documentSaved() {
+    this->savedUndoDropped = false;
     this->savedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
 }
+
+void UndoRedoHandler::setMemoryBudget(size_t budget, bool spillToDisk) {
+    this->memoryBudget = budget;
+    this->spillToDisk = spillToDisk;
+    enforceMemoryBudget();
+}
+
+auto UndoRedoHandler::getMemoryUsage() const -> size_t { return this->memoryUsage; }
+
+void UndoRedoHandler::account(const UndoAction& action) {
+    size_t& accounted = this->accountedMemory[&action];
+    this->memoryUsage -= accounted;
+    accounted = this->spilled.count(&action) ? 0 : action.getMemoryUsage();
+    this->memoryUsage += accounted;
+}
+
+void UndoRedoHandler::unaccount(const UndoAction& action) {
+    if (auto it = this->accountedMemory.find(&action); it != this->accountedMemory.end()) {
+        this->memoryUsage -= it->second;
+        this->accountedMemory.erase(it);
+    }
+    releaseSpilled(action);
+}
+
+void UndoRedoHandler::releaseSpilled(const UndoAction& action) {
+    auto it = this->spilled.find(&action);
+    if (it == this->spilled.end()) {
+        return;
+    }
+    this->spillFile->release(it->second.offset, it->second.length);
+    this->spilled.erase(it);
+    if (this->spilled.empty()) {
+        // Start over with an empty file
+        this->spillFile.reset();
+    }
+}
+
+auto UndoRedoHandler::getSpillFileSize() const -> size_t { return this->spillFile ? this->spillFile->size() : 0; }
+
+void UndoRedoHandler::enforceMemoryBudget() {
+    if (this->memoryBudget == 0) {
+        return;
+    }
+
+    // The last action is never spilled nor dropped: the tool that created it may still be completing it
+    if (this->spillToDisk) {
+        for (auto it = this->undoList.begin();
+             this->memoryUsage > this->memoryBudget && std::next(it) != this->undoList.end(); ++it) {
+            if (this->accountedMemory[it->get()] >= MIN_SPILL_SIZE && !spill(**it)) {
+                break;
+            }
+        }
+        return;
+    }
+
+    while (this->memoryUsage > this->memoryBudget && this->undoList.size() > 1) {
+        // The saved state is lost with the oldest action, or with the empty history (no saved action)
+        const UndoAction* oldest = this->undoList.front().get();
+        this->savedUndoDropped |= !this->savedUndo || oldest == this->savedUndo;
+        this->autosavedUndoDropped |= !this->autosavedUndo || oldest == this->autosavedUndo;
+        unaccount(*oldest);
+        this->undoList.pop_front();
+    }
+}
+
+auto UndoRedoHandler::spill(UndoAction& action) -> bool {
+    if (!this->spillFile) {
+        this->spillFile = std::make_unique<SpillFile>();
+    }
+    if (!this->spillFile->isOpen()) {
+        return false;
+    }
+
+    ObjectOutputStream out(new BinObjectEncoding());
+    action.spill(out);
+    GString* data = out.stealData();
+    const long offset = this->spillFile->write(data->str, data->len);
+    if (offset < 0) {
+        g_warning("Could not write the undo history to the temporary file");
+        // Give the data back to the action
+        ObjectInputStream in;
+        in.read(data->str, data->len);
+        action.restore(in);
+        g_string_free(data, true);
+        return false;
+    }
+    this->spilled[&action] = {offset, data->len};
+    g_string_free(data, true);
+    account(action);
+    return true;
+}
+
+auto UndoRedoHandler::restore(UndoAction& action) -> bool {
+    auto it = this->spilled.find(&action);
+    if (it == this->spilled.end()) {
+        return true;
+    }
+    auto data = this->spillFile->read(it->second.offset, it->second.length);
+    releaseSpilled(action);
+    ObjectInputStream in;
+    bool restored = data && in.read(data->data(), data->size());
+    if (restored) {
+        try {
+            action.restore(in);
+        } catch (const InputStreamException& e) {
+            g_warning("Could not read the undo history back: %s", e.what());
+            restored = false;
+        }
+    }
+    if (!restored) {
+        const bool changed = isChanged();
+        const bool changedAutosave = isChangedAutosave();
+        clearContents();
+        this->savedUndoDropped = changed;
+        this->autosavedUndoDropped = changedAutosave;
+        fireUpdateUndoRedoButtons({});
+        XojMsgBox::showErrorToUser(control->getGtkWindow(),
+                                   _("The undo history could not be read back from the temporary file, and was "
+                                     "cleared."));
+        return false;
+    }
+    account(action);
+    return true;
+}
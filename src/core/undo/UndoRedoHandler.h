@@ -11,9 +11,12 @@
 
 #pragma once
 
-#include <deque>   // for deque
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>        // for size_t
+#include <deque>          // for deque
+#include <memory>         // for unique_ptr
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
 
 #include "model/PageRef.h"  // for PageRef
 
@@ -55,16 +58,59 @@ public:
     void documentAutosaved();
     void documentSaved();
 
+    /**
+     * Limit the memory held by the undo history. The last action is always kept in memory.
+     * @param budget The budget in bytes, 0 for no limit
+     * @param spillToDisk If true, the data of the oldest actions is written to a temporary file, and read back before
+     *                    they are undone. Otherwise, the oldest actions are dropped.
+     */
+    void setMemoryBudget(size_t budget, bool spillToDisk);
+
+    /// @return The estimated memory held by the actions, without the spilled data, in bytes
+    size_t getMemoryUsage() const;
+
+    /// @return The size of the temporary file holding the spilled data, in bytes
+    size_t getSpillFileSize() const;
+
 private:
     void clearRedo();
     void printContents();
 
+    /// Update the memory accounted for the action, after it was added, undone or redone
+    void account(const UndoAction& action);
+    void unaccount(const UndoAction& action);
+
+    /// Spill or drop the oldest actions until the memory usage is within the budget
+    void enforceMemoryBudget();
+    bool spill(UndoAction& action);
+    /// Read back the data of the action if it was spilled. @return false if it could not be read
+    bool restore(UndoAction& action);
+    /// Free the space of the spilled data of the action in the temporary file, if any
+    void releaseSpilled(const UndoAction& action);
+
 private:
     std::deque<UndoActionPtr> undoList;
     std::deque<UndoActionPtr> redoList;
 
     UndoAction* savedUndo = nullptr;
     UndoAction* autosavedUndo = nullptr;
+    /// The saved (or autosaved) state was dropped from the undo list because of the memory budget
+    bool savedUndoDropped = false;
+    bool autosavedUndoDropped = false;
+
+    size_t memoryBudget = 0;
+    bool spillToDisk = false;
+    size_t memoryUsage = 0;
+    std::unordered_map<const UndoAction*, size_t> accountedMemory;
+
+    /// Temporary file holding the data of the spilled actions
+    class SpillFile;
+    std::unique_ptr<SpillFile> spillFile;
+    struct SpilledData {
+        long offset;
+        size_t length;
+    };
+    std::unordered_map<const UndoAction*, SpilledData> spilled;
 
     std::vector<UndoRedoListener*> listener;
 
@@ -2,19 +2,30 @@
 
 #include <memory>  // for unique_ptr
 
+#include <cairo.h>  // for cairo_clip_extents
+
+#include "model/Element.h"           // for Element
 #include "model/ElementContainer.h"  // for ElementContainer
 
 #include "View.h"  // for ElementView
 
-class Element;
-
 using namespace xoj::view;
 
 ElementContainerView::ElementContainerView(const ElementContainer* container): container(container) {}
 
 void ElementContainerView::draw(const Context& ctx) const {
-    container->forEachElement([&ctx](const Element* e) {
-        auto elementView = ElementView::createFromElement(e);
-        elementView->draw(ctx);
+    // Get the bounds of the clip region, in the container's coordinates
+    double minX;
+    double maxX;
+    double minY;
+    double maxY;
+    cairo_clip_extents(ctx.cr, &minX, &minY, &maxX, &maxY);
+
+    container->forEachElement([&](const Element* e) {
+        // Skip the elements that cannot be seen: do not even create their view
+        if (e->intersectsArea(minX, minY, maxX - minX, maxY - minY)) {
+            auto elementView = ElementView::createFromElement(e);
+            elementView->draw(ctx);
+        }
     });
 }
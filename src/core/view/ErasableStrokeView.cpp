@@ -10,6 +10,7 @@
 #include "model/PathParameter.h"          // for PathParameter
 #include "model/Point.h"                  // for Point
 #include "model/Stroke.h"                 // for Stroke, StrokeTool::HIGHLIG...
+#include "model/StrokePoints.h"           // for StrokePoints
 #include "model/eraser/ErasableStroke.h"  // for ErasableStroke, ErasableStr...
 #include "util/Assert.h"                  // for xoj_assert
 #include "util/Color.h"                   // for cairo_set_source_rgbi
@@ -37,7 +38,7 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
 
     const auto& dashes = stroke.getLineStyle().getDashes();
 
-    const std::vector<Point>& data = stroke.getPointVector();
+    const StrokePoints& data = stroke.getPointVector();
 
     xoj::util::CairoSaveGuard guard(cr);
 
@@ -48,14 +49,14 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
             cairo_set_line_width(cr, p.z);
             cairo_move_to(cr, p.x, p.y);
 
-            const Point* lastPoint = &p;
+            Point lastPoint = p;
 
             auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)interval.max.index + 1);
             for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)interval.min.index + 1); it != endIt; ++it) {
                 if (!dashes.empty()) {
                     Util::cairo_set_dash_from_vector(cr, dashes, dashOffset);
-                    dashOffset += lastPoint->lineLengthTo(*it);
-                    lastPoint = &(*it);
+                    dashOffset += lastPoint.lineLengthTo(*it);
+                    lastPoint = *it;
                 }
                 cairo_line_to(cr, it->x, it->y);
                 cairo_stroke(cr);
@@ -147,7 +148,7 @@ void ErasableStrokeView::drawFilling(cairo_t* cr) const {
     }
 
     const Stroke& stroke = this->erasableStroke.stroke;
-    const std::vector<Point>& data = stroke.getPointVector();
+    const StrokePoints& data = stroke.getPointVector();
 
     bool mergeFirstAndLast = this->erasableStroke.isClosedStroke() && sections.size() >= 2 &&
                              sections.front().min == PathParameter(0, 0.0) &&
@@ -222,7 +223,7 @@ void ErasableStrokeView::paintFilledHighlighter(cairo_t* cr) const {
     cairo_set_operator(cr, CAIRO_OPERATOR_MULTIPLY);
     Util::cairo_set_source_rgbi(cr, stroke.getColor(), static_cast<double>(stroke.getFill()) / 255.0);
 
-    const std::vector<Point>& data = stroke.getPointVector();
+    const StrokePoints& data = stroke.getPointVector();
 
     bool mergeFirstAndLast = erasableStroke.isClosedStroke() && sections.size() >= 2 &&
                              sections.front().min == PathParameter(0, 0.0) &&
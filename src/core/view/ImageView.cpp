@@ -1,10 +1,13 @@
 #include "ImageView.h"
 
+#include <cmath>  // for abs, sqrt
+
 #include <cairo.h>  // for cairo_image_surface_get_height, cairo_image...
 
-#include "model/Image.h"  // for Image
-#include "util/Point.h"   // for Point
-#include "view/View.h"    // for Context, OPACITY_NO_AUDIO, view
+#include "model/Image.h"              // for Image
+#include "util/Point.h"               // for Point
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+#include "view/View.h"                // for Context, OPACITY_NO_AUDIO, view
 
 using namespace xoj::view;
 
@@ -12,30 +15,60 @@ ImageView::ImageView(const Image* image): image(image) {}
 
 ImageView::~ImageView() = default;
 
+/// Vector surfaces (PDF export, printing) get the image at full resolution
+static bool isVectorSurface(cairo_surface_t* surface) {
+    switch (cairo_surface_get_type(surface)) {
+        case CAIRO_SURFACE_TYPE_PDF:
+        case CAIRO_SURFACE_TYPE_PS:
+        case CAIRO_SURFACE_TYPE_SVG:
+        case CAIRO_SURFACE_TYPE_RECORDING:
+        case CAIRO_SURFACE_TYPE_SCRIPT:
+            return true;
+        default:
+            return false;
+    }
+}
+
 void ImageView::draw(const Context& ctx) const {
     cairo_t* cr = ctx.cr;
 
-    cairo_save(cr);
+    const auto& box = image->getBoundingBox();
 
-    cairo_surface_t* img = image->getImage();
+    // The size of the image on the target, in pixels
+    double width = 0;
+    double height = 0;
+    cairo_surface_t* target = cairo_get_target(cr);
+    if (!isVectorSurface(target)) {
+        cairo_matrix_t m;
+        cairo_get_matrix(cr, &m);
+        double xScale = 1;
+        double yScale = 1;
+        cairo_surface_get_device_scale(target, &xScale, &yScale);
+        const double zoom = std::sqrt(std::abs(m.xx * m.yy - m.xy * m.yx));
+        width = box.width * zoom * xScale;
+        height = box.height * zoom * yScale;
+    }
+
+    xoj::util::CairoSurfaceSPtr img = image->getImage(width, height);
     if (!img) {
         g_warning("Image could not be rendered");
         return;
     }
 
-    int width = cairo_image_surface_get_width(img);
-    int height = cairo_image_surface_get_height(img);
+    cairo_save(cr);
+
+    int imgWidth = cairo_image_surface_get_width(img.get());
+    int imgHeight = cairo_image_surface_get_height(img.get());
 
     cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
 
-    const auto& box = image->getBoundingBox();
-    double xFactor = box.width / width;
-    double yFactor = box.height / height;
+    double xFactor = box.width / imgWidth;
+    double yFactor = box.height / imgHeight;
 
     cairo_scale(cr, xFactor, yFactor);
 
     auto [x, y] = image->getOrigin();
-    cairo_set_source_surface(cr, img, x / xFactor, y / yFactor);
+    cairo_set_source_surface(cr, img.get(), x / xFactor, y / yFactor);
     // make images translucent when highlighting elements with audio, as they can not have audio
     if (ctx.fadeOutNonAudio) {
         cairo_paint_with_alpha(cr, OPACITY_NO_AUDIO);
@@ -7,6 +7,7 @@
 
 #include "model/Element.h"  // for Element
 #include "model/Layer.h"    // for Layer
+#include "util/Range.h"     // for Range
 
 #include "DebugShowRepaintBounds.h"  // for IF_DEBUG_REPAINT
 #include "View.h"                    // for Context, ElementView
@@ -18,7 +19,7 @@ LayerView::LayerView(const Layer* layer): layer(layer) {}
 const Layer* LayerView::getLayer() const { return layer; }
 
 void LayerView::draw(const Context& ctx) const {
-    IF_DEBUG_REPAINT(int drawn = 0; int notDrawn = 0;);
+    IF_DEBUG_REPAINT(int drawn = 0;);
 
     // Get the bounds of the mask, in page coordinates
     double minX;
@@ -27,14 +28,16 @@ void LayerView::draw(const Context& ctx) const {
     double maxY;
     cairo_clip_extents(ctx.cr, &minX, &minY, &maxX, &maxY);
 
-    for (auto const& e: layer->getElementsView()) {
-
+    // Only go through the elements that can be visible in the clip region: rerendering a small area of a dense page
+    // does not depend on the total number of elements.
+    layer->forEachElementIntersecting(Range(minX, minY, maxX, maxY), [&](const Element* e, Element::Index) {
         IF_DEBUG_REPAINT({
             auto cr = ctx.cr;
+            const auto& box = e->getBoundingBox();
             cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
             cairo_set_source_rgb(cr, 0, 1, 0);
             cairo_set_line_width(cr, 1);
-            cairo_rectangle(cr, e->getX(), e->getY(), e->getElementWidth(), e->getElementHeight());
+            cairo_rectangle(cr, box.x, box.y, box.width, box.height);
             cairo_stroke(cr);
         });
 
@@ -42,7 +45,7 @@ void LayerView::draw(const Context& ctx) const {
             ElementView::createFromElement(e)->draw(ctx);
             IF_DEBUG_REPAINT(drawn++;);
         }
-        IF_DEBUG_REPAINT(else { notDrawn++; });
-    }
-    IF_DEBUG_REPAINT(g_message("DBG:LayerView::draw: draw %i / not draw %i", drawn, notDrawn););
+    });
+    IF_DEBUG_REPAINT(g_message("DBG:LayerView::draw: draw %i / not draw %zu", drawn,
+                               layer->getElementsView().size() - static_cast<size_t>(drawn)););
 }
@@ -6,7 +6,7 @@
 
 #include "util/Assert.h"
 #include "util/Range.h"
-#include "util/safe_casts.h"  // for ceil_cast, floor_cast
+#include "util/safe_casts.h"  // for ceil_cast, floor_cast, as_unsigned
 
 #include "config-debug.h"
 
@@ -84,6 +84,18 @@ void Mask::constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom
         std::cout << "  Its DPI scaling: " << x << " x " << y << std::endl;
     });
 
+    if (cairo_surface_get_type(surf) == CAIRO_SURFACE_TYPE_IMAGE) {
+        this->memoryUsage = as_unsigned(cairo_image_surface_get_stride(surf)) *
+                            as_unsigned(cairo_image_surface_get_height(surf));
+    } else {
+        // The pixel data may live elsewhere (e.g. in the X server): estimate it
+        double scaleX = 1.0;
+        double scaleY = 1.0;
+        cairo_surface_get_device_scale(surf, &scaleX, &scaleY);
+        const size_t bytesPerPixel = contentType == CAIRO_CONTENT_ALPHA ? 1 : 4;
+        this->memoryUsage = static_cast<size_t>(width * scaleX) * static_cast<size_t>(height * scaleY) * bytesPerPixel;
+    }
+
     this->cr.reset(cairo_create(surf), xoj::util::adopt);
     cairo_surface_destroy(surf);  // surf is now owned by this->cr
 
@@ -145,7 +157,12 @@ void Mask::wipeRange(const Range& rg) {
     wipe();
 }
 
-void Mask::reset() { cr.reset(); }
+void Mask::reset() {
+    cr.reset();
+    memoryUsage = 0;
+}
+
+auto Mask::getMemoryUsage() const -> size_t { return isInitialized() ? memoryUsage : 0; }
 
 #ifdef DEBUG_MASKS
 namespace {
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <cairo.h>
 #include <gdk/gdk.h>
 
@@ -79,6 +81,11 @@ public:
 
     inline double getZoom() const { return zoom; }
 
+    /**
+     * @return The (estimated) size in bytes of the pixel data of the surface, or 0 if the mask is not initialized
+     */
+    size_t getMemoryUsage() const;
+
 private:
     template <typename DPIInfoType>
     void constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom, cairo_content_t contentType);
@@ -87,5 +94,6 @@ private:
     int xOffset = 0;
     int yOffset = 0;
     double zoom = 1.0;
+    size_t memoryUsage = 0;
 };
 };  // namespace xoj::view
@@ -3,9 +3,9 @@
 #include "model/LineStyle.h"
 #include "model/Point.h"
 #include "model/StrokeContour.h"
+#include "model/StrokePoints.h"
 #include "util/Assert.h"
 #include "util/LoopUtil.h"
-#include "util/PairView.h"
 #include "util/Util.h"  // for cairo_set_dash_from_vector
 
 void xoj::view::StrokeViewHelper::pathToCairo(cairo_t* cr, const std::vector<Point>& pts) {
@@ -14,25 +14,47 @@ void xoj::view::StrokeViewHelper::pathToCairo(cairo_t* cr, const std::vector<Poi
             [cr](auto const& other) { cairo_line_to(cr, other.x, other.y); });
 }
 
-/**
- * No pressure sensitivity, one line is drawn
- */
-void xoj::view::StrokeViewHelper::drawNoPressure(cairo_t* cr, const std::vector<Point>& pts, const double strokeWidth,
-                                                 const LineStyle& lineStyle, double dashOffset) {
+void xoj::view::StrokeViewHelper::pathToCairo(cairo_t* cr, const StrokePoints& pts) {
+    if (pts.empty()) {
+        return;
+    }
+    // Only read the coordinate arrays
+    const double* xs = pts.xData();
+    const double* ys = pts.yData();
+    cairo_move_to(cr, xs[0], ys[0]);
+    for (size_t i = 1; i < pts.size(); i++) {
+        cairo_line_to(cr, xs[i], ys[i]);
+    }
+}
+
+template <class PointContainer>
+static void drawNoPressureImpl(cairo_t* cr, const PointContainer& pts, const double strokeWidth,
+                               const LineStyle& lineStyle, double dashOffset) {
     cairo_set_line_width(cr, strokeWidth);
 
     const auto& dashes = lineStyle.getDashes();
     Util::cairo_set_dash_from_vector(cr, dashes, dashOffset);
 
-    pathToCairo(cr, pts);
+    xoj::view::StrokeViewHelper::pathToCairo(cr, pts);
     cairo_stroke(cr);
 }
 
 /**
- * Draw a stroke with pressure, for this multiple lines with different widths needs to be drawn
+ * No pressure sensitivity, one line is drawn
  */
-double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const std::vector<Point>& pts,
-                                                     const LineStyle& lineStyle, double dashOffset) {
+void xoj::view::StrokeViewHelper::drawNoPressure(cairo_t* cr, const std::vector<Point>& pts, const double strokeWidth,
+                                                 const LineStyle& lineStyle, double dashOffset) {
+    drawNoPressureImpl(cr, pts, strokeWidth, lineStyle, dashOffset);
+}
+
+void xoj::view::StrokeViewHelper::drawNoPressure(cairo_t* cr, const StrokePoints& pts, const double strokeWidth,
+                                                 const LineStyle& lineStyle, double dashOffset) {
+    drawNoPressureImpl(cr, pts, strokeWidth, lineStyle, dashOffset);
+}
+
+template <class PointContainer>
+static double drawWithPressureImpl(cairo_t* cr, const PointContainer& pts, const LineStyle& lineStyle,
+                                   double dashOffset) {
     const auto& dashes = lineStyle.getDashes();
     if (cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_PDF) {
         // PDF documents have an equivalent of cairo_stroke(). We use it to get smaller PDF files
@@ -47,27 +69,42 @@ double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const std::vec
             /*
              * Because the width varies, we need to call cairo_stroke() once per segment
              */
-            for (const auto& [p, q]: PairView(pts)) {
+            for (size_t i = 1; i < pts.size(); i++) {
+                const Point p = pts[i - 1];
+                const Point q = pts[i];
                 Util::cairo_set_dash_from_vector(cr, dashes, dashOffset);
                 dashOffset += p.lineLengthTo(q);
                 drawSegment(p, q);
             }
         } else {
             cairo_set_dash(cr, nullptr, 0, 0.0);
-            for (const auto& [p, q]: PairView(pts)) {
-                drawSegment(p, q);
-            };
+            for (size_t i = 1; i < pts.size(); i++) {
+                drawSegment(pts[i - 1], pts[i]);
+            }
         }
     } else {
         if (pts.size() == 2 && pts.front().equalsPos(pts.back())) {
             // Single dot
             cairo_arc(cr, pts.front().x, pts.front().y, .5 * pts.front().z, 0, 2. * M_PI);
         } else if (!dashes.empty()) {
-            dashOffset = StrokeContourDashes(pts, dashes).addToCairo(cr, dashOffset);
+            dashOffset = xoj::view::StrokeContourDashes(pts, dashes).addToCairo(cr, dashOffset);
         } else {
-            StrokeContour(pts).addToCairo(cr);
+            xoj::view::StrokeContour(pts).addToCairo(cr);
         }
         cairo_fill(cr);
     }
     return dashOffset;
 }
+
+/**
+ * Draw a stroke with pressure, for this multiple lines with different widths needs to be drawn
+ */
+double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const std::vector<Point>& pts,
+                                                     const LineStyle& lineStyle, double dashOffset) {
+    return drawWithPressureImpl(cr, pts, lineStyle, dashOffset);
+}
+
+double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const StrokePoints& pts, const LineStyle& lineStyle,
+                                                     double dashOffset) {
+    return drawWithPressureImpl(cr, pts, lineStyle, dashOffset);
+}
@@ -17,6 +17,7 @@
 
 class LineStyle;
 class Point;
+class StrokePoints;
 
 namespace xoj::view::StrokeViewHelper {
 
@@ -24,12 +25,15 @@ namespace xoj::view::StrokeViewHelper {
  * @brief Simply adds the points to a cairo context, as a single path
  */
 void pathToCairo(cairo_t* cr, const std::vector<Point>& pts);
+void pathToCairo(cairo_t* cr, const StrokePoints& pts);
 
 /**
  * @brief No pressure sensitivity, one line is drawn, with given width and line style (dashes)
  */
 void drawNoPressure(cairo_t* cr, const std::vector<Point>& pts, const double strokeWidth, const LineStyle& lineStyle,
                     double dashOffset = 0);
+void drawNoPressure(cairo_t* cr, const StrokePoints& pts, const double strokeWidth, const LineStyle& lineStyle,
+                    double dashOffset = 0);
 
 /**
  * @brief Draw a stroke with pressure, for this multiple lines with different widths needs to be drawn.
@@ -37,4 +41,5 @@ void drawNoPressure(cairo_t* cr, const std::vector<Point>& pts, const double str
  *      Effectively, the return value equals dashOffset + length of the path.
  */
 double drawWithPressure(cairo_t* cr, const std::vector<Point>& pts, const LineStyle& lineStyle, double dashOffset = 0);
+double drawWithPressure(cairo_t* cr, const StrokePoints& pts, const LineStyle& lineStyle, double dashOffset = 0);
 };  // namespace xoj::view::StrokeViewHelper
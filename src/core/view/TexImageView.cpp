@@ -1,5 +1,6 @@
 #include "TexImageView.h"
 
+#include <mutex>   // for mutex, lock_guard
 #include <string>  // for string
 
 #include <cairo.h>    // for cairo_paint_with_alpha, cairo_scale
@@ -12,6 +13,10 @@
 
 using namespace xoj::view;
 
+/// Poppler documents must not be rendered from several threads at once, and the same TexImage may be drawn
+/// concurrently by several render workers (e.g. for the page and for its sidebar preview).
+static std::mutex popplerRenderMutex;
+
 TexImageView::TexImageView(const TexImage* texImage): texImage(texImage) {}
 
 TexImageView::~TexImageView() = default;
@@ -32,6 +37,7 @@ void TexImageView::draw(const Context& ctx) const {
             return;
         }
 
+        std::lock_guard lock(popplerRenderMutex);
         PopplerPage* page = poppler_document_get_page(pdf, 0);
 
         double pageWidth = 0;
@@ -3,12 +3,12 @@
 #include <algorithm>  // for max
 #include <cstddef>    // for size_t
 
-#include "model/Text.h"           // for Text
-#include "util/Color.h"           // for cairo_set_source_rgbi
-#include "util/StringUtils.h"     // for StringUtils
+#include "model/Text.h"        // for Text
+#include "util/Color.h"        // for cairo_set_source_rgbi
+#include "util/StringUtils.h"  // for StringUtils
 #include "util/raii/CairoWrappers.h"
 #include "util/raii/GObjectSPtr.h"
-#include "view/View.h"            // for Context, OPACITY_NO_AUDIO, view
+#include "view/View.h"         // for Context, OPACITY_NO_AUDIO, view
 
 #include "filesystem.h"  // for path
 
@@ -19,10 +19,14 @@ TextView::TextView(const Text* text): text(text) {}
 TextView::~TextView() = default;
 
 auto TextView::initPango(cairo_t* cr, const Text* t) -> xoj::util::GObjectSPtr<PangoLayout> {
-    auto layout = t->createPangoLayout();
-    pango_cairo_update_layout(cr, layout.get());
-    pango_context_set_matrix(pango_layout_get_context(layout.get()), nullptr);
-
+    /*
+     * The layout is cached per font options of the target. pango_cairo_update_layout() would set the transformation
+     * of cr too, which changes on every draw and would make the layout shape its text again.
+     */
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_surface_get_font_options(cairo_get_target(cr), options);
+    auto layout = t->getPangoLayout(options);
+    cairo_font_options_destroy(options);
     return layout;
 }
 
@@ -47,8 +51,5 @@ void TextView::draw(const Context& ctx) const {
     cairo_translate(ctx.cr, origin.x, origin.y);
 
     auto layout = initPango(ctx.cr, text);
-    const std::string& content = text->getText();
-    pango_layout_set_text(layout.get(), content.c_str(), static_cast<int>(content.length()));
-
     pango_cairo_show_layout(ctx.cr, layout.get());
 }
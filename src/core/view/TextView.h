@@ -33,7 +33,7 @@ public:
     void draw(const Context& ctx) const override;
 
     /**
-     * Initialize a Pango layout
+     * The cached layout of the text, ready for drawing on cr
      */
     static xoj::util::GObjectSPtr<PangoLayout> initPango(cairo_t* cr, const Text* t);
 
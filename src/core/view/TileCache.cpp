@@ -0,0 +1,153 @@
+#include "TileCache.h"
+
+#include <algorithm>  // for max, remove_if
+#include <cmath>      // for floor, ceil
+#include <iterator>   // for next
+#include <utility>    // for move
+
+using namespace xoj::view;
+
+static bool overlaps(const Range& a, const Range& b) {
+    return a.minX < b.maxX && b.minX < a.maxX && a.minY < b.maxY && b.minY < a.maxY;
+}
+
+auto TileCache::key(TileCoord c) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(c.x)) << 32) | static_cast<uint32_t>(c.y);
+}
+
+auto TileCache::getTileExtent(TileCoord c, double zoom) -> Range {
+    const double side = TILE_SIZE / zoom;
+    return Range(c.x * side, c.y * side, (c.x + 1) * side, (c.y + 1) * side);
+}
+
+auto TileCache::getTilesCovering(const Range& rg, double zoom) -> std::vector<TileCoord> {
+    std::vector<TileCoord> res;
+    if (!rg.isValid()) {
+        return res;
+    }
+    const double scale = zoom / TILE_SIZE;
+    const auto minX = static_cast<int32_t>(std::floor(rg.minX * scale));
+    const auto minY = static_cast<int32_t>(std::floor(rg.minY * scale));
+    // A range ending exactly on a tile boundary does not need the next tile
+    const auto maxX = std::max(minX, static_cast<int32_t>(std::ceil(rg.maxX * scale)) - 1);
+    const auto maxY = std::max(minY, static_cast<int32_t>(std::ceil(rg.maxY * scale)) - 1);
+
+    res.reserve(static_cast<size_t>(maxX - minX + 1) * static_cast<size_t>(maxY - minY + 1));
+    for (int32_t y = minY; y <= maxY; y++) {
+        for (int32_t x = minX; x <= maxX; x++) {
+            res.push_back({x, y});
+        }
+    }
+    return res;
+}
+
+void TileCache::setZoom(double zoom) {
+    if (zoom == this->zoom) {
+        return;
+    }
+    if (!tiles.empty()) {
+        // Otherwise keep the former placeholders: they are better than nothing
+        placeholders = std::move(tiles);
+        tiles.clear();
+    }
+    this->zoom = zoom;
+}
+
+auto TileCache::getZoom() const -> double { return zoom; }
+
+auto TileCache::getMissingTiles(const Range& rg, bool includeOutdated) const -> std::vector<TileCoord> {
+    auto res = getTilesCovering(rg, zoom);
+    res.erase(std::remove_if(res.begin(), res.end(),
+                             [&](TileCoord c) {
+                                 auto it = tiles.find(key(c));
+                                 return it != tiles.end() &&
+                                        (!includeOutdated || (!it->second.outdated && !it->second.draft));
+                             }),
+              res.end());
+    return res;
+}
+
+auto TileCache::paintTo(cairo_t* cr, const Range& rg) const -> State {
+    std::vector<const Tile*> covering;
+    bool complete = true;
+    bool upToDate = true;
+    for (TileCoord c: getTilesCovering(rg, zoom)) {
+        if (auto it = tiles.find(key(c)); it != tiles.end()) {
+            covering.push_back(&it->second);
+            upToDate = upToDate && !it->second.outdated && !it->second.draft;
+        } else {
+            complete = false;
+        }
+    }
+
+    if (!complete) {
+        for (auto&& [k, tile]: placeholders) {
+            if (overlaps(tile.extent, rg)) {
+                tile.mask.paintTo(cr);
+            }
+        }
+    }
+    for (const Tile* tile: covering) {
+        tile->mask.paintTo(cr);
+    }
+    return !complete ? State::INCOMPLETE : upToDate ? State::UP_TO_DATE : State::OUTDATED;
+}
+
+void TileCache::setTile(TileCoord c, double zoom, Mask tile, bool draft) {
+    if (zoom != this->zoom) {
+        return;
+    }
+    if (draft && tiles.find(key(c)) != tiles.end()) {
+        return;
+    }
+    tiles[key(c)] = Tile{std::move(tile), getTileExtent(c, zoom), false, draft};
+}
+
+void TileCache::forEachTileIntersecting(const Range& rg, const std::function<void(cairo_t*)>& fn) {
+    for (auto* map: {&placeholders, &tiles}) {
+        for (auto&& [k, tile]: *map) {
+            if (overlaps(tile.extent, rg)) {
+                fn(tile.mask.get());
+            }
+        }
+    }
+}
+
+void TileCache::invalidateAll() {
+    for (auto&& [k, tile]: tiles) {
+        tile.outdated = true;
+    }
+}
+
+void TileCache::prune(const Range& rg) {
+    if (!rg.isValid()) {
+        return;
+    }
+    Range kept = rg;
+    kept.addPadding(TILE_SIZE / zoom);
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        it = overlaps(it->second.extent, kept) ? std::next(it) : tiles.erase(it);
+    }
+
+    bool covered = true;
+    for (TileCoord c: getTilesCovering(rg, zoom)) {
+        if (tiles.find(key(c)) == tiles.end()) {
+            covered = false;
+            break;
+        }
+    }
+    if (covered) {
+        placeholders.clear();
+        return;
+    }
+    for (auto it = placeholders.begin(); it != placeholders.end();) {
+        it = overlaps(it->second.extent, rg) ? std::next(it) : placeholders.erase(it);
+    }
+}
+
+void TileCache::clear() {
+    tiles.clear();
+    placeholders.clear();
+}
+
+auto TileCache::isEmpty() const -> bool { return tiles.empty() && placeholders.empty(); }
@@ -0,0 +1,129 @@
+/*
+ * Xournal++
+ *
+ * Tiled rendering cache of a page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>        // for int32_t, uint64_t
+#include <functional>     // for function
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include <cairo.h>  // for cairo_t
+
+#include "util/Range.h"  // for Range
+
+#include "Mask.h"  // for Mask
+
+namespace xoj::view {
+
+/**
+ * @brief Cache of the rendering of a page, split into fixed-size tiles
+ *
+ * The page, rendered at a given zoom, is cut into squares of TILE_SIZE x TILE_SIZE pixels (before DPI scaling). Only
+ * the tiles that have been rendered are kept, so the memory usage depends on the visible area and not on the zoom.
+ *
+ * When the zoom changes, the tiles of the former zoom level become placeholders: they are painted (scaled) where the
+ * tiles of the new zoom level are not available yet.
+ *
+ * The cache is not thread safe: the owner (see XojPageView) is responsible for the locking.
+ */
+class TileCache {
+public:
+    struct TileCoord {
+        int32_t x;
+        int32_t y;
+    };
+
+    /// Side of a tile, in pixels (before DPI scaling)
+    static constexpr int TILE_SIZE = 256;
+
+    enum class State {
+        /// Covered by up-to-date tiles
+        UP_TO_DATE,
+        /// Covered by tiles, some of which are outdated or drafts
+        OUTDATED,
+        /// Some tiles are missing
+        INCOMPLETE
+    };
+
+    /**
+     * @return The extent of the tile, in page coordinates
+     */
+    static Range getTileExtent(TileCoord c, double zoom);
+
+    /**
+     * @return The tiles covering rg (in page coordinates), row by row starting from the top
+     */
+    static std::vector<TileCoord> getTilesCovering(const Range& rg, double zoom);
+
+    /**
+     * @brief Set the zoom level of the tiles.
+     * If it differs from the current one, the current tiles become placeholders.
+     */
+    void setZoom(double zoom);
+    double getZoom() const;
+
+    /**
+     * @param includeOutdated If false, only the tiles that do not exist at all are returned
+     * @return The tiles covering rg (in page coordinates) that are either missing or outdated (drafts included)
+     */
+    std::vector<TileCoord> getMissingTiles(const Range& rg, bool includeOutdated = true) const;
+
+    /**
+     * @brief Paint the tiles covering rg. Where tiles are missing, the placeholders are painted instead (if any).
+     * @param cr A cairo context in page coordinates
+     * @return Whether rg is covered by up-to-date tiles
+     */
+    State paintTo(cairo_t* cr, const Range& rg) const;
+
+    /**
+     * @brief Store a rendered tile. The tile is dropped if the zoom level has changed in the meantime.
+     * @param draft Whether the tile is a quick, low quality rendering. A draft never replaces an existing tile.
+     */
+    void setTile(TileCoord c, double zoom, Mask tile, bool draft = false);
+
+    /**
+     * @brief Call fn on the cairo context (in page coordinates) of every tile and placeholder intersecting rg
+     */
+    void forEachTileIntersecting(const Range& rg, const std::function<void(cairo_t*)>& fn);
+
+    /**
+     * @brief Mark all the tiles as outdated. They are still painted until they are replaced.
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Delete the tiles that are not within a tile's distance from rg. The placeholders are deleted as soon as
+     * rg is covered by tiles of the current zoom level.
+     */
+    void prune(const Range& rg);
+
+    void clear();
+
+    bool isEmpty() const;
+
+private:
+    struct Tile {
+        Mask mask;
+        Range extent;
+        bool outdated = false;
+        bool draft = false;
+    };
+
+    static uint64_t key(TileCoord c);
+
+    double zoom = 1.0;
+    std::unordered_map<uint64_t, Tile> tiles;
+
+    /// Tiles of a former zoom level
+    std::unordered_map<uint64_t, Tile> placeholders;
+};
+};  // namespace xoj::view
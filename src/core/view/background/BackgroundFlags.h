@@ -18,6 +18,8 @@ enum ImageBackgroundTreatment : bool { SHOW_IMAGE_BACKGROUND = true, HIDE_IMAGE_
 enum RulingBackgroundTreatment : bool { SHOW_RULING_BACKGROUND = true, HIDE_RULING_BACKGROUND = false };
 enum BackgroundColorTreatment : bool { FORCE_AT_LEAST_BACKGROUND_COLOR = true, DONT_FORCE_BACKGROUND_COLOR = false };
 enum VisibilityTreatment : bool { FORCE_VISIBLE = true, USE_DOCUMENT_VISIBILITY = false };
+/// Drafts accept any cached rendering of the pdf page, whatever its resolution, and never replace it
+enum PDFRenderingTreatment : bool { ACCEPT_ANY_PDF_RENDERING = true, REFRESH_PDF_RENDERING = false };
 
 struct BackgroundFlags {
     PDFBackgroundTreatment showPDF;
@@ -25,6 +27,7 @@ struct BackgroundFlags {
     RulingBackgroundTreatment showRuling;
     BackgroundColorTreatment forceBackgroundColor = DONT_FORCE_BACKGROUND_COLOR;
     VisibilityTreatment forceVisible = USE_DOCUMENT_VISIBILITY;
+    PDFRenderingTreatment pdfRendering = REFRESH_PDF_RENDERING;
 };
 
 static constexpr BackgroundFlags BACKGROUND_SHOW_ALL = {SHOW_PDF_BACKGROUND, SHOW_IMAGE_BACKGROUND,
@@ -8,8 +8,9 @@
 
 using namespace xoj::view;
 
-PdfBackgroundView::PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache):
-        BackgroundView(pageWidth, pageHeight), pageNo(pageNo), pdfCache(pdfCache) {}
+PdfBackgroundView::PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache,
+                                     PDFRenderingTreatment rendering):
+        BackgroundView(pageWidth, pageHeight), pageNo(pageNo), pdfCache(pdfCache), rendering(rendering) {}
 
 void PdfBackgroundView::draw(cairo_t* cr) const {
     if (pdfCache) {
@@ -22,7 +23,7 @@ void PdfBackgroundView::draw(cairo_t* cr) const {
         cairo_surface_get_device_scale(cairo_get_target(cr), &scaleX, &scaleY);
         xoj_assert(scaleX == scaleY);
         double pixelsPerPageUnit = matrix.xx * scaleX;
-        pdfCache->render(cr, pageNo, pixelsPerPageUnit, pageWidth, pageHeight);
+        pdfCache->render(cr, pageNo, pixelsPerPageUnit, pageWidth, pageHeight, rendering == ACCEPT_ANY_PDF_RENDERING);
     } else {
         g_warning("PdfBackgroundView::draw Missing pdf cache: cannot render the pdf page");
         PdfCache::renderMissingPdfPage(cr, pageWidth, pageHeight);
@@ -15,7 +15,8 @@
 
 #include <cairo.h>  // for cairo_t
 
-#include "BackgroundView.h"  // for BackgroundView
+#include "BackgroundFlags.h"  // for PDFRenderingTreatment
+#include "BackgroundView.h"   // for BackgroundView
 
 class PdfCache;
 
@@ -24,7 +25,8 @@ namespace view {
 
 class PdfBackgroundView: public BackgroundView {
 public:
-    PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache = nullptr);
+    PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache = nullptr,
+                      PDFRenderingTreatment rendering = REFRESH_PDF_RENDERING);
     virtual ~PdfBackgroundView() = default;
 
     /**
@@ -35,6 +37,7 @@ public:
 private:
     size_t pageNo;
     PdfCache* pdfCache = nullptr;
+    PDFRenderingTreatment rendering;
 };
 
 };  // namespace view
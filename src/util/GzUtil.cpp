@@ -1,5 +1,7 @@
 #include "util/GzUtil.h"
 
+#include "util/safe_casts.h"  // for strict_cast
+
 auto GzUtil::openPath(const fs::path& path, const std::string& flags) -> gzFile {
 #ifdef _WIN32
     gzFile fp = gzopen_w(path.c_str(), flags.c_str());
@@ -9,3 +11,23 @@ auto GzUtil::openPath(const fs::path& path, const std::string& flags) -> gzFile
     return gzopen(path.c_str(), flags.c_str());
 #endif
 }
+
+auto GzUtil::deflateRaw(std::string_view data, int level) -> std::optional<std::string> {
+    z_stream strm{};
+    if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return std::nullopt;
+    }
+    std::string result(deflateBound(&strm, strict_cast<uLong>(data.size())), '\0');
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    strm.avail_in = strict_cast<uInt>(data.size());
+    strm.next_out = reinterpret_cast<Bytef*>(result.data());
+    strm.avail_out = strict_cast<uInt>(result.size());
+    // The output buffer is large enough for a single call
+    const int ret = deflate(&strm, Z_FINISH);
+    result.resize(result.size() - strm.avail_out);
+    deflateEnd(&strm);
+    if (ret != Z_STREAM_END) {
+        return std::nullopt;
+    }
+    return result;
+}
@@ -1,13 +1,20 @@
 #include "util/OutputStream.h"
 
+#include <algorithm>    // for min
 #include <cassert>
 #include <cerrno>
+#include <cstdint>      // for uint32_t
 #include <cstring>      // for strlen
+#include <deque>        // for deque
+#include <functional>   // for function
+#include <future>       // for future
+#include <string>       // for string, to_string
 #include <string_view>  // for string_view
 #include <utility>      // for move
 
-#include "util/GzUtil.h"  // for GzUtil
-#include "util/i18n.h"    // for FS, _F
+#include "util/GzUtil.h"      // for GzUtil
+#include "util/WorkerPool.h"  // for WorkerPool
+#include "util/i18n.h"        // for FS, _F
 #include "util/safe_casts.h"
 
 OutputStream::OutputStream() = default;
@@ -20,15 +27,200 @@ void OutputStream::write(const std::string_view sv) { write(sv.data(), sv.length
 
 void OutputStream::write(const std::u8string_view sv) { write(char_cast(sv.data()), sv.length()); }
 
+void StringOutputStream::write(const char* data, size_t len) { this->str.append(data, len); }
+
+void StringOutputStream::close() {}
+
+auto StringOutputStream::getString() const -> const std::string& { return this->str; }
+
+auto StringOutputStream::takeString() -> std::string { return std::move(this->str); }
+
 ////////////////////////////////////////////////////////
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(fs::path file): file(std::move(file)) {
-    this->fp = GzUtil::openPath(this->file, "w");
+/**
+ * Compresses blocks of data in parallel, and writes them as a single gzip stream (RFC 1952). Each block is deflated
+ * on its own, with the end of the previous block as dictionary, and is terminated by a sync flush so that the blocks
+ * can be concatenated.
+ * The blocks are compressed by a WorkerPool, started with the compressor.
+ */
+class ParallelGzCompressor {
+public:
+    /// @param sink Gets the compressed stream, in order, on the writing thread
+    ParallelGzCompressor(std::function<void(const char*, size_t)> sink, const GzCompression& compression);
+    ~ParallelGzCompressor();
+
+    void write(const char* data, size_t len);
+
+    /**
+     * Compress the remaining data and write the end of the gzip stream
+     * @return false if a block could not be compressed
+     */
+    bool finish();
+
+private:
+    struct CompressedBlock {
+        std::string data;
+        uLong crc;
+        size_t length;
+        bool ok;
+    };
+
+    static auto compress(std::string block, std::string dictionary, int level, bool last) -> CompressedBlock;
+
+    void submitBlock(bool last);
+    void writeNextBlock();
+
+private:
+    /// Size of the uncompressed blocks, as in pigz
+    static constexpr size_t BLOCK_SIZE = 128 * 1024;
+    /// The maximal window of deflate
+    static constexpr size_t DICTIONARY_SIZE = 32 * 1024;
+
+    std::function<void(const char*, size_t)> sink;
+    int level;
+    bool ok = true;
+    size_t maxPendingBlocks;
+
+    std::string block;
+    std::string dictionary;
+    /// The results of the submitted blocks, in order
+    std::deque<std::future<CompressedBlock>> pending;
+
+    xoj::util::WorkerPool workers;
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    /// The uncompressed size modulo 2^32, as stored by gzip
+    uint32_t totalLength = 0;
+};
+
+ParallelGzCompressor::ParallelGzCompressor(std::function<void(const char*, size_t)> sink,
+                                           const GzCompression& compression):
+        sink(std::move(sink)),
+        level(compression.level),
+        maxPendingBlocks(std::max(compression.threads, 1U)),
+        workers(std::max(compression.threads, 1U)) {
+    block.reserve(BLOCK_SIZE);
+    // Magic number, deflate, no flags, no modification time, no extra flags, Unix
+    constexpr char header[] = {'\x1f', '\x8b', '\x08', 0, 0, 0, 0, 0, 0, '\x03'};
+    this->sink(header, sizeof(header));
+}
+
+ParallelGzCompressor::~ParallelGzCompressor() = default;
+
+void ParallelGzCompressor::write(const char* data, size_t len) {
+    while (len > 0) {
+        size_t n = std::min(len, BLOCK_SIZE - block.size());
+        block.append(data, n);
+        data += n;
+        len -= n;
+        if (block.size() == BLOCK_SIZE) {
+            submitBlock(false);
+        }
+    }
+}
+
+auto ParallelGzCompressor::finish() -> bool {
+    submitBlock(true);
+    while (!pending.empty()) {
+        writeNextBlock();
+    }
+
+    // CRC32 and size, little endian
+    char trailer[8];
+    for (int i = 0; i < 4; i++) {
+        trailer[i] = static_cast<char>((crc >> (8 * i)) & 0xff);
+        trailer[4 + i] = static_cast<char>((totalLength >> (8 * i)) & 0xff);
+    }
+    sink(trailer, sizeof(trailer));
+    return ok;
+}
+
+void ParallelGzCompressor::submitBlock(bool last) {
+    if (pending.size() >= maxPendingBlocks) {
+        writeNextBlock();
+    }
+
+    std::string nextDictionary = block.size() > DICTIONARY_SIZE ? block.substr(block.size() - DICTIONARY_SIZE) : block;
+    auto task = [block = std::move(block), dictionary = std::move(dictionary), level = level, last]() mutable {
+        return compress(std::move(block), std::move(dictionary), level, last);
+    };
+    pending.push_back(workers.submit(std::move(task)));
+    dictionary = std::move(nextDictionary);
+    block = std::string();
+    block.reserve(BLOCK_SIZE);
+}
+
+void ParallelGzCompressor::writeNextBlock() {
+    CompressedBlock b = pending.front().get();
+    pending.pop_front();
+
+    if (!b.ok) {
+        ok = false;
+        return;
+    }
+    crc = crc32_combine(crc, b.crc, static_cast<z_off_t>(b.length));
+    totalLength += static_cast<uint32_t>(b.length);
+    sink(b.data.data(), b.data.size());
+}
+
+auto ParallelGzCompressor::compress(std::string block, std::string dictionary, int level, bool last)
+        -> CompressedBlock {
+    CompressedBlock result{{}, crc32(0L, Z_NULL, 0), block.size(), false};
+    result.crc = crc32(result.crc, reinterpret_cast<const Bytef*>(block.data()), strict_cast<uInt>(block.size()));
+
+    z_stream strm{};
+    // Raw deflate: the gzip header and trailer are written by the ParallelCompressor
+    if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return result;
+    }
+    if (!dictionary.empty() && deflateSetDictionary(&strm, reinterpret_cast<const Bytef*>(dictionary.data()),
+                                                    strict_cast<uInt>(dictionary.size())) != Z_OK) {
+        deflateEnd(&strm);
+        return result;
+    }
+
+    // Room for the sync flush marker
+    result.data.resize(deflateBound(&strm, block.size()) + 16);
+    strm.next_in = reinterpret_cast<Bytef*>(block.data());
+    strm.avail_in = strict_cast<uInt>(block.size());
+    size_t written = 0;
+    int ret = Z_OK;
+    do {
+        if (written == result.data.size()) {
+            result.data.resize(2 * result.data.size());
+        }
+        strm.next_out = reinterpret_cast<Bytef*>(result.data.data() + written);
+        strm.avail_out = strict_cast<uInt>(result.data.size() - written);
+        ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+        written = result.data.size() - strm.avail_out;
+        // deflate needs to be called again if it filled the output buffer
+    } while ((ret == Z_OK || ret == Z_BUF_ERROR) && strm.avail_out == 0);
+    deflateEnd(&strm);
+
+    result.data.resize(written);
+    // Z_BUF_ERROR only means that the last call had nothing left to flush
+    result.ok = last ? ret == Z_STREAM_END : (ret == Z_OK || ret == Z_BUF_ERROR) && strm.avail_in == 0;
+    return result;
+}
+
+GzOutputStream::GzOutputStream(fs::path file, GzCompression compression): file(std::move(file)) {
+    std::string mode = "w";
+    if (compression.threads > 1) {
+        // The data is compressed by the ParallelCompressor
+        mode += "T";
+    } else if (compression.level >= 0 && compression.level <= 9) {
+        mode += std::to_string(compression.level);
+    }
+
+    this->fp = GzUtil::openPath(this->file, mode);
     if (this->fp == nullptr) {
         this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
         this->error = this->error + "\n" + std::strerror(errno);
+    } else if (compression.threads > 1) {
+        this->compressor = std::make_unique<ParallelGzCompressor>(
+                [this](const char* data, size_t len) { writeToFile(data, len); }, compression);
     }
 }
 
@@ -43,6 +235,14 @@ auto GzOutputStream::getLastError() const -> const std::string& { return this->e
 
 void GzOutputStream::write(const char* data, size_t len) {
     xoj_assert(len != 0 && this->fp);
+    if (this->compressor) {
+        this->compressor->write(data, len);
+    } else {
+        writeToFile(data, len);
+    }
+}
+
+void GzOutputStream::writeToFile(const char* data, size_t len) {
     auto written = gzwrite(this->fp, data, strict_cast<unsigned int>(len));
     if (as_unsigned(written) != len) {
         int errnum = 0;
@@ -65,6 +265,13 @@ void GzOutputStream::close() {
         return;
     }
 
+    if (this->compressor) {
+        if (!this->compressor->finish() && this->error.empty()) {
+            this->error = FS(_F("Error compressing data for file: \"{1}\"") % this->file.u8string());
+        }
+        this->compressor.reset();
+    }
+
     auto errnum = gzclose(this->fp);
     this->fp = nullptr;
 
@@ -77,3 +284,60 @@ void GzOutputStream::close() {
         }
     }
 }
+
+////////////////////////////////////////////////////////
+/// GzStringOutputStream ///////////////////////////////
+////////////////////////////////////////////////////////
+
+GzStringOutputStream::GzStringOutputStream(GzCompression compression):
+        compressor(std::make_unique<ParallelGzCompressor>(
+                [this](const char* data, size_t len) { this->compressed.append(data, len); }, compression)) {}
+
+GzStringOutputStream::~GzStringOutputStream() = default;
+
+void GzStringOutputStream::write(const char* data, size_t len) {
+    xoj_assert(this->compressor);
+    this->compressor->write(data, len);
+}
+
+void GzStringOutputStream::close() {
+    if (!this->compressor) {
+        return;
+    }
+    if (!this->compressor->finish()) {
+        this->error = _("Error compressing data");
+    }
+    this->compressor.reset();
+}
+
+auto GzStringOutputStream::writeTo(const fs::path& file) -> bool {
+    close();
+    if (!this->error.empty()) {
+        return false;
+    }
+
+    // Already compressed: written as is ("T" for transparent)
+    gzFile fp = GzUtil::openPath(file, "wT");
+    if (fp == nullptr) {
+        this->error = FS(_F("Error opening file: \"{1}\"") % file.u8string());
+        this->error = this->error + "\n" + std::strerror(errno);
+        return false;
+    }
+
+    constexpr size_t MAX_WRITE = 1U << 30;
+    for (size_t pos = 0; pos < this->compressed.size(); pos += MAX_WRITE) {
+        const size_t len = std::min(MAX_WRITE, this->compressed.size() - pos);
+        if (as_unsigned(gzwrite(fp, this->compressed.data() + pos, strict_cast<unsigned int>(len))) != len) {
+            this->error = FS(_F("Error writing data to file: \"{1}\"") % file.u8string());
+            this->error = this->error + "\n" + std::strerror(errno);
+            break;
+        }
+    }
+    if (gzclose(fp) != Z_OK && this->error.empty()) {
+        this->error = FS(_F("Error occurred while closing file: \"{1}\"") % file.u8string());
+        this->error = this->error + "\n" + std::strerror(errno);
+    }
+    return this->error.empty();
+}
+
+auto GzStringOutputStream::getLastError() const -> const std::string& { return this->error; }
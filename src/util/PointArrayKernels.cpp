@@ -0,0 +1,306 @@
+#include "util/PointArrayKernels.h"
+
+#include <algorithm>  // for min, max
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#define XOJ_SIMD_X86
+#include <immintrin.h>  // for _mm256_*, _mm_*
+#endif
+
+using namespace xoj::util::simd;
+
+/*
+ * Scalar implementations
+ */
+auto scalar::minMax(const double* values, size_t n) -> MinMax {
+    MinMax res{values[0], values[0]};
+    for (size_t i = 1; i < n; i++) {
+        res.min = std::min(res.min, values[i]);
+        res.max = std::max(res.max, values[i]);
+    }
+    return res;
+}
+
+auto scalar::maxValue(const double* values, size_t n) -> double {
+    double res = values[0];
+    for (size_t i = 1; i < n; i++) {
+        res = std::max(res, values[i]);
+    }
+    return res;
+}
+
+void scalar::translate(double* values, size_t n, double d) {
+    for (size_t i = 0; i < n; i++) {
+        values[i] += d;
+    }
+}
+
+void scalar::transform(double* xs, double* ys, size_t n, const AffineMatrix& m) {
+    for (size_t i = 0; i < n; i++) {
+        const double x = xs[i];
+        const double y = ys[i];
+        // Same order of operations as cairo_matrix_transform_point()
+        xs[i] = (m.xx * x + m.xy * y) + m.x0;
+        ys[i] = (m.yx * x + m.yy * y) + m.y0;
+    }
+}
+
+static inline bool segmentTouchesBox(double x1, double y1, double x2, double y2, const Box& box) {
+    return std::max(x1, x2) >= box.minX && std::min(x1, x2) <= box.maxX && std::max(y1, y2) >= box.minY &&
+           std::min(y1, y2) <= box.maxY;
+}
+
+auto scalar::findSegmentTouchingBox(const double* xs, const double* ys, size_t first, size_t last, const Box& box)
+        -> size_t {
+    for (size_t i = first; i < last; i++) {
+        if (segmentTouchesBox(xs[i], ys[i], xs[i + 1], ys[i + 1], box)) {
+            return i;
+        }
+    }
+    return last;
+}
+
+#ifdef XOJ_SIMD_X86
+/*
+ * SSE2 implementations: SSE2 is part of the x86-64 baseline, no runtime check needed
+ */
+namespace sse2 {
+static auto minMax(const double* values, size_t n) -> MinMax {
+    if (n < 4) {
+        return scalar::minMax(values, n);
+    }
+    __m128d mins = _mm_loadu_pd(values);
+    __m128d maxs = mins;
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d v = _mm_loadu_pd(values + i);
+        mins = _mm_min_pd(mins, v);
+        maxs = _mm_max_pd(maxs, v);
+    }
+    alignas(16) double lo[2];
+    alignas(16) double hi[2];
+    _mm_store_pd(lo, mins);
+    _mm_store_pd(hi, maxs);
+    MinMax res{std::min(lo[0], lo[1]), std::max(hi[0], hi[1])};
+    for (; i < n; i++) {
+        res.min = std::min(res.min, values[i]);
+        res.max = std::max(res.max, values[i]);
+    }
+    return res;
+}
+
+static auto maxValue(const double* values, size_t n) -> double {
+    if (n < 4) {
+        return scalar::maxValue(values, n);
+    }
+    __m128d maxs = _mm_loadu_pd(values);
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        maxs = _mm_max_pd(maxs, _mm_loadu_pd(values + i));
+    }
+    alignas(16) double hi[2];
+    _mm_store_pd(hi, maxs);
+    double res = std::max(hi[0], hi[1]);
+    for (; i < n; i++) {
+        res = std::max(res, values[i]);
+    }
+    return res;
+}
+
+static void translate(double* values, size_t n, double d) {
+    const __m128d dd = _mm_set1_pd(d);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(values + i, _mm_add_pd(_mm_loadu_pd(values + i), dd));
+    }
+    scalar::translate(values + i, n - i, d);
+}
+
+static void transform(double* xs, double* ys, size_t n, const AffineMatrix& m) {
+    const __m128d xx = _mm_set1_pd(m.xx);
+    const __m128d yx = _mm_set1_pd(m.yx);
+    const __m128d xy = _mm_set1_pd(m.xy);
+    const __m128d yy = _mm_set1_pd(m.yy);
+    const __m128d x0 = _mm_set1_pd(m.x0);
+    const __m128d y0 = _mm_set1_pd(m.y0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d x = _mm_loadu_pd(xs + i);
+        const __m128d y = _mm_loadu_pd(ys + i);
+        _mm_storeu_pd(xs + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(xx, x), _mm_mul_pd(xy, y)), x0));
+        _mm_storeu_pd(ys + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(yx, x), _mm_mul_pd(yy, y)), y0));
+    }
+    scalar::transform(xs + i, ys + i, n - i, m);
+}
+
+static auto findSegmentTouchingBox(const double* xs, const double* ys, size_t first, size_t last, const Box& box)
+        -> size_t {
+    const __m128d minX = _mm_set1_pd(box.minX);
+    const __m128d minY = _mm_set1_pd(box.minY);
+    const __m128d maxX = _mm_set1_pd(box.maxX);
+    const __m128d maxY = _mm_set1_pd(box.maxY);
+    size_t i = first;
+    // The segments i and i + 1 end on the points i + 1 and i + 2 <= last
+    for (; i + 2 <= last; i += 2) {
+        const __m128d x1 = _mm_loadu_pd(xs + i);
+        const __m128d x2 = _mm_loadu_pd(xs + i + 1);
+        const __m128d y1 = _mm_loadu_pd(ys + i);
+        const __m128d y2 = _mm_loadu_pd(ys + i + 1);
+        const __m128d touchX =
+                _mm_and_pd(_mm_cmpge_pd(_mm_max_pd(x1, x2), minX), _mm_cmple_pd(_mm_min_pd(x1, x2), maxX));
+        const __m128d touchY =
+                _mm_and_pd(_mm_cmpge_pd(_mm_max_pd(y1, y2), minY), _mm_cmple_pd(_mm_min_pd(y1, y2), maxY));
+        if (const int mask = _mm_movemask_pd(_mm_and_pd(touchX, touchY)); mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return scalar::findSegmentTouchingBox(xs, ys, i, last, box);
+}
+};  // namespace sse2
+
+/*
+ * AVX2 implementations, only used if the CPU supports it
+ */
+#define XOJ_TARGET_AVX2 __attribute__((target("avx2")))
+
+namespace avx2 {
+XOJ_TARGET_AVX2 static auto minMax(const double* values, size_t n) -> MinMax {
+    if (n < 8) {
+        return sse2::minMax(values, n);
+    }
+    __m256d mins = _mm256_loadu_pd(values);
+    __m256d maxs = mins;
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d v = _mm256_loadu_pd(values + i);
+        mins = _mm256_min_pd(mins, v);
+        maxs = _mm256_max_pd(maxs, v);
+    }
+    alignas(32) double lo[4];
+    alignas(32) double hi[4];
+    _mm256_store_pd(lo, mins);
+    _mm256_store_pd(hi, maxs);
+    MinMax res{std::min({lo[0], lo[1], lo[2], lo[3]}), std::max({hi[0], hi[1], hi[2], hi[3]})};
+    for (; i < n; i++) {
+        res.min = std::min(res.min, values[i]);
+        res.max = std::max(res.max, values[i]);
+    }
+    return res;
+}
+
+XOJ_TARGET_AVX2 static auto maxValue(const double* values, size_t n) -> double {
+    if (n < 8) {
+        return sse2::maxValue(values, n);
+    }
+    __m256d maxs = _mm256_loadu_pd(values);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        maxs = _mm256_max_pd(maxs, _mm256_loadu_pd(values + i));
+    }
+    alignas(32) double hi[4];
+    _mm256_store_pd(hi, maxs);
+    double res = std::max({hi[0], hi[1], hi[2], hi[3]});
+    for (; i < n; i++) {
+        res = std::max(res, values[i]);
+    }
+    return res;
+}
+
+XOJ_TARGET_AVX2 static void translate(double* values, size_t n, double d) {
+    const __m256d dd = _mm256_set1_pd(d);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(values + i, _mm256_add_pd(_mm256_loadu_pd(values + i), dd));
+    }
+    scalar::translate(values + i, n - i, d);
+}
+
+XOJ_TARGET_AVX2 static void transform(double* xs, double* ys, size_t n, const AffineMatrix& m) {
+    // No FMA: the results must not differ from the scalar implementation
+    const __m256d xx = _mm256_set1_pd(m.xx);
+    const __m256d yx = _mm256_set1_pd(m.yx);
+    const __m256d xy = _mm256_set1_pd(m.xy);
+    const __m256d yy = _mm256_set1_pd(m.yy);
+    const __m256d x0 = _mm256_set1_pd(m.x0);
+    const __m256d y0 = _mm256_set1_pd(m.y0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d x = _mm256_loadu_pd(xs + i);
+        const __m256d y = _mm256_loadu_pd(ys + i);
+        _mm256_storeu_pd(xs + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(xx, x), _mm256_mul_pd(xy, y)), x0));
+        _mm256_storeu_pd(ys + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(yx, x), _mm256_mul_pd(yy, y)), y0));
+    }
+    scalar::transform(xs + i, ys + i, n - i, m);
+}
+
+XOJ_TARGET_AVX2 static auto findSegmentTouchingBox(const double* xs, const double* ys, size_t first, size_t last,
+                                                   const Box& box) -> size_t {
+    const __m256d minX = _mm256_set1_pd(box.minX);
+    const __m256d minY = _mm256_set1_pd(box.minY);
+    const __m256d maxX = _mm256_set1_pd(box.maxX);
+    const __m256d maxY = _mm256_set1_pd(box.maxY);
+    size_t i = first;
+    // The segments i, ..., i + 3 end on the points i + 1, ..., i + 4 <= last
+    for (; i + 4 <= last; i += 4) {
+        const __m256d x1 = _mm256_loadu_pd(xs + i);
+        const __m256d x2 = _mm256_loadu_pd(xs + i + 1);
+        const __m256d y1 = _mm256_loadu_pd(ys + i);
+        const __m256d y2 = _mm256_loadu_pd(ys + i + 1);
+        const __m256d touchX = _mm256_and_pd(_mm256_cmp_pd(_mm256_max_pd(x1, x2), minX, _CMP_GE_OQ),
+                                             _mm256_cmp_pd(_mm256_min_pd(x1, x2), maxX, _CMP_LE_OQ));
+        const __m256d touchY = _mm256_and_pd(_mm256_cmp_pd(_mm256_max_pd(y1, y2), minY, _CMP_GE_OQ),
+                                             _mm256_cmp_pd(_mm256_min_pd(y1, y2), maxY, _CMP_LE_OQ));
+        if (const int mask = _mm256_movemask_pd(_mm256_and_pd(touchX, touchY)); mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return sse2::findSegmentTouchingBox(xs, ys, i, last, box);
+}
+};  // namespace avx2
+#endif
+
+namespace {
+struct Kernels {
+    MinMax (*minMax)(const double*, size_t);
+    double (*maxValue)(const double*, size_t);
+    void (*translate)(double*, size_t, double);
+    void (*transform)(double*, double*, size_t, const AffineMatrix&);
+    size_t (*findSegmentTouchingBox)(const double*, const double*, size_t, size_t, const Box&);
+    const char* name;
+};
+
+auto selectKernels() -> Kernels {
+#ifdef XOJ_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {avx2::minMax, avx2::maxValue, avx2::translate, avx2::transform, avx2::findSegmentTouchingBox, "AVX2"};
+    }
+    return {sse2::minMax, sse2::maxValue, sse2::translate, sse2::transform, sse2::findSegmentTouchingBox, "SSE2"};
+#else
+    return {scalar::minMax,    scalar::maxValue, scalar::translate,
+            scalar::transform, scalar::findSegmentTouchingBox, "scalar"};
+#endif
+}
+
+auto kernels() -> const Kernels& {
+    static const Kernels k = selectKernels();
+    return k;
+}
+}  // namespace
+
+auto xoj::util::simd::minMax(const double* values, size_t n) -> MinMax { return kernels().minMax(values, n); }
+
+auto xoj::util::simd::maxValue(const double* values, size_t n) -> double { return kernels().maxValue(values, n); }
+
+void xoj::util::simd::translate(double* values, size_t n, double d) { kernels().translate(values, n, d); }
+
+void xoj::util::simd::transform(double* xs, double* ys, size_t n, const AffineMatrix& m) {
+    kernels().transform(xs, ys, n, m);
+}
+
+auto xoj::util::simd::findSegmentTouchingBox(const double* xs, const double* ys, size_t first, size_t last,
+                                             const Box& box) -> size_t {
+    return kernels().findSegmentTouchingBox(xs, ys, first, last, box);
+}
+
+auto xoj::util::simd::getImplementationName() -> const char* { return kernels().name; }
@@ -0,0 +1,26 @@
+#include "util/StringInputStream.h"
+
+#include <algorithm>  // for min
+#include <cstring>    // for memcpy
+#include <utility>    // for move
+
+
+namespace xoj::util {
+
+StringInputStream::StringInputStream(std::string data): data(std::move(data)) {}
+
+StringInputStream::~StringInputStream() = default;
+
+auto StringInputStream::read(char* buffer, unsigned int len) noexcept -> int {
+    const size_t n = std::min<size_t>(len, this->data.size() - this->pos);
+    std::memcpy(buffer, this->data.data() + this->pos, n);
+    this->pos += n;
+    return static_cast<int>(n);
+}
+
+void StringInputStream::close() {
+    this->data.clear();
+    this->pos = 0;
+}
+
+}  // namespace xoj::util
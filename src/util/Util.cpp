@@ -1,10 +1,12 @@
 #include "util/Util.h"
 
-#include <array>    // for array
-#include <cstdlib>  // for system
-#include <string>   // for allocator, string
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <array>     // for array
+#include <charconv>  // for to_chars, chars_format
+#include <cstdlib>   // for system
+#include <cstring>   // for strlen
+#include <string>    // for allocator, string
+#include <utility>   // for move
+#include <vector>    // for vector
 
 #include <gdk/gdk.h>  // for gdk_cairo_set_source_rgba, gdk_t...
 
@@ -52,13 +54,70 @@ void Util::cairo_set_dash_from_vector(cairo_t* cr, const std::vector<double>& da
     cairo_set_dash(cr, dashes.data(), static_cast<int>(dashes.size()), offset);
 }
 
+auto Util::formatNumber(char* buf, double value) -> char* {
+#if ENABLE_FLOAT_TO_CHARS
+    // Specified to give the same output as printf("%.8g") in the C locale
+    return std::to_chars(buf, buf + NUMBER_STRING_BUF_SIZE, value, std::chars_format::general, 8).ptr;
+#else
+    g_ascii_formatd(buf, NUMBER_STRING_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
+    return buf + std::strlen(buf);
+#endif
+}
+
 void Util::writeCoordinateString(OutputStream* out, double xVal, double yVal) {
-    std::array<char, G_ASCII_DTOSTR_BUF_SIZE> coordString{};
-    g_ascii_formatd(coordString.data(), G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, xVal);
-    out->write(coordString.data());
-    out->write(" ");
-    g_ascii_formatd(coordString.data(), G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, yVal);
-    out->write(coordString.data());
+    std::array<char, 2 * NUMBER_STRING_BUF_SIZE + 1> coordString;
+    char* end = formatNumber(coordString.data(), xVal);
+    *end++ = ' ';
+    end = formatNumber(end, yVal);
+    out->write(coordString.data(), static_cast<size_t>(end - coordString.data()));
+}
+
+namespace {
+/// Gathers the formatted numbers, and writes them to the OutputStream by chunks
+class NumberStringWriter {
+public:
+    explicit NumberStringWriter(OutputStream* out): out(out) {}
+    ~NumberStringWriter() { flush(); }
+
+    void add(double value) {
+        if (static_cast<size_t>(buffer.data() + buffer.size() - pos) < Util::NUMBER_STRING_BUF_SIZE + 1) {
+            flush();
+        }
+        if (!first) {
+            *pos++ = ' ';
+        }
+        first = false;
+        pos = Util::formatNumber(pos, value);
+    }
+
+    void flush() {
+        if (pos != buffer.data()) {
+            out->write(buffer.data(), static_cast<size_t>(pos - buffer.data()));
+            pos = buffer.data();
+        }
+    }
+
+private:
+    OutputStream* out;
+    std::array<char, 4096> buffer;
+    char* pos = buffer.data();
+    bool first = true;
+};
+}  // namespace
+
+void Util::writeCoordinateString(OutputStream* out, const double* xs, const double* ys, size_t n) {
+    NumberStringWriter writer(out);
+    for (size_t i = 0; i < n; i++) {
+        writer.add(xs[i]);
+        writer.add(ys[i]);
+    }
+}
+
+void Util::writeNumberString(OutputStream* out, const double* values, size_t n) {
+    NumberStringWriter writer(out);
+    for (size_t i = 0; i < n; i++) {
+        writer.add(values[i]);
+    }
 }
 
 void Util::systemWithMessage(const char* command) {
@@ -0,0 +1,47 @@
+#include "util/WorkerPool.h"
+
+#include <utility>  // for move
+
+namespace xoj::util {
+
+WorkerPool::WorkerPool(unsigned int threads) {
+    workers.reserve(threads);
+    for (unsigned int i = 0; i < threads; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard lock(queueMutex);
+        stopping = true;
+    }
+    queueCond.notify_all();
+    for (auto& w: workers) {
+        w.join();
+    }
+}
+
+void WorkerPool::push(std::function<void()> task) {
+    {
+        std::lock_guard lock(queueMutex);
+        queue.push_back(std::move(task));
+    }
+    queueCond.notify_one();
+}
+
+void WorkerPool::workerLoop() {
+    std::unique_lock lock(queueMutex);
+    while (true) {
+        queueCond.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            return;
+        }
+        auto task = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+}  // namespace xoj::util
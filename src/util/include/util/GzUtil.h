@@ -11,7 +11,9 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <optional>     // for optional
+#include <string>       // for string
+#include <string_view>  // for string_view
 
 #include <zlib.h>  // for gzFile
 
@@ -24,4 +26,11 @@ private:
 
 public:
     static gzFile openPath(const fs::path& path, const std::string& flags);
+
+    /**
+     * Compress the data with raw deflate (without zlib or gzip header), as stored in zip archives
+     * @param level zlib compression level, or Z_DEFAULT_COMPRESSION
+     * @return The compressed data, or std::nullopt on error
+     */
+    static std::optional<std::string> deflateRaw(std::string_view data, int level);
 };
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <memory>       // for unique_ptr
 #include <string>       // for string
 #include <string_view>  // for string_view
 
@@ -32,9 +33,44 @@ public:
     virtual void close() = 0;
 };
 
+/**
+ * Keeps the written data in memory
+ */
+class StringOutputStream: public OutputStream {
+public:
+    using OutputStream::write;
+    void write(const char* data, size_t len) override;
+    void close() override;
+
+    const std::string& getString() const;
+
+    /**
+     * Moves the written data out of the stream, which is left empty
+     */
+    std::string takeString();
+
+private:
+    std::string str;
+};
+
+/**
+ * Compression parameters of a GzOutputStream
+ */
+struct GzCompression {
+    /// zlib compression level, from 0 (no compression) to 9 (best compression), or Z_DEFAULT_COMPRESSION
+    int level = Z_DEFAULT_COMPRESSION;
+    /**
+     * Number of threads compressing the data. With more than one thread, the data is cut into blocks that are
+     * compressed independently and concatenated (like pigz does): the result is a standard gzip file.
+     */
+    unsigned int threads = 1;
+};
+
+class ParallelGzCompressor;
+
 class GzOutputStream: public OutputStream {
 public:
-    GzOutputStream(fs::path file);
+    GzOutputStream(fs::path file, GzCompression compression = {});
     ~GzOutputStream() override;
 
 public:
@@ -44,9 +80,47 @@ public:
 
     const std::string& getLastError() const;
 
+private:
+    /// Write the data to the file as is
+    void writeToFile(const char* data, size_t len);
+
 private:
     gzFile fp = nullptr;
 
+    /// Compresses the data before it is written to fp, if more than one thread is used
+    std::unique_ptr<ParallelGzCompressor> compressor;
+
     std::string error;
     fs::path file;
 };
+
+/**
+ * Compresses the data to memory as a gzip stream, on GzCompression::threads threads (at least one, besides the writing
+ * thread): only the compressed data is kept. It is written to a file by writeTo().
+ */
+class GzStringOutputStream: public OutputStream {
+public:
+    explicit GzStringOutputStream(GzCompression compression = {});
+    ~GzStringOutputStream() override;
+
+public:
+    using OutputStream::write;
+    void write(const char* data, size_t len) override;
+
+    /// Compress the remaining data and end the gzip stream
+    void close() override;
+
+    /**
+     * Close the stream and write the compressed data to the file, as is
+     * @return false on error, see getLastError()
+     */
+    bool writeTo(const fs::path& file);
+
+    const std::string& getLastError() const;
+
+private:
+    std::string compressed;
+    std::unique_ptr<ParallelGzCompressor> compressor;
+
+    std::string error;
+};
@@ -0,0 +1,97 @@
+/*
+ * Xournal++
+ *
+ * Vectorized loops over arrays of coordinates
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+
+/**
+ * @brief Loops over arrays of coordinates (typically the points of a stroke), using SIMD instructions when the CPU
+ * supports them.
+ *
+ * The implementation (AVX2, SSE2 or plain scalar code) is picked at runtime, the first time a kernel is called. All
+ * implementations return the same results.
+ */
+namespace xoj::util::simd {
+
+struct MinMax {
+    double min;
+    double max;
+};
+
+/**
+ * @brief Affine transformation, with the same convention as cairo_matrix_t:
+ *      x' = xx * x + xy * y + x0
+ *      y' = yx * x + yy * y + y0
+ */
+struct AffineMatrix {
+    double xx;
+    double yx;
+    double xy;
+    double yy;
+    double x0;
+    double y0;
+};
+
+/**
+ * @brief Axis aligned box, boundaries included
+ */
+struct Box {
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+};
+
+/**
+ * @return The smallest and largest values of the array. n must be positive.
+ */
+MinMax minMax(const double* values, size_t n);
+
+/**
+ * @return The largest value of the array. n must be positive.
+ */
+double maxValue(const double* values, size_t n);
+
+/**
+ * @brief Add d to each value of the array
+ */
+void translate(double* values, size_t n, double d);
+
+/**
+ * @brief Apply the affine transformation to each point (xs[i], ys[i])
+ */
+void transform(double* xs, double* ys, size_t n, const AffineMatrix& m);
+
+/**
+ * @brief Find the first segment [(xs[i], ys[i]), (xs[i + 1], ys[i + 1])], with first <= i < last, whose bounding box
+ * intersects the box. This is a conservative test: the segment itself may miss the box.
+ * @return The index i of the segment, or last if there is none
+ */
+size_t findSegmentTouchingBox(const double* xs, const double* ys, size_t first, size_t last, const Box& box);
+
+/**
+ * @return The name of the implementation in use ("AVX2", "SSE2" or "scalar")
+ */
+const char* getImplementationName();
+
+/**
+ * @brief The scalar implementations, for reference and benchmarking
+ */
+namespace scalar {
+MinMax minMax(const double* values, size_t n);
+double maxValue(const double* values, size_t n);
+void translate(double* values, size_t n, double d);
+void transform(double* xs, double* ys, size_t n, const AffineMatrix& m);
+size_t findSegmentTouchingBox(const double* xs, const double* ys, size_t first, size_t last, const Box& box);
+}  // namespace scalar
+
+};  // namespace xoj::util::simd
@@ -0,0 +1,35 @@
+/*
+ * Xournal++
+ *
+ * Input stream for data kept in memory
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+
+#include "util/InputStream.h"  // for InputStream
+
+
+namespace xoj::util {
+
+class StringInputStream final: public InputStream {
+public:
+    explicit StringInputStream(std::string data);
+    ~StringInputStream() override;
+
+    int read(char* buffer, unsigned int len) noexcept override;
+    void close() override;
+
+private:
+    std::string data;
+    size_t pos = 0;
+};
+
+}  // namespace xoj::util
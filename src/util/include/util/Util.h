@@ -82,8 +82,30 @@ void cairo_set_dash_from_vector(cairo_t* cr, const std::vector<double>& dashes,
  */
 extern void writeCoordinateString(OutputStream* out, double xVal, double yVal);
 
+/**
+ * Writes the n points (xs[i], ys[i]) as "x0 y0 x1 y1 ...", with the precision of writeCoordinateString.
+ * The text is gathered in chunks before being written to the OutputStream.
+ */
+extern void writeCoordinateString(OutputStream* out, const double* xs, const double* ys, size_t n);
+
+/**
+ * Writes the n values as "v0 v1 ...", with the precision of writeCoordinateString.
+ * The text is gathered in chunks before being written to the OutputStream.
+ */
+extern void writeNumberString(OutputStream* out, const double* values, size_t n);
+
 constexpr const gchar* PRECISION_FORMAT_STRING = "%.8g";
 
+/// Size of a buffer large enough for any value written by formatNumber()
+constexpr size_t NUMBER_STRING_BUF_SIZE = G_ASCII_DTOSTR_BUF_SIZE;
+
+/**
+ * Writes the value with 8 digits of precision (same output as PRECISION_FORMAT_STRING in the C locale) to buf, which
+ * must hold at least NUMBER_STRING_BUF_SIZE chars. No null terminator is written.
+ * @return The end of the written string
+ */
+extern char* formatNumber(char* buf, double value);
+
 constexpr const auto DPI_NORMALIZATION_FACTOR = 72.0;
 
 /**
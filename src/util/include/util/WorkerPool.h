@@ -0,0 +1,67 @@
+/*
+ * Xournal++
+ *
+ * A fixed set of threads running tasks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <condition_variable>  // for condition_variable
+#include <deque>               // for deque
+#include <functional>          // for function
+#include <future>              // for future, packaged_task
+#include <memory>              // for make_shared
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+#include <type_traits>         // for invoke_result_t
+#include <utility>             // for move
+#include <vector>              // for vector
+
+namespace xoj::util {
+
+/**
+ * @brief Runs the submitted tasks on a fixed set of threads, started with the pool, in the order they were submitted.
+ * The destructor waits for the queued tasks to be done.
+ */
+class WorkerPool final {
+public:
+    explicit WorkerPool(unsigned int threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Queue the task
+     * @return The future result of the task
+     */
+    template <class F>
+    auto submit(F task) -> std::future<std::invoke_result_t<F>> {
+        // std::function needs a copyable target
+        auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(task));
+        auto result = packaged->get_future();
+        push([packaged = std::move(packaged)]() { (*packaged)(); });
+        return result;
+    }
+
+private:
+    void push(std::function<void()> task);
+
+    /// Runs the queued tasks until the pool is destroyed
+    void workerLoop();
+
+private:
+    std::vector<std::thread> workers;
+
+    /// Protects the members below
+    std::mutex queueMutex;
+    std::condition_variable queueCond;
+    std::deque<std::function<void()>> queue;
+    bool stopping = false;
+};
+}  // namespace xoj::util
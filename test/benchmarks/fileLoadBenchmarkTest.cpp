@@ -19,20 +19,47 @@
 #include "control/xojfile/LoadHandler.h"
 #include "control/xojfile/SaveHandler.h"
 #include "model/Document.h"
+#include "model/Layer.h"
 #include "model/PageRef.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
 #include "model/XojPage.h"
 #include "util/PathUtil.h"
 
 #include "filesystem.h"
 
 
+static auto countStrokePoints(const Document& doc) -> size_t {
+    size_t count = 0;
+    for (size_t p = 0; p < doc.getPageCount(); p++) {
+        for (const Layer* l: doc.getPage(p)->getLayersView()) {
+            for (const Element* e: l->getElementsView()) {
+                if (e->getType() == ELEMENT_STROKE) {
+                    count += static_cast<const Stroke*>(e)->getPointCount();
+                }
+            }
+        }
+    }
+    return count;
+}
+
 static void benchLoadFile(const fs::path& filename, int iterations) {
+    size_t points = 0;
     const auto start = g_get_monotonic_time();
     for (int i = 0; i < iterations; ++i) {
-        LoadHandler{}.loadDocument(filename);
+        auto doc = LoadHandler{}.loadDocument(filename);
+        if (i == 0 && doc) {
+            points = countStrokePoints(*doc);
+        }
     }
     const auto stop = g_get_monotonic_time();
-    std::cout << "Loaded " << filename << ' ' << iterations << " times in " << (stop - start) / 1000 << "ms.\n";
+    std::cout << "Loaded " << filename << ' ' << iterations << " times in " << (stop - start) / 1000 << "ms.";
+    if (points > 0 && stop > start) {
+        const double seconds = static_cast<double>(stop - start) / G_USEC_PER_SEC;
+        std::cout << " " << static_cast<size_t>(static_cast<double>(points) * iterations / seconds)
+                  << " stroke points per second.";
+    }
+    std::cout << "\n";
 }
 
 TEST(FileLoadBenchmark, benchmarkHandwrittenText) {
@@ -91,3 +118,73 @@ TEST(FileLoadBenchmark, benchmarkManyPages) {
     // Clean up test file
     fs::remove(tmp_path);
 }
+
+TEST(FileLoadBenchmark, benchmarkManyPressureStrokes) {
+    // Create a page full of handwriting, with pressure values
+    const auto tmp_path = createTemporaryFile(
+            [](Document& doc) -> void {
+                const PageRef page = std::make_shared<XojPage>(595, 842);
+                GRand* rand = g_rand_new_with_seed(42);
+                for (int i = 0; i < 5'000; ++i) {
+                    auto s = std::make_unique<Stroke>();
+                    s->setWidth(1.41);
+                    double x = g_rand_double_range(rand, 0, 580);
+                    double y = g_rand_double_range(rand, 0, 830);
+                    for (int j = 0; j < 40; ++j) {
+                        s->addPoint(Point(x, y, g_rand_double_range(rand, 0.5, 2)));
+                        x += g_rand_double_range(rand, -0.5, 1);
+                        y += g_rand_double_range(rand, -0.5, 0.5);
+                    }
+                    page->getLayers().front()->addElement(std::move(s));
+                }
+                g_rand_free(rand);
+                doc.addPage(page);
+            },
+            u8"many-pressure-strokes.xopp");
+
+    // Benchmark loading time
+    benchLoadFile(tmp_path, 20);
+
+    // Clean up test file
+    fs::remove(tmp_path);
+}
+
+TEST(FileLoadBenchmark, benchmarkParallelParsing) {
+    // Create 200 pages full of handwriting
+    const auto tmp_path = createTemporaryFile(
+            [](Document& doc) -> void {
+                GRand* rand = g_rand_new_with_seed(42);
+                for (int p = 0; p < 200; ++p) {
+                    const PageRef page = std::make_shared<XojPage>(595, 842);
+                    for (int i = 0; i < 500; ++i) {
+                        auto s = std::make_unique<Stroke>();
+                        s->setWidth(1.41);
+                        double x = g_rand_double_range(rand, 0, 580);
+                        double y = g_rand_double_range(rand, 0, 830);
+                        for (int j = 0; j < 40; ++j) {
+                            s->addPoint(Point(x, y, g_rand_double_range(rand, 0.5, 2)));
+                            x += g_rand_double_range(rand, -0.5, 1);
+                            y += g_rand_double_range(rand, -0.5, 0.5);
+                        }
+                        page->getLayers().front()->addElement(std::move(s));
+                    }
+                    doc.addPage(page);
+                }
+                g_rand_free(rand);
+            },
+            u8"many-pages-of-strokes.xopp");
+
+    for (unsigned int threads: {1U, 2U, 4U, 8U}) {
+        const auto start = g_get_monotonic_time();
+        LoadHandler handler;
+        handler.setParsingThreads(threads);
+        auto doc = handler.loadDocument(tmp_path);
+        const auto stop = g_get_monotonic_time();
+        ASSERT_TRUE(doc);
+        std::cout << "Loaded 200 pages of strokes with " << threads << " parsing threads in " << (stop - start) / 1000
+                  << "ms.\n";
+    }
+
+    // Clean up test file
+    fs::remove(tmp_path);
+}
@@ -0,0 +1,150 @@
+/*
+ * Xournal++
+ *
+ * Fixed input benchmark test of the file saving process
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <config-test.h>
+#include <glib-2.0/glib.h>
+#include <gtest/gtest.h>
+
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/PageRef.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+#include "util/Util.h"
+
+#include "filesystem.h"
+
+
+static void benchSaveDocument(const Document& doc, const char* name, int iterations) {
+    const auto tmp_path = Util::getTmpDirSubfolder() / "save-benchmark.xopp";
+
+    auto start = g_get_monotonic_time();
+    for (int i = 0; i < iterations; ++i) {
+        SaveHandler sh;
+        sh.prepareSave(&doc, tmp_path);
+        sh.saveTo(tmp_path);
+    }
+    auto stop = g_get_monotonic_time();
+    std::cout << "Saved " << name << ' ' << iterations << " times in " << (stop - start) / 1000
+              << "ms with an XML tree.\n";
+
+    start = g_get_monotonic_time();
+    for (int i = 0; i < iterations; ++i) {
+        SaveHandler sh;
+        sh.saveDocumentTo(&doc, tmp_path, tmp_path);
+    }
+    stop = g_get_monotonic_time();
+    std::cout << "Saved " << name << ' ' << iterations << " times in " << (stop - start) / 1000
+              << "ms with the streaming writer.\n";
+
+    fs::remove(tmp_path);
+}
+
+static void benchSaveFile(const fs::path& filename, int iterations) {
+    auto doc = LoadHandler{}.loadDocument(filename);
+    ASSERT_TRUE(doc) << "Unable to load " << filename;
+    benchSaveDocument(*doc, filename.filename().string().c_str(), iterations);
+}
+
+TEST(FileSaveBenchmark, benchmarkHandwrittenText) {
+    benchSaveFile(GET_TESTFILE(u8"benchmark/handwritten-text.xopp"), 25);
+}
+
+TEST(FileSaveBenchmark, benchmarkTypedText) { benchSaveFile(GET_TESTFILE(u8"benchmark/typed-text.xopp"), 1'000); }
+
+TEST(FileSaveBenchmark, benchmarkLatex) { benchSaveFile(GET_TESTFILE(u8"benchmark/latex.xopp"), 50); }
+
+/// Fill the document with 100 pages full of handwriting, with pressure values
+static void addManyStrokes(Document& doc) {
+    GRand* rand = g_rand_new_with_seed(42);
+    for (int p = 0; p < 100; ++p) {
+        const PageRef page = std::make_shared<XojPage>(595, 842);
+        for (int i = 0; i < 2'000; ++i) {
+            auto s = std::make_unique<Stroke>();
+            s->setWidth(1.41);
+            double x = g_rand_double_range(rand, 0, 580);
+            double y = g_rand_double_range(rand, 0, 830);
+            for (int j = 0; j < 40; ++j) {
+                s->addPoint(Point(x, y, g_rand_double_range(rand, 0.5, 2)));
+                x += g_rand_double_range(rand, -0.5, 1);
+                y += g_rand_double_range(rand, -0.5, 0.5);
+            }
+            page->getLayers().front()->addElement(std::move(s));
+        }
+        doc.addPage(page);
+    }
+    g_rand_free(rand);
+}
+
+TEST(FileSaveBenchmark, benchmarkManyStrokes) {
+    DocumentHandler dh;
+    Document doc{&dh};
+    addManyStrokes(doc);
+
+    benchSaveDocument(doc, "100 pages of strokes", 3);
+}
+
+TEST(FileSaveBenchmark, benchmarkCompressionThreads) {
+    DocumentHandler dh;
+    Document doc{&dh};
+    addManyStrokes(doc);
+
+    const auto tmp_path = Util::getTmpDirSubfolder() / "save-benchmark.xopp";
+    for (unsigned int threads: {1U, 2U, 4U, 8U}) {
+        const auto start = g_get_monotonic_time();
+        SaveHandler sh;
+        sh.setCompression({Z_DEFAULT_COMPRESSION, threads});
+        sh.saveDocumentTo(&doc, tmp_path, tmp_path);
+        const auto stop = g_get_monotonic_time();
+        std::cout << "Saved 100 pages of strokes with " << threads << " compression threads in "
+                  << (stop - start) / 1000 << "ms (" << fs::file_size(tmp_path) << " bytes).\n";
+    }
+    fs::remove(tmp_path);
+}
+
+TEST(FileSaveBenchmark, benchmarkNumberFormatting) {
+    constexpr int NB_VALUES = 10'000'000;
+    GRand* rand = g_rand_new_with_seed(42);
+    std::vector<double> values(NB_VALUES);
+    for (double& v: values) {
+        v = g_rand_double_range(rand, 0, 842);
+    }
+    g_rand_free(rand);
+
+    size_t length = 0;
+    char str[Util::NUMBER_STRING_BUF_SIZE];
+
+    auto start = g_get_monotonic_time();
+    for (double v: values) {
+        g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, v);
+        length += std::strlen(str);
+    }
+    auto stop = g_get_monotonic_time();
+    std::cout << "Formatted " << NB_VALUES << " numbers in " << (stop - start) / 1000 << "ms with g_ascii_formatd.\n";
+
+    start = g_get_monotonic_time();
+    for (double v: values) {
+        length += static_cast<size_t>(Util::formatNumber(str, v) - str);
+    }
+    stop = g_get_monotonic_time();
+    std::cout << "Formatted " << NB_VALUES << " numbers in " << (stop - start) / 1000
+              << "ms with Util::formatNumber (" << length << " chars in total).\n";
+}
@@ -0,0 +1,87 @@
+/*
+ * Xournal++
+ *
+ * Benchmark of the lasso selection on a dense page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+#include <glib-2.0/glib.h>
+#include <gtest/gtest.h>
+
+#include "control/tools/Selector.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/PageRef.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+constexpr int NB_STROKES = 50'000;
+constexpr int NB_LASSO_POINTS = 2'000;
+constexpr int ITERATIONS = 5;
+
+/// A hand drawn lasso: a wobbly loop over most of the page
+static auto makeLasso() -> std::unique_ptr<LassoSelector> {
+    GRand* rand = g_rand_new_with_seed(7);
+    auto lasso = std::make_unique<LassoSelector>(297, 71);
+    for (int i = 1; i < NB_LASSO_POINTS; i++) {
+        const double angle = 2 * M_PI * i / NB_LASSO_POINTS - M_PI_2;
+        const double radius = 350 + g_rand_double_range(rand, -20, 20);
+        lasso->currentPos(297 + 0.8 * radius * std::cos(angle), 421 + radius * std::sin(angle));
+    }
+    g_rand_free(rand);
+    return lasso;
+}
+
+TEST(LassoSelectionBenchmark, benchmarkDensePage) {
+    DocumentHandler dh;
+    Document doc{&dh};
+    GRand* rand = g_rand_new_with_seed(42);
+    const PageRef page = std::make_shared<XojPage>(595, 842);
+    for (int i = 0; i < NB_STROKES; ++i) {
+        auto s = std::make_unique<Stroke>();
+        double x = g_rand_double_range(rand, 0, 580);
+        double y = g_rand_double_range(rand, 0, 830);
+        for (int j = 0; j < 20; ++j) {
+            s->addPoint(Point(x, y));
+            x += g_rand_double_range(rand, -0.5, 1);
+            y += g_rand_double_range(rand, -0.5, 0.5);
+        }
+        page->getLayers().front()->addElement(std::move(s));
+    }
+    doc.addPage(page);
+    g_rand_free(rand);
+
+    // Before: every point of every element tested against every edge of the lasso, on one thread
+    size_t selected = 0;
+    auto start = g_get_monotonic_time();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        auto lasso = makeLasso();
+        selected = 0;
+        for (const auto& e: page->getSelectedLayer()->getElementsView()) {
+            selected += e->isInSelection(lasso.get());
+        }
+    }
+    auto stop = g_get_monotonic_time();
+    std::cout << "Lassoed " << selected << " of " << NB_STROKES << " strokes " << ITERATIONS << " times in "
+              << (stop - start) / 1000 << "ms with a linear scan of the edges.\n";
+
+    start = g_get_monotonic_time();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        auto lasso = makeLasso();
+        lasso->finalize(page, true, &doc);
+        selected = lasso->releaseElements().size();
+    }
+    stop = g_get_monotonic_time();
+    std::cout << "Lassoed " << selected << " of " << NB_STROKES << " strokes " << ITERATIONS << " times in "
+              << (stop - start) / 1000 << "ms with Selector::finalize.\n";
+}
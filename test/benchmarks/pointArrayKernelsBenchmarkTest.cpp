@@ -0,0 +1,105 @@
+/*
+ * Xournal++
+ *
+ * Micro-benchmarks of the vectorized loops over the points of strokes
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <glib-2.0/glib.h>
+#include <gtest/gtest.h>
+
+#include "model/PathParameter.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/eraser/PaddedBox.h"
+#include "util/PointArrayKernels.h"
+#include "util/SmallVector.h"
+
+using namespace xoj::util::simd;
+
+constexpr size_t NB_POINTS = 500'000;
+
+static auto makeValues(GRand* rand, size_t n) -> std::vector<double> {
+    std::vector<double> v(n);
+    for (double& d: v) {
+        d = g_rand_double_range(rand, 0, 800);
+    }
+    return v;
+}
+
+/// Runs fn `iterations` times and prints the elapsed time
+template <class Fn>
+static void bench(const char* what, const char* implementation, int iterations, Fn fn) {
+    const auto start = g_get_monotonic_time();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    const auto stop = g_get_monotonic_time();
+    std::cout << what << " (" << implementation << "): " << iterations << " times " << NB_POINTS << " points in "
+              << (stop - start) / 1000 << "ms.\n";
+}
+
+class PointArrayKernelsBenchmark: public ::testing::Test {
+protected:
+    void SetUp() override {
+        GRand* rand = g_rand_new_with_seed(42);
+        xs = makeValues(rand, NB_POINTS);
+        ys = makeValues(rand, NB_POINTS);
+        g_rand_free(rand);
+    }
+
+    std::vector<double> xs;
+    std::vector<double> ys;
+    /// Prevents the compiler from optimizing the calls away
+    volatile double sink = 0;
+};
+
+TEST_F(PointArrayKernelsBenchmark, benchmarkMinMax) {
+    bench("Bounding box", "scalar", 1000, [&]() { sink = scalar::minMax(xs.data(), NB_POINTS).max; });
+    bench("Bounding box", getImplementationName(), 1000, [&]() { sink = minMax(xs.data(), NB_POINTS).max; });
+}
+
+TEST_F(PointArrayKernelsBenchmark, benchmarkTranslate) {
+    bench("Translation", "scalar", 1000, [&]() { scalar::translate(xs.data(), NB_POINTS, 0.5); });
+    bench("Translation", getImplementationName(), 1000, [&]() { translate(xs.data(), NB_POINTS, -0.5); });
+}
+
+TEST_F(PointArrayKernelsBenchmark, benchmarkTransform) {
+    const AffineMatrix rotation = {std::cos(0.01), std::sin(0.01), -std::sin(0.01), std::cos(0.01), 1.0, -1.0};
+    bench("Rotation", "scalar", 1000, [&]() { scalar::transform(xs.data(), ys.data(), NB_POINTS, rotation); });
+    bench("Rotation", getImplementationName(), 1000, [&]() { transform(xs.data(), ys.data(), NB_POINTS, rotation); });
+}
+
+TEST_F(PointArrayKernelsBenchmark, benchmarkFindSegmentTouchingBox) {
+    // Eraser-sized box, that no segment reaches
+    const Box box = {1000, 1000, 1010, 1010};
+    bench("Segment culling", "scalar", 1000,
+          [&]() { sink = scalar::findSegmentTouchingBox(xs.data(), ys.data(), 0, NB_POINTS - 1, box); });
+    bench("Segment culling", getImplementationName(), 1000,
+          [&]() { sink = findSegmentTouchingBox(xs.data(), ys.data(), 0, NB_POINTS - 1, box); });
+}
+
+TEST_F(PointArrayKernelsBenchmark, benchmarkStroke) {
+    Stroke stroke;
+    for (size_t i = 0; i < NB_POINTS; i++) {
+        // A long scribble on the left half of the page
+        stroke.addPoint(Point(xs[i] / 2, ys[i], 1.0));
+    }
+    bench("Stroke::move", getImplementationName(), 1000, [&]() { stroke.move(0.5, 0.5); });
+    bench("Stroke::rotate + bounding box", getImplementationName(), 1000, [&]() {
+        stroke.rotate(200, 400, 0.001);
+        sink = stroke.getBoundingBox().width;
+    });
+    // An eraser on the right half of the page
+    const PaddedBox box{Point(600, 400), 5, 6};
+    bench("Stroke::intersectWithPaddedBox", getImplementationName(), 1000,
+          [&]() { sink = static_cast<double>(stroke.intersectWithPaddedBox(box).size()); });
+}
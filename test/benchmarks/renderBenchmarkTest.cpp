@@ -0,0 +1,117 @@
+/*
+ * Xournal++
+ *
+ * Fixed input benchmark test of the page rendering
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <iostream>
+#include <memory>
+
+#include <cairo.h>
+#include <config-test.h>
+#include <glib-2.0/glib.h>
+#include <gtest/gtest.h>
+
+#include "control/xojfile/LoadHandler.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/Text.h"
+#include "model/XojPage.h"
+#include "view/LayerView.h"
+#include "view/View.h"
+
+constexpr double PAGE_WIDTH = 595;
+constexpr double PAGE_HEIGHT = 842;
+
+/// Fills a layer with short strokes looking like handwriting, covering the whole page
+static auto createDenseLayer(int nbStrokes) -> std::unique_ptr<Layer> {
+    auto layer = std::make_unique<Layer>();
+    GRand* rand = g_rand_new_with_seed(42);
+    for (int i = 0; i < nbStrokes; i++) {
+        auto s = std::make_unique<Stroke>();
+        s->setWidth(1.41);
+        s->setColor(Colors::black);
+        double x = g_rand_double_range(rand, 0, PAGE_WIDTH - 10);
+        double y = g_rand_double_range(rand, 0, PAGE_HEIGHT - 10);
+        for (int j = 0; j < 20; j++) {
+            s->addPoint(Point(x, y, g_rand_double_range(rand, 0.5, 2)));
+            x += g_rand_double_range(rand, -0.5, 1);
+            y += g_rand_double_range(rand, -0.5, 0.5);
+        }
+        layer->addElement(std::move(s));
+    }
+    g_rand_free(rand);
+    return layer;
+}
+
+static void benchRenderRect(const Layer& layer, double x, double y, double width, double height, int iterations) {
+    cairo_surface_t* surface =
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(PAGE_WIDTH), static_cast<int>(PAGE_HEIGHT));
+    cairo_t* cr = cairo_create(surface);
+    cairo_rectangle(cr, x, y, width, height);
+    cairo_clip(cr);
+
+    xoj::view::LayerView view(&layer);
+    const auto start = g_get_monotonic_time();
+    for (int i = 0; i < iterations; ++i) {
+        view.draw(xoj::view::Context::createDefault(cr));
+    }
+    const auto stop = g_get_monotonic_time();
+    std::cout << "Rendered a " << width << "x" << height << " area of a page with "
+              << layer.getElementsView().size() << " elements " << iterations << " times in " << (stop - start) / 1000
+              << "ms.\n";
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+
+TEST(RenderBenchmark, benchmarkSmallRectOnDensePage) {
+    auto layer = createDenseLayer(20'000);
+    // Build the spatial index outside of the measurement
+    benchRenderRect(*layer, 0, 0, PAGE_WIDTH, PAGE_HEIGHT, 1);
+
+    benchRenderRect(*layer, 200, 300, 20, 20, 5'000);
+    benchRenderRect(*layer, 200, 300, 100, 100, 500);
+}
+
+TEST(RenderBenchmark, benchmarkFullPageOnDensePage) {
+    auto layer = createDenseLayer(20'000);
+    benchRenderRect(*layer, 0, 0, PAGE_WIDTH, PAGE_HEIGHT, 10);
+}
+
+/// Fills a layer with paragraphs of typed text, covering the whole page
+static auto createTextLayer(int nbTexts) -> std::unique_ptr<Layer> {
+    auto layer = std::make_unique<Layer>();
+    for (int i = 0; i < nbTexts; i++) {
+        auto t = std::make_unique<Text>();
+        t->setText("Lorem ipsum dolor sit amet, consectetur adipiscing elit.\n"
+                   "Sed do eiusmod tempor incididunt ut labore.");
+        t->setColor(Colors::black);
+        t->setWrap(150);
+        t->setOrigin(150.0 * (i % 4), 20.0 * (i / 4 % 40));
+        layer->addElement(std::move(t));
+    }
+    return layer;
+}
+
+TEST(RenderBenchmark, benchmarkTextPage) {
+    auto layer = createTextLayer(600);
+    benchRenderRect(*layer, 0, 0, PAGE_WIDTH, PAGE_HEIGHT, 50);
+}
+
+TEST(RenderBenchmark, benchmarkTypedTextFile) {
+    auto doc = LoadHandler{}.loadDocument(GET_TESTFILE(u8"benchmark/typed-text.xopp"));
+    ASSERT_TRUE(doc) << "Unable to load typed-text.xopp";
+    for (size_t p = 0; p < doc->getPageCount(); p++) {
+        for (const Layer* l: doc->getPage(p)->getLayersView()) {
+            benchRenderRect(*l, 0, 0, PAGE_WIDTH, PAGE_HEIGHT, 200);
+        }
+    }
+}
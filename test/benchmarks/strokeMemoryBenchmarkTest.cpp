@@ -0,0 +1,86 @@
+/*
+ * Xournal++
+ *
+ * Memory used by the points of the strokes of fixed input documents
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <config-test.h>
+#include <glib-2.0/glib.h>
+#include <gtest/gtest.h>
+
+#include "control/xojfile/LoadHandler.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+#include "filesystem.h"
+
+/// Compares the memory used by the points with what an array of Point would use
+static void reportMemoryUsage(const std::string& name, const std::vector<const Stroke*>& strokes) {
+    size_t nbPoints = 0;
+    size_t used = 0;
+    for (const Stroke* s: strokes) {
+        nbPoints += s->getPointCount();
+        used += s->getPointVector().getMemoryUsage();
+    }
+    std::cout << name << ": " << strokes.size() << " strokes, " << nbPoints << " points use " << used / 1024
+              << "kB (" << nbPoints * sizeof(Point) / 1024 << "kB as an array of Point).\n";
+}
+
+static void benchDocument(const fs::path& filename) {
+    auto doc = LoadHandler{}.loadDocument(filename);
+    ASSERT_TRUE(doc) << "Unable to load " << filename;
+
+    std::vector<const Stroke*> strokes;
+    for (size_t p = 0; p < doc->getPageCount(); p++) {
+        for (const Layer* l: doc->getPage(p)->getLayersView()) {
+            for (const Element* e: l->getElementsView()) {
+                if (e->getType() == ELEMENT_STROKE) {
+                    strokes.push_back(static_cast<const Stroke*>(e));
+                }
+            }
+        }
+    }
+    reportMemoryUsage(filename.filename().string(), strokes);
+}
+
+TEST(StrokeMemoryBenchmark, benchmarkTypedText) { benchDocument(GET_TESTFILE(u8"benchmark/typed-text.xopp")); }
+
+TEST(StrokeMemoryBenchmark, benchmarkLatex) { benchDocument(GET_TESTFILE(u8"benchmark/latex.xopp")); }
+
+TEST(StrokeMemoryBenchmark, benchmarkHandwriting) {
+    // Half of the strokes with pressure values, half without
+    std::vector<std::unique_ptr<Stroke>> strokes;
+    GRand* rand = g_rand_new_with_seed(42);
+    for (int i = 0; i < 20'000; i++) {
+        auto s = std::make_unique<Stroke>();
+        double x = g_rand_double_range(rand, 0, 500);
+        double y = g_rand_double_range(rand, 0, 800);
+        for (int j = 0; j < 50; j++) {
+            s->addPoint(Point(x, y, i % 2 ? g_rand_double_range(rand, 0.5, 2) : Point::NO_PRESSURE));
+            x += g_rand_double_range(rand, -0.5, 1);
+            y += g_rand_double_range(rand, -0.5, 0.5);
+        }
+        s->freeUnusedPointItems();
+        strokes.push_back(std::move(s));
+    }
+    g_rand_free(rand);
+
+    std::vector<const Stroke*> view;
+    for (const auto& s: strokes) {
+        view.push_back(s.get());
+    }
+    reportMemoryUsage("Random handwriting", view);
+}
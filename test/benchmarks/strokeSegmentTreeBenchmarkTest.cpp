@@ -0,0 +1,114 @@
+/*
+ * Xournal++
+ *
+ * Micro-benchmarks of the queries on long strokes
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <glib-2.0/glib.h>
+#include <gtest/gtest.h>
+
+#include "model/PathParameter.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeSegmentTree.h"
+#include "model/eraser/PaddedBox.h"
+#include "util/SmallVector.h"
+
+constexpr size_t NB_POINTS = 20'000;
+constexpr int NB_QUERIES = 10'000;
+
+/// Runs fn `iterations` times and prints the elapsed time
+template <class Fn>
+static void bench(const char* what, int iterations, Fn fn) {
+    const auto start = g_get_monotonic_time();
+    for (int i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    const auto stop = g_get_monotonic_time();
+    std::cout << what << ": " << iterations << " times on " << NB_POINTS << " points in " << (stop - start) / 1000
+              << "ms.\n";
+}
+
+class StrokeSegmentTreeBenchmark: public ::testing::Test {
+protected:
+    void SetUp() override {
+        GRand* rand = g_rand_new_with_seed(42);
+        // A hand drawn diagram: a long random walk over the page
+        double x = 300;
+        double y = 400;
+        for (size_t i = 0; i < NB_POINTS; i++) {
+            x = std::clamp(x + g_rand_double_range(rand, -3, 3), 0.0, 600.0);
+            y = std::clamp(y + g_rand_double_range(rand, -3, 3), 0.0, 800.0);
+            stroke.addPoint(Point(x, y, 1.5));
+        }
+        for (int i = 0; i < NB_QUERIES; i++) {
+            queries.emplace_back(g_rand_double_range(rand, 0, 600), g_rand_double_range(rand, 0, 800));
+        }
+        g_rand_free(rand);
+
+        // The same segments in strokes too short to use a segment tree, i.e. scanned linearly
+        const size_t step = StrokeSegmentTree::MIN_POINTS / 2;
+        for (size_t first = 0; first + 1 < NB_POINTS; first += step) {
+            auto& part = parts.emplace_back(std::make_unique<Stroke>());
+            for (size_t i = first; i <= std::min(first + step, NB_POINTS - 1); i++) {
+                part->addPoint(stroke.getPoint(i));
+            }
+        }
+    }
+
+    Stroke stroke;
+    std::vector<std::unique_ptr<Stroke>> parts;
+    std::vector<Point> queries;
+    /// Prevents the compiler from optimizing the calls away
+    volatile double sink = 0;
+};
+
+TEST_F(StrokeSegmentTreeBenchmark, benchmarkDistanceTo) {
+    bench("Stroke::distanceTo, linear scan", NB_QUERIES, [&](int i) {
+        double d = std::numeric_limits<double>::max();
+        for (auto& part: parts) {
+            d = std::min(d, part->distanceTo(queries[i].x, queries[i].y));
+        }
+        sink = d;
+    });
+    bench("Stroke::distanceTo, segment tree", NB_QUERIES,
+          [&](int i) { sink = stroke.distanceTo(queries[i].x, queries[i].y); });
+}
+
+TEST_F(StrokeSegmentTreeBenchmark, benchmarkIntersects) {
+    bench("Stroke::intersects, linear scan", NB_QUERIES, [&](int i) {
+        bool hit = false;
+        for (auto& part: parts) {
+            hit = hit || part->intersects(queries[i].x, queries[i].y, 5);
+        }
+        sink = hit;
+    });
+    bench("Stroke::intersects, segment tree", NB_QUERIES,
+          [&](int i) { sink = stroke.intersects(queries[i].x, queries[i].y, 5); });
+}
+
+TEST_F(StrokeSegmentTreeBenchmark, benchmarkIntersectWithPaddedBox) {
+    bench("Stroke::intersectWithPaddedBox, segment tree", NB_QUERIES, [&](int i) {
+        const PaddedBox box{queries[i], 5, 6};
+        sink = static_cast<double>(stroke.intersectWithPaddedBox(box).size());
+    });
+}
+
+TEST_F(StrokeSegmentTreeBenchmark, benchmarkRebuild) {
+    // Every change of the stroke drops the tree: the next query builds it again
+    bench("Stroke::move + distanceTo", 1000, [&](int i) {
+        stroke.move(0.5, 0.5);
+        sink = stroke.distanceTo(queries[i].x, queries[i].y);
+    });
+}
@@ -0,0 +1,192 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/xojfile/AutosaveJournal.h"
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/OutputStream.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+static void addStroke(const PageRef& page, double x, double y) {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(1.5);
+    for (int i = 0; i < 10; i++) {
+        s->addPoint(Point(x + i, y + 0.5 * i));
+    }
+    page->getLayers().front()->addElement(std::move(s));
+}
+
+static auto newPage(double x) -> PageRef {
+    auto page = std::make_shared<XojPage>(595, 842);
+    addStroke(page, x, 10);
+    return page;
+}
+
+/// The document as it would be written by a full save
+static auto toString(const Document& doc) -> std::string {
+    SaveHandler handler;
+    StringOutputStream out;
+    const auto target = Util::getTmpDirSubfolder() / "journal.xopp";
+    handler.saveDocumentTo(&doc, target, &out, target);
+    return out.takeString();
+}
+
+static void fullAutosave(AutosaveJournal& journal, const Document& doc, const fs::path& file) {
+    auto base = journal.prepareBase();
+    SaveHandler handler;
+    handler.saveDocumentTo(&doc, file, file);
+    ASSERT_TRUE(handler.getErrorMessage().empty()) << handler.getErrorMessage();
+    journal.setBase(std::move(base), file);
+}
+
+TEST(ControlAutosaveJournal, testReplay) {
+    const auto file = Util::getTmpDirSubfolder() / "journal-test.autosave.xopp";
+    DocumentHandler dh;
+    Document doc(&dh);
+    for (int i = 0; i < 4; i++) {
+        doc.addPage(newPage(10.0 * i));
+    }
+
+    AutosaveJournal journal(&doc);
+    EXPECT_TRUE(journal.hasChanges());
+    EXPECT_FALSE(journal.canAppend(file));
+    fullAutosave(journal, doc, file);
+    EXPECT_FALSE(journal.hasChanges());
+    EXPECT_TRUE(journal.canAppend(file));
+
+    // Change a page
+    addStroke(doc.getPage(1), 100, 100);
+    journal.undoRedoPageChanged(doc.getPage(1));
+    EXPECT_TRUE(journal.hasChanges());
+    EXPECT_EQ(journal.append(file), "");
+    EXPECT_FALSE(journal.hasChanges());
+
+    // Insert, delete and move pages: the unchanged pages are taken from the base or the first record
+    doc.insertPage(newPage(200), 0);
+    journal.pageInserted(0);
+    doc.deletePage(3);
+    auto last = doc.getPage(3);
+    doc.deletePage(3);
+    doc.insertPage(last, 1);
+    journal.pageInserted(1);
+    EXPECT_EQ(journal.append(file), "");
+
+    const auto expected = toString(doc);
+    auto recovered = LoadHandler().loadDocument(file);
+    ASSERT_TRUE(recovered);
+    EXPECT_EQ(recovered->getPageCount(), doc.getPageCount());
+    EXPECT_EQ(toString(*recovered), expected);
+
+    AutosaveJournal::remove(file);
+    EXPECT_FALSE(fs::exists(AutosaveJournal::getJournalPath(file)));
+    fs::remove(file);
+}
+
+TEST(ControlAutosaveJournal, testChangesAfterTheUndoActionAreWritten) {
+    const auto file = Util::getTmpDirSubfolder() / "journal-test.autosave.xopp";
+    DocumentHandler dh;
+    Document doc(&dh);
+    for (int i = 0; i < 3; i++) {
+        doc.addPage(newPage(10.0 * i));
+    }
+
+    AutosaveJournal journal(&doc);
+    fullAutosave(journal, doc, file);
+
+    // The undo action is recorded when the erasing starts...
+    auto page = doc.getPage(2);
+    addStroke(page, 100, 100);
+    journal.undoRedoPageChanged(page);
+    EXPECT_EQ(journal.append(file), "");
+    EXPECT_FALSE(journal.hasChanges());
+
+    // ... and the page keeps changing afterwards, without any notification
+    Layer* layer = page->getLayers().front();
+    layer->removeElement(layer->getElementsView().front());
+    EXPECT_TRUE(journal.hasChanges());
+    EXPECT_EQ(journal.append(file), "");
+    EXPECT_FALSE(journal.hasChanges());
+
+    // Moving a page is a change of the document, even if no page changed
+    auto first = doc.getPage(0);
+    doc.deletePage(0);
+    doc.insertPage(first, 1);
+    EXPECT_TRUE(journal.hasChanges());
+    EXPECT_EQ(journal.append(file), "");
+
+    EXPECT_EQ(toString(*LoadHandler().loadDocument(file)), toString(doc));
+
+    AutosaveJournal::remove(file);
+    fs::remove(file);
+}
+
+TEST(ControlAutosaveJournal, testCompaction) {
+    const auto file = Util::getTmpDirSubfolder() / "journal-test.autosave.xopp";
+    DocumentHandler dh;
+    Document doc(&dh);
+    doc.addPage(newPage(0));
+
+    AutosaveJournal journal(&doc);
+    fullAutosave(journal, doc, file);
+
+    // After too many records, the whole document has to be saved again
+    size_t records = 0;
+    while (journal.canAppend(file)) {
+        addStroke(doc.getPage(0), 1.0 * records, 50);
+        journal.undoRedoPageChanged(doc.getPage(0));
+        ASSERT_EQ(journal.append(file), "");
+        records++;
+        ASSERT_LT(records, 1000U);
+    }
+    EXPECT_GT(records, 1U);
+    EXPECT_EQ(toString(*LoadHandler().loadDocument(file)), toString(doc));
+
+    fullAutosave(journal, doc, file);
+    EXPECT_FALSE(fs::exists(AutosaveJournal::getJournalPath(file)));
+    EXPECT_TRUE(journal.canAppend(file));
+
+    // Replacing the document always requires a full autosave
+    journal.documentChanged(DOCUMENT_CHANGE_COMPLETE);
+    EXPECT_FALSE(journal.canAppend(file));
+
+    fs::remove(file);
+}
+
+TEST(ControlAutosaveJournal, testOutdatedJournalIsIgnored) {
+    const auto file = Util::getTmpDirSubfolder() / "journal-test.autosave.xopp";
+    DocumentHandler dh;
+    Document doc(&dh);
+    doc.addPage(newPage(0));
+
+    AutosaveJournal journal(&doc);
+    fullAutosave(journal, doc, file);
+    const auto base = toString(doc);
+
+    addStroke(doc.getPage(0), 300, 300);
+    journal.undoRedoPageChanged(doc.getPage(0));
+    EXPECT_EQ(journal.append(file), "");
+
+    // The autosave file is replaced by another program: the journal does not apply to it anymore
+    Document other(&dh);
+    other.addPage(newPage(0));
+    SaveHandler handler;
+    handler.saveDocumentTo(&other, file, file);
+    fs::last_write_time(file, fs::last_write_time(file) + std::chrono::seconds(10));
+
+    EXPECT_FALSE(journal.canAppend(file));
+    EXPECT_EQ(toString(*LoadHandler().loadDocument(file)), base);
+
+    AutosaveJournal::remove(file);
+    fs::remove(file);
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/tools/EraseHandler.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "util/Point.h"
+
+using Pt = xoj::util::Point<double>;
+
+TEST(ControlEraseHandler, testSweptPositions) {
+    // A fast motion: the squares fill the gap between the two events
+    auto positions = EraseHandler::getSweptPositions(Pt(0, 0), {Pt(10, 0)}, 3);
+    ASSERT_EQ(positions.size(), 4U);
+    EXPECT_DOUBLE_EQ(positions[0].x, 2.5);
+    EXPECT_DOUBLE_EQ(positions[3].x, 10);
+    for (const auto& p: positions) {
+        EXPECT_EQ(p.y, 0);
+    }
+
+    // Dense events: one square per event, the ones which did not move are dropped
+    positions = EraseHandler::getSweptPositions(Pt(0, 0), {Pt(1, 1), Pt(1, 1), Pt(2, 1)}, 3);
+    ASSERT_EQ(positions.size(), 2U);
+    EXPECT_EQ(positions[0].x, 1);
+    EXPECT_EQ(positions[1].x, 2);
+
+    // Along a polyline, the squares are never farther apart than the step
+    const std::vector<Pt> path = {Pt(5, 5), Pt(-20, 17), Pt(30, -40)};
+    positions = EraseHandler::getSweptPositions(Pt(0, 0), path, 2);
+    Pt last(0, 0);
+    for (const auto& p: positions) {
+        EXPECT_LE(std::hypot(p.x - last.x, p.y - last.y), 2 + 1e-9);
+        last = p;
+    }
+    EXPECT_DOUBLE_EQ(last.x, 30);
+    EXPECT_DOUBLE_EQ(last.y, -40);
+}
+
+TEST(ControlEraseHandler, testBatchedErase) {
+    // A vertical stroke between two sparse eraser events
+    Stroke stroke;
+    stroke.setWidth(1);
+    for (int i = 0; i <= 20; i++) {
+        stroke.addPoint(Point(50, i * 5));
+    }
+    const double h = 2;
+    const std::vector<Pt> path = {Pt(0, 40), Pt(100, 60)};
+
+    // Neither event touches the stroke, but the path between them does
+    EXPECT_FALSE(stroke.intersects(path[0].x, path[0].y, h));
+    EXPECT_FALSE(stroke.intersects(path[1].x, path[1].y, h));
+    EXPECT_TRUE(stroke.intersectsSweptPath(path, h));
+
+    // The single test of the path agrees with the test at each of the swept positions
+    const auto positions = EraseHandler::getSweptPositions(path[0], {path[1]}, h);
+    EXPECT_TRUE(std::any_of(positions.begin(), positions.end(),
+                            [&](const Pt& p) { return stroke.intersects(p.x, p.y, h); }));
+
+    // Paths passing by the stroke
+    EXPECT_FALSE(stroke.intersectsSweptPath({Pt(0, 40), Pt(45, 40), Pt(45, 90)}, h));
+    EXPECT_FALSE(stroke.intersectsSweptPath({Pt(50, 120), Pt(60, 200)}, h));
+    // A single position
+    EXPECT_TRUE(stroke.intersectsSweptPath({Pt(51, 33)}, h));
+    EXPECT_FALSE(stroke.intersectsSweptPath({Pt(55, 33)}, h));
+
+    // Long strokes are looked up in their segment tree
+    Stroke longStroke;
+    longStroke.setWidth(1);
+    for (int i = 0; i <= 2000; i++) {
+        longStroke.addPoint(Point(50 + (i % 2), i * 0.5));
+    }
+    EXPECT_TRUE(longStroke.intersectsSweptPath(path, h));
+    EXPECT_TRUE(longStroke.intersectsSweptPath({Pt(0, 900), Pt(100, 950)}, h));
+    EXPECT_FALSE(longStroke.intersectsSweptPath({Pt(0, 900), Pt(45, 950)}, h));
+    EXPECT_FALSE(longStroke.intersectsSweptPath({Pt(0, 1100), Pt(100, 1200)}, h));
+}
@@ -0,0 +1,66 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "control/tools/Selector.h"
+
+/// Gives access to the edge buckets, built by Selector::finalize() otherwise
+class TestLassoSelector: public LassoSelector {
+public:
+    using LassoSelector::LassoSelector;
+    using LassoSelector::prepareContains;
+};
+
+static auto makeLasso(const std::vector<Selector::BoundaryPoint>& points) -> std::unique_ptr<TestLassoSelector> {
+    auto lasso = std::make_unique<TestLassoSelector>(points.front().x, points.front().y);
+    for (size_t i = 1; i < points.size(); i++) {
+        lasso->currentPos(points[i].x, points[i].y);
+    }
+    return lasso;
+}
+
+TEST(ControlLassoSelector, testEdgeBucketsMatchLinearScan) {
+    GRand* rand = g_rand_new_with_seed(42);
+    // A self-intersecting star shaped lasso, with integer coordinates and horizontal edges
+    std::vector<Selector::BoundaryPoint> points;
+    for (int i = 0; i < 2000; i++) {
+        const double angle = 0.037 * i;
+        const double radius = g_rand_double_range(rand, 20, 250);
+        points.emplace_back(std::round(300 + radius * std::cos(angle)), std::round(300 + radius * std::sin(angle)));
+    }
+    auto lasso = makeLasso(points);
+    auto buckets = makeLasso(points);
+    buckets->prepareContains();
+    for (int i = 0; i < 20000; i++) {
+        // Also on the vertices, where rounding matters
+        const bool onGrid = i % 2 == 0;
+        double x = g_rand_double_range(rand, 0, 600);
+        double y = g_rand_double_range(rand, 0, 600);
+        if (onGrid) {
+            x = std::round(x);
+            y = std::round(y);
+        }
+        ASSERT_EQ(buckets->contains(x, y), lasso->contains(x, y)) << x << ", " << y;
+    }
+    g_rand_free(rand);
+}
+
+TEST(ControlLassoSelector, testEdgeBucketsWithInfiniteVertices) {
+    // What extendAtPageEdges() produces for a lasso touching the top of the page
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    const std::vector<Selector::BoundaryPoint> points = {{100, 100}, {100, -INF}, {200, -INF}, {200, 100}, {150, 200}};
+    auto lasso = makeLasso(points);
+    auto buckets = makeLasso(points);
+    buckets->prepareContains();
+    for (double x: {50.0, 120.0, 150.0, 199.0, 250.0}) {
+        for (double y: {-1e9, -10.0, 50.0, 100.0, 150.0, 199.0, 300.0}) {
+            EXPECT_EQ(buckets->contains(x, y), lasso->contains(x, y)) << x << ", " << y;
+        }
+    }
+    EXPECT_TRUE(buckets->contains(150, -1e9));
+    EXPECT_FALSE(buckets->contains(50, 50));
+}
@@ -16,15 +16,18 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include <config-test.h>
 #include <gtest/gtest.h>
+#include <zip.h>
 
 #include "control/xojfile/LoadHandler.h"
 #include "control/xojfile/SaveHandler.h"
+#include "model/BackgroundImage.h"
 #include "model/Element.h"
 #include "model/Image.h"
 #include "model/Link.h"
@@ -37,6 +40,7 @@
 #include "model/TextAlignment.h"
 #include "model/XojPage.h"
 #include "util/Color.h"
+#include "util/OutputStream.h"
 #include "util/PathUtil.h"
 #include "util/StringUtils.h"
 
@@ -703,7 +707,7 @@ TEST(ControlLoadHandler, testStrokeWidthRecovery) {
     auto* s1 = dynamic_cast<const Stroke*>(layer->getElementsView()[0]);
     EXPECT_NE(s1, nullptr);
     EXPECT_EQ(ELEMENT_STROKE, s1->getType());
-    for (auto& p: s1->getPointVector()) {
+    for (const auto& p: s1->getPointVector()) {
         EXPECT_EQ(p.z, Point::NO_PRESSURE);
     }
 
@@ -843,3 +847,259 @@ TEST(ControlLoadHandler, testUrlLink) {
     check_link(3, u8"Other non-ASCII characters:\nHæuñßéř, dǒńg-bǎǐ, łúčný, qǐng-wèn, vò-địâ",
                u8"mailto:françois.rené@café-crème.fr", TextAlignment::RIGHT);
 }
+
+TEST(ControlLoadHandler, testStreamingSaveMatchesTreeSave) {
+    for (auto file: {u8"packaged_xopp/suite.xopp", u8"load/pages.xopp", u8"load/image.xopp", u8"load/text.xopp",
+                     u8"load/latex.xopp", u8"load/links.xopp", u8"packaged_xopp/testPreview.xopp"}) {
+        auto doc = loadTestDocument(GET_TESTFILE(file));
+        ASSERT_TRUE(doc) << "Unable to load test file \"" << char_cast(file) << "\"";
+
+        const auto target = Util::getTmpDirSubfolder() / "save.xopp";
+
+        SaveHandler treeSaver;
+        StringOutputStream treeOut;
+        treeSaver.prepareSave(doc.get(), target);
+        treeSaver.saveTo(&treeOut, target);
+
+        SaveHandler streamSaver;
+        StringOutputStream streamOut;
+        streamSaver.saveDocumentTo(doc.get(), target, &streamOut, target);
+
+        EXPECT_FALSE(streamOut.getString().empty());
+        EXPECT_EQ(treeOut.getString(), streamOut.getString()) << "in \"" << char_cast(file) << "\"";
+        EXPECT_EQ(treeSaver.getErrorMessage(), streamSaver.getErrorMessage());
+    }
+}
+
+TEST(ControlLoadHandler, testLazyLoadingMatchesFullLoading) {
+    for (auto file: {u8"packaged_xopp/suite.xopp", u8"load/pages.xopp", u8"load/layers.xopp", u8"load/image.xopp",
+                     u8"load/text.xopp", u8"load/latex.xopp", u8"load/links.xopp", u8"load/strokes.xopp"}) {
+        auto doc = loadTestDocument(GET_TESTFILE(file));
+        ASSERT_TRUE(doc) << "Unable to load test file \"" << char_cast(file) << "\"";
+
+        LoadHandler handler;
+        handler.setLazyLoading(true);
+        auto lazyDoc = handler.loadDocument(GET_TESTFILE(file));
+        ASSERT_EQ(lazyDoc->getPageCount(), doc->getPageCount());
+        for (size_t i = 0; i < lazyDoc->getPageCount(); i++) {
+            EXPECT_FALSE(lazyDoc->getPage(i)->isContentLoaded()) << "page " << i << " in \"" << char_cast(file) << "\"";
+            EXPECT_EQ(lazyDoc->getPage(i)->getBackgroundType(), doc->getPage(i)->getBackgroundType());
+        }
+
+        // Saving the document loads all the pages
+        const auto target = Util::getTmpDirSubfolder() / "save.xopp";
+        StringOutputStream out;
+        StringOutputStream lazyOut;
+        SaveHandler().saveDocumentTo(doc.get(), target, &out, target);
+        SaveHandler().saveDocumentTo(lazyDoc.get(), target, &lazyOut, target);
+        EXPECT_EQ(out.getString(), lazyOut.getString()) << "in \"" << char_cast(file) << "\"";
+        EXPECT_TRUE(lazyDoc->getPage(0)->isContentLoaded());
+    }
+}
+
+TEST(ControlLoadHandler, testCorruptLazyPageIsNotSaved) {
+    const auto file = Util::getTmpDirSubfolder() / "corrupt-page.xopp";
+    const std::string page = R"(<page width="612" height="792"><background type="solid" color="#ffffffff" )"
+                             R"(style="plain"/><layer><text font="Sans" size="12" x="10" y="10" color="#000000ff">)";
+    std::string xml = R"(<?xml version="1.0" standalone="no"?><xournal creator="test" fileversion="4">)";
+    xml += page + "intact</text></layer></page>";
+    // The text of the second page is cut off
+    xml += page + "trunc</layer></page>";
+    xml += "</xournal>\n";
+    {
+        GzOutputStream out(file);
+        out.write(xml.data(), xml.size());
+        out.close();
+    }
+    const auto before = fs::file_size(file);
+
+    std::vector<std::string> reported;
+    LoadHandler handler;
+    handler.setLazyLoading(true, [&reported](const std::string& error) { reported.push_back(error); });
+    auto doc = handler.loadDocument(file);
+    ASSERT_TRUE(doc);
+    ASSERT_EQ(doc->getPageCount(), 2U);
+    EXPECT_TRUE(doc->getPage(0)->getContentError().empty());
+    EXPECT_TRUE(reported.empty());
+
+    // The error is reported when the page is loaded...
+    EXPECT_FALSE(doc->getPage(1)->getContentError().empty());
+    EXPECT_EQ(reported.size(), 1U);
+
+    // ... and the file is not overwritten with the empty page
+    SaveHandler saver;
+    saver.saveDocumentTo(doc.get(), file, file);
+    EXPECT_FALSE(saver.getErrorMessage().empty());
+    SaveHandler serializer;
+    EXPECT_FALSE(serializer.serializeDocument(doc.get(), file, false));
+    serializer.writeSerializedTo(file);
+    EXPECT_EQ(fs::file_size(file), before);
+
+    // The rest of the document can be saved once the page is deleted
+    doc->deletePage(1);
+    SaveHandler fixedSaver;
+    fixedSaver.saveDocumentTo(doc.get(), file, file);
+    EXPECT_TRUE(fixedSaver.getErrorMessage().empty()) << fixedSaver.getErrorMessage();
+    EXPECT_EQ(LoadHandler().loadDocument(file)->getPageCount(), 1U);
+    fs::remove(file);
+}
+
+TEST(ControlLoadHandler, testParallelParsingMatchesFullLoading) {
+    for (auto file: {u8"packaged_xopp/suite.xopp", u8"load/pages.xopp", u8"load/layers.xopp", u8"load/image.xopp",
+                     u8"load/text.xopp", u8"load/latex.xopp", u8"load/links.xopp", u8"load/strokes.xopp"}) {
+        auto doc = loadTestDocument(GET_TESTFILE(file));
+        ASSERT_TRUE(doc) << "Unable to load test file \"" << char_cast(file) << "\"";
+
+        std::vector<std::string> errors;
+        LoadHandler(&errors).loadDocument(GET_TESTFILE(file));
+        std::vector<std::string> parallelErrors;
+        LoadHandler handler(&parallelErrors);
+        handler.setParsingThreads(4);
+        auto parallelDoc = handler.loadDocument(GET_TESTFILE(file));
+        ASSERT_EQ(parallelDoc->getPageCount(), doc->getPageCount());
+        EXPECT_EQ(parallelErrors.size(), errors.size()) << "in \"" << char_cast(file) << "\"";
+        for (size_t i = 0; i < parallelDoc->getPageCount(); i++) {
+            EXPECT_TRUE(parallelDoc->getPage(i)->isContentLoaded()) << "page " << i;
+        }
+
+        const auto target = Util::getTmpDirSubfolder() / "save.xopp";
+        StringOutputStream out;
+        StringOutputStream parallelOut;
+        SaveHandler().saveDocumentTo(doc.get(), target, &out, target);
+        SaveHandler().saveDocumentTo(parallelDoc.get(), target, &parallelOut, target);
+        EXPECT_EQ(out.getString(), parallelOut.getString()) << "in \"" << char_cast(file) << "\"";
+    }
+}
+
+TEST(ControlLoadHandler, testSerializedSaveDoesNotNeedTheDocument) {
+    for (bool chunked: {false, true}) {
+        auto doc = loadTestDocument(GET_TESTFILE(u8"load/layers.xopp"));
+        ASSERT_TRUE(doc);
+        const auto target = Util::getTmpDirSubfolder() / "save.xopp";
+        StringOutputStream out;
+        SaveHandler().saveDocumentTo(doc.get(), target, &out, target);
+
+        const auto file = Util::getTmpDirSubfolder() / "serialized.xopp";
+        SaveHandler saver;
+        saver.serializeDocument(doc.get(), file, chunked);
+        // The document may change once it is serialized
+        doc->getPage(0)->getLayers().front()->clearNoFree();
+        doc->deletePage(0);
+        saver.writeSerializedTo(file);
+        ASSERT_TRUE(saver.getErrorMessage().empty()) << saver.getErrorMessage();
+
+        auto savedDoc = LoadHandler().loadDocument(file);
+        ASSERT_TRUE(savedDoc);
+        StringOutputStream savedOut;
+        SaveHandler().saveDocumentTo(savedDoc.get(), target, &savedOut, target);
+        EXPECT_EQ(out.getString(), savedOut.getString()) << "chunked: " << chunked;
+        fs::remove(file);
+    }
+}
+
+TEST(ControlLoadHandler, testChunkedRoundTrip) {
+    for (auto file: {u8"load/layers.xopp", u8"load/image.xopp", u8"load/text.xopp", u8"load/latex.xopp",
+                     u8"load/links.xopp", u8"load/strokes.xopp"}) {
+        auto doc = loadTestDocument(GET_TESTFILE(file));
+        ASSERT_TRUE(doc) << "Unable to load test file \"" << char_cast(file) << "\"";
+
+        const auto chunkedFile = Util::getTmpDirSubfolder() / "chunked.xopp";
+        SaveHandler chunkedSaver;
+        chunkedSaver.saveChunkedTo(doc.get(), chunkedFile, chunkedFile);
+        ASSERT_TRUE(chunkedSaver.getErrorMessage().empty()) << chunkedSaver.getErrorMessage();
+
+        const auto target = Util::getTmpDirSubfolder() / "save.xopp";
+        StringOutputStream out;
+        SaveHandler().saveDocumentTo(doc.get(), target, &out, target);
+
+        for (bool lazy: {false, true}) {
+            LoadHandler handler;
+            handler.setLazyLoading(lazy);
+            auto chunkedDoc = handler.loadDocument(chunkedFile);
+            ASSERT_EQ(chunkedDoc->getPageCount(), doc->getPageCount());
+            EXPECT_EQ(chunkedDoc->getPage(0)->isContentLoaded(), !lazy);
+
+            StringOutputStream chunkedOut;
+            SaveHandler().saveDocumentTo(chunkedDoc.get(), target, &chunkedOut, target);
+            EXPECT_EQ(out.getString(), chunkedOut.getString()) << "in \"" << char_cast(file) << "\", lazy: " << lazy;
+        }
+        fs::remove(chunkedFile);
+    }
+}
+
+TEST(ControlLoadHandler, testChunkedImageDeduplication) {
+    auto doc = loadTestDocument(GET_TESTFILE(u8"load/image.xopp"));
+    ASSERT_TRUE(doc);
+    Layer* layer = doc->getPage(0)->getLayers().front();
+    const auto* img = dynamic_cast<const Image*>(layer->getElementsView()[0]);
+    ASSERT_NE(img, nullptr);
+    for (int i = 0; i < 3; i++) {
+        layer->addElement(img->clone());
+    }
+
+    const auto chunkedFile = Util::getTmpDirSubfolder() / "chunked-images.xopp";
+    SaveHandler saver;
+    saver.saveChunkedTo(doc.get(), chunkedFile, chunkedFile);
+    ASSERT_TRUE(saver.getErrorMessage().empty()) << saver.getErrorMessage();
+
+    // The data is stored once
+    zip_t* zip = zip_open(char_cast(chunkedFile.u8string().c_str()), ZIP_RDONLY, nullptr);
+    ASSERT_NE(zip, nullptr);
+    size_t imageEntries = 0;
+    for (zip_int64_t i = 0; i < zip_get_num_entries(zip, 0); i++) {
+        imageEntries += std::string_view(zip_get_name(zip, static_cast<zip_uint64_t>(i), 0)).starts_with("images/");
+    }
+    zip_discard(zip);
+    EXPECT_EQ(imageEntries, 1U);
+
+    // The loaded images share it again
+    for (bool lazy: {false, true}) {
+        LoadHandler handler;
+        handler.setLazyLoading(lazy);
+        auto loaded = handler.loadDocument(chunkedFile);
+        ASSERT_TRUE(loaded);
+        const auto& elements = loaded->getPage(0)->getLayersView().front()->getElementsView();
+        ASSERT_EQ(elements.size(), 4U);
+        const auto* first = dynamic_cast<const Image*>(elements[0]);
+        ASSERT_NE(first, nullptr);
+        EXPECT_EQ(first->getRawDataLength(), img->getRawDataLength());
+        for (const auto* e: elements) {
+            EXPECT_EQ(dynamic_cast<const Image*>(e)->getSharedData(), first->getSharedData());
+        }
+    }
+    fs::remove(chunkedFile);
+}
+
+TEST(ControlLoadHandler, testBackgroundImagesWithSameData) {
+    // Two copies of the same image
+    const auto dir = Util::getTmpDirSubfolder();
+    const auto first = dir / "same-a.png";
+    const auto second = dir / "same-b.png";
+    for (const auto& copy: {first, second}) {
+        fs::copy_file(GET_TESTFILE(u8"load/pages.xopp.bg_1.png"), copy, fs::copy_options::overwrite_existing);
+    }
+
+    BackgroundImage::PixbufPool pool;
+    BackgroundImage a;
+    BackgroundImage b;
+    a.loadFile(first, nullptr, &pool);
+    b.loadFile(second, nullptr, &pool);
+    ASSERT_NE(a.getPixbuf(), nullptr);
+
+    // Only the decoded image is shared
+    EXPECT_EQ(a.getPixbuf(), b.getPixbuf());
+    EXPECT_EQ(a.getFilepath(), first);
+    EXPECT_EQ(b.getFilepath(), second);
+    a.setAttach(true);
+    a.setCloneId(3);
+    EXPECT_FALSE(b.isAttached());
+    EXPECT_EQ(b.getCloneId(), -1);
+
+    // Without a pool, nothing is shared
+    BackgroundImage c;
+    c.loadFile(first, nullptr);
+    EXPECT_NE(c.getPixbuf(), a.getPixbuf());
+
+    fs::remove(first);
+    fs::remove(second);
+}
@@ -0,0 +1,59 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "control/jobs/Job.h"
+#include "control/jobs/Scheduler.h"
+
+/// Counts how many jobs run on the same source at a time
+struct JobSource {
+    std::atomic<int> running{0};
+    std::atomic<int> maxRunning{0};
+    std::atomic<int> done{0};
+};
+
+class CountingJob: public Job {
+public:
+    CountingJob(JobSource* source, JobType type): source(source), type(type) {}
+
+    JobType getType() override { return type; }
+    void* getSource() override { return source; }
+
+protected:
+    void run() override {
+        const int n = ++source->running;
+        int max = source->maxRunning;
+        while (n > max && !source->maxRunning.compare_exchange_weak(max, n)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        source->running--;
+        source->done++;
+    }
+
+private:
+    JobSource* source;
+    JobType type;
+};
+
+TEST(ControlScheduler, testJobsOfAnyTypeOnOneSourceDoNotOverlap) {
+    Scheduler scheduler;
+    scheduler.setRenderWorkerCount(4);
+    scheduler.start();
+
+    JobSource source;
+    constexpr int JOB_COUNT = 40;
+    for (int i = 0; i < JOB_COUNT; i++) {
+        auto* job = new CountingJob(&source, i % 2 ? JOB_TYPE_RENDER : JOB_TYPE_RENDER_DRAFT);
+        scheduler.addJob(job, i % 2 ? JOB_PRIORITY_URGENT : JOB_PRIORITY_HIGH);
+        job->unref();
+    }
+
+    for (int i = 0; i < 1000 && source.done < JOB_COUNT; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    scheduler.stop();
+
+    EXPECT_EQ(source.done, JOB_COUNT);
+    EXPECT_EQ(source.maxRunning, 1);
+}
@@ -0,0 +1,62 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "control/SearchIndex.h"
+#include "pdf/base/XojPdfPage.h"
+
+/// One glyph of width 10 per character, on lines of height 12
+static auto makeLayout(const std::string& text) -> XojPdfPage::TextLayout {
+    XojPdfPage::TextLayout layout{text, {}};
+    double x = 0;
+    double y = 0;
+    for (const char* p = text.c_str(); *p; p = g_utf8_next_char(p)) {
+        layout.glyphs.emplace_back(x, y, x + 10, y + 12);
+        x += 10;
+        if (*p == '\n') {
+            x = 0;
+            y += 12;
+        }
+    }
+    return layout;
+}
+
+TEST(ControlSearchIndex, testToLowerCase) {
+    std::vector<uint32_t> charIndices;
+    EXPECT_EQ(SearchIndex::toLowerCase("ÄbC", &charIndices), "äbc");
+    // "ä" takes two bytes
+    EXPECT_EQ(charIndices, (std::vector<uint32_t>{0, 0, 1, 2}));
+}
+
+TEST(ControlSearchIndex, testFindPdfText) {
+    const SearchIndex::PdfText text(makeLayout("Hello World\nhello again"));
+
+    auto results = text.find(SearchIndex::toLowerCase("HELLO"));
+    ASSERT_EQ(results.size(), 2U);
+    EXPECT_EQ(results[0].x1, 0);
+    EXPECT_EQ(results[0].x2, 50);
+    EXPECT_EQ(results[0].y1, 0);
+    EXPECT_EQ(results[1].x1, 0);
+    EXPECT_EQ(results[1].y1, 12);
+    EXPECT_EQ(results[1].y2, 24);
+
+    results = text.find("o w");
+    ASSERT_EQ(results.size(), 1U);
+    EXPECT_EQ(results[0].x1, 40);
+    EXPECT_EQ(results[0].x2, 70);
+
+    EXPECT_TRUE(text.find("goodbye").empty());
+    EXPECT_TRUE(text.find("").empty());
+}
+
+TEST(ControlSearchIndex, testFindPdfTextMultiByte) {
+    // The boxes are those of the characters, not of the bytes
+    const SearchIndex::PdfText text(makeLayout("Ölçü über"));
+    auto results = text.find(SearchIndex::toLowerCase("ÜBER"));
+    ASSERT_EQ(results.size(), 1U);
+    EXPECT_EQ(results[0].x1, 50);
+    EXPECT_EQ(results[0].x2, 90);
+}
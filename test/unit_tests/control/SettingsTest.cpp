@@ -46,6 +46,7 @@ TEST(SettingsTest, testReadWrite) {
         settings.setFont(XojFont{"myfontname italic 34"});             // Font
         settings.latexSettings.editorFont = XojFont{"myfonttest 52"};  // Font
         settings.setPreloadPagesAfter(145);                            // unsigned int
+        settings.setPdfPageCacheMemory(1024);                          // unsigned int
         settings.transactionEnd();                                     // calls save()
 
         Settings loaded(outPath);
@@ -74,8 +75,24 @@ TEST(SettingsTest, testReadWrite) {
         EXPECT_EQ(settings.latexSettings.editorFont.getSize(), loaded.latexSettings.editorFont.getSize());  // Font
         EXPECT_EQ(settings.getPreloadPagesAfter(), loaded.getPreloadPagesAfter());    // unsigned int
         EXPECT_EQ(settings.getPreloadPagesBefore(), loaded.getPreloadPagesBefore());  // unsigned int
+        EXPECT_EQ(settings.getPdfPageCacheMemory(), loaded.getPdfPageCacheMemory());  // unsigned int
 
         fs::remove(outPath);
     };
     saveReloadTest(fs::temp_directory_path());
 }
+
+TEST(SettingsTest, testAutosaveCompressionThreadsAreCapped) {
+    Settings settings{"non-existing-file-path"};
+    // Do not write the settings
+    settings.transactionStart();
+    settings.setSaveCompressionThreads(8);
+    EXPECT_EQ(settings.getSaveCompressionThreads(), 8U);
+    EXPECT_EQ(settings.getAutosaveCompressionThreads(), Settings::MAX_AUTOSAVE_COMPRESSION_THREADS);
+    settings.setSaveCompressionThreads(1);
+    EXPECT_EQ(settings.getAutosaveCompressionThreads(), 1U);
+    // All the cores
+    settings.setSaveCompressionThreads(0);
+    EXPECT_GE(settings.getSaveCompressionThreads(), settings.getAutosaveCompressionThreads());
+    EXPECT_LE(settings.getAutosaveCompressionThreads(), Settings::MAX_AUTOSAVE_COMPRESSION_THREADS);
+}
@@ -0,0 +1,81 @@
+#include <charconv>
+#include <string>
+#include <string_view>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "control/xojfile/XmlParserHelper.h"
+
+#include "config-features.h"
+
+using XmlParserHelper::ScanResult;
+
+/// The reference parser: std::from_chars, or g_ascii_strtod where it cannot parse doubles
+static auto parseReference(const char* it, [[maybe_unused]] const char* end, double& value) -> const char* {
+#if ENABLE_FLOAT_FROM_CHARS
+    auto [ptr, ec] = std::from_chars(it, end, value);
+    return ec == std::errc{} ? ptr : nullptr;
+#else
+    char* ptr = nullptr;
+    value = g_ascii_strtod(it, &ptr);
+    return ptr == it ? nullptr : ptr;
+#endif
+}
+
+/// Scans the whole string and compares every value with the reference parser
+static void checkAgainstFromChars(const std::string& str) {
+    const char* it = str.data();
+    const char* end = str.data() + str.size();
+    const char* ref = it;
+    double value = 0;
+    while (XmlParserHelper::scanNumber(it, end, value) == ScanResult::OK) {
+        while (*ref == ' ' || *ref == '\n') {
+            ++ref;
+        }
+        double expected = 0;
+        const char* ptr = parseReference(ref, end, expected);
+        ASSERT_NE(ptr, nullptr) << "in \"" << str << '"';
+        EXPECT_EQ(value, expected) << "in \"" << str << '"';
+        EXPECT_EQ(it, ptr) << "in \"" << str << '"';
+        ref = ptr;
+    }
+    EXPECT_EQ(it, end) << "in \"" << str << '"';
+}
+
+TEST(XmlParserHelper, testScanNumberFixedFormat) {
+    checkAgainstFromChars("0 1 -1 12.5 -0.75 123.45678 -123.45678 0.1 0.3 9007.1992547");
+    checkAgainstFromChars("12345678.1234567 1234567.8 .5 -.5 5. 0.00012345 00001");
+    // More than 8 consecutive digits, handled 8 at a time
+    checkAgainstFromChars("123456789012345 1234.5678901 98765432.123");
+    // Whitespace as written by Xournal++
+    checkAgainstFromChars("  1.5\n2.25   \n");
+}
+
+TEST(XmlParserHelper, testScanNumberFallback) {
+    // Exponents and too many digits for the fast path
+    checkAgainstFromChars("1e-05 -1.2345678e+12 3E2");
+    checkAgainstFromChars("1234567890123456789 0.12345678901234567890 3.141592653589793238");
+}
+
+TEST(XmlParserHelper, testScanNumberErrors) {
+    std::string_view str = "1.5 abc";
+    const char* it = str.data();
+    const char* end = str.data() + str.size();
+    double value = 0;
+    EXPECT_EQ(XmlParserHelper::scanNumber(it, end, value), ScanResult::OK);
+    EXPECT_EQ(value, 1.5);
+    EXPECT_EQ(XmlParserHelper::scanNumber(it, end, value), ScanResult::BAD_NUMBER);
+    EXPECT_EQ(*it, 'a');
+
+    str = "  \n ";
+    it = str.data();
+    end = str.data() + str.size();
+    EXPECT_EQ(XmlParserHelper::scanNumber(it, end, value), ScanResult::END);
+
+    for (std::string_view bad: {"-", ".", "-.", "+"}) {
+        it = bad.data();
+        end = bad.data() + bad.size();
+        EXPECT_EQ(XmlParserHelper::scanNumber(it, end, value), ScanResult::BAD_NUMBER) << bad;
+    }
+}
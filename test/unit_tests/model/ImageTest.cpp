@@ -10,11 +10,15 @@
  */
 
 #include <fstream>
+#include <thread>
+#include <vector>
 
 #include <config-test.h>
 #include <gtest/gtest.h>
 
+#include "model/DecodedImageCache.h"
 #include "model/Image.h"
+#include "model/ImageDataPool.h"
 
 #include "filesystem.h"
 
@@ -49,6 +53,101 @@ TEST(Image, testGetImageApplyOrientation) {
     // Test image now have the correct size - which is the image has been rotated.
     EXPECT_EQ(image.getImageSize(), rotatedImageSize);
     EXPECT_EQ(image.getImageSize(), std::make_pair(130, 500));
-    EXPECT_EQ(std::make_pair(cairo_image_surface_get_width(surface), cairo_image_surface_get_height(surface)),
+    EXPECT_EQ(std::make_pair(cairo_image_surface_get_width(surface.get()),
+                             cairo_image_surface_get_height(surface.get())),
               rotatedImageSize);
 }
+
+TEST(Image, testDecodedImageCacheLevels) {
+    EXPECT_EQ(DecodedImageCache::getLevel(1000, 500, 0, 0), 0U);
+    EXPECT_EQ(DecodedImageCache::getLevel(1000, 500, 1200, 600), 0U);
+    EXPECT_EQ(DecodedImageCache::getLevel(1000, 500, 501, 250), 0U);
+    EXPECT_EQ(DecodedImageCache::getLevel(1000, 500, 500, 250), 1U);
+    // The orientation does not matter
+    EXPECT_EQ(DecodedImageCache::getLevel(1000, 500, 125, 250), 2U);
+    EXPECT_EQ(DecodedImageCache::getLevel(1000, 500, 1, 1), DecodedImageCache::MAX_LEVEL);
+}
+
+static auto surfaceSize(const xoj::util::CairoSurfaceSPtr& surface) -> std::pair<int, int> {
+    return {cairo_image_surface_get_width(surface.get()), cairo_image_surface_get_height(surface.get())};
+}
+
+TEST(Image, testDecodedImageCache) {
+    auto& cache = DecodedImageCache::getInstance();
+    cache.clear();
+
+    std::ifstream imageFile{fs::path(GET_TESTFILE(u8"images/r90.jpg")), std::ios::binary};
+    auto image = Image();
+    image.setImage(std::string(std::istreambuf_iterator<char>(imageFile), {}));
+
+    // Drawn 4 times smaller than its size: only a quarter of the resolution is decoded
+    auto small = image.getImage(130 / 4.0, 500 / 4.0);
+    ASSERT_TRUE(small);
+    EXPECT_EQ(image.getImageSize(), std::make_pair(130, 500));
+    EXPECT_EQ(surfaceSize(small), std::make_pair(33, 125));
+    EXPECT_EQ(image.getImage(130 / 4.0, 500 / 4.0).get(), small.get());
+
+    // A bit larger: the next level is needed
+    auto medium = image.getImage(40, 160);
+    EXPECT_EQ(surfaceSize(medium), std::make_pair(65, 250));
+    EXPECT_EQ(surfaceSize(image.getImage()), std::make_pair(130, 500));
+
+    // Only the most recently used surface fits in the budget
+    cache.setMemoryBudget(0);
+    const auto stride = cairo_image_surface_get_stride(image.getImage().get());
+    EXPECT_EQ(cache.getMemoryUsage(), static_cast<size_t>(stride) * 500);
+
+    // The evicted levels are decoded again
+    auto again = image.getImage(130 / 4.0, 500 / 4.0);
+    EXPECT_NE(again.get(), small.get());
+    EXPECT_EQ(surfaceSize(again), surfaceSize(small));
+
+    cache.setMemoryBudget(DecodedImageCache::DEFAULT_MEMORY_BUDGET);
+    cache.clear();
+    EXPECT_EQ(cache.getMemoryUsage(), 0U);
+}
+
+TEST(Image, testSharedImageData) {
+    auto& pool = ImageDataPool::getInstance();
+    const size_t buffers = pool.size();
+
+    std::ifstream imageFile{fs::path(GET_TESTFILE(u8"images/r90.jpg")), std::ios::binary};
+    const std::string data(std::istreambuf_iterator<char>(imageFile), {});
+    {
+        // Images with the same data share the buffer and the decoded surface
+        auto first = Image();
+        first.setImage(std::string(data));
+        auto second = Image();
+        second.setImage(std::string(data));
+        EXPECT_EQ(first.getSharedData(), second.getSharedData());
+        EXPECT_EQ(pool.size(), buffers + 1);
+        EXPECT_EQ(first.getImage().get(), second.getImage().get());
+        EXPECT_EQ(second.getImageSize(), std::make_pair(130, 500));
+
+        auto clone = first.clone();
+        EXPECT_EQ(dynamic_cast<Image*>(clone.get())->getSharedData(), first.getSharedData());
+        EXPECT_EQ(pool.size(), buffers + 1);
+    }
+    // The buffer is freed with the last image using it
+    EXPECT_EQ(pool.size(), buffers);
+}
+
+TEST(Image, testDecodeOnSeveralThreads) {
+    auto& cache = DecodedImageCache::getInstance();
+    cache.clear();
+
+    std::ifstream imageFile{fs::path(GET_TESTFILE(u8"images/r90.jpg")), std::ios::binary};
+    auto image = Image();
+    image.setImage(std::string(std::istreambuf_iterator<char>(imageFile), {}));
+
+    // The render jobs decode the same image at different levels while the main thread reads its size
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&image, i]() { EXPECT_TRUE(image.getImage(130.0 / (1 << i), 500.0 / (1 << i))); });
+    }
+    for (auto& t: threads) {
+        t.join();
+    }
+    EXPECT_EQ(image.getImageSize(), std::make_pair(130, 500));
+    cache.clear();
+}
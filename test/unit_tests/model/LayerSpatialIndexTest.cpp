@@ -0,0 +1,117 @@
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "util/Range.h"
+
+static auto makeStroke(double x, double y, double length) -> std::unique_ptr<Stroke> {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(1);
+    s->addPoint(Point(x, y));
+    s->addPoint(Point(x + length, y + length));
+    return s;
+}
+
+static auto findIntersecting(const Layer& l, const Range& rg) -> std::vector<Element::Index> {
+    std::vector<Element::Index> res;
+    l.forEachElementIntersecting(rg, [&](const Element*, Element::Index pos) { res.push_back(pos); });
+    return res;
+}
+
+TEST(LayerSpatialIndex, testQueryMatchesLinearScan) {
+    Layer l;
+    for (int i = 0; i < 50; i++) {
+        for (int j = 0; j < 50; j++) {
+            l.addElement(makeStroke(20. * i, 20. * j, 5.));
+        }
+    }
+    // One stroke crossing the whole layer
+    l.addElement(makeStroke(-100, -100, 20'000));
+
+    const Range queries[] = {Range(0, 0, 1, 1), Range(95, 95, 230, 410), Range(-50, -50, -10, -10),
+                             Range(0, 0, 2000, 2000), Range(500.5, 500.5, 500.5, 500.5)};
+    for (const Range& rg: queries) {
+        std::vector<Element::Index> expected;
+        Element::Index pos = 0;
+        for (const Element* e: l.getElementsView()) {
+            Range box(e->getBoundingBox());
+            if (box.minX <= rg.maxX && rg.minX <= box.maxX && box.minY <= rg.maxY && rg.minY <= box.maxY) {
+                expected.push_back(pos);
+            }
+            pos++;
+        }
+        EXPECT_EQ(findIntersecting(l, rg), expected);
+    }
+}
+
+TEST(LayerSpatialIndex, testIndexFollowsLayerChanges) {
+    Layer l;
+    l.addElement(makeStroke(0, 0, 10));
+    auto s = makeStroke(100, 100, 10);
+    Stroke* moved = s.get();
+    l.addElement(std::move(s));
+
+    const Range origin(0, 0, 20, 20);
+    EXPECT_EQ(findIntersecting(l, origin), std::vector<Element::Index>{0});
+
+    // Move the second stroke onto the first one
+    moved->move(-100, -100);
+    EXPECT_TRUE(l.updateElementBounds(moved));
+    EXPECT_EQ(findIntersecting(l, origin), (std::vector<Element::Index>{0, 1}));
+
+    // Insertion in front shifts the indices
+    l.insertElement(makeStroke(5, 5, 1), 0);
+    EXPECT_EQ(findIntersecting(l, origin), (std::vector<Element::Index>{0, 1, 2}));
+
+    auto removed = l.removeElement(moved);
+    EXPECT_EQ(removed.pos, 2);
+    EXPECT_EQ(findIntersecting(l, origin), (std::vector<Element::Index>{0, 1}));
+
+    l.clearNoFree();
+    EXPECT_TRUE(findIntersecting(l, origin).empty());
+}
+
+TEST(LayerSpatialIndex, testPositionsFollowInsertionsAndRemovals) {
+    Layer l;
+    for (int i = 0; i < 20; i++) {
+        l.addElement(makeStroke(i, i, 1));
+    }
+    const Range all(-10, -10, 100, 100);
+    // Build the cached positions
+    EXPECT_EQ(findIntersecting(l, all).size(), 20U);
+
+    auto checkPositions = [&]() {
+        std::vector<const Element*> found;
+        std::vector<Element::Index> indices;
+        l.forEachElementIntersecting(all, [&](const Element* e, Element::Index pos) {
+            found.push_back(e);
+            indices.push_back(pos);
+        });
+        std::vector<const Element*> expected(l.getElementsView().begin(), l.getElementsView().end());
+        EXPECT_EQ(found, expected);
+        for (size_t i = 0; i < indices.size(); i++) {
+            EXPECT_EQ(indices[i], static_cast<Element::Index>(i));
+        }
+    };
+
+    l.insertElement(makeStroke(3, 3, 1), 7);
+    checkPositions();
+    l.insertElement(makeStroke(4, 4, 1), 1000);
+    checkPositions();
+    l.removeElementAt(l.getElements()[4].get(), 4);
+    checkPositions();
+    l.removeElement(l.getElements().back().get());
+    checkPositions();
+
+    InsertionOrderRef toRemove;
+    toRemove.emplace_back(l.getElements()[2].get(), 2);
+    toRemove.emplace_back(l.getElements()[11].get(), 11);
+    auto removed = l.removeElementsAt(toRemove);
+    EXPECT_EQ(removed.size(), 2U);
+    checkPositions();
+    l.addElement(makeStroke(6, 6, 1));
+    checkPositions();
+}
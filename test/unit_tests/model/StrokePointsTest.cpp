@@ -0,0 +1,65 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/StrokePoints.h"
+
+TEST(StrokePoints, testPressureArrayIsLazy) {
+    StrokePoints pts;
+    pts.push_back(Point(0, 0));
+    pts.push_back(Point(1, 2));
+    EXPECT_FALSE(pts.hasPressureValues());
+    EXPECT_EQ(pts[1].z, Point::NO_PRESSURE);
+
+    pts.push_back(Point(3, 4, 0.5));
+    EXPECT_TRUE(pts.hasPressureValues());
+    EXPECT_EQ(pts.pressure(0), Point::NO_PRESSURE);
+    EXPECT_EQ(pts.pressure(1), Point::NO_PRESSURE);
+    EXPECT_EQ(pts.pressure(2), 0.5);
+    EXPECT_EQ(pts.back().x, 3);
+    EXPECT_EQ(pts.back().y, 4);
+}
+
+TEST(StrokePoints, testAppendAndTruncate) {
+    StrokePoints noPressure = std::vector<Point>{{0, 0}, {1, 1}, {2, 2}};
+    StrokePoints withPressure = std::vector<Point>{{5, 5, 1.0}, {6, 6, 2.0}};
+
+    StrokePoints pts = noPressure;
+    pts.append(withPressure, 1, 2);
+    ASSERT_EQ(pts.size(), 4U);
+    EXPECT_TRUE(pts.hasPressureValues());
+    EXPECT_EQ(pts.pressure(2), Point::NO_PRESSURE);
+    EXPECT_EQ(pts.pressure(3), 2.0);
+
+    pts.append(noPressure, 0, 2);
+    ASSERT_EQ(pts.size(), 6U);
+    EXPECT_EQ(pts.pressure(5), Point::NO_PRESSURE);
+    EXPECT_EQ(pts[5].x, 1);
+
+    pts.truncate(3);
+    EXPECT_EQ(pts.size(), 3U);
+    pts.truncate(10);
+    EXPECT_EQ(pts.size(), 3U);
+}
+
+TEST(StrokePoints, testRoundTrip) {
+    const std::vector<Point> points = {{0, 1, 0.25}, {2, 3, Point::NO_PRESSURE}, {4, 5, 0.75}};
+    StrokePoints pts = points;
+    pts.translate(1, -1);
+    pts.scalePressures(2);
+
+    const auto res = pts.toVector();
+    ASSERT_EQ(res.size(), points.size());
+    for (size_t i = 0; i < res.size(); i++) {
+        EXPECT_EQ(res[i].x, points[i].x + 1);
+        EXPECT_EQ(res[i].y, points[i].y - 1);
+        EXPECT_EQ(res[i].z, points[i].z == Point::NO_PRESSURE ? Point::NO_PRESSURE : 2 * points[i].z);
+    }
+
+    size_t n = 0;
+    for (const Point& p: pts) {
+        EXPECT_EQ(p.x, res[n++].x);
+    }
+    EXPECT_EQ(n, points.size());
+}
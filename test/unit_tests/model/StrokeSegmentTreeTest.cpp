@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "model/PathParameter.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeSegmentTree.h"
+#include "model/eraser/PaddedBox.h"
+#include "util/SmallVector.h"
+
+/// A random walk, long enough to use a segment tree
+static auto makeLongStroke(GRand* rand, bool pressure) -> std::unique_ptr<Stroke> {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(2.0);
+    double x = 300;
+    double y = 300;
+    for (size_t i = 0; i < 20 * StrokeSegmentTree::MIN_POINTS; i++) {
+        x += g_rand_double_range(rand, -5, 5);
+        y += g_rand_double_range(rand, -5, 5);
+        s->addPoint(Point(x, y, pressure ? g_rand_double_range(rand, 0.5, 6) : Point::NO_PRESSURE));
+    }
+    return s;
+}
+
+/// The same segments, split into strokes too short to use a segment tree
+static auto splitStroke(const Stroke& s) -> std::vector<std::unique_ptr<Stroke>> {
+    std::vector<std::unique_ptr<Stroke>> parts;
+    const size_t step = StrokeSegmentTree::MIN_POINTS / 2;
+    for (size_t first = 0; first + 1 < s.getPointCount(); first += step) {
+        auto part = std::make_unique<Stroke>();
+        part->applyStyleFrom(&s);
+        for (size_t i = first; i <= std::min(first + step, s.getPointCount() - 1); i++) {
+            part->addPoint(s.getPoint(i));
+        }
+        parts.emplace_back(std::move(part));
+    }
+    return parts;
+}
+
+TEST(StrokeSegmentTree, testQueriesMatchLinearScan) {
+    GRand* rand = g_rand_new_with_seed(42);
+    for (bool pressure: {false, true}) {
+        auto s = makeLongStroke(rand, pressure);
+        auto parts = splitStroke(*s);
+        ASSERT_LT(parts.front()->getPointCount(), StrokeSegmentTree::MIN_POINTS);
+
+        for (int i = 0; i < 500; i++) {
+            const double x = g_rand_double_range(rand, 0, 600);
+            const double y = g_rand_double_range(rand, 0, 600);
+            const double halfSize = g_rand_double_range(rand, 0.5, 10);
+
+            double distance = s->distanceTo(x, y);
+            double expectedDistance = std::numeric_limits<double>::max();
+            bool expectedIntersection = false;
+            for (auto& part: parts) {
+                expectedDistance = std::min(expectedDistance, part->distanceTo(x, y));
+                expectedIntersection |= part->intersects(x, y, halfSize);
+            }
+            EXPECT_EQ(distance, expectedDistance);
+            EXPECT_EQ(s->intersects(x, y, halfSize), expectedIntersection);
+        }
+    }
+    g_rand_free(rand);
+}
+
+TEST(StrokeSegmentTree, testIntersectWithPaddedBox) {
+    // A long horizontal line, crossing the box once
+    Stroke s;
+    s.setWidth(1.0);
+    for (size_t i = 0; i < 10 * StrokeSegmentTree::MIN_POINTS; i++) {
+        s.addPoint(Point(static_cast<double>(i), 10.0));
+    }
+
+    const PaddedBox box{Point(100.5, 10.0), 2.0, 3.0};
+    auto result = s.intersectWithPaddedBox(box);
+    ASSERT_EQ(result.size(), 2U);
+    EXPECT_EQ(result[0].index, 97U);
+    EXPECT_DOUBLE_EQ(result[0].t, 0.5);
+    EXPECT_EQ(result[1].index, 103U);
+    EXPECT_DOUBLE_EQ(result[1].t, 0.5);
+
+    // Restricted to a range of segments
+    EXPECT_EQ(s.intersectWithPaddedBox(box, 200, 300).size(), 0U);
+    EXPECT_EQ(s.intersectWithPaddedBox(box, 90, 300).size(), 2U);
+}
+
+TEST(StrokeSegmentTree, testTreeFollowsChanges) {
+    GRand* rand = g_rand_new_with_seed(7);
+    auto s = makeLongStroke(rand, false);
+    const Point p = s->getPoint(100);
+    EXPECT_EQ(s->distanceTo(p.x, p.y), 0.0);
+
+    s->move(1000, 0);
+    EXPECT_GT(s->distanceTo(p.x, p.y), 500.0);
+    EXPECT_EQ(s->distanceTo(p.x + 1000, p.y), 0.0);
+
+    s->setWidth(20.0);
+    EXPECT_EQ(s->distanceTo(p.x + 1000, p.y + 9), 0.0);
+
+    s->addPoint(Point(0, 0));
+    EXPECT_EQ(s->distanceTo(0, 0), 0.0);
+
+    s->deletePointsFrom(s->getPointCount() - 1);
+    EXPECT_GT(s->distanceTo(0, 0), 0.0);
+    g_rand_free(rand);
+}
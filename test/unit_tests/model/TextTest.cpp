@@ -0,0 +1,45 @@
+#include <thread>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/Font.h"
+#include "model/Text.h"
+
+TEST(Text, testLayoutIsCached) {
+    Text t;
+    t.setText("Lorem ipsum");
+    auto layout = t.getPangoLayout();
+    EXPECT_EQ(t.getPangoLayout().get(), layout.get());
+    const double width = t.getBoundingBox().width;
+
+    // Any change of the text or of its style drops the cached layout
+    t.setText("Lorem ipsum dolor sit amet");
+    EXPECT_NE(t.getPangoLayout().get(), layout.get());
+    EXPECT_GT(t.getBoundingBox().width, width);
+
+    layout = t.getPangoLayout();
+    t.setFont(XojFont("Sans", 24));
+    EXPECT_NE(t.getPangoLayout().get(), layout.get());
+
+    layout = t.getPangoLayout();
+    const double height = t.getBoundingBox().height;
+    t.setWrap(100);
+    EXPECT_NE(t.getPangoLayout().get(), layout.get());
+    EXPECT_GT(t.getBoundingBox().height, height);
+
+    // Another thread gets a layout of its own
+    layout = t.getPangoLayout();
+    std::thread([&]() { EXPECT_NE(t.getPangoLayout().get(), layout.get()); }).join();
+    // ... and does not drop the layout of this thread
+    EXPECT_EQ(t.getPangoLayout().get(), layout.get());
+
+    // Each font options get a layout of their own, and do not drop the other ones either
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_font_options_set_antialias(options, CAIRO_ANTIALIAS_NONE);
+    auto other = t.getPangoLayout(options);
+    EXPECT_NE(other.get(), layout.get());
+    EXPECT_EQ(t.getPangoLayout(options).get(), other.get());
+    EXPECT_EQ(t.getPangoLayout().get(), layout.get());
+    cairo_font_options_destroy(options);
+}
@@ -0,0 +1,66 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "undo/DeleteUndoAction.h"
+#include "util/serializing/BinObjectEncoding.h"
+#include "util/serializing/ObjectInputStream.h"
+#include "util/serializing/ObjectOutputStream.h"
+
+static auto newStroke(double y, int points) -> ElementPtr {
+    auto s = std::make_unique<Stroke>();
+    s->setWidth(1.5);
+    for (int i = 0; i < points; i++) {
+        s->addPoint(Point(i, y + 0.25 * i, 0.5 + 0.001 * i));
+    }
+    return s;
+}
+
+TEST(UndoMemory, testSpillAndRestoreDeletedStrokes) {
+    auto page = std::make_shared<XojPage>(595, 842);
+    Layer* layer = page->getLayers().front();
+
+    DeleteUndoAction action(page, false);
+    std::vector<const Stroke*> strokes;
+    std::vector<std::vector<Point>> points;
+    for (int i = 0; i < 3; i++) {
+        auto e = newStroke(10.0 * i, 1'000);
+        auto* s = dynamic_cast<const Stroke*>(e.get());
+        strokes.push_back(s);
+        points.emplace_back(s->getPointVector().begin(), s->getPointVector().end());
+        action.addElement(layer, std::move(e), i);
+    }
+
+    // The points make up most of the memory used by the action
+    const size_t usage = action.getMemoryUsage();
+    EXPECT_GE(usage, 3 * 1'000 * sizeof(Point));
+
+    ObjectOutputStream out(new BinObjectEncoding);
+    action.spill(out);
+    for (const Stroke* s: strokes) {
+        EXPECT_EQ(s->getPointCount(), 0U);
+    }
+    EXPECT_LT(action.getMemoryUsage(), usage / 10);
+
+    GString* data = out.stealData();
+    ObjectInputStream in;
+    ASSERT_TRUE(in.read(data->str, data->len));
+    action.restore(in);
+    g_string_free(data, true);
+
+    EXPECT_GE(action.getMemoryUsage(), 3 * 1'000 * sizeof(Point));
+    for (size_t i = 0; i < strokes.size(); i++) {
+        const auto& restored = strokes[i]->getPointVector();
+        ASSERT_EQ(restored.size(), points[i].size());
+        for (size_t j = 0; j < points[i].size(); j++) {
+            EXPECT_TRUE(restored[j].equalsPos(points[i][j]));
+            EXPECT_EQ(restored[j].z, points[i][j].z);
+        }
+    }
+}
@@ -0,0 +1,139 @@
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "undo/UndoAction.h"
+#include "undo/UndoRedoHandler.h"
+#include "util/serializing/ObjectInputStream.h"
+#include "util/serializing/ObjectOutputStream.h"
+
+constexpr size_t BLOB_SIZE = 100 * 1024;
+
+/// Action holding a blob of data, which it spills
+class BlobAction: public UndoAction {
+public:
+    explicit BlobAction(char c): UndoAction("BlobAction"), data(BLOB_SIZE, c), c(c) {}
+
+    bool undo(Control*) override { return true; }
+    bool redo(Control*) override { return true; }
+    std::string getText() override { return "Blob"; }
+
+    size_t getMemoryUsage() const override { return UndoAction::getMemoryUsage() + data.capacity(); }
+
+    void spill(ObjectOutputStream& out) override {
+        out.writeString(data);
+        data.clear();
+        data.shrink_to_fit();
+    }
+
+    void restore(ObjectInputStream& in) override { data = in.readString(); }
+
+    bool isSpilled() const { return data.empty(); }
+    bool isIntact() const { return data == std::string(BLOB_SIZE, c); }
+
+private:
+    std::string data;
+    char c;
+};
+
+static auto addBlob(UndoRedoHandler& handler, char c) -> BlobAction* {
+    auto action = std::make_unique<BlobAction>(c);
+    auto* ptr = action.get();
+    handler.addUndoAction(std::move(action));
+    return ptr;
+}
+
+TEST(UndoRedoHandler, testMemoryUsageIsAccounted) {
+    UndoRedoHandler handler(nullptr);
+    EXPECT_EQ(handler.getMemoryUsage(), 0U);
+
+    addBlob(handler, 'a');
+    addBlob(handler, 'b');
+    EXPECT_GE(handler.getMemoryUsage(), 2 * BLOB_SIZE);
+    EXPECT_LT(handler.getMemoryUsage(), 3 * BLOB_SIZE);
+
+    // The undone actions are still held, until a new action is added
+    handler.undo();
+    EXPECT_GE(handler.getMemoryUsage(), 2 * BLOB_SIZE);
+    handler.undo();
+    EXPECT_GE(handler.getMemoryUsage(), 2 * BLOB_SIZE);
+
+    addBlob(handler, 'c');
+    EXPECT_GE(handler.getMemoryUsage(), BLOB_SIZE);
+    EXPECT_LT(handler.getMemoryUsage(), 2 * BLOB_SIZE);
+
+    handler.clearContents();
+    EXPECT_EQ(handler.getMemoryUsage(), 0U);
+}
+
+TEST(UndoRedoHandler, testOldestActionsAreSpilledFirst) {
+    UndoRedoHandler handler(nullptr);
+    handler.setMemoryBudget(5 * BLOB_SIZE / 2, true);
+
+    std::vector<BlobAction*> actions;
+    for (char c: {'a', 'b', 'c', 'd'}) {
+        actions.push_back(addBlob(handler, c));
+    }
+    EXPECT_LE(handler.getMemoryUsage(), 5 * BLOB_SIZE / 2);
+    EXPECT_TRUE(actions[0]->isSpilled());
+    EXPECT_TRUE(actions[1]->isSpilled());
+    EXPECT_FALSE(actions[2]->isSpilled());
+    EXPECT_FALSE(actions[3]->isSpilled());
+    EXPECT_GE(handler.getSpillFileSize(), 2 * BLOB_SIZE);
+
+    // The spilled actions are read back before they are undone
+    while (handler.canUndo()) {
+        handler.undo();
+    }
+    for (const BlobAction* action: actions) {
+        EXPECT_TRUE(action->isIntact());
+    }
+    EXPECT_EQ(handler.getSpillFileSize(), 0U);
+}
+
+TEST(UndoRedoHandler, testOldestActionsAreDroppedWithoutSpilling) {
+    UndoRedoHandler handler(nullptr);
+    handler.documentSaved();
+    handler.setMemoryBudget(5 * BLOB_SIZE / 2, false);
+
+    std::vector<BlobAction*> actions;
+    for (char c: {'a', 'b', 'c', 'd'}) {
+        actions.push_back(addBlob(handler, c));
+    }
+    EXPECT_LE(handler.getMemoryUsage(), 5 * BLOB_SIZE / 2);
+    EXPECT_EQ(handler.getSpillFileSize(), 0U);
+    EXPECT_FALSE(actions[2]->isSpilled());
+    EXPECT_FALSE(actions[3]->isSpilled());
+
+    int undone = 0;
+    while (handler.canUndo()) {
+        handler.undo();
+        undone++;
+    }
+    EXPECT_EQ(undone, 2);
+    // The saved state cannot be reached anymore
+    EXPECT_TRUE(handler.isChanged());
+}
+
+TEST(UndoRedoHandler, testSpillFileSpaceIsReused) {
+    UndoRedoHandler handler(nullptr);
+    handler.setMemoryBudget(3 * BLOB_SIZE / 2, true);
+
+    BlobAction* first = addBlob(handler, 'a');
+    for (int i = 0; i < 10; i++) {
+        addBlob(handler, 'b');
+        addBlob(handler, 'c');
+        EXPECT_TRUE(first->isSpilled());
+        EXPECT_LT(handler.getSpillFileSize(), 3 * BLOB_SIZE);
+
+        // Reads back the second action, whose space is freed
+        handler.undo();
+        handler.undo();
+        EXPECT_GE(handler.getSpillFileSize(), BLOB_SIZE);
+        EXPECT_LT(handler.getSpillFileSize(), 2 * BLOB_SIZE);
+    }
+}
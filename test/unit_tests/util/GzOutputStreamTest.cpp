@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "util/GzInputStream.h"
+#include "util/OutputStream.h"
+
+#include "filesystem.h"
+
+/// Text that looks like a .xopp file, with some variation
+static auto makeContent(size_t size) -> std::string {
+    std::string content;
+    unsigned state = 42;
+    while (content.size() < size) {
+        state = state * 1103515245U + 12345U;
+        content += "<stroke tool=\"pen\" color=\"#000000ff\" width=\"1.41\">";
+        content += std::to_string(state % 1000) + "." + std::to_string(state % 97) + " 12.5 ";
+        content += std::to_string(state) + "</stroke>\n";
+    }
+    content.resize(size);
+    return content;
+}
+
+static auto readAll(const fs::path& file) -> std::string {
+    xoj::util::GzInputStream in(file);
+    std::string result;
+    char buffer[4096];
+    int read = 0;
+    while ((read = in.read(buffer, sizeof(buffer))) > 0) {
+        result.append(buffer, static_cast<size_t>(read));
+    }
+    EXPECT_EQ(read, 0);
+    in.close();
+    return result;
+}
+
+/// Write in pieces of varying sizes, crossing the block boundaries
+static void writeInPieces(OutputStream& out, const std::string& content) {
+    size_t pos = 0;
+    for (size_t n = 1; pos < content.size(); n = n * 3 + 1) {
+        size_t len = std::min(n % 100'000 + 1, content.size() - pos);
+        out.write(content.data() + pos, len);
+        pos += len;
+    }
+}
+
+static void checkRoundTrip(const std::string& content, GzCompression compression) {
+    const auto file = fs::temp_directory_path() / "xournalpp-test-units_GzOutputStream.gz";
+    {
+        GzOutputStream out(file, compression);
+        ASSERT_TRUE(out.getLastError().empty()) << out.getLastError();
+        writeInPieces(out, content);
+        out.close();
+        EXPECT_TRUE(out.getLastError().empty()) << out.getLastError();
+    }
+    EXPECT_EQ(readAll(file), content) << "level " << compression.level << ", " << compression.threads << " threads, "
+                                      << content.size() << " bytes";
+    fs::remove(file);
+}
+
+TEST(UtilGzOutputStream, testRoundTrip) {
+    for (size_t size: {0UL, 10UL, 128UL * 1024UL, 1'000'000UL}) {
+        const auto content = makeContent(size);
+        for (int level: {Z_DEFAULT_COMPRESSION, 0, 1, 9}) {
+            for (unsigned int threads: {1U, 2U, 4U}) {
+                checkRoundTrip(content, {level, threads});
+            }
+        }
+    }
+}
+
+TEST(UtilGzOutputStream, testStringRoundTrip) {
+    const auto file = fs::temp_directory_path() / "xournalpp-test-units_GzStringOutputStream.gz";
+    for (size_t size: {0UL, 10UL, 1'000'000UL}) {
+        const auto content = makeContent(size);
+        for (unsigned int threads: {1U, 4U}) {
+            GzStringOutputStream out({Z_DEFAULT_COMPRESSION, threads});
+            writeInPieces(out, content);
+            ASSERT_TRUE(out.writeTo(file)) << out.getLastError();
+            // Only the compressed data was kept
+            if (size > 1000) {
+                EXPECT_LT(fs::file_size(file), content.size());
+            }
+            EXPECT_EQ(readAll(file), content) << threads << " threads, " << size << " bytes";
+        }
+    }
+    fs::remove(file);
+}
+
+TEST(UtilGzOutputStream, testParallelCompressionRatio) {
+    // The blocks use the end of the previous block as dictionary: the file should barely be larger
+    const auto content = makeContent(2'000'000);
+    auto compressedSize = [&](unsigned int threads) {
+        const auto file = fs::temp_directory_path() / "xournalpp-test-units_GzOutputStream.gz";
+        GzOutputStream out(file, {Z_DEFAULT_COMPRESSION, threads});
+        out.write(content.data(), content.size());
+        out.close();
+        auto size = fs::file_size(file);
+        fs::remove(file);
+        return size;
+    };
+    const auto serial = compressedSize(1);
+    const auto parallel = compressedSize(4);
+    EXPECT_LT(parallel, serial + serial / 50);
+}
@@ -0,0 +1,70 @@
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "util/OutputStream.h"
+#include "util/Util.h"
+
+/// The output of the original implementation
+static auto formatWithPrintf(double value) -> std::string {
+    char str[G_ASCII_DTOSTR_BUF_SIZE];
+    g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
+    return str;
+}
+
+static auto formatNumber(double value) -> std::string {
+    char str[Util::NUMBER_STRING_BUF_SIZE];
+    char* end = Util::formatNumber(str, value);
+    return std::string(str, end);
+}
+
+TEST(UtilNumberFormat, testSameAsPrintf) {
+    for (double v: {0.0, -0.0, 1.0, -1.0, 0.5, 12.345678912, 595.27559, 841.88976, 123456789.0, 1e-7, 2.5e-12,
+                    -3.0e15, 1e300, 1e-300, 0.1, 1.0 / 3.0, 99999999.5, 9.99999995}) {
+        EXPECT_EQ(formatNumber(v), formatWithPrintf(v));
+    }
+
+    // Coordinates and pressures as found in handwritten strokes
+    unsigned state = 42;
+    for (int i = 0; i < 100'000; i++) {
+        state = state * 1103515245U + 12345U;
+        const double v = static_cast<double>(state) / 4096.0 - 500'000.0;
+        ASSERT_EQ(formatNumber(v), formatWithPrintf(v)) << v;
+        ASSERT_EQ(formatNumber(v / 1000.0), formatWithPrintf(v / 1000.0)) << v / 1000.0;
+    }
+}
+
+TEST(UtilNumberFormat, testWriteCoordinateString) {
+    // Enough points for several chunks
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::string expected;
+    for (int i = 0; i < 2'000; i++) {
+        xs.push_back(0.1 * i + 1.0 / 3.0);
+        ys.push_back(-0.7 * i);
+        if (i > 0) {
+            expected += ' ';
+        }
+        expected += formatWithPrintf(xs.back()) + ' ' + formatWithPrintf(ys.back());
+    }
+
+    StringOutputStream out;
+    Util::writeCoordinateString(&out, xs.data(), ys.data(), xs.size());
+    EXPECT_EQ(out.getString(), expected);
+
+    StringOutputStream single;
+    Util::writeCoordinateString(&single, xs[1], ys[1]);
+    EXPECT_EQ(single.getString(), formatWithPrintf(xs[1]) + ' ' + formatWithPrintf(ys[1]));
+
+    StringOutputStream values;
+    Util::writeNumberString(&values, xs.data(), 3);
+    EXPECT_EQ(values.getString(), formatWithPrintf(xs[0]) + ' ' + formatWithPrintf(xs[1]) + ' ' + formatWithPrintf(xs[2]));
+
+    StringOutputStream empty;
+    Util::writeNumberString(&empty, xs.data(), 0);
+    EXPECT_TRUE(empty.getString().empty());
+}
@@ -355,8 +355,8 @@ void assertStrokeEquality(const Stroke& stroke1, const Stroke& stroke2) {
         EXPECT_TRUE(std::isnan(avgPressure2));
     }
 
-    std::vector<Point> points1 = stroke1.getPointVector();
-    std::vector<Point> points2 = stroke2.getPointVector();
+    std::vector<Point> points1 = stroke1.getPointVector().toVector();
+    std::vector<Point> points2 = stroke2.getPointVector().toVector();
 
     EXPECT_EQ(points1.size(), points2.size());
     for (size_t i = 0; i < points1.size(); ++i) { EXPECT_TRUE(points1[i].equalsPos(points2[i])); }
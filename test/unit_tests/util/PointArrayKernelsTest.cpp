@@ -0,0 +1,77 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/PointArrayKernels.h"
+
+using namespace xoj::util::simd;
+
+/// Pseudo random coordinates, deterministic
+static auto makeValues(size_t n, unsigned seed) -> std::vector<double> {
+    std::vector<double> v(n);
+    unsigned state = seed;
+    for (double& d: v) {
+        state = state * 1103515245U + 12345U;
+        d = static_cast<double>(state % 100000U) / 100.0 - 500.0;
+    }
+    return v;
+}
+
+TEST(PointArrayKernels, testMinMaxAgainstScalar) {
+    // Sizes around the vector widths, to test the remainders
+    for (size_t n = 1; n < 40; n++) {
+        auto v = makeValues(n, static_cast<unsigned>(n));
+        const auto ref = scalar::minMax(v.data(), n);
+        const auto res = minMax(v.data(), n);
+        EXPECT_EQ(res.min, ref.min) << "n = " << n;
+        EXPECT_EQ(res.max, ref.max) << "n = " << n;
+        EXPECT_EQ(maxValue(v.data(), n), scalar::maxValue(v.data(), n)) << "n = " << n;
+    }
+}
+
+TEST(PointArrayKernels, testTransformAgainstScalar) {
+    const AffineMatrix m = {std::cos(0.3), std::sin(0.3), -std::sin(0.3), std::cos(0.3), 12.5, -3.25};
+    for (size_t n = 0; n < 40; n++) {
+        auto xs = makeValues(n, 1);
+        auto ys = makeValues(n, 2);
+        auto refXs = xs;
+        auto refYs = ys;
+        scalar::transform(refXs.data(), refYs.data(), n, m);
+        transform(xs.data(), ys.data(), n, m);
+        EXPECT_EQ(xs, refXs) << "n = " << n;
+        EXPECT_EQ(ys, refYs) << "n = " << n;
+
+        scalar::translate(refXs.data(), n, 0.125);
+        translate(xs.data(), n, 0.125);
+        EXPECT_EQ(xs, refXs) << "n = " << n;
+    }
+}
+
+TEST(PointArrayKernels, testFindSegmentTouchingBox) {
+    // A horizontal polyline going through the box [10, 12] x [-1, 1] between the points 10 and 12
+    std::vector<double> xs;
+    std::vector<double> ys;
+    for (int i = 0; i < 30; i++) {
+        xs.push_back(i);
+        ys.push_back(i % 2 ? 0.5 : -0.5);
+    }
+    const Box box = {10.0, -1.0, 12.0, 1.0};
+    const size_t last = xs.size() - 1;
+
+    // The segment 9 ends on the box boundary
+    EXPECT_EQ(findSegmentTouchingBox(xs.data(), ys.data(), 0, last, box), 9U);
+    EXPECT_EQ(findSegmentTouchingBox(xs.data(), ys.data(), 10, last, box), 10U);
+    EXPECT_EQ(findSegmentTouchingBox(xs.data(), ys.data(), 12, last, box), 12U);
+    EXPECT_EQ(findSegmentTouchingBox(xs.data(), ys.data(), 13, last, box), last);
+    EXPECT_EQ(findSegmentTouchingBox(xs.data(), ys.data(), 0, 5, box), 5U);
+
+    for (size_t first = 0; first < last; first++) {
+        EXPECT_EQ(findSegmentTouchingBox(xs.data(), ys.data(), first, last, box),
+                  scalar::findSegmentTouchingBox(xs.data(), ys.data(), first, last, box));
+    }
+
+    // Far above the box
+    std::vector<double> above(xs.size(), 5.0);
+    EXPECT_EQ(findSegmentTouchingBox(xs.data(), above.data(), 0, last, box), last);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "util/Range.h"
+#include "view/Mask.h"
+#include "view/TileCache.h"
+
+using xoj::view::Mask;
+using xoj::view::TileCache;
+
+static auto makeTile(TileCache::TileCoord c, double zoom) -> Mask {
+    return Mask(1, TileCache::getTileExtent(c, zoom), zoom, CAIRO_CONTENT_COLOR_ALPHA);
+}
+
+TEST(TileCache, testTilesCovering) {
+    constexpr double zoom = 2.0;
+    const double side = TileCache::TILE_SIZE / zoom;
+
+    auto tiles = TileCache::getTilesCovering(Range(0, 0, side, side), zoom);
+    ASSERT_EQ(tiles.size(), 1U);
+    EXPECT_EQ(tiles[0].x, 0);
+    EXPECT_EQ(tiles[0].y, 0);
+
+    tiles = TileCache::getTilesCovering(Range(side - 1, 0, 2 * side + 1, side / 2), zoom);
+    ASSERT_EQ(tiles.size(), 3U);
+    EXPECT_EQ(tiles.front().x, 0);
+    EXPECT_EQ(tiles.back().x, 2);
+
+    EXPECT_TRUE(TileCache::getTilesCovering(Range(), zoom).empty());
+}
+
+TEST(TileCache, testMissingTilesAndInvalidation) {
+    constexpr double zoom = 1.0;
+    const double side = TileCache::TILE_SIZE / zoom;
+    const Range area(0, 0, 2 * side, side);
+
+    TileCache cache;
+    cache.setZoom(zoom);
+    EXPECT_TRUE(cache.isEmpty());
+    EXPECT_EQ(cache.getMissingTiles(area).size(), 2U);
+
+    cache.setTile({0, 0}, zoom, makeTile({0, 0}, zoom));
+    auto missing = cache.getMissingTiles(area);
+    ASSERT_EQ(missing.size(), 1U);
+    EXPECT_EQ(missing[0].x, 1);
+
+    // Tiles rendered for an outdated zoom level are dropped
+    cache.setTile({1, 0}, 3.0, makeTile({1, 0}, 3.0));
+    EXPECT_EQ(cache.getMissingTiles(area).size(), 1U);
+
+    cache.setTile({1, 0}, zoom, makeTile({1, 0}, zoom));
+    EXPECT_TRUE(cache.getMissingTiles(area).empty());
+
+    cache.invalidateAll();
+    EXPECT_EQ(cache.getMissingTiles(area).size(), 2U);
+    EXPECT_FALSE(cache.isEmpty());
+}
+
+TEST(TileCache, testZoomChangeAndPruning) {
+    const double side = TileCache::TILE_SIZE;
+    TileCache cache;
+    cache.setZoom(1.0);
+    for (int x = 0; x < 4; x++) {
+        cache.setTile({x, 0}, 1.0, makeTile({x, 0}, 1.0));
+    }
+
+    // Tiles further than one tile away from the visible area are deleted
+    cache.prune(Range(0, 0, side / 2, side / 2));
+    EXPECT_TRUE(cache.getMissingTiles(Range(0, 0, 2 * side, side)).empty());
+    EXPECT_EQ(cache.getMissingTiles(Range(2 * side, 0, 4 * side, side)).size(), 2U);
+
+    // The former tiles are kept as placeholders until the visible area is covered
+    cache.setZoom(2.0);
+    const Range visible(0, 0, side / 4, side / 4);
+    EXPECT_EQ(cache.getMissingTiles(visible).size(), 1U);
+    cache.prune(visible);
+    EXPECT_FALSE(cache.isEmpty());
+
+    int count = 0;
+    cache.forEachTileIntersecting(visible, [&count](cairo_t*) { count++; });
+    EXPECT_EQ(count, 1);
+
+    cache.setTile({0, 0}, 2.0, makeTile({0, 0}, 2.0));
+    cache.prune(visible);
+    count = 0;
+    cache.forEachTileIntersecting(visible, [&count](cairo_t*) { count++; });
+    EXPECT_EQ(count, 1);
+
+    cache.clear();
+    EXPECT_TRUE(cache.isEmpty());
+}
+
+TEST(TileCache, testDrafts) {
+    constexpr double zoom = 1.0;
+    const double side = TileCache::TILE_SIZE / zoom;
+    const Range area(0, 0, side, side);
+
+    TileCache cache;
+    cache.setZoom(zoom);
+    cache.setTile({0, 0}, zoom, Mask(1, TileCache::getTileExtent({0, 0}, zoom), zoom / 2, CAIRO_CONTENT_COLOR_ALPHA),
+                  /* draft */ true);
+
+    // A draft still needs to be replaced by the final rendering
+    EXPECT_TRUE(cache.getMissingTiles(area, false).empty());
+    EXPECT_EQ(cache.getMissingTiles(area).size(), 1U);
+
+    cache.setTile({0, 0}, zoom, makeTile({0, 0}, zoom));
+    EXPECT_TRUE(cache.getMissingTiles(area).empty());
+
+    // A draft never replaces a tile
+    cache.setTile({0, 0}, zoom, makeTile({0, 0}, zoom), /* draft */ true);
+    EXPECT_TRUE(cache.getMissingTiles(area).empty());
+}